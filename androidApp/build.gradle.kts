@@ -34,6 +34,11 @@ android {
             excludes += "/META-INF/{AL2.0,LGPL2.1}"
         }
     }
+
+    // 模型 bundle 不压缩存储，native 端可直接 mmap APK 中的数据
+    androidResources {
+        noCompress += "l2dbundle"
+    }
     
     signingConfigs {
         create("release") {
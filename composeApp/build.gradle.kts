@@ -261,6 +261,8 @@ android {
         externalNativeBuild {
             cmake {
                 abiFilters.addAll(listOf("arm64-v8a", "x86_64", "x86"))
+                // -Plive2d.vulkan=true: 同时编译 Vulkan 后端 (运行时不可用则回退 GLES)
+                if (project.findProperty("live2d.vulkan") == "true") arguments += "-DLIVE2D_VULKAN=ON"
             }
         }
     }
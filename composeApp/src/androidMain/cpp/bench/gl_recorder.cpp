@@ -0,0 +1,408 @@
+#include "gl_recorder.h"
+#include "gl_trace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <utility>
+
+// ===================== Log Writer =====================
+
+static std::vector<uint8_t> g_log;
+static const GLDispatch*    g_next = nullptr;
+static bool                 g_logging = false;   // false: null backend only, nothing appended
+
+// Null backend state
+static GLuint g_nextObject = 1;
+static GLuint g_boundElementBuffer = 0;
+static GLuint g_boundVertexArray = 0;
+static GLuint g_boundPackBuffer = 0;    // 非 0 时 ReadPixels 的 pixels 是缓冲内偏移
+static std::map<GLuint, GLuint> g_vertexArrayElementBuffer;   // VAO 记录自己的索引缓冲绑定
+static std::map<GLuint, std::vector<uint8_t>> g_elementData;  // 索引缓冲内容, 用来算 DrawElements 的顶点数
+static std::map<GLuint, GLint> g_nextBlock;
+static std::vector<uint8_t> g_mapScratch;   // 空后端 MapBufferRange 返回的内存, 只增不减
+static int g_nullGlesVersion = 2;
+static std::map<std::pair<GLuint, std::string>, GLint> g_locations;
+static std::map<GLuint, GLint> g_nextAttrib, g_nextUniform;
+
+// 空后端的 "程序二进制": 任何内容都能 "链接" 成功, 只用来走通二进制缓存的读写路径
+static const char   kNullProgramBinary[] = "L2D null program binary";
+static const GLenum kNullProgramBinaryFormat = 0x4C32;
+
+static void putWord(uint32_t w) {
+    if (!g_logging) return;
+    uint8_t b[4] = { (uint8_t)w, (uint8_t)(w >> 8), (uint8_t)(w >> 16), (uint8_t)(w >> 24) };
+    g_log.insert(g_log.end(), b, b + 4);
+}
+
+static void beginRecord(uint8_t op, size_t words) {
+    if (!g_logging) return;
+    g_log.push_back(op);
+    g_log.push_back((uint8_t)(words & 0xFF));
+    g_log.push_back((uint8_t)(words >> 8));
+}
+
+static void rec(GLOp op, std::initializer_list<uint32_t> words) {
+    beginRecord((uint8_t)op, words.size());
+    for (uint32_t w : words) putWord(w);
+}
+
+static uint32_t fbits(float f) { uint32_t u; memcpy(&u, &f, 4); return u; }
+
+static uint32_t hashString(const char* s, int len, uint32_t h) {
+    for (int i = 0; len < 0 ? s[i] != '\0' : i < len; i++) { h ^= (uint8_t)s[i]; h *= 16777619u; }
+    return h;
+}
+
+static GLint nullLocation(GLuint program, const GLchar* name, std::map<GLuint, GLint>& next) {
+    auto key = std::make_pair(program, std::string(name));
+    auto it = g_locations.find(key);
+    if (it != g_locations.end()) return it->second;
+    GLint loc = next[program]++;
+    g_locations[key] = loc;
+    return loc;
+}
+
+// ===================== Recording Entry Points =====================
+
+#define FWD(name, args) do { if (g_next) g_next->name args; } while (0)
+
+static void r_ActiveTexture(GLenum t) { rec(GLOp::ActiveTexture, {t}); FWD(ActiveTexture, (t)); }
+static void r_AttachShader(GLuint p, GLuint s) { rec(GLOp::AttachShader, {p, s}); FWD(AttachShader, (p, s)); }
+static void r_BindBuffer(GLenum t, GLuint b) {
+    if (t == GL_ELEMENT_ARRAY_BUFFER) g_vertexArrayElementBuffer[g_boundVertexArray] = g_boundElementBuffer = b;
+    if (t == GL_PIXEL_PACK_BUFFER) g_boundPackBuffer = b;
+    rec(GLOp::BindBuffer, {t, b}); FWD(BindBuffer, (t, b));
+}
+static void r_BindFramebuffer(GLenum t, GLuint f) { rec(GLOp::BindFramebuffer, {t, f}); FWD(BindFramebuffer, (t, f)); }
+static void r_BindRenderbuffer(GLenum t, GLuint r) { rec(GLOp::BindRenderbuffer, {t, r}); FWD(BindRenderbuffer, (t, r)); }
+static void r_BindTexture(GLenum t, GLuint tex) { rec(GLOp::BindTexture, {t, tex}); FWD(BindTexture, (t, tex)); }
+static void r_BlendFuncSeparate(GLenum a, GLenum b, GLenum c, GLenum d) {
+    rec(GLOp::BlendFuncSeparate, {a, b, c, d}); FWD(BlendFuncSeparate, (a, b, c, d));
+}
+static void r_BufferData(GLenum t, GLsizeiptr size, const void* data, GLenum usage) {
+    if (t == GL_ELEMENT_ARRAY_BUFFER && g_logging) {
+        std::vector<uint8_t>& copy = g_elementData[g_boundElementBuffer];
+        if (data) copy.assign((const uint8_t*)data, (const uint8_t*)data + size);
+        else copy.clear();
+    }
+    rec(GLOp::BufferData, {t, (uint32_t)size, usage, data ? 1u : 0u}); FWD(BufferData, (t, size, data, usage));
+}
+static void r_BufferSubData(GLenum t, GLintptr off, GLsizeiptr size, const void* data) {
+    rec(GLOp::BufferSubData, {t, (uint32_t)off, (uint32_t)size}); FWD(BufferSubData, (t, off, size, data));
+}
+static GLenum r_CheckFramebufferStatus(GLenum t) {
+    GLenum s = g_next ? g_next->CheckFramebufferStatus(t) : (GLenum)GL_FRAMEBUFFER_COMPLETE;
+    rec(GLOp::CheckFramebufferStatus, {t, s});
+    return s;
+}
+static void r_Clear(GLbitfield m) { rec(GLOp::Clear, {m}); FWD(Clear, (m)); }
+static void r_ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
+    rec(GLOp::ClearColor, {fbits(r), fbits(g), fbits(b), fbits(a)}); FWD(ClearColor, (r, g, b, a));
+}
+static void r_ColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a) {
+    rec(GLOp::ColorMask, {r, g, b, a}); FWD(ColorMask, (r, g, b, a));
+}
+static void r_CompileShader(GLuint s) { rec(GLOp::CompileShader, {s}); FWD(CompileShader, (s)); }
+static GLuint r_CreateProgram() {
+    GLuint p = g_next ? g_next->CreateProgram() : g_nextObject++;
+    rec(GLOp::CreateProgram, {p});
+    return p;
+}
+static GLuint r_CreateShader(GLenum type) {
+    GLuint s = g_next ? g_next->CreateShader(type) : g_nextObject++;
+    rec(GLOp::CreateShader, {type, s});
+    return s;
+}
+static void r_CullFace(GLenum m) { rec(GLOp::CullFace, {m}); FWD(CullFace, (m)); }
+static void r_DeleteBuffers(GLsizei n, const GLuint* ids) {
+    for (GLsizei i = 0; i < n; i++) rec(GLOp::DeleteBuffers, {1, ids[i]});
+    FWD(DeleteBuffers, (n, ids));
+}
+static void r_DeleteFramebuffers(GLsizei n, const GLuint* ids) {
+    for (GLsizei i = 0; i < n; i++) rec(GLOp::DeleteFramebuffers, {1, ids[i]});
+    FWD(DeleteFramebuffers, (n, ids));
+}
+static void r_DeleteProgram(GLuint p) { rec(GLOp::DeleteProgram, {p}); FWD(DeleteProgram, (p)); }
+static void r_DeleteRenderbuffers(GLsizei n, const GLuint* ids) {
+    for (GLsizei i = 0; i < n; i++) rec(GLOp::DeleteRenderbuffers, {1, ids[i]});
+    FWD(DeleteRenderbuffers, (n, ids));
+}
+static void r_DeleteShader(GLuint s) { rec(GLOp::DeleteShader, {s}); FWD(DeleteShader, (s)); }
+static void r_DeleteTextures(GLsizei n, const GLuint* ids) {
+    for (GLsizei i = 0; i < n; i++) rec(GLOp::DeleteTextures, {1, ids[i]});
+    FWD(DeleteTextures, (n, ids));
+}
+static void r_Disable(GLenum c) { rec(GLOp::Disable, {c}); FWD(Disable, (c)); }
+static void r_DisableVertexAttribArray(GLuint i) { rec(GLOp::DisableVertexAttribArray, {i}); FWD(DisableVertexAttribArray, (i)); }
+static void r_DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+    // 客户端索引数组, 或 BufferData 上传过内容的索引缓冲: 算出实际引用的顶点数
+    uint32_t verts = 0;
+    const void* data = g_boundElementBuffer == 0 ? indices : nullptr;
+    if (g_boundElementBuffer != 0) {
+        auto it = g_elementData.find(g_boundElementBuffer);
+        size_t offset = (size_t)(uintptr_t)indices;
+        size_t bytes = (size_t)count * (type == GL_UNSIGNED_SHORT ? 2 : type == GL_UNSIGNED_BYTE ? 1 : 4);
+        if (it != g_elementData.end() && offset + bytes <= it->second.size()) data = it->second.data() + offset;
+    }
+    if (data) {
+        for (GLsizei i = 0; i < count; i++) {
+            uint32_t v = (type == GL_UNSIGNED_SHORT) ? ((const GLushort*)data)[i]
+                       : (type == GL_UNSIGNED_BYTE)  ? ((const GLubyte*)data)[i]
+                       : ((const GLuint*)data)[i];
+            if (v + 1 > verts) verts = v + 1;
+        }
+    }
+    rec(GLOp::DrawElements, {mode, (uint32_t)count, type, verts});
+    FWD(DrawElements, (mode, count, type, indices));
+}
+static void r_Enable(GLenum c) { rec(GLOp::Enable, {c}); FWD(Enable, (c)); }
+static void r_EnableVertexAttribArray(GLuint i) { rec(GLOp::EnableVertexAttribArray, {i}); FWD(EnableVertexAttribArray, (i)); }
+static void r_Finish() { rec(GLOp::Finish, {}); FWD(Finish, ()); }
+static void r_FramebufferTexture2D(GLenum t, GLenum a, GLenum tt, GLuint tex, GLint l) {
+    rec(GLOp::FramebufferTexture2D, {t, a, tt, tex, (uint32_t)l}); FWD(FramebufferTexture2D, (t, a, tt, tex, l));
+}
+static void r_FramebufferRenderbuffer(GLenum t, GLenum a, GLenum rt, GLuint r) {
+    rec(GLOp::FramebufferRenderbuffer, {t, a, rt, r}); FWD(FramebufferRenderbuffer, (t, a, rt, r));
+}
+static void r_FrontFace(GLenum m) { rec(GLOp::FrontFace, {m}); FWD(FrontFace, (m)); }
+static void r_GenBuffers(GLsizei n, GLuint* ids) {
+    if (g_next) g_next->GenBuffers(n, ids);
+    else for (GLsizei i = 0; i < n; i++) ids[i] = g_nextObject++;
+    for (GLsizei i = 0; i < n; i++) rec(GLOp::GenBuffers, {1, ids[i]});
+}
+static void r_GenFramebuffers(GLsizei n, GLuint* ids) {
+    if (g_next) g_next->GenFramebuffers(n, ids);
+    else for (GLsizei i = 0; i < n; i++) ids[i] = g_nextObject++;
+    for (GLsizei i = 0; i < n; i++) rec(GLOp::GenFramebuffers, {1, ids[i]});
+}
+static void r_GenRenderbuffers(GLsizei n, GLuint* ids) {
+    if (g_next) g_next->GenRenderbuffers(n, ids);
+    else for (GLsizei i = 0; i < n; i++) ids[i] = g_nextObject++;
+    for (GLsizei i = 0; i < n; i++) rec(GLOp::GenRenderbuffers, {1, ids[i]});
+}
+static void r_GenTextures(GLsizei n, GLuint* ids) {
+    if (g_next) g_next->GenTextures(n, ids);
+    else for (GLsizei i = 0; i < n; i++) ids[i] = g_nextObject++;
+    for (GLsizei i = 0; i < n; i++) rec(GLOp::GenTextures, {1, ids[i]});
+}
+static void r_GenerateMipmap(GLenum t) { rec(GLOp::GenerateMipmap, {t}); FWD(GenerateMipmap, (t)); }
+static GLint r_GetAttribLocation(GLuint p, const GLchar* name) {
+    GLint loc = g_next ? g_next->GetAttribLocation(p, name) : nullLocation(p, name, g_nextAttrib);
+    rec(GLOp::GetAttribLocation, {p, hashString(name, -1, 2166136261u), (uint32_t)loc});
+    return loc;
+}
+static GLenum r_GetError() {
+    GLenum e = g_next ? g_next->GetError() : (GLenum)GL_NO_ERROR;
+    rec(GLOp::GetError, {e});
+    return e;
+}
+static void r_GetIntegerv(GLenum pname, GLint* data) {
+    if (g_next) g_next->GetIntegerv(pname, data);
+    else if (pname == GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT) *data = 256;
+    else if (pname == GL_STENCIL_BITS) *data = 8;
+    else *data = (pname == GL_NUM_PROGRAM_BINARY_FORMATS_OES) ? 1 : 0;
+    rec(GLOp::GetIntegerv, {pname});
+}
+static void r_GetProgramInfoLog(GLuint p, GLsizei n, GLsizei* len, GLchar* log) {
+    if (g_next) g_next->GetProgramInfoLog(p, n, len, log);
+    else { if (n > 0) log[0] = '\0'; if (len) *len = 0; }
+    rec(GLOp::GetProgramInfoLog, {p});
+}
+static void r_GetProgramiv(GLuint p, GLenum pname, GLint* v) {
+    if (g_next) g_next->GetProgramiv(p, pname, v);
+    else if (pname == GL_PROGRAM_BINARY_LENGTH_OES) *v = (GLint)sizeof(kNullProgramBinary);
+    else *v = (pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) ? GL_TRUE : 0;
+    rec(GLOp::GetProgramiv, {p, pname});
+}
+static void r_GetShaderInfoLog(GLuint s, GLsizei n, GLsizei* len, GLchar* log) {
+    if (g_next) g_next->GetShaderInfoLog(s, n, len, log);
+    else { if (n > 0) log[0] = '\0'; if (len) *len = 0; }
+    rec(GLOp::GetShaderInfoLog, {s});
+}
+static void r_GetShaderiv(GLuint s, GLenum pname, GLint* v) {
+    if (g_next) g_next->GetShaderiv(s, pname, v);
+    else *v = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+    rec(GLOp::GetShaderiv, {s, pname});
+}
+static const GLubyte* r_GetString(GLenum name) {
+    rec(GLOp::GetString, {name});
+    if (g_next) return g_next->GetString(name);
+    if (name == GL_EXTENSIONS) return (const GLubyte*)"GL_OES_get_program_binary";
+    if (name == GL_VERSION && g_nullGlesVersion >= 3) return (const GLubyte*)"OpenGL ES 3.0 L2D GL recorder (null)";
+    return (const GLubyte*)"L2D GL recorder (null)";
+}
+static GLint r_GetUniformLocation(GLuint p, const GLchar* name) {
+    GLint loc = g_next ? g_next->GetUniformLocation(p, name) : nullLocation(p, name, g_nextUniform);
+    rec(GLOp::GetUniformLocation, {p, hashString(name, -1, 2166136261u), (uint32_t)loc});
+    return loc;
+}
+static void r_LinkProgram(GLuint p) { rec(GLOp::LinkProgram, {p}); FWD(LinkProgram, (p)); }
+static void r_ReadPixels(GLint x, GLint y, GLsizei w, GLsizei h, GLenum fmt, GLenum type, void* px) {
+    rec(GLOp::ReadPixels, {(uint32_t)x, (uint32_t)y, (uint32_t)w, (uint32_t)h, fmt, type, (uint32_t)(uintptr_t)px});
+    if (g_next) g_next->ReadPixels(x, y, w, h, fmt, type, px);
+    else if (!g_boundPackBuffer && fmt == GL_RGBA && type == GL_UNSIGNED_BYTE) memset(px, 0, (size_t)w * h * 4);
+}
+static void r_RenderbufferStorage(GLenum t, GLenum fmt, GLsizei w, GLsizei h) {
+    rec(GLOp::RenderbufferStorage, {t, fmt, (uint32_t)w, (uint32_t)h}); FWD(RenderbufferStorage, (t, fmt, w, h));
+}
+static void r_Scissor(GLint x, GLint y, GLsizei w, GLsizei h) {
+    rec(GLOp::Scissor, {(uint32_t)x, (uint32_t)y, (uint32_t)w, (uint32_t)h}); FWD(Scissor, (x, y, w, h));
+}
+static void r_ShaderSource(GLuint s, GLsizei count, const GLchar* const* str, const GLint* len) {
+    uint32_t h = 2166136261u;
+    for (GLsizei i = 0; i < count; i++) h = hashString(str[i], len ? len[i] : -1, h);
+    rec(GLOp::ShaderSource, {s, h});
+    FWD(ShaderSource, (s, count, str, len));
+}
+static void r_StencilFunc(GLenum f, GLint ref, GLuint mask) {
+    rec(GLOp::StencilFunc, {f, (uint32_t)ref, mask}); FWD(StencilFunc, (f, ref, mask));
+}
+static void r_StencilOp(GLenum a, GLenum b, GLenum c) { rec(GLOp::StencilOp, {a, b, c}); FWD(StencilOp, (a, b, c)); }
+static void r_TexImage2D(GLenum t, GLint l, GLint ifmt, GLsizei w, GLsizei h, GLint b, GLenum fmt, GLenum type, const void* px) {
+    rec(GLOp::TexImage2D, {t, (uint32_t)l, (uint32_t)ifmt, (uint32_t)w, (uint32_t)h, fmt, type, px ? 1u : 0u});
+    FWD(TexImage2D, (t, l, ifmt, w, h, b, fmt, type, px));
+}
+static void r_TexParameteri(GLenum t, GLenum p, GLint v) { rec(GLOp::TexParameteri, {t, p, (uint32_t)v}); FWD(TexParameteri, (t, p, v)); }
+static void r_Uniform1f(GLint l, GLfloat a) { rec(GLOp::Uniform1f, {(uint32_t)l, fbits(a)}); FWD(Uniform1f, (l, a)); }
+static void r_Uniform1i(GLint l, GLint a) { rec(GLOp::Uniform1i, {(uint32_t)l, (uint32_t)a}); FWD(Uniform1i, (l, a)); }
+static void r_Uniform2f(GLint l, GLfloat a, GLfloat b) { rec(GLOp::Uniform2f, {(uint32_t)l, fbits(a), fbits(b)}); FWD(Uniform2f, (l, a, b)); }
+static void r_Uniform4f(GLint l, GLfloat a, GLfloat b, GLfloat c, GLfloat d) {
+    rec(GLOp::Uniform4f, {(uint32_t)l, fbits(a), fbits(b), fbits(c), fbits(d)}); FWD(Uniform4f, (l, a, b, c, d));
+}
+static void r_UniformMatrix4fv(GLint l, GLsizei count, GLboolean tr, const GLfloat* v) {
+    beginRecord((uint8_t)GLOp::UniformMatrix4fv, 3 + 16 * (size_t)count);
+    putWord((uint32_t)l); putWord((uint32_t)count); putWord(tr);
+    for (GLsizei i = 0; i < 16 * count; i++) putWord(fbits(v[i]));
+    FWD(UniformMatrix4fv, (l, count, tr, v));
+}
+static void r_UseProgram(GLuint p) { rec(GLOp::UseProgram, {p}); FWD(UseProgram, (p)); }
+static void r_VertexAttribPointer(GLuint i, GLint sz, GLenum type, GLboolean n, GLsizei stride, const void* ptr) {
+    rec(GLOp::VertexAttribPointer, {i, (uint32_t)sz, type, n, (uint32_t)stride});
+    FWD(VertexAttribPointer, (i, sz, type, n, stride, ptr));
+}
+static void r_Viewport(GLint x, GLint y, GLsizei w, GLsizei h) {
+    rec(GLOp::Viewport, {(uint32_t)x, (uint32_t)y, (uint32_t)w, (uint32_t)h}); FWD(Viewport, (x, y, w, h));
+}
+static void r_GetProgramBinary(GLuint p, GLsizei n, GLsizei* len, GLenum* fmt, void* bin) {
+    if (g_next) g_next->GetProgramBinary(p, n, len, fmt, bin);
+    else {
+        GLsizei size = n < (GLsizei)sizeof(kNullProgramBinary) ? 0 : (GLsizei)sizeof(kNullProgramBinary);
+        if (size) memcpy(bin, kNullProgramBinary, size);
+        if (len) *len = size;
+        *fmt = kNullProgramBinaryFormat;
+    }
+    rec(GLOp::GetProgramBinary, {p});
+}
+static void r_ProgramBinary(GLuint p, GLenum fmt, const void* bin, GLint len) {
+    rec(GLOp::ProgramBinary, {p, fmt, (uint32_t)len, hashString((const char*)bin, len, 2166136261u)});
+    FWD(ProgramBinary, (p, fmt, bin, len));
+}
+static void r_BindVertexArray(GLuint a) {
+    g_boundVertexArray = a;
+    auto it = g_vertexArrayElementBuffer.find(a);
+    g_boundElementBuffer = it != g_vertexArrayElementBuffer.end() ? it->second : 0;
+    rec(GLOp::BindVertexArray, {a}); FWD(BindVertexArray, (a));
+}
+static void r_DeleteVertexArrays(GLsizei n, const GLuint* ids) {
+    for (GLsizei i = 0; i < n; i++) rec(GLOp::DeleteVertexArrays, {1, ids[i]});
+    FWD(DeleteVertexArrays, (n, ids));
+}
+static void r_GenVertexArrays(GLsizei n, GLuint* ids) {
+    if (g_next) g_next->GenVertexArrays(n, ids);
+    else for (GLsizei i = 0; i < n; i++) ids[i] = g_nextObject++;
+    for (GLsizei i = 0; i < n; i++) rec(GLOp::GenVertexArrays, {1, ids[i]});
+}
+static void* r_MapBufferRange(GLenum t, GLintptr off, GLsizeiptr len, GLbitfield access) {
+    rec(GLOp::MapBufferRange, {t, (uint32_t)off, (uint32_t)len, access});
+    if (g_next) return g_next->MapBufferRange(t, off, len, access);
+    if (g_mapScratch.size() < (size_t)len) g_mapScratch.resize((size_t)len);
+    return g_mapScratch.data();
+}
+static GLboolean r_UnmapBuffer(GLenum t) {
+    rec(GLOp::UnmapBuffer, {t});
+    return g_next ? g_next->UnmapBuffer(t) : (GLboolean)GL_TRUE;
+}
+static void r_BindBufferRange(GLenum t, GLuint index, GLuint b, GLintptr off, GLsizeiptr size) {
+    rec(GLOp::BindBufferRange, {t, index, b, (uint32_t)off, (uint32_t)size}); FWD(BindBufferRange, (t, index, b, off, size));
+}
+static GLuint r_GetUniformBlockIndex(GLuint p, const GLchar* name) {
+    GLuint idx = g_next ? g_next->GetUniformBlockIndex(p, name) : (GLuint)nullLocation(p, name, g_nextBlock);
+    rec(GLOp::GetUniformBlockIndex, {p, hashString(name, -1, 2166136261u), idx});
+    return idx;
+}
+static void r_UniformBlockBinding(GLuint p, GLuint idx, GLuint binding) {
+    rec(GLOp::UniformBlockBinding, {p, idx, binding}); FWD(UniformBlockBinding, (p, idx, binding));
+}
+static void r_InvalidateFramebuffer(GLenum t, GLsizei n, const GLenum* att) {
+    beginRecord((uint8_t)GLOp::InvalidateFramebuffer, 2 + (size_t)n);
+    putWord(t); putWord((uint32_t)n);
+    for (GLsizei i = 0; i < n; i++) putWord(att[i]);
+    FWD(InvalidateFramebuffer, (t, n, att));
+}
+
+// 空后端的 fence 立即完成; 日志里 GLsync 记为低 32 位
+static GLsync r_FenceSync(GLenum cond, GLbitfield flags) {
+    GLsync sync = g_next ? g_next->FenceSync(cond, flags) : (GLsync)(uintptr_t)g_nextObject++;
+    rec(GLOp::FenceSync, {cond, flags, (uint32_t)(uintptr_t)sync});
+    return sync;
+}
+static GLenum r_ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+    GLenum r = g_next ? g_next->ClientWaitSync(sync, flags, timeout) : (GLenum)GL_ALREADY_SIGNALED;
+    rec(GLOp::ClientWaitSync, {(uint32_t)(uintptr_t)sync, flags, (uint32_t)timeout, r});
+    return r;
+}
+static void r_DeleteSync(GLsync sync) { rec(GLOp::DeleteSync, {(uint32_t)(uintptr_t)sync}); FWD(DeleteSync, (sync)); }
+
+#undef FWD
+
+static const GLDispatch kRecorderGL = {
+#define L2D_GL_RECORDER(ret, name, params, args) r_##name,
+    L2D_GL_ALL_FUNCTIONS(L2D_GL_RECORDER)
+#undef L2D_GL_RECORDER
+};
+
+// ===================== Public API =====================
+
+static void resetRecorder(const GLDispatch* forward, bool logging, int nullGlesVersion) {
+    g_next = forward;
+    g_logging = logging;
+    g_nullGlesVersion = nullGlesVersion;
+    g_log.clear();
+    g_log.shrink_to_fit();
+    g_nextObject = 1;
+    g_boundElementBuffer = 0;
+    g_boundVertexArray = 0;
+    g_boundPackBuffer = 0;
+    g_vertexArrayElementBuffer.clear();
+    g_elementData.clear();
+    g_locations.clear();
+    g_nextAttrib.clear();
+    g_nextUniform.clear();
+    g_nextBlock.clear();
+}
+
+const GLDispatch* startGLRecording(const GLDispatch* forward, int nullGlesVersion) {
+    resetRecorder(forward, true, nullGlesVersion);
+    g_log.insert(g_log.end(), "L2DGLLOG", "L2DGLLOG" + 8);
+    putWord(kGLTraceVersion);
+    putWord((uint32_t)GLOp::Count);
+    return &kRecorderGL;
+}
+
+const GLDispatch* nullGLDispatch(int glesVersion) {
+    resetRecorder(nullptr, false, glesVersion);
+    return &kRecorderGL;
+}
+
+void markGLFrame() { beginRecord(kGLTraceFrameMarker, 0); }
+
+const std::vector<uint8_t>& glRecording() { return g_log; }
+
+bool saveGLRecording(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(g_log.data(), 1, g_log.size(), f) == g_log.size();
+    return fclose(f) == 0 && ok;
+}
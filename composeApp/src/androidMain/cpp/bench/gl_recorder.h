@@ -0,0 +1,30 @@
+#pragma once
+
+// Recording GL backend. Every call made through the returned dispatch table is
+// appended to a compact binary log (see gl_trace.h for the format) and then
+// either forwarded to another table (e.g. the native one, to render and record
+// at the same time) or answered by a null implementation that synthesizes
+// object ids, successful compile/link/framebuffer status and a dummy program
+// binary format, so the renderer can run without any GL context at all.
+
+#include "live2d_gl.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Reset the log and return the recording table. forward == nullptr selects the
+ * null backend, which then reports GL_VERSION for nullGlesVersion (2 or 3).
+ */
+const GLDispatch* startGLRecording(const GLDispatch* forward, int nullGlesVersion = 2);
+
+/** Null backend without the log: no per-call work beyond the synthesized answers, no allocation. */
+const GLDispatch* nullGLDispatch(int glesVersion = 2);
+
+/** Append a frame boundary. Commands before the first marker belong to frame 0 (setup). */
+void markGLFrame();
+
+const std::vector<uint8_t>& glRecording();
+
+bool saveGLRecording(const std::string& path);
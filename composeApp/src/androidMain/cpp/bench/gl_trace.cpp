@@ -0,0 +1,279 @@
+#include "gl_trace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <utility>
+
+static const char* const kOpNames[] = {
+#define L2D_GL_NAME(ret, name, params, args) #name,
+    L2D_GL_ALL_FUNCTIONS(L2D_GL_NAME)
+#undef L2D_GL_NAME
+};
+
+const char* glOpName(GLOp op) {
+    return (op < GLOp::Count) ? kOpNames[(int)op] : "?";
+}
+
+GLTraceCounts& GLTraceCounts::operator+=(const GLTraceCounts& o) {
+    calls += o.calls; draws += o.draws; indices += o.indices; vertices += o.vertices;
+    stateChanges += o.stateChanges; redundantState += o.redundantState;
+    uniformWrites += o.uniformWrites; redundantUniforms += o.redundantUniforms;
+    programBinds += o.programBinds; textureBinds += o.textureBinds; framebufferBinds += o.framebufferBinds;
+    clears += o.clears; queries += o.queries;
+    return *this;
+}
+
+// ===================== Parsing =====================
+
+// Words the analysis reads for each op; shorter records are rejected as corrupt.
+static size_t minWords(GLOp op) {
+    switch (op) {
+        case GLOp::DrawElements:
+        case GLOp::BlendFuncSeparate:
+        case GLOp::ClearColor:
+        case GLOp::ColorMask:
+        case GLOp::Scissor:
+        case GLOp::Viewport:            return 4;
+        case GLOp::BindBufferRange:     return 5;
+        case GLOp::StencilFunc:
+        case GLOp::StencilOp:
+        case GLOp::UniformMatrix4fv:    return 3;
+        case GLOp::BindTexture:
+        case GLOp::BindFramebuffer:
+        case GLOp::BindBuffer:
+        case GLOp::Uniform1f:
+        case GLOp::Uniform1i:           return 2;
+        case GLOp::Uniform2f:           return 3;
+        case GLOp::Uniform4f:           return 5;
+        case GLOp::Enable:
+        case GLOp::Disable:
+        case GLOp::BindVertexArray:
+        case GLOp::EnableVertexAttribArray:
+        case GLOp::DisableVertexAttribArray:
+        case GLOp::ActiveTexture:
+        case GLOp::UseProgram:
+        case GLOp::LinkProgram:
+        case GLOp::CullFace:
+        case GLOp::FrontFace:           return 1;
+        default:                        return 0;
+    }
+}
+
+static uint32_t readWord(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+bool parseGLTrace(const std::vector<uint8_t>& data, GLTrace& out, std::string* error) {
+    auto fail = [&](const char* msg) { if (error) *error = msg; return false; };
+    out.frames.assign(1, {});
+    if (data.size() < 16 || memcmp(data.data(), "L2DGLLOG", 8) != 0) return fail("not a GL trace");
+    if (readWord(&data[8]) != kGLTraceVersion) return fail("unsupported trace version");
+    if (readWord(&data[12]) != (uint32_t)GLOp::Count) return fail("trace written by a build with a different GL op table");
+
+    size_t p = 16;
+    while (p < data.size()) {
+        if (p + 3 > data.size()) return fail("truncated record header");
+        uint8_t op = data[p];
+        size_t n = data[p + 1] | ((size_t)data[p + 2] << 8);
+        p += 3;
+        if (p + n * 4 > data.size()) return fail("truncated record");
+        if (op == kGLTraceFrameMarker) { out.frames.emplace_back(); continue; }
+        if (op >= (uint8_t)GLOp::Count) return fail("unknown op");
+        if (n < minWords((GLOp)op)) return fail("record too short for its op");
+        GLCmd cmd;
+        cmd.op = (GLOp)op;
+        cmd.words.resize(n);
+        for (size_t i = 0; i < n; i++) cmd.words[i] = readWord(&data[p + i * 4]);
+        p += n * 4;
+        out.frames.back().push_back(std::move(cmd));
+    }
+    return true;
+}
+
+bool loadGLTrace(const std::string& path, GLTrace& out, std::string* error) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) { if (error) *error = "cannot open " + path; return false; }
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return parseGLTrace(data, out, error);
+}
+
+// ===================== Analysis =====================
+
+namespace {
+
+// Shadow of the GL state that the renderer touches. Keys are (op-specific) ids,
+// values are the argument words last written.
+struct Shadow {
+    std::map<uint64_t, std::vector<uint32_t>> state;
+    std::map<std::pair<uint32_t, uint32_t>, std::vector<uint32_t>> uniforms;  // (program, location)
+    uint32_t program = 0;
+    uint32_t activeTexture = GL_TEXTURE0;
+    uint32_t vertexArray = 0;
+
+    // Returns true if the write is redundant, and records it otherwise.
+    bool set(uint64_t key, const std::vector<uint32_t>& v) {
+        auto it = state.find(key);
+        if (it != state.end() && it->second == v) return true;
+        state[key] = v;
+        return false;
+    }
+};
+
+uint64_t key(GLOp op, uint32_t sub = 0) { return ((uint64_t)op << 32) | sub; }
+
+}
+
+std::vector<GLTraceCounts> analyzeGLTrace(const GLTrace& trace) {
+    std::vector<GLTraceCounts> result;
+    Shadow sh;
+    for (const auto& frame : trace.frames) {
+        GLTraceCounts c;
+        for (const auto& cmd : frame) {
+            const auto& w = cmd.words;
+            c.calls++;
+            bool redundant = false;
+            bool isState = true;
+            switch (cmd.op) {
+                case GLOp::DrawElements:
+                    isState = false;
+                    c.draws++;
+                    c.indices += w[1];
+                    c.vertices += w[3];
+                    break;
+                case GLOp::Enable:
+                case GLOp::Disable:
+                    redundant = sh.set(key(GLOp::Enable, w[0]), {cmd.op == GLOp::Enable ? 1u : 0u});
+                    break;
+                case GLOp::EnableVertexAttribArray:
+                case GLOp::DisableVertexAttribArray:
+                    // 属性开关属于当前 VAO
+                    redundant = sh.set(key(GLOp::EnableVertexAttribArray, sh.vertexArray * 65536u + (w[0] & 0xFFFF)),
+                                       {cmd.op == GLOp::EnableVertexAttribArray ? 1u : 0u});
+                    break;
+                case GLOp::BindVertexArray:
+                    redundant = (sh.vertexArray == w[0]);
+                    sh.vertexArray = w[0];
+                    break;
+                case GLOp::BindBufferRange:
+                    redundant = sh.set(key(cmd.op, w[0] * 65536u + (w[1] & 0xFFFF)), {w[2], w[3], w[4]});
+                    break;
+                case GLOp::ActiveTexture:
+                    redundant = (sh.activeTexture == w[0]);
+                    sh.activeTexture = w[0];
+                    break;
+                case GLOp::BindTexture:
+                    c.textureBinds++;
+                    redundant = sh.set(key(GLOp::BindTexture, sh.activeTexture * 65536u + (w[0] & 0xFFFF)), {w[1]});
+                    break;
+                case GLOp::BindFramebuffer:
+                    c.framebufferBinds++;
+                    redundant = sh.set(key(cmd.op, w[0]), {w[1]});
+                    break;
+                case GLOp::BindBuffer:
+                    // 索引缓冲绑定同样属于当前 VAO
+                    redundant = sh.set(key(cmd.op, w[0] == GL_ELEMENT_ARRAY_BUFFER ? sh.vertexArray << 16 | (w[0] & 0xFFFF) : w[0]),
+                                       {w[1]});
+                    break;
+                case GLOp::UseProgram:
+                    c.programBinds++;
+                    redundant = (sh.program == w[0]);
+                    sh.program = w[0];
+                    break;
+                case GLOp::BlendFuncSeparate:
+                case GLOp::ClearColor:
+                case GLOp::ColorMask:
+                case GLOp::CullFace:
+                case GLOp::FrontFace:
+                case GLOp::Scissor:
+                case GLOp::StencilFunc:
+                case GLOp::StencilOp:
+                case GLOp::Viewport:
+                    redundant = sh.set(key(cmd.op), w);
+                    break;
+                case GLOp::VertexAttribPointer:
+                    // 指针不记录, 每次都视为有效修改
+                    break;
+                case GLOp::Uniform1f:
+                case GLOp::Uniform1i:
+                case GLOp::Uniform2f:
+                case GLOp::Uniform4f:
+                case GLOp::UniformMatrix4fv: {
+                    isState = false;
+                    c.uniformWrites++;
+                    auto k = std::make_pair(sh.program, w[0]);
+                    std::vector<uint32_t> v(w.begin() + 1, w.end());
+                    auto it = sh.uniforms.find(k);
+                    if (it != sh.uniforms.end() && it->second == v) c.redundantUniforms++;
+                    else sh.uniforms[k] = std::move(v);
+                    break;
+                }
+                case GLOp::LinkProgram:
+                    // 重新链接会重置该程序的 uniform
+                    for (auto it = sh.uniforms.begin(); it != sh.uniforms.end();)
+                        it = (it->first.first == w[0]) ? sh.uniforms.erase(it) : std::next(it);
+                    isState = false;
+                    break;
+                case GLOp::Clear:
+                    isState = false;
+                    c.clears++;
+                    break;
+                case GLOp::CheckFramebufferStatus:
+                case GLOp::GetAttribLocation:
+                case GLOp::GetError:
+                case GLOp::GetIntegerv:
+                case GLOp::GetProgramInfoLog:
+                case GLOp::GetProgramiv:
+                case GLOp::GetShaderInfoLog:
+                case GLOp::GetShaderiv:
+                case GLOp::GetString:
+                case GLOp::GetUniformLocation:
+                case GLOp::GetUniformBlockIndex:
+                    isState = false;
+                    c.queries++;
+                    break;
+                default:
+                    isState = false;
+                    break;
+            }
+            if (isState) {
+                c.stateChanges++;
+                if (redundant) c.redundantState++;
+            }
+        }
+        result.push_back(c);
+    }
+    return result;
+}
+
+std::string formatGLCmd(const GLCmd& cmd) {
+    std::string s = glOpName(cmd.op);
+    bool floats = false;
+    size_t firstFloat = 0;
+    switch (cmd.op) {
+        case GLOp::ClearColor: floats = true; break;
+        case GLOp::Uniform1f: case GLOp::Uniform2f: case GLOp::Uniform4f: floats = true; firstFloat = 1; break;
+        case GLOp::UniformMatrix4fv: floats = true; firstFloat = 3; break;
+        default: break;
+    }
+    char buf[64];
+    if (cmd.op == GLOp::DrawElements) {
+        snprintf(buf, sizeof(buf), "(0x%x, %u, 0x%x) verts=%u", cmd.words[0], cmd.words[1], cmd.words[2], cmd.words[3]);
+        return s + buf;
+    }
+    s += "(";
+    for (size_t i = 0; i < cmd.words.size(); i++) {
+        uint32_t w = cmd.words[i];
+        if (floats && i >= firstFloat) { float f; memcpy(&f, &w, 4); snprintf(buf, sizeof(buf), "%g", f); }
+        else if (w >= 0x100 && w != 0xFFFFFFFFu) snprintf(buf, sizeof(buf), "0x%x", w);
+        else snprintf(buf, sizeof(buf), "%d", (int)w);
+        if (i) s += ", ";
+        s += buf;
+    }
+    s += ")";
+    return s;
+}
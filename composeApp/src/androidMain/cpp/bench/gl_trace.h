@@ -0,0 +1,59 @@
+#pragma once
+
+// Reader and analysis for GL command logs written by gl_recorder.
+//
+// Log format (little endian):
+//   header  "L2DGLLOG" u32 version u32 opCount   (opCount = GLOp::Count of the writer)
+//   record  u8 op, u16 wordCount, wordCount x u32
+// op 0xFF with no words is a frame marker. Pointers are never recorded; draws
+// carry the index count and the vertex count derived from the client indices.
+
+#include "live2d_gl.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+static const uint32_t kGLTraceVersion = 1;
+static const uint8_t  kGLTraceFrameMarker = 0xFF;
+
+struct GLCmd {
+    GLOp op;
+    std::vector<uint32_t> words;
+};
+
+struct GLTrace {
+    std::vector<std::vector<GLCmd>> frames;  // frames[0] = commands before the first marker
+};
+
+struct GLTraceCounts {
+    long calls = 0;
+    long draws = 0;
+    long indices = 0;
+    long vertices = 0;
+    long stateChanges = 0;       // binds, enables, blend/cull/viewport/mask state, attribute setup
+    long redundantState = 0;     // state calls that set the value already current
+    long uniformWrites = 0;
+    long redundantUniforms = 0;  // same value written to the same (program, location)
+    long programBinds = 0;
+    long textureBinds = 0;
+    long framebufferBinds = 0;
+    long clears = 0;
+    long queries = 0;            // glGet* / glCheckFramebufferStatus (potential pipeline stalls)
+
+    GLTraceCounts& operator+=(const GLTraceCounts& o);
+};
+
+bool parseGLTrace(const std::vector<uint8_t>& data, GLTrace& out, std::string* error = nullptr);
+bool loadGLTrace(const std::string& path, GLTrace& out, std::string* error = nullptr);
+
+/**
+ * Per-frame counts. Redundancy is tracked with shadow state that carries over
+ * between frames, so a frame that re-sets state left by the previous one counts it.
+ */
+std::vector<GLTraceCounts> analyzeGLTrace(const GLTrace& trace);
+
+const char* glOpName(GLOp op);
+
+/** One command as text, e.g. "DrawElements(0x4, 96, 0x1403) verts=32". */
+std::string formatGLCmd(const GLCmd& cmd);
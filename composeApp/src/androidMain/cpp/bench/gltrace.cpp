@@ -0,0 +1,104 @@
+// Inspect and compare GL command logs written by the recording backend.
+//
+//   live2d_gltrace stats <log>            per-frame and total call accounting
+//   live2d_gltrace dump <log> [frame]     print commands (all frames or one)
+//   live2d_gltrace diff <a> <b>           compare two logs frame by frame;
+//                                         exit status 1 if the streams differ
+
+#include "gl_trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static void printCountsHeader() {
+    printf("%-8s %7s %6s %8s %8s %7s %9s %8s %10s %6s %6s %6s %6s\n",
+           "frame", "calls", "draws", "indices", "verts", "state", "redundant",
+           "uniforms", "redundantU", "progs", "tex", "fbo", "query");
+}
+
+static void printCounts(const char* label, const GLTraceCounts& c) {
+    printf("%-8s %7ld %6ld %8ld %8ld %7ld %9ld %8ld %10ld %6ld %6ld %6ld %6ld\n",
+           label, c.calls, c.draws, c.indices, c.vertices, c.stateChanges, c.redundantState,
+           c.uniformWrites, c.redundantUniforms, c.programBinds, c.textureBinds, c.framebufferBinds, c.queries);
+}
+
+static bool load(const char* path, GLTrace& t) {
+    std::string err;
+    if (!loadGLTrace(path, t, &err)) { fprintf(stderr, "%s: %s\n", path, err.c_str()); return false; }
+    return true;
+}
+
+static int cmdStats(const char* path) {
+    GLTrace t;
+    if (!load(path, t)) return 2;
+    auto counts = analyzeGLTrace(t);
+    GLTraceCounts total;
+    printCountsHeader();
+    for (size_t i = 0; i < counts.size(); i++) {
+        char label[16];
+        snprintf(label, sizeof(label), i == 0 ? "setup" : "%zu", i);
+        printCounts(label, counts[i]);
+        if (i > 0) total += counts[i];
+    }
+    printCounts("frames", total);
+    return 0;
+}
+
+static int cmdDump(const char* path, int only) {
+    GLTrace t;
+    if (!load(path, t)) return 2;
+    for (size_t f = 0; f < t.frames.size(); f++) {
+        if (only >= 0 && (int)f != only) continue;
+        printf("--- frame %zu (%zu commands)\n", f, t.frames[f].size());
+        for (const auto& c : t.frames[f]) printf("  %s\n", formatGLCmd(c).c_str());
+    }
+    return 0;
+}
+
+static int cmdDiff(const char* pathA, const char* pathB) {
+    GLTrace a, b;
+    if (!load(pathA, a) || !load(pathB, b)) return 2;
+    auto ca = analyzeGLTrace(a), cb = analyzeGLTrace(b);
+    bool differ = a.frames.size() != b.frames.size();
+    if (differ) printf("frame count: %zu vs %zu\n", a.frames.size(), b.frames.size());
+
+    size_t n = std::min(a.frames.size(), b.frames.size());
+    bool reportedFirst = false;
+    int differingFrames = 0;
+    for (size_t f = 0; f < n; f++) {
+        const auto& fa = a.frames[f];
+        const auto& fb = b.frames[f];
+        size_t m = std::min(fa.size(), fb.size()), i = 0;
+        while (i < m && fa[i].op == fb[i].op && fa[i].words == fb[i].words) i++;
+        if (i == m && fa.size() == fb.size()) continue;
+        differ = true;
+        differingFrames++;
+        if (!reportedFirst) {
+            reportedFirst = true;
+            printf("first difference: frame %zu, command %zu\n", f, i);
+            printf("  a: %s\n", i < fa.size() ? formatGLCmd(fa[i]).c_str() : "<end>");
+            printf("  b: %s\n", i < fb.size() ? formatGLCmd(fb[i]).c_str() : "<end>");
+        }
+    }
+    if (!differ) { printf("identical (%zu frames)\n", a.frames.size()); return 0; }
+
+    GLTraceCounts ta, tb;
+    for (size_t i = 1; i < ca.size(); i++) ta += ca[i];
+    for (size_t i = 1; i < cb.size(); i++) tb += cb[i];
+    printf("%d differing frames\n", differingFrames);
+    printCountsHeader();
+    printCounts("a", ta);
+    printCounts("b", tb);
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && !strcmp(argv[1], "stats")) return cmdStats(argv[2]);
+    if (argc >= 3 && !strcmp(argv[1], "dump")) return cmdDump(argv[2], argc >= 4 ? atoi(argv[3]) : -1);
+    if (argc >= 4 && !strcmp(argv[1], "diff")) return cmdDiff(argv[2], argv[3]);
+    fprintf(stderr, "usage: live2d_gltrace stats <log> | dump <log> [frame] | diff <a> <b>\n");
+    return 2;
+}
@@ -0,0 +1,1002 @@
+// Headless frame-time benchmark for the Live2D native renderer.
+//
+// Loads a model3.json from disk, drives drawFrame() for N frames with a fixed
+// time step and scripted inputs, and prints per-stage percentiles, heap
+// allocation counts, draw-call counts and the final memoryStats() as JSON.
+//
+// GL runs on an EGL pbuffer; on Linux the Mesa surfaceless platform is used
+// when available, so no display server is needed (llvmpipe software GL).
+// "--gl null" runs without any context on the null backend of the recorder.
+// "--backend vulkan" renders with the Vulkan backend instead (live2d_vulkan.h,
+// built with -DLIVE2D_VULKAN=ON) into an offscreen image, e.g. on lavapipe or
+// SwiftShader; the run fails (exit 1) when no Vulkan device is found.
+//
+// Usage:
+//   live2d_bench <model3.json> [--frames N] [--warmup N] [--size WxH]
+//                [--dt SECONDS] [--script FILE] [--finish] [--out FILE]
+//                [--gl egl|null] [--backend gles|vulkan] [--record GLLOG]
+//                [--record-calls TRACE] [--replay TRACE [--asset-root DIR]]
+//                [--max-allocs N] [--metadata FILE] [--lod-async] [--eager-textures]
+//                [--drs BUDGET_MS] [--flipbook FRAMES [--flipbook-scale S]]
+//                [--shader-cache DIR] [--gles 2|3] [--clip auto|mask|stencil]
+//                [--dump-frame PAM] [--diff-frame PAM [--diff-tolerance T] [--max-diff-pixels N]]
+//                [--frame-source gl|cpu|snapshot [--raster-threads N]] [--thumbnail WxH PAM]
+//                [--snapshot-every N] [--snapshot-size WxH] [--snapshot-background AARRGGBB]
+//                [--render-thread HZ [--frame-interval N] [--surface-cycle N]]
+//
+// With --record the GL command stream is captured, its call accounting is
+// added to the JSON, and the log can be inspected or diffed with
+// live2d_gltrace.
+//
+// --max-allocs N fails the run (exit 3) when any measured frame performs more
+// than N heap allocations; "--gl null --max-allocs 0" checks that the
+// steady-state frame is allocation-free.
+//
+// --metadata writes the model information blob (modelMetadata()) after load.
+//
+// Texture LOD changes are decoded synchronously inside drawFrame by default so
+// runs are reproducible; --lod-async uses the worker thread as on device.
+// Textures not used in the default pose are uploaded on first use and released
+// after 30 s unused (residentTextures); --eager-textures loads them all up front.
+//
+// --drs enables dynamic resolution with the given frame budget. The controller
+// reads the fixed --dt, so a budget below it drives the scale down step by step.
+//
+// --flipbook enables the low-power idle mode: once the inputs have been still
+// for an idle loop, the loop is baked into an atlas of FRAMES cells (at
+// --flipbook-scale of the model's window size, default 0.5) and played back.
+// The host inputs keep changing every frame, so use "inputs off" in a script.
+//
+// --shader-cache keeps linked program binaries in DIR (setShaderCacheDir); the
+// load section reports shaderMs and how many programs were cached / compiled, so
+// running twice shows the warm-start cost.
+//
+// --gles 3 creates an OpenGL ES 3.0 context (or makes the null backend report
+// 3.0) and lets the renderer take its GLES3 path (per-drawable VAOs, mapped
+// vertex streaming, uniform buffers); the default 2 keeps the client-array path
+// even where the driver hands out a 3.x context anyway (Mesa does).
+// "gles" in the JSON is the path the renderer actually chose.
+//
+// With "--backend vulkan" no GL context is created (the null GL dispatch stays
+// installed for the GL calls outside the renderer), "renderer" is the Vulkan
+// device and "backend" says "vulkan". The last frame (--dump-frame /
+// --diff-frame) is read back from the offscreen image, so it can be diffed
+// against a GL or CPU reference; programSwitches counts pipeline binds.
+// Dynamic resolution, the idle flipbook and stencil clipping are GLES-only and
+// ignored. --record and --replay need GL.
+//
+// --clip selects how clipping masks are applied (setClipMode); the EGL surface
+// always has an 8-bit stencil buffer. "clip" in the JSON is the path the last
+// frame took ("auto" picks stencil only on tile-based GPUs, so mask on Mesa).
+//
+// --dump-frame writes the last frame as a PAM image (RGB_ALPHA, top row first);
+// --diff-frame compares the last frame with such a reference and reports the
+// pixels whose channels differ by more than --diff-tolerance (default 0) as
+// "frameDiff". More than --max-diff-pixels (default 0) fails the run (exit 4),
+// so two render paths can be checked against each other image by image.
+// Both need a real context (--gl egl), unless "--frame-source cpu" takes the
+// last frame from the CPU rasterizer (rasterizeFrame) instead of glReadPixels:
+// then the null backend is enough, and the CPU image can be diffed against a
+// frame dumped from GL. --raster-threads limits its worker threads.
+//
+// --thumbnail renders renderModelThumbnail(<model3.json>) into a PAM image on a
+// second thread while the frames are drawn, the way the model picker uses it
+// (its allocations then count against the frames, so leave --max-allocs off).
+//
+// --snapshot-every N calls requestSnapshot() on every Nth measured frame, at
+// --snapshot-size (default: surface size) over --snapshot-background (hex
+// 0xAARRGGBB, default transparent), and pollSnapshot() after every frame, as the
+// host does. "snapshots" reports how many frames and milliseconds each took to
+// come back; timeMs "snapshot" / "readback" is the time the render thread spent
+// drawing them and getting the pixels back, so a readback that stalls shows there.
+// "--frame-source snapshot" requests one more before the last frame and uses it
+// as the last frame image (--dump-frame / --diff-frame), drawing extra frames
+// with dt 0 until it arrives; it works on the null backend too (all zero there).
+//
+// Script lines ("#" starts a comment), applied before rendering <frame>:
+//   <frame> motion <group> <index> [priority]
+//   <frame> expression <name>            (use "-" to clear)
+//   <frame> param <id> <value> [weight]
+//   <frame> transform <scale> <offsetX> <offsetY>
+//   <frame> inputs on|off                (per-frame host inputs, on by default)
+//   <frame> trim <level>                 (trimMemory: 1 caches, 2 textures, 3 critical)
+// Without --script, only the per-frame host inputs (lip sync + gaze, as in
+// Live2DManager.onFrameUpdate) are generated.
+//
+// --render-thread runs the frames on the native render thread (live2d_thread.h)
+// as the app does: it owns the context, renders on a HZ timer standing in for
+// the display vsync (every --frame-interval vsyncs) with the dt between vsyncs,
+// and the main thread only posts script events as tasks and sets the lip sync /
+// gaze inputs, which the thread smooths and applies itself. --surface-cycle N
+// releases and re-sets the window every N frames, like the app going to the
+// background, which must neither reload the model nor recreate the context.
+// "frame" / "finish" are then drawFrame / eglSwapBuffers on that thread,
+// "vsyncLate" how late each frame started after its vsync and "interval" the
+// dt it got; "thread" counts the host calls per frame, tasks, skipped vsyncs,
+// contexts, windows and model loads. Load includes creating the context.
+// Script events land a frame or two later than in the direct loop, so images
+// and --max-allocs are not comparable with it; --replay and --snapshot-* need
+// the direct loop.
+//
+// --replay drives the renderer from a call trace (live2d_calltrace.h) instead:
+// every recorded call is re-issued in order and each recorded frame is drawn
+// with its recorded dt, so a device session is reproduced frame for frame.
+// Asset paths in the trace are resolved against --asset-root, or replaced by
+// <model3.json> when one is given. Calls before the first frame count as load;
+// --frames defaults to the frames remaining after --warmup.
+// --record-calls writes such a trace of the benchmark's own calls.
+
+#include "live2d_renderer.h"
+#include "live2d_calltrace.h"
+#include "live2d_thread.h"
+#include "live2d_gl.h"
+#include "gl_recorder.h"
+#include "gl_trace.h"
+#ifdef LIVE2D_VULKAN
+#include "live2d_vulkan.h"
+#endif
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ===================== Allocation Counting =====================
+
+static std::atomic<long long> g_allocCount{0};
+static std::atomic<long long> g_allocBytes{0};
+
+void* operator new(size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add((long long)size, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add((long long)size, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t& t) noexcept { return operator new(size, t); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// ===================== EGL =====================
+
+struct EglContext {
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLSurface surface = EGL_NO_SURFACE;
+    EGLContext context = EGL_NO_CONTEXT;
+};
+
+static bool openEglDisplay(EglContext& c, EGLint& major, EGLint& minor) {
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay)
+        c.display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+#endif
+    if (c.display == EGL_NO_DISPLAY || !eglInitialize(c.display, &major, &minor)) {
+        c.display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (c.display == EGL_NO_DISPLAY || !eglInitialize(c.display, &major, &minor)) {
+            fprintf(stderr, "eglInitialize failed: 0x%x\n", eglGetError());
+            c.display = EGL_NO_DISPLAY;
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool createEglContext(EglContext& c, int width, int height, int glesVersion) {
+    EGLint major = 0, minor = 0;
+    if (!openEglDisplay(c, major, minor)) return false;
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, glesVersion >= 3 ? EGL_OPENGL_ES3_BIT_KHR : EGL_OPENGL_ES2_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8, EGL_STENCIL_SIZE, 8,
+        EGL_DEPTH_SIZE, 16,
+        EGL_NONE
+    };
+    EGLConfig config; EGLint n = 0;
+    if (!eglChooseConfig(c.display, configAttribs, &config, 1, &n) || n == 0) {
+        fprintf(stderr, "eglChooseConfig: no RGBA8 pbuffer config\n");
+        return false;
+    }
+    const EGLint pbufferAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+    c.surface = eglCreatePbufferSurface(c.display, config, pbufferAttribs);
+    if (c.surface == EGL_NO_SURFACE) { fprintf(stderr, "eglCreatePbufferSurface failed: 0x%x\n", eglGetError()); return false; }
+
+    eglBindAPI(EGL_OPENGL_ES_API);
+    const EGLint contextAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, glesVersion, EGL_NONE };
+    c.context = eglCreateContext(c.display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (c.context == EGL_NO_CONTEXT) {
+        fprintf(stderr, "eglCreateContext (GLES %d) failed: 0x%x\n", glesVersion, eglGetError());
+        return false;
+    }
+    if (!eglMakeCurrent(c.display, c.surface, c.surface, c.context)) {
+        fprintf(stderr, "eglMakeCurrent failed: 0x%x\n", eglGetError());
+        return false;
+    }
+    fprintf(stderr, "EGL %d.%d, GL_RENDERER=%s\n", major, minor, (const char*)glGetString(GL_RENDERER));
+    return true;
+}
+
+static void destroyEglContext(EglContext& c) {
+    if (c.display == EGL_NO_DISPLAY) return;
+    eglMakeCurrent(c.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (c.context != EGL_NO_CONTEXT) eglDestroyContext(c.display, c.context);
+    if (c.surface != EGL_NO_SURFACE) eglDestroySurface(c.display, c.surface);
+    eglTerminate(c.display);
+}
+
+// ===================== Script =====================
+
+struct ScriptEvent {
+    int frame = 0;
+    std::string cmd;
+    std::vector<std::string> args;
+};
+
+static bool loadScript(const char* path, std::vector<ScriptEvent>& out) {
+    FILE* f = fopen(path, "r");
+    if (!f) { fprintf(stderr, "Cannot open script: %s\n", path); return false; }
+    char line[1024];
+    int lineNo = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        if (char* hash = strchr(line, '#')) *hash = '\0';
+        std::vector<std::string> tok;
+        for (char* t = strtok(line, " \t\r\n"); t; t = strtok(nullptr, " \t\r\n")) tok.emplace_back(t);
+        if (tok.empty()) continue;
+        if (tok.size() < 2) { fprintf(stderr, "%s:%d: expected '<frame> <command> ...'\n", path, lineNo); fclose(f); return false; }
+        ScriptEvent e;
+        e.frame = atoi(tok[0].c_str());
+        e.cmd = tok[1];
+        e.args.assign(tok.begin() + 2, tok.end());
+        out.push_back(std::move(e));
+    }
+    fclose(f);
+    std::stable_sort(out.begin(), out.end(), [](const ScriptEvent& a, const ScriptEvent& b) { return a.frame < b.frame; });
+    return true;
+}
+
+static bool g_hostInputs = true;
+
+static void applyScriptEvent(const ScriptEvent& e) {
+    const auto& a = e.args;
+    auto num = [&](size_t i, float def) { return i < a.size() ? (float)atof(a[i].c_str()) : def; };
+    if (e.cmd == "motion" && !a.empty()) {
+        startMotion(a[0], (int)num(1, 0), (int)num(2, 2));
+    } else if (e.cmd == "expression") {
+        setExpression(a.empty() || a[0] == "-" ? std::string() : a[0]);
+    } else if (e.cmd == "param" && a.size() >= 2) {
+        setParameterOverride(a[0].c_str(), num(1, 0), num(2, 1));
+    } else if (e.cmd == "transform" && a.size() >= 3) {
+        setModelTransform(num(0, 1), num(1, 0), num(2, 0));
+    } else if (e.cmd == "inputs" && a.size() == 1 && (a[0] == "on" || a[0] == "off")) {
+        g_hostInputs = a[0] == "on";
+    } else if (e.cmd == "trim" && a.size() == 1 && num(0, 0) >= 1 && num(0, 0) <= 3) {
+        trimMemory((TrimLevel)(int)num(0, 0));
+    } else {
+        fprintf(stderr, "Unknown script command at frame %d: %s\n", e.frame, e.cmd.c_str());
+    }
+}
+
+// Same parameter traffic the Android host sends every frame (lip sync + gaze).
+static void applyHostInputs(float t) {
+    float mouth = 0.5f + 0.5f * sinf(t * 12.f);
+    setParameterOverride("ParamMouthOpenY", mouth, 1.f);
+    setParameterOverride("ParamA", mouth, 1.f);
+    float fx = sinf(t * 0.7f), fy = 0.5f * sinf(t * 1.1f);
+    setParameterOverride("ParamEyeBallX", fx, 1.f);
+    setParameterOverride("ParamEyeBallY", fy, 1.f);
+    setParameterOverride("ParamAngleX", fx * 30.f, 1.f);
+    setParameterOverride("ParamAngleY", fy * 30.f, 1.f);
+    setParameterOverride("ParamAngleZ", fx * fy * -30.f, 1.f);
+    setParameterOverride("ParamBodyAngleX", fx * 10.f, 1.f);
+}
+
+// 渲染线程模式: 同样的输入只交给渲染线程, 由它每帧应用 (嘴型参数在加载后设置)
+static void sendHostInputs(float t) {
+    setLipSyncValue(0.5f + 0.5f * sinf(t * 12.f));
+    setGazeTarget(sinf(t * 0.7f), 0.5f * sinf(t * 1.1f));
+}
+
+// ===================== Replay =====================
+
+struct Replay {
+    std::vector<CallRecord> calls;
+    size_t next = 0;
+    std::string modelOverride;  // replaces every recorded model path
+    std::string assetRoot;      // prefix for recorded (asset-relative) paths
+};
+
+static int countFrames(const std::vector<CallRecord>& calls) {
+    int n = 0;
+    for (const auto& c : calls) if (c.op == CallOp::Frame) n++;
+    return n;
+}
+
+static void replayRecord(const Replay& r, const CallRecord& rec) {
+    if (rec.op != CallOp::LoadModel || (r.modelOverride.empty() && r.assetRoot.empty())) {
+        replayCall(rec);
+        return;
+    }
+    CallRecord mapped = rec;
+    mapped.str = !r.modelOverride.empty() ? r.modelOverride : r.assetRoot + "/" + rec.str;
+    replayCall(mapped);
+}
+
+// Issue recorded calls up to the next frame; with drawNext the frame itself is drawn too.
+// Returns false when the trace has no frame left.
+static bool replayUntilFrame(Replay& r, bool drawNext) {
+    while (r.next < r.calls.size() && r.calls[r.next].op != CallOp::Frame) replayRecord(r, r.calls[r.next++]);
+    if (r.next >= r.calls.size()) return false;
+    if (drawNext) replayRecord(r, r.calls[r.next++]);
+    return true;
+}
+
+// ===================== Statistics =====================
+
+static double nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void writeSeries(FILE* out, const char* name, std::vector<double> v, bool last) {
+    std::sort(v.begin(), v.end());
+    auto pct = [&](double p) {
+        if (v.empty()) return 0.0;
+        size_t i = (size_t)std::min<double>(v.size() - 1, std::floor(p * (v.size() - 1) + 0.5));
+        return v[i];
+    };
+    double sum = 0;
+    for (double x : v) sum += x;
+    fprintf(out, "    \"%s\": {\"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f}%s\n",
+            name, v.empty() ? 0.0 : sum / v.size(), pct(0.5), pct(0.9), pct(0.99), v.empty() ? 0.0 : v.back(),
+            last ? "" : ",");
+}
+
+// ===================== Frame Images =====================
+
+// 窗口内容, 顶行在前 (glReadPixels 从底行开始)
+static std::vector<uint8_t> readFrame(int width, int height) {
+    std::vector<uint8_t> px((size_t)width * height * 4), out(px.size());
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, px.data());
+    size_t row = (size_t)width * 4;
+    for (int y = 0; y < height; y++) memcpy(&out[y * row], &px[(height - 1 - y) * row], row);
+    return out;
+}
+
+static bool writePam(const char* path, int width, int height, const std::vector<uint8_t>& rgba) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", width, height);
+    bool ok = fwrite(rgba.data(), 1, rgba.size(), f) == rgba.size();
+    return fclose(f) == 0 && ok;
+}
+
+static bool readPam(const char* path, int& width, int& height, std::vector<uint8_t>& rgba) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    char line[128];
+    int depth = 0, maxval = 0;
+    width = height = 0;
+    bool header = fgets(line, sizeof(line), f) && !strncmp(line, "P7", 2);
+    while (header && fgets(line, sizeof(line), f) && strncmp(line, "ENDHDR", 6)) {
+        sscanf(line, "WIDTH %d", &width);
+        sscanf(line, "HEIGHT %d", &height);
+        sscanf(line, "DEPTH %d", &depth);
+        sscanf(line, "MAXVAL %d", &maxval);
+    }
+    bool ok = header && width > 0 && height > 0 && depth == 4 && maxval == 255;
+    if (ok) {
+        rgba.resize((size_t)width * height * 4);
+        ok = fread(rgba.data(), 1, rgba.size(), f) == rgba.size();
+    }
+    fclose(f);
+    return ok;
+}
+
+// ===================== Main =====================
+
+static void usage() {
+    fprintf(stderr,
+            "usage: live2d_bench <model3.json> [--frames N] [--warmup N] [--size WxH]\n"
+            "                    [--dt SECONDS] [--script FILE] [--finish] [--out FILE]\n"
+            "                    [--gl egl|null] [--backend gles|vulkan] [--record GLLOG]\n"
+            "                    [--record-calls TRACE] [--replay TRACE [--asset-root DIR]]\n"
+            "                    [--max-allocs N] [--metadata FILE] [--lod-async] [--eager-textures]\n"
+            "                    [--drs BUDGET_MS] [--flipbook FRAMES [--flipbook-scale S]]\n"
+            "                    [--shader-cache DIR] [--gles 2|3] [--clip auto|mask|stencil]\n"
+            "                    [--dump-frame PAM] [--diff-frame PAM [--diff-tolerance T] [--max-diff-pixels N]]\n"
+            "                    [--frame-source gl|cpu|snapshot [--raster-threads N]] [--thumbnail WxH PAM]\n"
+            "                    [--snapshot-every N] [--snapshot-size WxH] [--snapshot-background AARRGGBB]\n"
+            "                    [--render-thread HZ [--frame-interval N] [--surface-cycle N]]\n"
+            "       live2d_bench --replay TRACE [model3.json] [options]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* modelPath = nullptr;
+    const char* scriptPath = nullptr;
+    const char* outPath = nullptr;
+    const char* recordPath = nullptr;
+    const char* recordCallsPath = nullptr;
+    const char* replayPath = nullptr;
+    const char* metadataPath = nullptr;
+    const char* shaderCacheDir = nullptr;
+    const char* dumpFramePath = nullptr;
+    const char* diffFramePath = nullptr;
+    int diffTolerance = 0;
+    long long maxDiffPixels = 0;
+    bool cpuFrame = false, snapshotFrame = false;
+    int snapshotEvery = 0, snapshotW = 0, snapshotH = 0;
+    uint32_t snapshotBackground = 0;
+    int rasterThreads = 0;
+    const char* thumbnailPath = nullptr;
+    int thumbW = 0, thumbH = 0;
+    Replay replay;
+    bool nullGL = false, vulkan = false, framesGiven = false, sizeGiven = false;
+    int frames = 600, warmup = 60, width = 1080, height = 1920;
+    long long maxAllocs = -1;
+    float dt = 1.f / 60.f;
+    bool finish = false, lodAsync = false, eagerTextures = false;
+    float drsBudgetMs = 0.f;
+    int flipbookFrames = 0;
+    float flipbookScale = 0.5f;
+    int glesVersion = 2;
+    ClipMode clipMode = ClipMode::Auto;
+    float threadHz = 0.f;
+    int frameInterval = 1, surfaceCycle = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (a == "--frames" && (v = next())) { frames = atoi(v); framesGiven = true; }
+        else if (a == "--warmup" && (v = next())) warmup = atoi(v);
+        else if (a == "--size" && (v = next())) { if (sscanf(v, "%dx%d", &width, &height) != 2) { usage(); return 2; } sizeGiven = true; }
+        else if (a == "--dt" && (v = next())) dt = (float)atof(v);
+        else if (a == "--script" && (v = next())) scriptPath = v;
+        else if (a == "--out" && (v = next())) outPath = v;
+        else if (a == "--finish") finish = true;
+        else if (a == "--gl" && (v = next())) { if (!strcmp(v, "null")) nullGL = true; else if (strcmp(v, "egl")) { usage(); return 2; } }
+        else if (a == "--backend" && (v = next())) { if (!strcmp(v, "vulkan")) vulkan = true; else if (strcmp(v, "gles")) { usage(); return 2; } }
+        else if (a == "--record" && (v = next())) recordPath = v;
+        else if (a == "--record-calls" && (v = next())) recordCallsPath = v;
+        else if (a == "--replay" && (v = next())) replayPath = v;
+        else if (a == "--asset-root" && (v = next())) replay.assetRoot = v;
+        else if (a == "--max-allocs" && (v = next())) maxAllocs = atoll(v);
+        else if (a == "--metadata" && (v = next())) metadataPath = v;
+        else if (a == "--lod-async") lodAsync = true;
+        else if (a == "--eager-textures") eagerTextures = true;
+        else if (a == "--drs" && (v = next())) drsBudgetMs = (float)atof(v);
+        else if (a == "--flipbook" && (v = next())) flipbookFrames = atoi(v);
+        else if (a == "--flipbook-scale" && (v = next())) flipbookScale = (float)atof(v);
+        else if (a == "--shader-cache" && (v = next())) shaderCacheDir = v;
+        else if (a == "--gles" && (v = next())) { glesVersion = atoi(v); if (glesVersion != 2 && glesVersion != 3) { usage(); return 2; } }
+        else if (a == "--clip" && (v = next())) {
+            if (!strcmp(v, "auto")) clipMode = ClipMode::Auto;
+            else if (!strcmp(v, "mask")) clipMode = ClipMode::MaskTexture;
+            else if (!strcmp(v, "stencil")) clipMode = ClipMode::Stencil;
+            else { usage(); return 2; }
+        }
+        else if (a == "--dump-frame" && (v = next())) dumpFramePath = v;
+        else if (a == "--diff-frame" && (v = next())) diffFramePath = v;
+        else if (a == "--diff-tolerance" && (v = next())) diffTolerance = atoi(v);
+        else if (a == "--max-diff-pixels" && (v = next())) maxDiffPixels = atoll(v);
+        else if (a == "--frame-source" && (v = next())) {
+            if (!strcmp(v, "cpu")) cpuFrame = true;
+            else if (!strcmp(v, "snapshot")) snapshotFrame = true;
+            else if (strcmp(v, "gl")) { usage(); return 2; }
+        }
+        else if (a == "--snapshot-every" && (v = next())) snapshotEvery = atoi(v);
+        else if (a == "--snapshot-size" && (v = next())) {
+            if (sscanf(v, "%dx%d", &snapshotW, &snapshotH) != 2 || snapshotW <= 0 || snapshotH <= 0) { usage(); return 2; }
+        }
+        else if (a == "--snapshot-background" && (v = next())) snapshotBackground = (uint32_t)strtoul(v, nullptr, 16);
+        else if (a == "--raster-threads" && (v = next())) rasterThreads = atoi(v);
+        else if (a == "--render-thread" && (v = next())) { threadHz = (float)atof(v); if (threadHz <= 0.f) { usage(); return 2; } }
+        else if (a == "--frame-interval" && (v = next())) frameInterval = atoi(v);
+        else if (a == "--surface-cycle" && (v = next())) surfaceCycle = atoi(v);
+        else if (a == "--thumbnail" && i + 2 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &thumbW, &thumbH) != 2 || thumbW <= 0 || thumbH <= 0) { usage(); return 2; }
+            thumbnailPath = argv[++i];
+        }
+        else if (a[0] != '-' && !modelPath) modelPath = argv[i];
+        else { usage(); return 2; }
+    }
+    if ((!modelPath && !replayPath) || frames <= 0 || width <= 0 || height <= 0) { usage(); return 2; }
+    if (nullGL && !cpuFrame && !snapshotFrame && (dumpFramePath || diffFramePath)) {
+        fprintf(stderr, "--dump-frame / --diff-frame need --gl egl or --frame-source cpu|snapshot\n");
+        return 2;
+    }
+    if (vulkan && (recordPath || replayPath)) {
+        fprintf(stderr, "--backend vulkan cannot be combined with --record / --replay\n");
+        return 2;
+    }
+    if (thumbnailPath && !modelPath) { fprintf(stderr, "--thumbnail needs <model3.json>\n"); return 2; }
+    bool threaded = threadHz > 0.f;
+    if (threaded && (replayPath || snapshotEvery > 0 || snapshotFrame)) {
+        fprintf(stderr, "--render-thread cannot be combined with --replay / --snapshot-every / --frame-source snapshot\n");
+        return 2;
+    }
+
+    std::vector<ScriptEvent> script;
+    if (scriptPath && !loadScript(scriptPath, script)) return 2;
+
+    if (replayPath) {
+        std::string err;
+        if (!loadCallTrace(replayPath, replay.calls, &err)) { fprintf(stderr, "%s: %s\n", replayPath, err.c_str()); return 2; }
+        int traceFrames = countFrames(replay.calls);
+        if (warmup >= traceFrames) warmup = 0;
+        if (!framesGiven) frames = traceFrames - warmup;
+        if (frames <= 0) { fprintf(stderr, "%s: no frames to replay\n", replayPath); return 2; }
+        if (modelPath) replay.modelOverride = modelPath;
+        // 未指定 --size 时使用录制时的 surface 尺寸
+        for (const auto& c : replay.calls) {
+            if (sizeGiven || c.op != CallOp::Viewport || c.i0 <= 0 || c.i1 <= 0) continue;
+            width = c.i0; height = c.i1;
+            break;
+        }
+    }
+
+    // 每条返回路径都先等着色器缓存写完: 写入线程会打日志, 不能留到静态对象析构时
+    struct ProgramCacheFlush { ~ProgramCacheFlush() { flushProgramCache(); } } programCacheFlush;
+    EglContext egl;
+    EGLint eglMajor = 0, eglMinor = 0;
+    // 渲染线程模式只打开 display, 上下文与窗口表面由渲染线程创建
+    if (vulkan) nullGL = true;   // 渲染器之外的 GL 调用落到空后端
+    if (!nullGL && !(threaded ? openEglDisplay(egl, eglMajor, eglMinor) : createEglContext(egl, width, height, glesVersion)))
+        return 1;
+    bool recording = recordPath != nullptr;
+    if (recording) setGLDispatch(startGLRecording(nullGL ? nullptr : nativeGLDispatch(), glesVersion));
+    else if (nullGL) setGLDispatch(nullGLDispatch(glesVersion));
+
+    if (!threaded && recordCallsPath && !startCallRecording(recordCallsPath)) { destroyEglContext(egl); return 1; }
+
+    // 默认纹理 LOD 切换在 drawFrame 内同步完成, 发生在哪一帧与机器速度无关
+    setTextureLodAsync(lodAsync);
+    setLazyTextures(!eagerTextures);
+    if (shaderCacheDir) setShaderCacheDir(shaderCacheDir);
+    setGLES3Enabled(glesVersion >= 3);
+    setClipMode(clipMode);
+
+    // 渲染线程模式下 GL 与渲染器的调用都要在渲染线程上执行
+    auto onRenderThread = [&](const std::function<void()>& fn) { if (threaded) runRenderTask(fn); else fn(); };
+    std::function<void(const RenderFrameInfo&)> frameHook;
+    bool callRecordingOk = true, threadLoaded = false;
+
+    double loadStart = nowMs();
+    long long loadAllocs = g_allocCount.load();
+    if (replayPath) {
+        replayUntilFrame(replay, false);
+        if (!isModelLoaded()) { fprintf(stderr, "%s: model not loaded by the trace\n", replayPath); destroyEglContext(egl); return 1; }
+    } else if (threaded) {
+        RenderThreadConfig rc;
+        rc.egl = !nullGL;
+        rc.vulkan = vulkan;
+        rc.display = egl.display;
+        rc.glesVersion = glesVersion;
+        rc.timerHz = threadHz;
+        if (shaderCacheDir) rc.shaderCacheDir = shaderCacheDir;
+        rc.onThreadStart = [&] { if (recordCallsPath) callRecordingOk = startCallRecording(recordCallsPath); };
+        rc.onModelLoaded = [&](const std::string&, bool ok) { threadLoaded = ok; };
+        rc.onFrame = [&](const RenderFrameInfo& info) { if (frameHook) frameHook(info); };
+        if (!startRenderThread(rc)) { destroyEglContext(egl); return 1; }
+        setRenderFrameInterval(frameInterval);
+        renderThreadLoadModel(modelPath);
+        runRenderTask([] {});   // 等待加载完成
+        bool backendOk = true;
+        runRenderTask([&] { backendOk = !vulkan || renderBackend() == RenderBackend::Vulkan; });
+        if (!backendOk) fprintf(stderr, "Vulkan renderer unavailable\n");
+        if (!callRecordingOk || !threadLoaded || !backendOk) { stopRenderThread(); destroyEglContext(egl); return 1; }
+    } else if (vulkan) {
+        if (!initRendererVulkan()) { fprintf(stderr, "Vulkan renderer unavailable\n"); return 1; }
+        if (!loadModel(modelPath)) { shutdownRendererVulkan(); return 1; }
+    } else {
+        initRenderer();
+        if (!loadModel(modelPath)) { destroyEglContext(egl); return 1; }
+    }
+    double loadMs = nowMs() - loadStart;
+    loadAllocs = g_allocCount.load() - loadAllocs;
+    if (!replayPath && !threaded) setViewportSize(width, height);   // 渲染线程按窗口尺寸设置
+    onRenderThread([&] {
+        if (!replayPath && drsBudgetMs > 0.f) setDynamicResolution(true, drsBudgetMs);
+        if (!replayPath && flipbookFrames > 0) setIdleFlipbook(true, flipbookFrames, flipbookScale);
+        if (metadataPath) {
+            FILE* mf = fopen(metadataPath, "wb");
+            const std::vector<uint8_t>& blob = modelMetadata();
+            if (!mf || fwrite(blob.data(), 1, blob.size(), mf) != blob.size()) fprintf(stderr, "Cannot write %s\n", metadataPath);
+            if (mf) fclose(mf);
+        }
+    });
+
+    std::vector<double> animation, physics, core, draw, total, frame, gpu;
+    std::vector<double> drawCalls, maskDraws, maskPasses, culledDraws, allocs, scratch, textureBytes, renderScale, coverage;
+    std::vector<double> flipbook, flipbookBytes, bakeMs, residentTextures, programSwitches;
+    std::vector<double> snapshotMs, readbackMs, vsyncLate, interval;
+    for (auto* v : {&animation, &physics, &core, &draw, &total, &frame, &gpu, &snapshotMs, &readbackMs,
+                    &vsyncLate, &interval,
+                    &drawCalls, &maskDraws, &maskPasses, &culledDraws, &programSwitches,
+                    &allocs, &scratch, &textureBytes, &residentTextures,
+                    &renderScale, &coverage,
+                    &flipbook, &flipbookBytes, &bakeMs})
+        v->reserve(frames);
+    size_t nextEvent = 0;
+    long long measuredAllocs = 0, measuredBytes = 0, worstFrameAllocs = 0;
+
+    // 缩略图与渲染循环并行, 不经过 GL 线程
+    std::vector<uint8_t> thumbnail;
+    bool thumbnailOk = false;
+    double thumbnailMs = 0;
+    std::thread thumbnailThread;
+    if (thumbnailPath) {
+        thumbnailThread = std::thread([&] {
+            double t0 = nowMs();
+            thumbnailOk = renderModelThumbnail(modelPath, thumbW, thumbH, thumbnail, rasterThreads);
+            thumbnailMs = nowMs() - t0;
+        });
+    }
+    int worstFrame = -1;
+
+    // 快照: 请求 / 完成计数, 完成时的帧数与耗时
+    int snapshotsRequested = 0, snapshotsDelivered = 0, snapshotsFailed = 0, snapshotMaxFrames = 0;
+    double snapshotFramesSum = 0, snapshotLatencySum = 0, snapshotLatencyMax = 0;
+    int frameSnapshotId = 0;
+    Snapshot frameSnapshot;
+    auto pollSnapshots = [&] {
+        Snapshot snap;
+        while (pollSnapshot(snap)) {
+            if (snap.rgba.empty()) { snapshotsFailed++; continue; }
+            snapshotsDelivered++;
+            snapshotFramesSum += snap.frames;
+            snapshotMaxFrames = std::max(snapshotMaxFrames, snap.frames);
+            snapshotLatencySum += snap.latencyMs;
+            snapshotLatencyMax = std::max(snapshotLatencyMax, snap.latencyMs);
+            if (snap.id == frameSnapshotId) frameSnapshot = std::move(snap);
+        }
+    };
+    auto requestOne = [&] {
+        int id = requestSnapshot(snapshotW, snapshotH, snapshotBackground);
+        if (id) snapshotsRequested++;
+        else fprintf(stderr, "requestSnapshot refused\n");
+        return id;
+    };
+
+    // 一帧的统计, 在画这一帧的线程上调用
+    auto collect = [&](double frameMs, double finishMs, long long da, long long db, int scriptFrame) {
+        const FrameStats& s = lastFrameStats();
+        animation.push_back(s.animationMs);
+        physics.push_back(s.physicsMs);
+        core.push_back(s.coreMs);
+        draw.push_back(s.drawMs);
+        total.push_back(s.totalMs);
+        frame.push_back(frameMs);
+        gpu.push_back(finishMs);
+        drawCalls.push_back(s.drawCalls);
+        maskDraws.push_back(s.maskDraws);
+        maskPasses.push_back(s.maskPasses);
+        culledDraws.push_back(s.culledDraws);
+        programSwitches.push_back(s.programSwitches);
+        allocs.push_back((double)da);
+        scratch.push_back(s.scratchBytes);
+        textureBytes.push_back(s.textureBytes);
+        residentTextures.push_back(s.residentTextures);
+        renderScale.push_back(s.renderScale);
+        coverage.push_back(s.coverage);
+        flipbook.push_back(s.flipbook);
+        flipbookBytes.push_back(s.flipbookBytes);
+        bakeMs.push_back(s.bakeMs);
+        snapshotMs.push_back(s.snapshotMs);
+        readbackMs.push_back(s.readbackMs);
+        if (da > worstFrameAllocs) { worstFrameAllocs = da; worstFrame = scriptFrame; }
+        measuredAllocs += da;
+        measuredBytes += db;
+    };
+
+    bool threadStalled = false;
+    if (threaded) {
+        std::mutex frameMutex;
+        std::condition_variable frameCv;
+        int framesDone = 0;
+        long long a0 = g_allocCount.load(), b0 = g_allocBytes.load();
+        frameHook = [&](const RenderFrameInfo& info) {
+            if (recording) markGLFrame();
+            long long a = g_allocCount.load(), b = g_allocBytes.load();
+            long long da = a - a0, db = b - b0;
+            a0 = a;
+            b0 = b;
+            if (info.index >= warmup && info.index < warmup + frames) {
+                collect(info.renderMs, info.swapMs, da, db, info.index - warmup);
+                vsyncLate.push_back(info.startLateMs);
+                interval.push_back(info.dt * 1000.0);
+            }
+            {
+                std::lock_guard<std::mutex> lock(frameMutex);
+                framesDone = info.index + 1;
+            }
+            frameCv.notify_one();
+        };
+        // 脚本事件作为任务交给渲染线程, 和宿主一样; "inputs" 控制的是主线程发送的输入
+        auto postScript = [&](int scriptFrame) {
+            while (nextEvent < script.size() && script[nextEvent].frame <= scriptFrame) {
+                const ScriptEvent& e = script[nextEvent++];
+                if (e.cmd == "inputs") applyScriptEvent(e);
+                else postRenderTask([e] { applyScriptEvent(e); });
+            }
+        };
+        setLipSyncParameters({"ParamMouthOpenY", "ParamA"});
+        postScript(-warmup);
+        setRenderWindow(EGLNativeWindowType{}, width, height);
+        for (int seen = 0; seen < warmup + frames;) {
+            int done;
+            {
+                std::unique_lock<std::mutex> lock(frameMutex);
+                if (!frameCv.wait_for(lock, std::chrono::seconds(10), [&] { return framesDone > seen; })) {
+                    fprintf(stderr, "render thread stalled after %d frames\n", framesDone);
+                    threadStalled = true;
+                    break;
+                }
+                done = framesDone;
+            }
+            for (; seen < done; seen++) {
+                postScript(seen + 1 - warmup);
+                if (surfaceCycle > 0 && (seen + 1) % surfaceCycle == 0 && seen + 1 < warmup + frames) {
+                    releaseRenderWindow(EGLNativeWindowType{});
+                    setRenderWindow(EGLNativeWindowType{}, width, height);
+                }
+            }
+            if (g_hostInputs) sendHostInputs(done * dt);
+        }
+        // 停止出帧, 之后 frameHook 不再被调用
+        setRenderPaused(true);
+        runRenderTask([&] { frameHook = nullptr; });
+    } else {
+        for (int f = 0; f < warmup + frames; f++) {
+            int scriptFrame = f - warmup;
+            long long a0 = g_allocCount.load(), b0 = g_allocBytes.load();
+            if (snapshotEvery > 0 && scriptFrame >= 0 && scriptFrame % snapshotEvery == 0) requestOne();
+            if (snapshotFrame && f == warmup + frames - 1) frameSnapshotId = requestOne();
+            double t0 = nowMs();
+
+            if (replayPath) {
+                if (!replayUntilFrame(replay, true)) break;
+            } else {
+                while (nextEvent < script.size() && script[nextEvent].frame <= scriptFrame)
+                    applyScriptEvent(script[nextEvent++]);
+                if (g_hostInputs) applyHostInputs(f * dt);
+                drawFrame(dt);
+            }
+
+            double t1 = nowMs();
+            if (finish) g_gl->Finish();
+            double t2 = nowMs();
+            if (recording) markGLFrame();
+            pollSnapshots();
+            long long da = g_allocCount.load() - a0, db = g_allocBytes.load() - b0;
+
+            if (f < warmup) continue;
+            collect(t1 - t0, t2 - t1, da, db, scriptFrame);
+        }
+    }
+
+    // 收尾的 GL 调用与最后一帧的画面: 保存, 或之后与参考图逐像素比较
+    GLenum glErr = GL_NO_ERROR;
+    std::string rendererName;
+    std::vector<uint8_t> image;
+    bool diffFailed = false;
+    double rasterMs = 0;
+    int imageW = width, imageH = height;
+    onRenderThread([&] {
+        if (recordCallsPath) stopCallRecording();
+        // 最后一帧请求的快照在之后的帧里才读回; dt 0 不推进动画
+        for (int k = 0; frameSnapshotId && frameSnapshot.id != frameSnapshotId && k < 16; k++) {
+            drawFrame(0.f);
+            if (recording) markGLFrame();
+            pollSnapshots();
+        }
+        glErr = g_gl->GetError();
+        if (dumpFramePath || diffFramePath) {
+            if (snapshotFrame) {
+                if (frameSnapshot.rgba.empty()) { fprintf(stderr, "Snapshot of the last frame failed\n"); diffFailed = true; }
+                image = std::move(frameSnapshot.rgba);
+                imageW = frameSnapshot.width;
+                imageH = frameSnapshot.height;
+            } else if (cpuFrame) {
+                double t0 = nowMs();
+                if (!rasterizeFrame(image, rasterThreads)) { fprintf(stderr, "rasterizeFrame failed\n"); diffFailed = true; }
+                rasterMs = nowMs() - t0;
+            } else if (vulkan) {
+                if (!readFrameVulkan(image)) { fprintf(stderr, "Vulkan readback failed\n"); diffFailed = true; }
+            } else {
+                image = readFrame(width, height);
+            }
+        }
+        if (const char* name = (const char*)g_gl->GetString(GL_RENDERER)) rendererName = name;
+#ifdef LIVE2D_VULKAN
+        if (vulkan) rendererName = vulkanDeviceName();
+#endif
+    });
+    RenderThreadStats threadStats;
+    if (threaded) {
+        stopRenderThread();
+        threadStats = renderThreadStats();
+    }
+
+    long long thumbnailPixels = 0;
+    if (thumbnailThread.joinable()) {
+        thumbnailThread.join();
+        for (size_t p = 3; p < thumbnail.size(); p += 4) thumbnailPixels += thumbnail[p] != 0;
+        if (!thumbnailOk) fprintf(stderr, "Thumbnail of %s failed\n", modelPath);
+        else if (!writePam(thumbnailPath, thumbW, thumbH, thumbnail)) fprintf(stderr, "Cannot write %s\n", thumbnailPath);
+    }
+
+    long long diffPixels = 0;
+    int diffMax = 0;
+    if (!image.empty() && dumpFramePath && !writePam(dumpFramePath, imageW, imageH, image)) {
+        fprintf(stderr, "Cannot write %s\n", dumpFramePath);
+        diffFailed = true;
+    }
+    if (!image.empty() && diffFramePath) {
+        std::vector<uint8_t> ref;
+        int refW = 0, refH = 0;
+        if (!readPam(diffFramePath, refW, refH, ref)) {
+            fprintf(stderr, "Cannot read %s\n", diffFramePath);
+            diffFailed = true;
+        } else if (refW != imageW || refH != imageH) {
+            fprintf(stderr, "%s is %dx%d, frame is %dx%d\n", diffFramePath, refW, refH, imageW, imageH);
+            diffFailed = true;
+        } else {
+            for (size_t p = 0; p < image.size(); p += 4) {
+                int d = 0;
+                for (int c = 0; c < 4; c++) d = std::max(d, std::abs((int)image[p + c] - (int)ref[p + c]));
+                diffMax = std::max(diffMax, d);
+                if (d > diffTolerance) diffPixels++;
+            }
+            diffFailed = diffFailed || diffPixels > maxDiffPixels;
+        }
+    }
+
+    // Call accounting over the measured frames (log frame f+1 = loop iteration f)
+    GLTraceCounts glCounts;
+    size_t logBytes = 0;
+    if (recording) {
+        GLTrace trace;
+        std::string err;
+        if (!parseGLTrace(glRecording(), trace, &err)) fprintf(stderr, "GL trace: %s\n", err.c_str());
+        auto perFrame = analyzeGLTrace(trace);
+        for (size_t i = warmup + 1; i < perFrame.size() && i <= (size_t)(warmup + frames); i++) glCounts += perFrame[i];
+        logBytes = glRecording().size();
+        if (recordPath && !saveGLRecording(recordPath)) fprintf(stderr, "Cannot write %s\n", recordPath);
+    }
+
+    FILE* out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) { fprintf(stderr, "Cannot open %s\n", outPath); destroyEglContext(egl); return 1; }
+    fprintf(out, "{\n");
+    fprintf(out, "  \"model\": \"%s\",\n", modelPath ? modelPath : "");
+    if (replayPath) fprintf(out, "  \"replay\": \"%s\",\n", replayPath);
+    fprintf(out, "  \"renderer\": \"%s\", \"backend\": \"%s\", \"gles\": %d, \"clip\": \"%s\",\n", rendererName.c_str(),
+            vulkan ? "vulkan" : "gles", renderPathVersion(), stencilClippingActive() ? "stencil" : "mask");
+    fprintf(out, "  \"width\": %d, \"height\": %d, \"frames\": %d, \"warmup\": %d, \"dt\": %.6f,\n",
+            width, height, frames, warmup, dt);
+    const ShaderCacheStats& shaders = shaderCacheStats();
+    fprintf(out, "  \"load\": {\"ms\": %.3f, \"allocations\": %lld, \"metadataBytes\": %zu, "
+                 "\"shaderMs\": %.3f, \"programsCached\": %d, \"programsCompiled\": %d},\n",
+            loadMs, loadAllocs, modelMetadata().size(), shaders.ms, shaders.cached, shaders.compiled);
+    fprintf(out, "  \"timeMs\": {\n");
+    writeSeries(out, "animation", animation, false);
+    writeSeries(out, "physics", physics, false);
+    writeSeries(out, "core", core, false);
+    writeSeries(out, "draw", draw, false);
+    writeSeries(out, "render", total, false);
+    writeSeries(out, "frame", frame, false);
+    writeSeries(out, "snapshot", snapshotMs, false);
+    writeSeries(out, "readback", readbackMs, false);
+    if (threaded) {
+        writeSeries(out, "vsyncLate", vsyncLate, false);
+        writeSeries(out, "interval", interval, false);
+    }
+    writeSeries(out, "finish", gpu, true);
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"counts\": {\n");
+    writeSeries(out, "drawCalls", drawCalls, false);
+    writeSeries(out, "maskDraws", maskDraws, false);
+    writeSeries(out, "maskPasses", maskPasses, false);
+    writeSeries(out, "culledDraws", culledDraws, false);
+    writeSeries(out, "programSwitches", programSwitches, false);
+    writeSeries(out, "allocations", allocs, false);
+    writeSeries(out, "scratchBytes", scratch, false);
+    writeSeries(out, "textureBytes", textureBytes, false);
+    writeSeries(out, "residentTextures", residentTextures, false);
+    writeSeries(out, "renderScale", renderScale, false);
+    writeSeries(out, "coverage", coverage, false);
+    writeSeries(out, "flipbook", flipbook, false);
+    writeSeries(out, "flipbookBytes", flipbookBytes, false);
+    writeSeries(out, "bakeMs", bakeMs, true);
+    fprintf(out, "  },\n");
+    MemoryStats mem = memoryStats();
+    fprintf(out, "  \"memory\": {\"moc\": %lld, \"model\": %lld, \"bundle\": %lld, \"textures\": %lld, "
+            "\"pendingPixels\": %lld, \"renderTargets\": %lld, \"motions\": %lld, \"expressions\": %lld, "
+            "\"physics\": %lld, \"caches\": %lld, \"total\": %lld},\n",
+            (long long)mem.moc, (long long)mem.model, (long long)mem.bundle, (long long)mem.textures,
+            (long long)mem.pendingPixels, (long long)mem.renderTargets, (long long)mem.motions,
+            (long long)mem.expressions, (long long)mem.physics, (long long)mem.caches, (long long)mem.total());
+    fprintf(out, "  \"allocations\": {\"total\": %lld, \"bytes\": %lld, \"perFrame\": %.3f},\n",
+            measuredAllocs, measuredBytes, (double)measuredAllocs / frames);
+    if (recording) {
+        auto perFrame = [&](long v) { return (double)v / frames; };
+        fprintf(out, "  \"gl\": {\"logBytes\": %zu, \"callsPerFrame\": %.2f, \"drawsPerFrame\": %.2f, "
+                "\"indicesPerFrame\": %.1f, \"verticesPerFrame\": %.1f,\n",
+                logBytes, perFrame(glCounts.calls), perFrame(glCounts.draws),
+                perFrame(glCounts.indices), perFrame(glCounts.vertices));
+        fprintf(out, "         \"stateChangesPerFrame\": %.2f, \"redundantStatePerFrame\": %.2f, "
+                "\"uniformWritesPerFrame\": %.2f, \"redundantUniformsPerFrame\": %.2f,\n",
+                perFrame(glCounts.stateChanges), perFrame(glCounts.redundantState),
+                perFrame(glCounts.uniformWrites), perFrame(glCounts.redundantUniforms));
+        fprintf(out, "         \"programBindsPerFrame\": %.2f, \"textureBindsPerFrame\": %.2f, "
+                "\"framebufferBindsPerFrame\": %.2f, \"queriesPerFrame\": %.2f},\n",
+                perFrame(glCounts.programBinds), perFrame(glCounts.textureBinds),
+                perFrame(glCounts.framebufferBinds), perFrame(glCounts.queries));
+    }
+    if (cpuFrame && (dumpFramePath || diffFramePath))
+        fprintf(out, "  \"raster\": {\"ms\": %.3f, \"threads\": %d},\n", rasterMs, rasterThreads);
+    if (thumbnailPath)
+        fprintf(out, "  \"thumbnail\": {\"ok\": %s, \"width\": %d, \"height\": %d, \"ms\": %.3f, \"coverage\": %.4f},\n",
+                thumbnailOk ? "true" : "false", thumbW, thumbH, thumbnailMs, (double)thumbnailPixels / ((double)thumbW * thumbH));
+    if (snapshotsRequested)
+        fprintf(out, "  \"snapshots\": {\"requested\": %d, \"delivered\": %d, \"failed\": %d, "
+                "\"meanFrames\": %.2f, \"maxFrames\": %d, \"meanMs\": %.3f, \"maxMs\": %.3f},\n",
+                snapshotsRequested, snapshotsDelivered, snapshotsFailed,
+                snapshotsDelivered ? snapshotFramesSum / snapshotsDelivered : 0.0, snapshotMaxFrames,
+                snapshotsDelivered ? snapshotLatencySum / snapshotsDelivered : 0.0, snapshotLatencyMax);
+    if (threaded)
+        fprintf(out, "  \"thread\": {\"hz\": %.1f, \"frameInterval\": %d, \"frames\": %d, \"hostCallsPerFrame\": %.2f, "
+                "\"tasks\": %lld, \"skippedVsyncs\": %d, \"contexts\": %d, \"windows\": %d, \"modelLoads\": %d},\n",
+                threadHz, frameInterval, threadStats.frames,
+                threadStats.frames ? (double)threadStats.hostCalls / threadStats.frames : 0.0,
+                (long long)threadStats.tasks, threadStats.skippedVsyncs, threadStats.contexts,
+                threadStats.windows, threadStats.modelLoads);
+    if (diffFramePath)
+        fprintf(out, "  \"frameDiff\": {\"reference\": \"%s\", \"tolerance\": %d, \"pixels\": %lld, \"maxDelta\": %d},\n",
+                diffFramePath, diffTolerance, diffPixels, diffMax);
+    fprintf(out, "  \"glError\": %u\n", glErr);
+    fprintf(out, "}\n");
+    if (out != stdout) fclose(out);
+
+    if (vulkan && !threaded) shutdownRendererVulkan();
+    destroyEglContext(egl);
+    if (maxAllocs >= 0 && worstFrameAllocs > maxAllocs) {
+        fprintf(stderr, "frame %d performed %lld heap allocations (limit %lld)\n",
+                worstFrame, worstFrameAllocs, maxAllocs);
+        return 3;
+    }
+    if (diffFailed) {
+        if (diffPixels > maxDiffPixels) fprintf(stderr, "%lld pixels differ from %s by more than %d (limit %lld)\n",
+                                   diffPixels, diffFramePath, diffTolerance, maxDiffPixels);
+        return 4;
+    }
+    if (thumbnailPath && !thumbnailOk) return 1;
+    if (threadStalled) return 1;
+    return glErr == GL_NO_ERROR ? 0 : 1;
+}
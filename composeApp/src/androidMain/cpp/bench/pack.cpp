@@ -0,0 +1,134 @@
+// Model bundle packer.
+//
+// Packs a model3.json and every file it references (moc3, textures, motions,
+// expressions, physics, pose, ...) into one .l2dbundle (format in
+// live2d_bundle.h). Motions are stored pre-parsed unless --raw-motions is
+// given. On Android put the bundle in assets with noCompress so it can be
+// mapped straight out of the APK.
+//
+// Usage:
+//   live2d_pack <model.model3.json> <out.l2dbundle> [--raw-motions]
+//   live2d_pack list <bundle>
+
+#include "live2d_bundle.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+// ===================== Files =====================
+
+static bool readFile(const std::string& path, std::vector<uint8_t>& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long sz = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    out.resize(sz > 0 ? (size_t)sz : 0);
+    bool ok = sz >= 0 && fread(out.data(), 1, out.size(), f) == out.size();
+    fclose(f);
+    return ok;
+}
+
+static bool writeFile(const std::string& path, const std::vector<uint8_t>& data) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) { fprintf(stderr, "Cannot write %s\n", path.c_str()); return false; }
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) fprintf(stderr, "Write failed: %s\n", path.c_str());
+    return ok;
+}
+
+static bool isRegularFile(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+static bool endsWith(const std::string& s, const char* suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+// model3.json 中所有字符串值 (只处理 \" \\ \/ 转义; 引用路径不会含其它转义)
+static std::vector<std::string> jsonStrings(const std::string& j) {
+    std::vector<std::string> out;
+    for (size_t i = 0; i < j.size(); i++) {
+        if (j[i] != '"') continue;
+        std::string s;
+        for (i++; i < j.size() && j[i] != '"'; i++) {
+            if (j[i] == '\\' && i + 1 < j.size()) i++;
+            s += j[i];
+        }
+        out.push_back(s);
+    }
+    return out;
+}
+
+// ===================== Commands =====================
+
+static int cmdPack(const std::string& model3Path, const std::string& outPath, bool rawMotions) {
+    std::vector<uint8_t> model3;
+    if (!readFile(model3Path, model3)) { fprintf(stderr, "Cannot read %s\n", model3Path.c_str()); return 1; }
+    size_t sl = model3Path.find_last_of('/');
+    std::string dir = sl != std::string::npos ? model3Path.substr(0, sl + 1) : "";
+    std::string mainName = sl != std::string::npos ? model3Path.substr(sl + 1) : model3Path;
+
+    std::vector<BundleInput> inputs;
+    inputs.push_back({mainName, BundleKind::File, model3});
+
+    // 引用的文件: 值为现存文件的字符串 (键名与 Groups/HitAreas 等的 Id 不会恰好是文件路径)
+    std::set<std::string> seen = {mainName};
+    int baked = 0;
+    for (const std::string& ref : jsonStrings(std::string(model3.begin(), model3.end()))) {
+        if (ref.empty() || !seen.insert(ref).second || !isRegularFile(dir + ref)) continue;
+        BundleInput in;
+        in.name = ref;
+        if (!readFile(dir + ref, in.data)) { fprintf(stderr, "Cannot read %s\n", (dir + ref).c_str()); return 1; }
+        std::vector<uint8_t> motion;
+        if (!rawMotions && endsWith(ref, ".motion3.json")
+            && bakeMotion3Json(std::string(in.data.begin(), in.data.end()), motion)) {
+            in.kind = BundleKind::Motion;
+            in.data.swap(motion);
+            baked++;
+        }
+        inputs.push_back(std::move(in));
+    }
+
+    std::vector<uint8_t> image;
+    std::string err;
+    if (!writeBundle(inputs, mainName, image, &err)) { fprintf(stderr, "Pack failed: %s\n", err.c_str()); return 1; }
+    if (!writeFile(outPath, image)) return 1;
+    printf("%s: %zu entries (%d baked motions), %zu bytes\n", outPath.c_str(), inputs.size(), baked, image.size());
+    return 0;
+}
+
+static int cmdList(const std::string& path) {
+    std::vector<uint8_t> image;
+    if (!readFile(path, image)) { fprintf(stderr, "Cannot read %s\n", path.c_str()); return 1; }
+    std::vector<BundleEntryView> entries;
+    uint32_t mainEntry = 0;
+    std::string err;
+    if (!parseBundle(image.data(), image.size(), entries, &mainEntry, &err)) {
+        fprintf(stderr, "%s: %s\n", path.c_str(), err.c_str());
+        return 1;
+    }
+    for (size_t i = 0; i < entries.size(); i++) {
+        const BundleEntryView& e = entries[i];
+        printf("%10zu  %10zu  %-6s %.*s%s\n", (size_t)(e.data - image.data()), e.size,
+               e.kind == BundleKind::Motion ? "motion" : "file", (int)e.nameLength, e.name,
+               i == mainEntry ? "  (main)" : "");
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && !strcmp(argv[1], "list")) return cmdList(argv[2]);
+    if (argc == 3 || (argc == 4 && !strcmp(argv[3], "--raw-motions")))
+        return cmdPack(argv[1], argv[2], argc == 4);
+    fprintf(stderr, "usage: live2d_pack <model.model3.json> <out%s> [--raw-motions] | list <bundle>\n", kBundleExtension);
+    return 2;
+}
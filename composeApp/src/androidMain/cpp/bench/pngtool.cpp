@@ -0,0 +1,311 @@
+// PNG decoder check / benchmark.
+//
+// Decodes PNGs with the streaming decoder (live2d_png.h) and with stb_image
+// (whole file + whole image + box filter, the fallback path) and compares the
+// results byte for byte, for each texture size cap. Also reports wall time and
+// peak heap of both paths. "inflate" checks and times live2d_inflate.cpp
+// against zlib on the concatenated IDAT stream.
+//
+// Usage:
+//   live2d_pngtool check <png>... [--max PX]...     exit 1 on any mismatch
+//   live2d_pngtool bench <png>... [--max PX] [--iterations N]
+//   live2d_pngtool inflate <png>... [--iterations N]
+
+#include "live2d_inflate.h"
+#include "live2d_png.h"
+#include "stb_image.h"
+
+#include <zlib.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <string>
+#include <vector>
+
+// ===================== Heap Tracking =====================
+// glibc: 替换 malloc 系列, 统计存活字节的峰值 (usable size)
+
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void  __libc_free(void*);
+}
+
+static long long g_live = 0;
+static long long g_peak = 0;
+
+static void track(void* p, long long sign) {
+    if (!p) return;
+    g_live += sign * (long long)malloc_usable_size(p);
+    if (g_live > g_peak) g_peak = g_live;
+}
+
+extern "C" {
+void* malloc(size_t n) { void* p = __libc_malloc(n); track(p, 1); return p; }
+void* calloc(size_t a, size_t b) { void* p = __libc_calloc(a, b); track(p, 1); return p; }
+void free(void* p) { track(p, -1); __libc_free(p); }
+void* realloc(void* old, size_t n) {
+    track(old, -1);
+    void* p = __libc_realloc(old, n);
+    track(p ? p : (n ? old : nullptr), 1);
+    return p;
+}
+void* memalign(size_t a, size_t n) { void* p = __libc_memalign(a, n); track(p, 1); return p; }
+void* aligned_alloc(size_t a, size_t n) { return memalign(a, n); }
+int posix_memalign(void** out, size_t a, size_t n) {
+    void* p = memalign(a, n);
+    if (!p) return 12;   // ENOMEM
+    *out = p;
+    return 0;
+}
+}
+
+static void resetPeak() { g_peak = g_live; }
+static long long peakSince(long long base) { return g_peak - base; }
+
+// ===================== Decoders =====================
+
+static size_t readFile(void* user, uint8_t* dst, size_t n) { return fread(dst, 1, n, (FILE*)user); }
+
+static PngStatus decodeStream(const std::string& path, int maxDim, PngImage& img, std::string& err) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) { err = "cannot open"; return PngStatus::Error; }
+    PngStatus st = decodePngStream(readFile, f, maxDim, true, img, &err);
+    fclose(f);
+    return st;
+}
+
+// 与渲染器的 stb 回退路径相同: 整文件读入, 翻转解码, 再 2^n 盒式降采样
+static bool decodeStb(const std::string& path, int maxDim, PngImage& img) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long sz = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    std::vector<unsigned char> data(sz > 0 ? sz : 0);
+    bool ok = fread(data.data(), 1, data.size(), f) == data.size();
+    fclose(f);
+    if (!ok) return false;
+
+    stbi_set_flip_vertically_on_load(1);
+    int w, h, ch;
+    unsigned char* px = stbi_load_from_memory(data.data(), (int)data.size(), &w, &h, &ch, 4);
+    if (!px) return false;
+    data = std::vector<unsigned char>();
+    int scale = pngDownsampleScale(w, h, maxDim);
+    int tw = w / scale, th = h / scale;
+    if (scale > 1) {
+        unsigned char* out = (unsigned char*)malloc((size_t)tw * th * 4);
+        int n = scale * scale;
+        for (int y = 0; y < th; y++)
+            for (int x = 0; x < tw; x++)
+                for (int c = 0; c < 4; c++) {
+                    int sum = 0;
+                    for (int sy = 0; sy < scale; sy++)
+                        for (int sx = 0; sx < scale; sx++)
+                            sum += px[((size_t)(y * scale + sy) * w + x * scale + sx) * 4 + c];
+                    out[((size_t)y * tw + x) * 4 + c] = (unsigned char)(sum / n);
+                }
+        stbi_image_free(px);
+        px = out;
+    }
+    img.pixels = px;
+    img.width = tw; img.height = th;
+    img.srcWidth = w; img.srcHeight = h;
+    img.scale = scale;
+    return true;
+}
+
+static double nowMs() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ===================== Commands =====================
+
+static int cmdCheck(const std::vector<std::string>& files, const std::vector<int>& caps) {
+    int failures = 0;
+    for (const std::string& path : files) {
+        for (int cap : caps) {
+            PngImage a, b;
+            std::string err;
+            long long base = g_live;
+            resetPeak();
+            PngStatus st = decodeStream(path, cap, a, err);
+            long long streamPeak = peakSince(base);
+            base = g_live;
+            resetPeak();
+            bool stbOk = decodeStb(path, cap, b);
+            long long stbPeak = peakSince(base);
+
+            const char* verdict;
+            if (st == PngStatus::Unsupported) verdict = "unsupported (stb fallback)";
+            else if (st == PngStatus::Error) verdict = stbOk ? "MISMATCH (stream failed)" : "rejected by both";
+            else if (!stbOk) verdict = "MISMATCH (stb failed)";
+            else if (a.width != b.width || a.height != b.height
+                     || memcmp(a.pixels, b.pixels, (size_t)a.width * a.height * 4) != 0) verdict = "MISMATCH";
+            else verdict = "ok";
+            if (!strncmp(verdict, "MISMATCH", 8)) failures++;
+
+            printf("%s max=%d: %s", path.c_str(), cap, verdict);
+            if (st == PngStatus::Error) printf(" [%s]", err.c_str());
+            if (st == PngStatus::Ok)
+                printf("  %dx%d -> %dx%d  peak heap: stream %.2f MB, stb %.2f MB",
+                       a.srcWidth, a.srcHeight, a.width, a.height, streamPeak / 1048576.0, stbPeak / 1048576.0);
+            printf("\n");
+            freePngImage(a);
+            freePngImage(b);
+        }
+    }
+    return failures ? 1 : 0;
+}
+
+static int cmdBench(const std::vector<std::string>& files, int cap, int iterations) {
+    printf("[\n");
+    for (size_t i = 0; i < files.size(); i++) {
+        const std::string& path = files[i];
+        double streamMs = 0, stbMs = 0;
+        long long streamPeak = 0, stbPeak = 0;
+        int w = 0, h = 0;
+        for (int it = 0; it < iterations; it++) {
+            PngImage img;
+            std::string err;
+            long long base = g_live;
+            resetPeak();
+            double t0 = nowMs();
+            if (decodeStream(path, cap, img, err) != PngStatus::Ok) {
+                fprintf(stderr, "%s: stream decode failed (%s)\n", path.c_str(), err.c_str());
+                return 1;
+            }
+            streamMs += nowMs() - t0;
+            streamPeak = peakSince(base);
+            w = img.srcWidth; h = img.srcHeight;
+            freePngImage(img);
+
+            base = g_live;
+            resetPeak();
+            t0 = nowMs();
+            if (!decodeStb(path, cap, img)) { fprintf(stderr, "%s: stb decode failed\n", path.c_str()); return 1; }
+            stbMs += nowMs() - t0;
+            stbPeak = peakSince(base);
+            freePngImage(img);
+        }
+        printf("  {\"file\": \"%s\", \"width\": %d, \"height\": %d, \"max\": %d,\n"
+               "   \"stream\": {\"ms\": %.3f, \"peakBytes\": %lld}, \"stb\": {\"ms\": %.3f, \"peakBytes\": %lld}}%s\n",
+               path.c_str(), w, h, cap, streamMs / iterations, streamPeak, stbMs / iterations, stbPeak,
+               i + 1 < files.size() ? "," : "");
+    }
+    printf("]\n");
+    return 0;
+}
+
+// ---- inflate ----
+
+static bool idatStream(const std::string& path, std::vector<uint8_t>& z) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::vector<uint8_t> d;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) d.insert(d.end(), buf, buf + n);
+    fclose(f);
+    z.clear();
+    for (size_t i = 8; i + 12 <= d.size();) {
+        size_t len = (size_t)d[i] << 24 | (size_t)d[i + 1] << 16 | (size_t)d[i + 2] << 8 | d[i + 3];
+        if (i + 12 + len > d.size()) return false;
+        if (!memcmp(&d[i + 4], "IDAT", 4)) z.insert(z.end(), &d[i + 8], &d[i + 8 + len]);
+        i += 12 + len;
+    }
+    return !z.empty();
+}
+
+struct MemStream { const uint8_t* p; size_t left; };
+
+static size_t readMem(void* user, uint8_t* dst, size_t n) {
+    auto* m = (MemStream*)user;
+    if (n > m->left) n = m->left;
+    memcpy(dst, m->p, n);
+    m->p += n; m->left -= n;
+    return n;
+}
+
+static int cmdInflate(const std::vector<std::string>& files, int iterations) {
+    int failures = 0;
+    for (const std::string& path : files) {
+        std::vector<uint8_t> z, ref(1 << 20), out;
+        if (!idatStream(path, z)) { fprintf(stderr, "%s: no image data\n", path.c_str()); failures++; continue; }
+        double zlibMs = 0, ownMs = 0;
+        for (int it = 0; it < iterations; it++) {
+            // zlib: 同样每次最多 256 KB 输出, 取走后继续
+            double t0 = nowMs();
+            z_stream zs;
+            memset(&zs, 0, sizeof(zs));
+            inflateInit(&zs);
+            zs.next_in = z.data();
+            zs.avail_in = (uInt)z.size();
+            size_t total = 0;
+            int rc;
+            do {
+                if (ref.size() - total < 256 * 1024) ref.resize(ref.size() * 2);
+                zs.next_out = ref.data() + total;
+                zs.avail_out = 256 * 1024;
+                rc = inflate(&zs, Z_NO_FLUSH);
+                total = (size_t)(zs.next_out - ref.data());
+            } while (rc == Z_OK);
+            inflateEnd(&zs);
+            zlibMs += nowMs() - t0;
+            if (rc != Z_STREAM_END) { fprintf(stderr, "%s: zlib failed (%d)\n", path.c_str(), rc); failures++; break; }
+
+            t0 = nowMs();
+            MemStream ms{z.data(), z.size()};
+            Inflater inf(readMem, &ms);
+            out.clear();
+            Inflater::Status st;
+            do {
+                const uint8_t* data;
+                size_t n;
+                st = inf.next(&data, &n);
+                out.insert(out.end(), data, data + n);
+            } while (st == Inflater::More);
+            ownMs += nowMs() - t0;
+            if (st != Inflater::End || out.size() != total || memcmp(out.data(), ref.data(), total) != 0) {
+                printf("%s: MISMATCH (%s, %zu vs %zu bytes)\n", path.c_str(),
+                       st == Inflater::Error ? inf.error() : "output differs", out.size(), total);
+                failures++;
+                break;
+            }
+            if (it == iterations - 1)
+                printf("%s: ok  %zu -> %zu bytes  zlib %.2f ms, inflater %.2f ms\n", path.c_str(), z.size(), total,
+                       zlibMs / iterations, ownMs / iterations);
+        }
+    }
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3 || (strcmp(argv[1], "check") && strcmp(argv[1], "bench") && strcmp(argv[1], "inflate"))) {
+        fprintf(stderr, "usage: live2d_pngtool check <png>... [--max PX]...\n"
+                        "       live2d_pngtool bench <png>... [--max PX] [--iterations N]\n"
+                        "       live2d_pngtool inflate <png>... [--iterations N]\n");
+        return 2;
+    }
+    std::vector<std::string> files;
+    std::vector<int> caps;
+    int iterations = 5;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--max") && i + 1 < argc) caps.push_back(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--iterations") && i + 1 < argc) iterations = atoi(argv[++i]);
+        else files.push_back(argv[i]);
+    }
+    if (files.empty() || iterations < 1) return 2;
+    if (!strcmp(argv[1], "inflate")) return cmdInflate(files, iterations);
+    if (!strcmp(argv[1], "check")) {
+        if (caps.empty()) caps = {1 << 24, 2048, 128, 32};
+        return cmdCheck(files, caps);
+    }
+    return cmdBench(files, caps.empty() ? 2048 : caps.front(), iterations);
+}
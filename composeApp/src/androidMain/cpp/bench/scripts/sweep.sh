@@ -0,0 +1,48 @@
+#!/bin/sh
+# Frame time against one synthetic-model dimension, as CSV on stdout.
+#
+#   sweep.sh <build-dir> <option> <value>... [-- <live2d_synth/live2d_bench args>]
+#
+# <option> is any live2d_synth option without the dashes (drawables, verts,
+# masked, mask-fanout, textures, texture-size, params, parts, motion-curves,
+# physics-settings, physics-chain). Arguments after "--" are passed to
+# live2d_synth if it knows them, otherwise to live2d_bench, e.g.
+#
+#   sweep.sh build-bench drawables 50 100 200 400 600 -- --masked 0 --frames 120
+set -e
+
+build=$1; dim=$2
+[ -n "$build" ] && [ -n "$dim" ] || { sed -n '2,11p' "$0" >&2; exit 2; }
+shift 2
+
+values=""
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do values="$values $1"; shift; done
+[ "$1" = "--" ] && shift
+
+synth_args=""; bench_args=""
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --drawables|--verts|--masked|--mask-fanout|--textures|--texture-size|--params|--parts|\
+        --motion-curves|--physics-settings|--physics-chain|--seed)
+            synth_args="$synth_args $1 $2"; shift 2 ;;
+        --finish) bench_args="$bench_args $1"; shift ;;
+        *) bench_args="$bench_args $1 $2"; shift 2 ;;
+    esac
+done
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+# 从 live2d_bench 的 JSON 中取 "<series>": {... "<stat>": x ...}
+field() { grep "\"$2\": {" "$1" | sed -n "s/.*\"$3\": \([0-9.]*\).*/\1/p" | head -n 1; }
+
+echo "$dim,frame_p50,frame_p90,draw_p50,core_p50,physics_p50,draw_calls,mask_passes,allocs_per_frame"
+for v in $values; do
+    # shellcheck disable=SC2086
+    "$build/live2d_synth" "$work/m$v" $synth_args "--$dim" "$v" >/dev/null
+    # shellcheck disable=SC2086
+    "$build/live2d_bench" "$work/m$v/synth.model3.json" $bench_args --out "$work/r$v.json" 2>/dev/null
+    r="$work/r$v.json"
+    allocs=$(sed -n 's/.*"perFrame": \([0-9.]*\).*/\1/p' "$r")
+    echo "$v,$(field "$r" frame p50),$(field "$r" frame p90),$(field "$r" draw p50),$(field "$r" core p50),$(field "$r" physics p50),$(field "$r" drawCalls p50),$(field "$r" maskPasses p50),$allocs"
+done
@@ -0,0 +1,310 @@
+// Synthetic model generator for scaling benchmarks.
+//
+// Writes a model3.json directory (synthetic moc, PNG textures, idle motion,
+// physics, optional expressions) that loads through the normal renderer path when the host build
+// links synth_core.cpp as its Cubism Core. Vary one dimension at a time and
+// run live2d_bench on each output to plot frame time against it (see
+// bench/scripts/sweep.sh).
+//
+// Usage:
+//   live2d_synth <outdir> [--drawables N] [--verts N] [--masked N] [--mask-fanout N]
+//                [--textures N] [--texture-size PX] [--params N] [--parts N]
+//                [--motion-curves N] [--physics-settings N] [--physics-chain N] [--seed N]
+//                [--expressions N] [--costume-textures N] [--tinted N] [--inverted-masks N]
+
+#include "synth_model.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+// ===================== Output =====================
+
+static bool writeFile(const std::string& path, const void* data, size_t size) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) { fprintf(stderr, "Cannot write %s\n", path.c_str()); return false; }
+    bool ok = fwrite(data, 1, size, f) == size;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) fprintf(stderr, "Write failed: %s\n", path.c_str());
+    return ok;
+}
+
+static bool writeText(const std::string& path, const std::string& text) {
+    return writeFile(path, text.data(), text.size());
+}
+
+static void appendf(std::string& s, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+static void appendf(std::string& s, const char* fmt, ...) {
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n > 0) s.append(buf, (size_t)std::min(n, (int)sizeof(buf) - 1));
+}
+
+// ===================== PNG =====================
+
+static void putBE32(std::vector<uint8_t>& out, uint32_t v) {
+    uint8_t b[4] = {(uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v};
+    out.insert(out.end(), b, b + 4);
+}
+
+static void putChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t size) {
+    putBE32(out, (uint32_t)size);
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + size);
+    putBE32(out, (uint32_t)crc32(0, out.data() + start, (uInt)(out.size() - start)));
+}
+
+// RGBA8 PNG, filter "Sub" on every row (what authoring tools typically emit)
+static bool writePng(const std::string& path, const std::vector<uint8_t>& rgba, int w, int h) {
+    std::vector<uint8_t> raw((size_t)(w * 4 + 1) * h);
+    for (int y = 0; y < h; y++) {
+        uint8_t* dst = &raw[(size_t)(w * 4 + 1) * y];
+        const uint8_t* src = &rgba[(size_t)w * 4 * y];
+        dst[0] = 1;
+        for (int x = 0; x < w * 4; x++) dst[1 + x] = (uint8_t)(src[x] - (x >= 4 ? src[x - 4] : 0));
+    }
+    uLongf zsize = compressBound((uLong)raw.size());
+    std::vector<uint8_t> z(zsize);
+    if (compress2(z.data(), &zsize, raw.data(), (uLong)raw.size(), 6) != Z_OK) return false;
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    uint8_t ihdr[13] = {(uint8_t)(w >> 24), (uint8_t)(w >> 16), (uint8_t)(w >> 8), (uint8_t)w,
+                        (uint8_t)(h >> 24), (uint8_t)(h >> 16), (uint8_t)(h >> 8), (uint8_t)h,
+                        8, 6, 0, 0, 0};
+    putChunk(png, "IHDR", ihdr, sizeof(ihdr));
+    putChunk(png, "IDAT", z.data(), zsize);
+    putChunk(png, "IEND", nullptr, 0);
+    return writeFile(path, png.data(), png.size());
+}
+
+// 4x4 atlas cells, each a soft-edged blob with a colour gradient (matches the UV layout in synth_core.cpp)
+static std::vector<uint8_t> makeTexture(int size, int index) {
+    std::vector<uint8_t> px((size_t)size * size * 4);
+    const int cells = 4;
+    float cellSize = size / (float)cells;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            int cx = (int)(x / cellSize), cy = (int)(y / cellSize);
+            float u = x / cellSize - cx - 0.5f, v = y / cellSize - cy - 0.5f;
+            float r = sqrtf(u * u + v * v);
+            float a = std::max(0.f, std::min(1.f, (0.48f - r) * 40.f));
+            float hue = (cy * cells + cx + index * 5) * 0.37f;
+            uint8_t* p = &px[((size_t)y * size + x) * 4];
+            p[0] = (uint8_t)(127 + 100 * sinf(hue) + 20 * u);
+            p[1] = (uint8_t)(127 + 100 * sinf(hue + 2.1f) + 20 * v);
+            p[2] = (uint8_t)(127 + 100 * sinf(hue + 4.2f));
+            p[3] = (uint8_t)(255 * a);
+        }
+    }
+    return px;
+}
+
+// ===================== JSON =====================
+
+static std::string modelJson(const SynthConfig& cfg, bool physics, uint32_t expressions) {
+    std::string s = "{\n\t\"Version\": 3,\n\t\"FileReferences\": {\n\t\t\"Moc\": \"synth.moc3\",\n\t\t\"Textures\": [\n";
+    for (uint32_t t = 0; t < cfg.textures; t++)
+        appendf(s, "\t\t\t\"textures/texture_%02u.png\"%s\n", t, t + 1 < cfg.textures ? "," : "");
+    s += "\t\t],\n";
+    if (physics) s += "\t\t\"Physics\": \"synth.physics3.json\",\n";
+    if (expressions) {
+        s += "\t\t\"Expressions\": [\n";
+        for (uint32_t e = 0; e < expressions; e++)
+            appendf(s, "\t\t\t{ \"Name\": \"exp_%02u\", \"File\": \"expressions/exp_%02u.exp3.json\" }%s\n",
+                    e, e, e + 1 < expressions ? "," : "");
+        s += "\t\t],\n";
+    }
+    s += "\t\t\"Motions\": {\n\t\t\t\"Idle\": [\n\t\t\t\t{\n\t\t\t\t\t\"File\": \"motions/idle.motion3.json\"\n"
+         "\t\t\t\t}\n\t\t\t]\n\t\t}\n\t},\n";
+    // LipSync 组使用标准参数 (synthParameterId 的前 8 个), 参数不足时留空
+    s += "\t\"Groups\": [\n\t\t{\n\t\t\t\"Target\": \"Parameter\",\n\t\t\t\"Name\": \"LipSync\",\n\t\t\t\"Ids\": [";
+    if (cfg.params > 7) appendf(s, "\"%s\", \"%s\"", synthParameterId(6).c_str(), synthParameterId(7).c_str());
+    s += "]\n\t\t}\n\t],\n";
+    s += "\t\"HitAreas\": [\n\t\t{ \"Id\": \"HitAreaHead\", \"Name\": \"Head\" },\n"
+         "\t\t{ \"Id\": \"HitAreaBody\", \"Name\": \"\" }\n\t]\n}\n";
+    return s;
+}
+
+// 每条曲线 8 段, 线性与贝塞尔交替, 4 秒循环
+static std::string motionJson(const SynthConfig& cfg) {
+    const int segments = 8;
+    const float duration = 4.f;
+    std::string curves;
+    for (uint32_t c = 0; c < cfg.motionCurves; c++) {
+        uint32_t p = synthMotionParameter(cfg, c);
+        float mn, mx;
+        synthParameterRange(p, mn, mx);
+        auto value = [&](int k) {
+            return mn + (mx - mn) * (0.5f + 0.5f * sinf(k * 0.785f + c * 1.3f));
+        };
+        appendf(curves, "%s\t\t{\n\t\t\t\"Target\": \"Parameter\",\n\t\t\t\"Id\": \"%s\",\n\t\t\t\"Segments\": [%g, %g",
+                c ? ",\n" : "", synthParameterId(p).c_str(), 0.f, value(0));
+        for (int k = 1; k <= segments; k++) {
+            float t0 = duration * (k - 1) / segments, t1 = duration * k / segments;
+            float v0 = value(k - 1), v1 = (k == segments) ? value(0) : value(k);
+            if (k % 2) appendf(curves, ", 0, %g, %g", t1, v1);
+            else appendf(curves, ", 1, %g, %g, %g, %g, %g, %g",
+                         t0 + (t1 - t0) / 3, v0, t1 - (t1 - t0) / 3, v1, t1, v1);
+        }
+        curves += "]\n\t\t}";
+    }
+    std::string s;
+    appendf(s, "{\n\t\"Version\": 3,\n\t\"Meta\": {\n\t\t\"Duration\": %g,\n\t\t\"Fps\": 30.0,\n"
+               "\t\t\"FadeInTime\": 0.5,\n\t\t\"FadeOutTime\": 0.5,\n\t\t\"Loop\": true,\n"
+               "\t\t\"CurveCount\": %u\n\t},\n\t\"Curves\": [\n", duration, cfg.motionCurves);
+    s += curves;
+    s += "\n\t]\n}\n";
+    return s;
+}
+
+// 每个表情对 4 个参数做 Add 偏移
+static std::string expressionJson(const SynthConfig& cfg, uint32_t index) {
+    std::string s = "{\n\t\"Type\": \"Live2D Expression\",\n\t\"Parameters\": [\n";
+    for (uint32_t k = 0; k < 4; k++) {
+        uint32_t p = (index * 4 + k) % cfg.params;
+        float mn, mx;
+        synthParameterRange(p, mn, mx);
+        appendf(s, "\t\t{ \"Id\": \"%s\", \"Value\": %g, \"Blend\": \"Add\" }%s\n",
+                synthParameterId(p).c_str(), (mx - mn) * 0.25f, k < 3 ? "," : "");
+    }
+    s += "\t]\n}\n";
+    return s;
+}
+
+// Each setting: a pendulum chain driven by ParamAngleX/ParamAngleZ/ParamBodyAngleX,
+// every particle after the root writes one output parameter.
+static std::string physicsJson(const SynthConfig& cfg) {
+    std::string s;
+    appendf(s, "{\n\t\"Version\": 3,\n\t\"Meta\": {\n\t\t\"PhysicsSettingCount\": %u,\n\t\t\"Fps\": 30,\n"
+               "\t\t\"EffectiveForces\": {\n\t\t\t\"Gravity\": {\n\t\t\t\t\"X\": 0,\n\t\t\t\t\"Y\": -1\n\t\t\t},\n"
+               "\t\t\t\"Wind\": {\n\t\t\t\t\"X\": 0,\n\t\t\t\t\"Y\": 0\n\t\t\t}\n\t\t}\n\t},\n"
+               "\t\"PhysicsSettings\": [\n", cfg.physicsSettings);
+    const char* inputs[][2] = {{"ParamAngleX", "X"}, {"ParamAngleZ", "Angle"}, {"ParamBodyAngleX", "X"}};
+    for (uint32_t st = 0; st < cfg.physicsSettings; st++) {
+        appendf(s, "\t\t{\n\t\t\t\"Id\": \"PhysicsSetting%u\",\n\t\t\t\"Input\": [\n", st + 1);
+        for (int i = 0; i < 3; i++) {
+            appendf(s, "\t\t\t\t{\n\t\t\t\t\t\"Source\": {\n\t\t\t\t\t\t\"Target\": \"Parameter\",\n"
+                       "\t\t\t\t\t\t\"Id\": \"%s\"\n\t\t\t\t\t},\n\t\t\t\t\t\"Weight\": %d,\n"
+                       "\t\t\t\t\t\"Type\": \"%s\",\n\t\t\t\t\t\"Reflect\": false\n\t\t\t\t}%s\n",
+                    inputs[i][0], i == 2 ? 40 : 60, inputs[i][1], i < 2 ? "," : "");
+        }
+        s += "\t\t\t],\n\t\t\t\"Output\": [\n";
+        for (uint32_t k = 1; k < cfg.physicsChain; k++) {
+            appendf(s, "\t\t\t\t{\n\t\t\t\t\t\"Destination\": {\n\t\t\t\t\t\t\"Target\": \"Parameter\",\n"
+                       "\t\t\t\t\t\t\"Id\": \"%s\"\n\t\t\t\t\t},\n\t\t\t\t\t\"VertexIndex\": %u,\n"
+                       "\t\t\t\t\t\"Scale\": 1.5,\n\t\t\t\t\t\"Weight\": 100,\n\t\t\t\t\t\"Type\": \"Angle\",\n"
+                       "\t\t\t\t\t\"Reflect\": false\n\t\t\t\t}%s\n",
+                    synthParameterId(synthPhysicsParameter(cfg, st, k)).c_str(), k,
+                    k + 1 < cfg.physicsChain ? "," : "");
+        }
+        s += "\t\t\t],\n\t\t\t\"Vertices\": [\n";
+        for (uint32_t k = 0; k < cfg.physicsChain; k++) {
+            appendf(s, "\t\t\t\t{\n\t\t\t\t\t\"Position\": {\n\t\t\t\t\t\t\"X\": 0,\n\t\t\t\t\t\t\"Y\": %u\n"
+                       "\t\t\t\t\t},\n\t\t\t\t\t\"Mobility\": %g,\n\t\t\t\t\t\"Delay\": %g,\n"
+                       "\t\t\t\t\t\"Acceleration\": %g,\n\t\t\t\t\t\"Radius\": %u\n\t\t\t\t}%s\n",
+                    k * 8, k ? 0.95 : 1.0, k ? 0.8 : 1.0, k ? 1.5 : 1.0, k ? 8u : 0u,
+                    k + 1 < cfg.physicsChain ? "," : "");
+        }
+        s += "\t\t\t],\n\t\t\t\"Normalization\": {\n"
+             "\t\t\t\t\"Position\": {\n\t\t\t\t\t\"Minimum\": -10,\n\t\t\t\t\t\"Default\": 0,\n\t\t\t\t\t\"Maximum\": 10\n\t\t\t\t},\n"
+             "\t\t\t\t\"Angle\": {\n\t\t\t\t\t\"Minimum\": -10,\n\t\t\t\t\t\"Default\": 0,\n\t\t\t\t\t\"Maximum\": 10\n\t\t\t\t}\n"
+             "\t\t\t}\n";
+        appendf(s, "\t\t}%s\n", st + 1 < cfg.physicsSettings ? "," : "");
+    }
+    s += "\t]\n}\n";
+    return s;
+}
+
+// ===================== Main =====================
+
+static void usage() {
+    fprintf(stderr,
+            "usage: live2d_synth <outdir> [--drawables N] [--verts N] [--masked N] [--mask-fanout N]\n"
+            "                    [--textures N] [--texture-size PX] [--params N] [--parts N]\n"
+            "                    [--motion-curves N] [--physics-settings N] [--physics-chain N] [--seed N]\n"
+            "                    [--expressions N] [--costume-textures N] [--tinted N] [--inverted-masks N]\n");
+}
+
+int main(int argc, char** argv) {
+    SynthConfig cfg;
+    uint32_t expressions = 0;   // 不影响 moc, 不放进 SynthConfig
+    const char* outDir = nullptr;
+    struct Option { const char* name; uint32_t* value; } options[] = {
+        {"--drawables", &cfg.drawables}, {"--verts", &cfg.vertsPerDrawable},
+        {"--masked", &cfg.maskedDrawables}, {"--mask-fanout", &cfg.maskFanout},
+        {"--textures", &cfg.textures}, {"--texture-size", &cfg.textureSize},
+        {"--params", &cfg.params}, {"--parts", &cfg.parts},
+        {"--motion-curves", &cfg.motionCurves}, {"--physics-settings", &cfg.physicsSettings},
+        {"--physics-chain", &cfg.physicsChain}, {"--seed", &cfg.seed},
+        {"--expressions", &expressions}, {"--costume-textures", &cfg.costumeTextures},
+        {"--tinted", &cfg.tintedDrawables}, {"--inverted-masks", &cfg.invertedMasks},
+    };
+    for (int i = 1; i < argc; i++) {
+        bool matched = false;
+        for (auto& o : options) {
+            if (strcmp(argv[i], o.name) || i + 1 >= argc) continue;
+            char* end;
+            long v = strtol(argv[++i], &end, 10);
+            if (*end || v < 0) { usage(); return 2; }
+            *o.value = (uint32_t)v;
+            matched = true;
+            break;
+        }
+        if (matched) continue;
+        if (argv[i][0] != '-' && !outDir) outDir = argv[i];
+        else { usage(); return 2; }
+    }
+    if (!outDir || !cfg.drawables || !cfg.params || !cfg.parts || !cfg.textures || cfg.textureSize < 4) {
+        usage();
+        return 2;
+    }
+    if (cfg.textureSize > 8192) { fprintf(stderr, "--texture-size must be <= 8192\n"); return 2; }
+    if (cfg.costumeTextures >= cfg.textures) { fprintf(stderr, "--costume-textures must be < --textures\n"); return 2; }
+
+    std::string dir = outDir;
+    mkdir(dir.c_str(), 0755);
+    mkdir((dir + "/textures").c_str(), 0755);
+    mkdir((dir + "/motions").c_str(), 0755);
+    if (expressions) mkdir((dir + "/expressions").c_str(), 0755);
+
+    bool physics = cfg.physicsSettings > 0 && cfg.physicsChain >= 2;
+    auto moc = encodeSynthMoc(cfg);
+    if (!writeFile(dir + "/synth.moc3", moc.data(), moc.size())) return 1;
+    if (!writeText(dir + "/synth.model3.json", modelJson(cfg, physics, expressions))) return 1;
+    if (!writeText(dir + "/motions/idle.motion3.json", motionJson(cfg))) return 1;
+    if (physics && !writeText(dir + "/synth.physics3.json", physicsJson(cfg))) return 1;
+    for (uint32_t e = 0; e < expressions; e++) {
+        char name[64];
+        snprintf(name, sizeof(name), "/expressions/exp_%02u.exp3.json", e);
+        if (!writeText(dir + name, expressionJson(cfg, e))) return 1;
+    }
+    for (uint32_t t = 0; t < cfg.textures; t++) {
+        char name[64];
+        snprintf(name, sizeof(name), "/textures/texture_%02u.png", t);
+        if (!writePng(dir + name, makeTexture((int)cfg.textureSize, (int)t), (int)cfg.textureSize, (int)cfg.textureSize)) {
+            fprintf(stderr, "Cannot write %s%s\n", dir.c_str(), name);
+            return 1;
+        }
+    }
+
+    int g = synthGridSize(cfg);
+    printf("%s/synth.model3.json: %u drawables x %d verts, %u clipped x %u masks, %u textures (%upx), "
+           "%u params, %u parts, %u curves, %u physics x %u, %u expressions, %u costume textures, "
+           "%u tinted, %u inverted masks\n",
+           dir.c_str(), cfg.drawables, g * g, synthClippedCount(cfg), cfg.maskFanout, cfg.textures,
+           cfg.textureSize, cfg.params, cfg.parts, cfg.motionCurves, physics ? cfg.physicsSettings : 0,
+           cfg.physicsChain, expressions, cfg.costumeTextures, cfg.tintedDrawables, cfg.invertedMasks);
+    return 0;
+}
@@ -0,0 +1,399 @@
+// Stand-in Cubism Core for host builds: implements the Core C API for the
+// synthetic mocs written by live2d_synth (see synth_model.h). Real .moc3 files
+// are rejected by csmHasMocConsistency.
+//
+// Like the real Core, a model lives entirely inside the caller's buffer
+// (csmGetSizeofModel bytes) and csmUpdateModel never allocates.
+//
+// Geometry: drawable d is a grid mesh placed pseudo-randomly on a 2x2 unit
+// canvas. It is bent by parameter d % params plus ParamAngleX/ParamAngleY, and
+// its opacity follows part d % parts (times ParamCostume on costume textures). Dynamic flags report real changes only,
+// so a model whose parameters hold still produces no VertexPositionsDidChange.
+// Multiply / screen colors (synthTint) and inverted masks are constant.
+
+#include "Live2DCubismCore.h"
+#include "synth_model.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace {
+
+struct SynthModel {
+    SynthConfig cfg;
+    int grid;
+    int vertsPer;
+    int indicesPer;
+
+    // Parameters
+    const char** paramIds;
+    csmParameterType* paramTypes;
+    float* paramMin;
+    float* paramMax;
+    float* paramDef;
+    float* paramVal;
+    float* paramLast;       // values seen by the previous csmUpdateModel
+    int* paramRepeats;
+    int* paramKeyCounts;
+    const float** paramKeyValues;
+
+    // Parts
+    const char** partIds;
+    float* partOpacities;
+    int* partParents;
+
+    // Drawables
+    const char** drawableIds;
+    csmFlags* constFlags;
+    csmFlags* dynFlags;
+    int* textureIndices;
+    int* drawOrders;
+    int* renderOrders;
+    float* opacities;
+    int* maskCounts;
+    const int** masks;
+    int* vertexCounts;
+    csmVector2* basePositions;          // drawables * vertsPer
+    csmVector2* positionStore;
+    const csmVector2** positions;
+    const csmVector2** uvs;
+    int* indexCounts;
+    const unsigned short** indices;
+    csmVector4* multiplyColors;
+    csmVector4* screenColors;
+    int* parentParts;
+    float* centers;                     // x, y, size per drawable
+    bool first;
+};
+
+// Carves arrays out of a caller-provided buffer; with base == nullptr it only measures.
+struct Carver {
+    uint8_t* base;
+    size_t used;
+
+    template <class T> T* take(size_t n) {
+        used = (used + alignof(T) - 1) & ~(alignof(T) - 1);
+        T* p = base ? (T*)(base + used) : nullptr;
+        used += n * sizeof(T);
+        return p;
+    }
+    char* string(const char* s) {
+        size_t n = strlen(s) + 1;
+        char* p = take<char>(n);
+        if (p) memcpy(p, s, n);
+        return p;
+    }
+};
+
+uint32_t hash32(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352dU;
+    x ^= x >> 15; x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+float unit(uint32_t seed, uint32_t i, uint32_t salt) {
+    return (hash32(seed * 0x9E3779B9U ^ i * 0x85EBCA6BU ^ salt) & 0xFFFFFF) / (float)0x1000000;
+}
+
+// Lays out (and with base != nullptr, fills) a model. Returns the bytes needed.
+size_t buildModel(const SynthConfig& cfg, uint8_t* base) {
+    Carver c{base, 0};
+    SynthModel* m = c.take<SynthModel>(1);
+    const int dc = (int)cfg.drawables, pc = (int)synthParameterCount(cfg), parts = (int)cfg.parts;
+    const int g = synthGridSize(cfg);
+    const int vpd = g * g, ipd = (g - 1) * (g - 1) * 6;
+    const uint32_t clipped = synthClippedCount(cfg);
+
+    // 测量阶段 (base == nullptr) 把指针写进 scratch
+    SynthModel scratch{};
+    if (m) new (m) SynthModel();
+    SynthModel* w = m ? m : &scratch;
+    w->cfg = cfg; w->grid = g; w->vertsPer = vpd; w->indicesPer = ipd; w->first = true;
+
+    // Parameters
+    w->paramIds = c.take<const char*>(pc);
+    w->paramTypes = c.take<csmParameterType>(pc);
+    w->paramMin = c.take<float>(pc);
+    w->paramMax = c.take<float>(pc);
+    w->paramDef = c.take<float>(pc);
+    w->paramVal = c.take<float>(pc);
+    w->paramLast = c.take<float>(pc);
+    w->paramRepeats = c.take<int>(pc);
+    w->paramKeyCounts = c.take<int>(pc);
+    w->paramKeyValues = c.take<const float*>(pc);
+    for (int i = 0; i < pc; i++) {
+        bool costume = i >= (int)cfg.params;
+        char* id = c.string(costume ? kSynthCostumeParam : synthParameterId(i).c_str());
+        if (!m) continue;
+        float mn = 0.f, mx = 1.f;
+        if (!costume) synthParameterRange(i, mn, mx);
+        m->paramIds[i] = id;
+        m->paramTypes[i] = csmParameterType_Normal;
+        m->paramMin[i] = mn; m->paramMax[i] = mx;
+        m->paramDef[i] = m->paramVal[i] = m->paramLast[i] = 0.f;
+        m->paramRepeats[i] = 0;
+        m->paramKeyCounts[i] = 0;
+        m->paramKeyValues[i] = nullptr;
+    }
+
+    // Parts
+    w->partIds = c.take<const char*>(parts);
+    w->partOpacities = c.take<float>(parts);
+    w->partParents = c.take<int>(parts);
+    for (int i = 0; i < parts; i++) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "PartSynth%02d", i);
+        char* id = c.string(buf);
+        if (!m) continue;
+        m->partIds[i] = id;
+        m->partOpacities[i] = 1.f;
+        m->partParents[i] = -1;
+    }
+
+    // Drawables
+    w->drawableIds = c.take<const char*>(dc);
+    w->constFlags = c.take<csmFlags>(dc);
+    w->dynFlags = c.take<csmFlags>(dc);
+    w->textureIndices = c.take<int>(dc);
+    w->drawOrders = c.take<int>(dc);
+    w->renderOrders = c.take<int>(dc);
+    w->opacities = c.take<float>(dc);
+    w->maskCounts = c.take<int>(dc);
+    w->masks = c.take<const int*>(dc);
+    w->vertexCounts = c.take<int>(dc);
+    w->basePositions = c.take<csmVector2>((size_t)dc * vpd);
+    w->positionStore = c.take<csmVector2>((size_t)dc * vpd);
+    w->positions = c.take<const csmVector2*>(dc);
+    w->uvs = c.take<const csmVector2*>(dc);
+    w->indexCounts = c.take<int>(dc);
+    w->indices = c.take<const unsigned short*>(dc);
+    w->multiplyColors = c.take<csmVector4>(dc);
+    w->screenColors = c.take<csmVector4>(dc);
+    w->parentParts = c.take<int>(dc);
+    w->centers = c.take<float>((size_t)dc * 3);
+
+    // 所有 drawable 共用同一份三角形索引
+    unsigned short* sharedIndices = c.take<unsigned short>(ipd);
+    if (m) {
+        unsigned short* ix = sharedIndices;
+        for (int y = 0; y < g - 1; y++)
+            for (int x = 0; x < g - 1; x++) {
+                unsigned short i0 = (unsigned short)(y * g + x);
+                *ix++ = i0; *ix++ = (unsigned short)(i0 + 1); *ix++ = (unsigned short)(i0 + g);
+                *ix++ = (unsigned short)(i0 + 1); *ix++ = (unsigned short)(i0 + g + 1); *ix++ = (unsigned short)(i0 + g);
+            }
+    }
+
+    // Clip lists: each clipped drawable is masked by the maskFanout drawables before it
+    int* maskStore = c.take<int>((size_t)clipped * cfg.maskFanout);
+    if (m) for (int d = 0; d < dc; d++) { m->maskCounts[d] = 0; m->masks[d] = nullptr; }
+    for (uint32_t k = 0; k < clipped; k++) {
+        if (!m) continue;
+        uint32_t d = synthClippedDrawable(cfg, k);
+        int* list = maskStore + (size_t)k * cfg.maskFanout;
+        for (uint32_t j = 0; j < cfg.maskFanout; j++) list[j] = (int)(d - 1 - j);
+        m->maskCounts[d] = (int)cfg.maskFanout;
+        m->masks[d] = list;
+    }
+
+    const int atlasCells = 4;  // 每张纹理按 4x4 网格分给不同 drawable
+    for (int d = 0; d < dc; d++) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "ArtMeshSynth%04d", d);
+        char* id = c.string(buf);
+        csmVector2* uv = c.take<csmVector2>(vpd);
+        if (!m) continue;
+
+        m->drawableIds[d] = id;
+        csmFlags flags = csmIsDoubleSided;
+        if (d % 29 == 11) flags |= csmBlendAdditive;
+        else if (d % 31 == 17) flags |= csmBlendMultiplicative;
+        m->constFlags[d] = flags;
+        m->dynFlags[d] = csmIsVisible;
+        m->textureIndices[d] = d % (int)cfg.textures;
+        m->drawOrders[d] = 500;
+        m->renderOrders[d] = d;
+        m->opacities[d] = 1.f;
+        m->vertexCounts[d] = vpd;
+        m->indexCounts[d] = ipd;
+        m->indices[d] = sharedIndices;
+        int tint = synthTint(cfg, (uint32_t)d);
+        m->multiplyColors[d] = (tint & kSynthTintMultiply) ? csmVector4{0.85f, 0.7f, 1.f, 1.f} : csmVector4{1.f, 1.f, 1.f, 1.f};
+        m->screenColors[d] = (tint & kSynthTintScreen) ? csmVector4{0.2f, 0.1f, 0.f, 1.f} : csmVector4{0.f, 0.f, 0.f, 1.f};
+        m->parentParts[d] = d % parts;
+
+        float size = 0.15f + 0.35f * unit(cfg.seed, d, 1);
+        float cx = -0.8f + 1.6f * unit(cfg.seed, d, 2);
+        float cy = -0.8f + 1.6f * unit(cfg.seed, d, 3);
+        m->centers[d * 3] = cx; m->centers[d * 3 + 1] = cy; m->centers[d * 3 + 2] = size;
+
+        int cell = (d / (int)cfg.textures) % (atlasCells * atlasCells);
+        float u0 = (cell % atlasCells) / (float)atlasCells, v0 = (cell / atlasCells) / (float)atlasCells;
+        csmVector2* bp = m->basePositions + (size_t)d * vpd;
+        for (int y = 0; y < g; y++)
+            for (int x = 0; x < g; x++) {
+                float fx = x / (float)(g - 1), fy = y / (float)(g - 1);
+                bp[y * g + x] = {cx + (fx - 0.5f) * size, cy + (fy - 0.5f) * size};
+                uv[y * g + x] = {u0 + fx / atlasCells, v0 + (1.f - fy) / atlasCells};
+            }
+        memcpy(m->positionStore + (size_t)d * vpd, bp, sizeof(csmVector2) * vpd);
+        m->positions[d] = m->positionStore + (size_t)d * vpd;
+        m->uvs[d] = uv;
+    }
+    for (uint32_t k = 0; m && k < clipped && k < cfg.invertedMasks; k++)
+        m->constFlags[synthClippedDrawable(cfg, k)] |= csmIsInvertedMask;
+    return c.used;
+}
+
+SynthModel* synth(const csmModel* model) { return (SynthModel*)model; }
+
+csmLogFunction g_logFunction = nullptr;
+
+void coreLog(const char* msg) { if (g_logFunction) g_logFunction(msg); }
+
+}
+
+extern "C" {
+
+csmVersion csmGetVersion() { return 0x05000000; }
+csmMocVersion csmGetLatestMocVersion() { return csmMocVersion_50; }
+
+csmMocVersion csmGetMocVersion(const void* address, const unsigned int size) {
+    SynthConfig cfg;
+    return decodeSynthMoc(address, size, cfg) ? csmMocVersion_50 : csmMocVersion_Unknown;
+}
+
+int csmHasMocConsistency(void* address, const unsigned int size) {
+    SynthConfig cfg;
+    if (decodeSynthMoc(address, size, cfg)) return 1;
+    coreLog("[synth core] not a synthetic moc (generate one with live2d_synth)");
+    return 0;
+}
+
+csmLogFunction csmGetLogFunction() { return g_logFunction; }
+void csmSetLogFunction(csmLogFunction handler) { g_logFunction = handler; }
+
+csmMoc* csmReviveMocInPlace(void* address, const unsigned int size) {
+    SynthConfig cfg;
+    return decodeSynthMoc(address, size, cfg) ? (csmMoc*)address : nullptr;
+}
+
+unsigned int csmGetSizeofModel(const csmMoc* moc) {
+    SynthConfig cfg;
+    decodeSynthMoc(moc, 16 + sizeof(SynthConfig), cfg);
+    return (unsigned int)buildModel(cfg, nullptr);
+}
+
+csmModel* csmInitializeModelInPlace(const csmMoc* moc, void* address, const unsigned int size) {
+    SynthConfig cfg;
+    if (!decodeSynthMoc(moc, 16 + sizeof(SynthConfig), cfg)) return nullptr;
+    if (buildModel(cfg, nullptr) > size) return nullptr;
+    buildModel(cfg, (uint8_t*)address);
+    return (csmModel*)address;
+}
+
+void csmUpdateModel(csmModel* model) {
+    SynthModel& m = *synth(model);
+    const int dc = (int)m.cfg.drawables, pc = (int)m.cfg.params, g = m.grid;
+    const int costumeParam = m.cfg.costumeTextures ? pc : -1;
+    float costume = costumeParam >= 0 ? fminf(fmaxf(m.paramVal[costumeParam], 0.f), 1.f) : 1.f;
+
+    auto norm = [&](int p) {
+        float range = m.paramMax[p] - m.paramMin[p];
+        return range > 0.f ? (m.paramVal[p] - m.paramDef[p]) / range : 0.f;
+    };
+    auto changed = [&](int p) { return m.first || m.paramVal[p] != m.paramLast[p]; };
+
+    // ParamAngleX / ParamAngleY move everything, like a head/body deformer
+    const int angX = pc > 0 ? 0 : -1, angY = pc > 1 ? 1 : -1;
+    bool globalChanged = (angX >= 0 && changed(angX)) || (angY >= 0 && changed(angY));
+    float gx = angX >= 0 ? norm(angX) * 0.1f : 0.f;
+    float gy = angY >= 0 ? norm(angY) * 0.1f : 0.f;
+
+    for (int d = 0; d < dc; d++) {
+        csmFlags dyn = m.dynFlags[d] & csmIsVisible;
+
+        int p = d % pc;
+        if (globalChanged || changed(p)) {
+            float bend = norm(p) * m.centers[d * 3 + 2] * 0.5f;
+            float cy = m.centers[d * 3 + 1];
+            const csmVector2* bp = m.basePositions + (size_t)d * m.vertsPer;
+            csmVector2* out = m.positionStore + (size_t)d * m.vertsPer;
+            for (int v = 0; v < m.vertsPer; v++) {
+                float t = bp[v].Y - cy;
+                out[v].X = bp[v].X + gx + bend * t * t * 4.f;
+                out[v].Y = bp[v].Y + gy + bend * 0.1f * (float)(v % g) / g;
+            }
+            dyn |= csmVertexPositionsDidChange;
+        }
+
+        float opacity = m.partOpacities[m.parentParts[d]];
+        if (costumeParam >= 0 && synthCostumeTexture(m.cfg, (uint32_t)m.textureIndices[d])) opacity *= costume;
+        if (opacity != m.opacities[d] || m.first) {
+            dyn |= csmOpacityDidChange;
+            bool visible = opacity > 0.f;
+            if (visible != ((dyn & csmIsVisible) != 0)) dyn |= csmVisibilityDidChange;
+            dyn = visible ? (dyn | csmIsVisible) : (dyn & ~csmIsVisible);
+            m.opacities[d] = opacity;
+        }
+        if (m.first) dyn |= csmDrawOrderDidChange | csmRenderOrderDidChange | csmBlendColorDidChange;
+        m.dynFlags[d] = dyn;
+    }
+    memcpy(m.paramLast, m.paramVal, sizeof(float) * pc);
+    m.first = false;
+}
+
+void csmReadCanvasInfo(const csmModel* model, csmVector2* outSizeInPixels, csmVector2* outOriginInPixels,
+                       float* outPixelsPerUnit) {
+    (void)model;
+    // 2x2 单位画布, 原点在中心
+    outSizeInPixels->X = 2048.f; outSizeInPixels->Y = 2048.f;
+    outOriginInPixels->X = 1024.f; outOriginInPixels->Y = 1024.f;
+    *outPixelsPerUnit = 1024.f;
+}
+
+int csmGetParameterCount(const csmModel* model) { return (int)synthParameterCount(synth(model)->cfg); }
+const char** csmGetParameterIds(const csmModel* model) { return synth(model)->paramIds; }
+const csmParameterType* csmGetParameterTypes(const csmModel* model) { return synth(model)->paramTypes; }
+const float* csmGetParameterMinimumValues(const csmModel* model) { return synth(model)->paramMin; }
+const float* csmGetParameterMaximumValues(const csmModel* model) { return synth(model)->paramMax; }
+const float* csmGetParameterDefaultValues(const csmModel* model) { return synth(model)->paramDef; }
+float* csmGetParameterValues(csmModel* model) { return synth(model)->paramVal; }
+const int* csmGetParameterRepeats(const csmModel* model) { return synth(model)->paramRepeats; }
+const int* csmGetParameterKeyCounts(const csmModel* model) { return synth(model)->paramKeyCounts; }
+const float** csmGetParameterKeyValues(const csmModel* model) { return synth(model)->paramKeyValues; }
+
+int csmGetPartCount(const csmModel* model) { return (int)synth(model)->cfg.parts; }
+const char** csmGetPartIds(const csmModel* model) { return synth(model)->partIds; }
+float* csmGetPartOpacities(csmModel* model) { return synth(model)->partOpacities; }
+const int* csmGetPartParentPartIndices(const csmModel* model) { return synth(model)->partParents; }
+
+int csmGetDrawableCount(const csmModel* model) { return (int)synth(model)->cfg.drawables; }
+const char** csmGetDrawableIds(const csmModel* model) { return synth(model)->drawableIds; }
+const csmFlags* csmGetDrawableConstantFlags(const csmModel* model) { return synth(model)->constFlags; }
+const csmFlags* csmGetDrawableDynamicFlags(const csmModel* model) { return synth(model)->dynFlags; }
+const int* csmGetDrawableTextureIndices(const csmModel* model) { return synth(model)->textureIndices; }
+const int* csmGetDrawableDrawOrders(const csmModel* model) { return synth(model)->drawOrders; }
+const int* csmGetDrawableRenderOrders(const csmModel* model) { return synth(model)->renderOrders; }
+const float* csmGetDrawableOpacities(const csmModel* model) { return synth(model)->opacities; }
+const int* csmGetDrawableMaskCounts(const csmModel* model) { return synth(model)->maskCounts; }
+const int** csmGetDrawableMasks(const csmModel* model) { return synth(model)->masks; }
+const int* csmGetDrawableVertexCounts(const csmModel* model) { return synth(model)->vertexCounts; }
+const csmVector2** csmGetDrawableVertexPositions(const csmModel* model) { return synth(model)->positions; }
+const csmVector2** csmGetDrawableVertexUvs(const csmModel* model) { return synth(model)->uvs; }
+const int* csmGetDrawableIndexCounts(const csmModel* model) { return synth(model)->indexCounts; }
+const unsigned short** csmGetDrawableIndices(const csmModel* model) { return synth(model)->indices; }
+const csmVector4* csmGetDrawableMultiplyColors(const csmModel* model) { return synth(model)->multiplyColors; }
+const csmVector4* csmGetDrawableScreenColors(const csmModel* model) { return synth(model)->screenColors; }
+const int* csmGetDrawableParentPartIndices(const csmModel* model) { return synth(model)->parentParts; }
+
+void csmResetDrawableDynamicFlags(csmModel* model) {
+    SynthModel& m = *synth(model);
+    for (uint32_t d = 0; d < m.cfg.drawables; d++) m.dynFlags[d] &= csmIsVisible;
+}
+
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+// Synthetic Live2D workloads for scaling benchmarks.
+//
+// A synthetic model is an ordinary model3.json directory (textures, idle
+// motion, physics) whose .moc3 is a small "L2DSYNTH" blob carrying a
+// SynthConfig instead of real moc data. synth_core.cpp implements the Cubism
+// Core C API on top of that blob and builds the geometry at
+// csmInitializeModelInPlace, so the unmodified renderer can load it on hosts
+// without the proprietary Core. live2d_synth writes such directories.
+//
+// Everything derived from the config (parameter ids, which drawables are
+// clipped, physics outputs) is defined here so the generator and the core agree.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct SynthConfig {
+    uint32_t drawables = 200;
+    uint32_t vertsPerDrawable = 64;   // rounded to a square grid
+    uint32_t maskedDrawables = 20;    // drawables that are clipped
+    uint32_t maskFanout = 1;          // mask drawables per clipped drawable
+    uint32_t textures = 1;
+    uint32_t textureSize = 1024;
+    uint32_t params = 50;
+    uint32_t parts = 20;
+    uint32_t motionCurves = 30;
+    uint32_t physicsSettings = 4;
+    uint32_t physicsChain = 3;        // particles per physics setting (incl. the root)
+    uint32_t seed = 1;
+    uint32_t costumeTextures = 0;     // trailing textures whose drawables are shown by ParamCostume
+    uint32_t tintedDrawables = 0;     // drawables with a non-identity multiply and/or screen color
+    uint32_t invertedMasks = 0;       // clipped drawables (the first ones) whose mask is inverted
+};
+
+static const char kSynthMocMagic[8] = {'L', '2', 'D', 'S', 'Y', 'N', 'T', 'H'};
+static const uint32_t kSynthMocVersion = 1;
+static const uint32_t kSynthConfigWords = sizeof(SynthConfig) / sizeof(uint32_t);
+
+// moc blob: magic, u32 version, u32 word count, SynthConfig words (host endian, host-only format)
+inline std::vector<uint8_t> encodeSynthMoc(const SynthConfig& cfg) {
+    std::vector<uint8_t> out(16 + sizeof(SynthConfig));
+    memcpy(out.data(), kSynthMocMagic, 8);
+    memcpy(out.data() + 8, &kSynthMocVersion, 4);
+    memcpy(out.data() + 12, &kSynthConfigWords, 4);
+    memcpy(out.data() + 16, &cfg, sizeof(SynthConfig));
+    return out;
+}
+
+inline bool decodeSynthMoc(const void* data, size_t size, SynthConfig& cfg) {
+    const uint8_t* p = (const uint8_t*)data;
+    if (size < 16 || memcmp(p, kSynthMocMagic, 8) != 0) return false;
+    uint32_t version, words;
+    memcpy(&version, p + 8, 4);
+    memcpy(&words, p + 12, 4);
+    if (version != kSynthMocVersion || words != kSynthConfigWords || size < 16 + sizeof(SynthConfig)) return false;
+    memcpy(&cfg, p + 16, sizeof(SynthConfig));
+    return cfg.drawables > 0 && cfg.params > 0 && cfg.parts > 0 && cfg.textures > 0;
+}
+
+/** Vertices per row of a drawable's grid (the mesh has synthGridSize()^2 vertices). */
+inline int synthGridSize(const SynthConfig& cfg) {
+    int g = 2;
+    while ((g + 1) * (g + 1) <= (int)cfg.vertsPerDrawable && (g + 1) * (g + 1) <= 65535) g++;
+    return g;
+}
+
+// 前几个参数使用标准 ID, 以便宿主的口型 / 视线输入和物理输入能作用到合成模型上
+static const char* const kSynthStandardParams[] = {
+    "ParamAngleX", "ParamAngleY", "ParamAngleZ", "ParamBodyAngleX",
+    "ParamEyeBallX", "ParamEyeBallY", "ParamMouthOpenY", "ParamA",
+};
+static const uint32_t kSynthStandardParamCount = sizeof(kSynthStandardParams) / sizeof(kSynthStandardParams[0]);
+
+inline std::string synthParameterId(uint32_t i) {
+    if (i < kSynthStandardParamCount) return kSynthStandardParams[i];
+    char buf[32];
+    snprintf(buf, sizeof(buf), "ParamSynth%03u", i);
+    return buf;
+}
+
+// 换装图集: 最后 costumeTextures 张纹理上的 drawable 不透明度再乘以 ParamCostume (0..1, 默认 0),
+// 它排在 cfg.params 个参数之后, 不受动作 / 物理驱动
+static const char* const kSynthCostumeParam = "ParamCostume";
+
+/** Parameters in the moc: cfg.params, plus ParamCostume when there are costume textures. */
+inline uint32_t synthParameterCount(const SynthConfig& cfg) {
+    return cfg.params + (cfg.costumeTextures ? 1 : 0);
+}
+
+inline bool synthCostumeTexture(const SynthConfig& cfg, uint32_t texture) {
+    return texture + cfg.costumeTextures >= cfg.textures;
+}
+
+// 染色: d % 5 == 2 的 drawable 中前 tintedDrawables 个, 依次只有 multiply、只有 screen、两者都有
+static const int kSynthTintMultiply = 1;
+static const int kSynthTintScreen   = 2;
+
+inline int synthTint(const SynthConfig& cfg, uint32_t d) {
+    if (d % 5 != 2 || d / 5 >= cfg.tintedDrawables) return 0;
+    return (int)(d / 5 % 3) + 1;
+}
+
+/** Range of parameter i: angles +-30, eye ball +-1, mouth 0..1, synthetic params +-1. */
+inline void synthParameterRange(uint32_t i, float& mn, float& mx) {
+    if (i < 4) { mn = -30.f; mx = 30.f; }
+    else if (i < 6) { mn = -1.f; mx = 1.f; }
+    else if (i < kSynthStandardParamCount) { mn = 0.f; mx = 1.f; }
+    else { mn = -1.f; mx = 1.f; }
+}
+
+/** Parameter driven by motion curve c; curves cycle over the non-standard parameters first. */
+inline uint32_t synthMotionParameter(const SynthConfig& cfg, uint32_t c) {
+    uint32_t extra = cfg.params > kSynthStandardParamCount ? cfg.params - kSynthStandardParamCount : 0;
+    return extra ? kSynthStandardParamCount + c % extra : c % cfg.params;
+}
+
+/** Parameter written by particle k (1-based) of physics setting s; taken from the end of the list. */
+inline uint32_t synthPhysicsParameter(const SynthConfig& cfg, uint32_t s, uint32_t k) {
+    uint32_t n = s * (cfg.physicsChain > 1 ? cfg.physicsChain - 1 : 1) + (k - 1);
+    return cfg.params - 1 - n % cfg.params;
+}
+
+/**
+ * Clipped drawable number m (0 <= m < clippedCount) and its masks. Clipped
+ * drawables are spread evenly over the draw order; each is clipped by the
+ * maskFanout drawables directly before it.
+ */
+inline uint32_t synthClippedCount(const SynthConfig& cfg) {
+    if (cfg.maskFanout == 0 || cfg.maskFanout >= cfg.drawables) return 0;
+    uint32_t room = cfg.drawables - cfg.maskFanout;
+    return cfg.maskedDrawables < room ? cfg.maskedDrawables : room;
+}
+
+inline uint32_t synthClippedDrawable(const SynthConfig& cfg, uint32_t m) {
+    uint32_t room = cfg.drawables - cfg.maskFanout;
+    return cfg.maskFanout + (uint32_t)((uint64_t)m * room / synthClippedCount(cfg));
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+// Per-frame bump allocator for scratch data that does not outlive drawFrame().
+//
+// reset() at the start of a frame rewinds the block. A frame that needs more
+// than the block holds gets its overflow from malloc, and the next reset()
+// grows the block to that frame's total, so after the first frames at a given
+// workload the steady state performs no heap allocation at all.
+// Only trivially destructible types: nothing is destroyed on reset.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <type_traits>
+
+class FrameArena {
+public:
+    FrameArena() = default;
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    ~FrameArena() { releaseOverflow(); free(m_block); }
+
+    void reset() {
+        size_t demand = m_used + m_overflowBytes;
+        releaseOverflow();
+        if (demand > m_capacity) {
+            size_t cap = m_capacity ? m_capacity : 4096;
+            while (cap < demand) cap *= 2;
+            free(m_block);
+            m_block = (uint8_t*)malloc(cap);
+            m_capacity = m_block ? cap : 0;
+            m_grows++;
+        }
+        if (m_used + m_overflowBytes > m_highWater) m_highWater = m_used + m_overflowBytes;
+        m_used = 0;
+        m_overflowBytes = 0;
+    }
+
+    template <class T> T* alloc(size_t n) {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameArena never runs destructors");
+        const size_t align = alignof(T) < 16 ? 16 : alignof(T);
+        size_t bytes = n * sizeof(T);
+        size_t start = (m_used + align - 1) & ~(align - 1);
+        if (m_block && start + bytes <= m_capacity) {
+            m_used = start + bytes;
+            return (T*)(m_block + start);
+        }
+        // 超出容量: 本帧临时 malloc, 下一帧 reset() 时扩容
+        if (m_overflowCount == kMaxOverflow) return nullptr;
+        void* p = malloc(bytes ? bytes : 1);
+        if (!p) return nullptr;
+        m_overflow[m_overflowCount++] = p;
+        m_overflowBytes += bytes + align;
+        return (T*)p;
+    }
+
+    // 归还整块内存 (内存紧张时); 之后的帧先走 malloc, 下一次 reset() 重新扩容
+    void release() {
+        releaseOverflow();
+        free(m_block);
+        m_block = nullptr;
+        m_capacity = 0;
+        m_used = 0;
+        m_overflowBytes = 0;
+    }
+
+    size_t used() const { return m_used + m_overflowBytes; }   // bytes handed out this frame
+    size_t capacity() const { return m_capacity; }
+    size_t highWater() const { return m_highWater; }
+    int growCount() const { return m_grows; }
+
+private:
+    static const int kMaxOverflow = 32;
+
+    void releaseOverflow() {
+        for (int i = 0; i < m_overflowCount; i++) free(m_overflow[i]);
+        m_overflowCount = 0;
+    }
+
+    uint8_t* m_block = nullptr;
+    size_t   m_capacity = 0;
+    size_t   m_used = 0;
+    size_t   m_overflowBytes = 0;
+    size_t   m_highWater = 0;
+    int      m_grows = 0;
+    void*    m_overflow[kMaxOverflow] = {};
+    int      m_overflowCount = 0;
+};
@@ -0,0 +1,218 @@
+#include "live2d_bundle.h"
+#include "live2d_log.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __ANDROID__
+#include <android/asset_manager.h>
+#endif
+
+// ===================== Format =====================
+
+static size_t alignUp(size_t v) { return (v + kBundleAlign - 1) & ~(kBundleAlign - 1); }
+
+static int compareName(const char* a, size_t an, const char* b, size_t bn) {
+    int c = memcmp(a, b, std::min(an, bn));
+    if (c != 0) return c;
+    return an < bn ? -1 : an > bn ? 1 : 0;
+}
+
+bool isBundlePath(const std::string& path) {
+    size_t n = sizeof(kBundleExtension) - 1;
+    return path.size() > n && path.compare(path.size() - n, n, kBundleExtension) == 0;
+}
+
+bool parseBundle(uint8_t* data, size_t size, std::vector<BundleEntryView>& entries,
+                 uint32_t* mainEntry, std::string* error) {
+    auto fail = [&](const char* msg) { if (error) *error = msg; return false; };
+    entries.clear();
+    if (size < sizeof(BundleHeader) || memcmp(data, "L2DBUNDL", 8) != 0) return fail("not a model bundle");
+    BundleHeader h;
+    memcpy(&h, data, sizeof(h));
+    if (h.version != kBundleVersion) return fail("unsupported bundle version");
+    if (h.fileSize != size) return fail("bundle size mismatch (truncated?)");
+    if (h.tocOffset > size || h.entryCount > (size - h.tocOffset) / sizeof(BundleTocEntry))
+        return fail("bad table of contents");
+    if (h.stringsOffset > size || h.stringsSize > size - h.stringsOffset) return fail("bad string table");
+    if (h.mainEntry >= h.entryCount) return fail("bad main entry");
+
+    const char* strings = (const char*)data + h.stringsOffset;
+    entries.reserve(h.entryCount);
+    for (uint32_t i = 0; i < h.entryCount; i++) {
+        BundleTocEntry e;
+        memcpy(&e, data + h.tocOffset + i * sizeof(BundleTocEntry), sizeof(e));
+        if (e.nameOffset > h.stringsSize || e.nameLength > h.stringsSize - e.nameOffset) return fail("bad entry name");
+        if (e.offset > size || e.size > size - e.offset || e.offset % kBundleAlign) return fail("bad entry range");
+        if (e.kind > (uint32_t)BundleKind::Motion) return fail("unknown entry kind");
+        BundleEntryView v;
+        v.name = strings + e.nameOffset;
+        v.nameLength = e.nameLength;
+        v.kind = (BundleKind)e.kind;
+        v.data = data + e.offset;
+        v.size = (size_t)e.size;
+        if (!entries.empty() && compareName(entries.back().name, entries.back().nameLength, v.name, v.nameLength) >= 0)
+            return fail("entries not sorted");
+        entries.push_back(v);
+    }
+    if (mainEntry) *mainEntry = h.mainEntry;
+    return true;
+}
+
+bool writeBundle(std::vector<BundleInput> inputs, const std::string& mainName,
+                 std::vector<uint8_t>& out, std::string* error) {
+    auto fail = [&](const std::string& msg) { if (error) *error = msg; return false; };
+    std::sort(inputs.begin(), inputs.end(), [](const BundleInput& a, const BundleInput& b) { return a.name < b.name; });
+    for (size_t i = 1; i < inputs.size(); i++)
+        if (inputs[i].name == inputs[i - 1].name) return fail("duplicate entry " + inputs[i].name);
+    auto mainIt = std::find_if(inputs.begin(), inputs.end(), [&](const BundleInput& in) { return in.name == mainName; });
+    if (mainIt == inputs.end()) return fail("main entry " + mainName + " missing");
+
+    BundleHeader h = {};
+    memcpy(h.magic, "L2DBUNDL", 8);
+    h.version = kBundleVersion;
+    h.entryCount = (uint32_t)inputs.size();
+    h.mainEntry = (uint32_t)(mainIt - inputs.begin());
+    h.tocOffset = alignUp(sizeof(BundleHeader));
+    h.stringsOffset = alignUp(h.tocOffset + inputs.size() * sizeof(BundleTocEntry));
+
+    std::vector<BundleTocEntry> toc(inputs.size());
+    std::string strings;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        toc[i].nameOffset = (uint32_t)strings.size();
+        toc[i].nameLength = (uint32_t)inputs[i].name.size();
+        toc[i].kind = (uint32_t)inputs[i].kind;
+        strings += inputs[i].name;
+    }
+    h.stringsSize = (uint32_t)strings.size();
+    size_t pos = alignUp(h.stringsOffset + strings.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        toc[i].offset = pos;
+        toc[i].size = inputs[i].data.size();
+        pos = alignUp(pos + inputs[i].data.size());
+    }
+    h.fileSize = pos;
+
+    out.assign(pos, 0);
+    memcpy(out.data(), &h, sizeof(h));
+    memcpy(out.data() + h.tocOffset, toc.data(), toc.size() * sizeof(BundleTocEntry));
+    memcpy(out.data() + h.stringsOffset, strings.data(), strings.size());
+    for (size_t i = 0; i < inputs.size(); i++)
+        if (!inputs[i].data.empty()) memcpy(out.data() + toc[i].offset, inputs[i].data.data(), inputs[i].data.size());
+    return true;
+}
+
+// ===================== Open Bundle =====================
+
+static uint8_t* g_bundleBase = nullptr;     // start of the image
+static void*    g_bundleMap = nullptr;      // mmap'd region (page aligned), or null when malloc'd
+static size_t   g_bundleMapSize = 0;
+static size_t   g_bundleSize = 0;
+static std::vector<BundleEntryView> g_bundleEntries;
+static uint32_t g_bundleMain = 0;
+
+// fd 区间 [start, start+len) 私有映射, 返回镜像起点
+static uint8_t* mapRange(int fd, off_t start, size_t len) {
+    long page = sysconf(_SC_PAGESIZE);
+    off_t pageStart = start - start % page;
+    size_t lead = (size_t)(start - pageStart);
+    void* m = mmap(nullptr, len + lead, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, pageStart);
+    if (m == MAP_FAILED) return nullptr;
+    g_bundleMap = m;
+    g_bundleMapSize = len + lead;
+    return (uint8_t*)m + lead;
+}
+
+static bool indexBundle(const std::string& path) {
+    std::string err;
+    if (!parseBundle(g_bundleBase, g_bundleSize, g_bundleEntries, &g_bundleMain, &err)) {
+        LOGE("Bundle %s: %s", path.c_str(), err.c_str());
+        closeBundle();
+        return false;
+    }
+    LOGI("Bundle %s: %zu entries, %zu bytes (%s)", path.c_str(), g_bundleEntries.size(), g_bundleSize,
+         g_bundleMap ? "mapped" : "read");
+    return true;
+}
+
+#ifdef __ANDROID__
+bool openBundle(AAssetManager* mgr, const std::string& path) {
+    closeBundle();
+    if (!mgr) { LOGE("No asset manager: %s", path.c_str()); return false; }
+    AAsset* asset = AAssetManager_open(mgr, path.c_str(), AASSET_MODE_STREAMING);
+    if (!asset) { LOGE("Cannot open asset: %s", path.c_str()); return false; }
+    off64_t start = 0, len = 0;
+    int fd = AAsset_openFileDescriptor64(asset, &start, &len);   // 仅未压缩 (noCompress) 的 asset 可用
+    if (fd >= 0) {
+        g_bundleSize = (size_t)len;
+        g_bundleBase = mapRange(fd, (off_t)start, (size_t)len);
+        close(fd);
+    }
+    if (!g_bundleBase) {
+        // 压缩存储: 读入一块对齐内存
+        g_bundleSize = (size_t)AAsset_getLength64(asset);
+        void* p = nullptr;
+        if (posix_memalign(&p, kBundleAlign, g_bundleSize ? g_bundleSize : 1) != 0) { AAsset_close(asset); return false; }
+        g_bundleBase = (uint8_t*)p;
+        if (AAsset_read(asset, g_bundleBase, g_bundleSize) != (int)g_bundleSize) {
+            LOGE("Cannot read bundle: %s", path.c_str());
+            AAsset_close(asset);
+            closeBundle();
+            return false;
+        }
+    }
+    AAsset_close(asset);
+    return indexBundle(path);
+}
+#else
+bool openBundle(const std::string& path) {
+    closeBundle();
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { LOGE("Cannot open bundle: %s", path.c_str()); return false; }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { close(fd); LOGE("Cannot stat bundle: %s", path.c_str()); return false; }
+    g_bundleSize = (size_t)st.st_size;
+    g_bundleBase = mapRange(fd, 0, g_bundleSize);
+    close(fd);
+    if (!g_bundleBase) { LOGE("Cannot map bundle: %s", path.c_str()); return false; }
+    return indexBundle(path);
+}
+#endif
+
+void closeBundle() {
+    if (g_bundleMap) munmap(g_bundleMap, g_bundleMapSize);
+    else free(g_bundleBase);
+    g_bundleMap = nullptr;
+    g_bundleMapSize = 0;
+    g_bundleBase = nullptr;
+    g_bundleSize = 0;
+    g_bundleEntries.clear();
+    g_bundleMain = 0;
+}
+
+bool bundleOpen() { return g_bundleBase != nullptr; }
+
+size_t bundleBytes(bool* mapped) {
+    if (mapped) *mapped = g_bundleMap != nullptr;
+    return g_bundleSize;
+}
+
+std::string bundleMainEntry() {
+    if (!bundleOpen()) return "";
+    const BundleEntryView& e = g_bundleEntries[g_bundleMain];
+    return std::string(e.name, e.nameLength);
+}
+
+const BundleEntryView* findBundleEntry(const std::string& name) {
+    auto it = std::lower_bound(g_bundleEntries.begin(), g_bundleEntries.end(), name,
+        [](const BundleEntryView& e, const std::string& n) {
+            return compareName(e.name, e.nameLength, n.data(), n.size()) < 0;
+        });
+    if (it == g_bundleEntries.end() || compareName(it->name, it->nameLength, name.data(), name.size()) != 0) return nullptr;
+    return &*it;
+}
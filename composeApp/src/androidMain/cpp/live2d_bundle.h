@@ -0,0 +1,116 @@
+#pragma once
+
+// Single-file model bundle (.l2dbundle): every file a model3.json references,
+// packed by live2d_pack (bench/pack.cpp) so a model loads with one open and
+// one map. Entries keep their model3.json-relative names; the moc and texture
+// payloads are used in place, motions may be stored pre-parsed.
+//
+// Layout (little endian, every section 64-byte aligned):
+//   header  "L2DBUNDL" u32 version, u32 entryCount, u32 mainEntry (model3.json),
+//           u32 stringsSize, u64 tocOffset, u64 stringsOffset, u64 fileSize
+//   toc     entryCount x BundleTocEntry, sorted by name
+//   strings entry names (not terminated)
+//   data    entry payloads
+//
+// The mapping is private and writable: csmReviveMocInPlace() patches the moc
+// section directly, and only the touched pages are copied by the kernel.
+// Offsets are aligned relative to the image; inside an APK the image itself
+// is only 4-byte aligned (zipalign), in which case the loader copies the moc
+// to an aligned buffer and everything else is still used in place.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef __ANDROID__
+struct AAssetManager;
+#endif
+
+static const uint32_t kBundleVersion = 1;
+static const size_t   kBundleAlign   = 64;   // >= csmAlignofMoc
+static const char     kBundleExtension[] = ".l2dbundle";
+
+enum class BundleKind : uint32_t {
+    File = 0,           // file bytes as-is (json, moc3, png)
+    Motion = 1,         // pre-parsed motion3.json, see below
+};
+
+// Pre-parsed motion: f32 duration, fadeIn, fadeOut, u32 loop, u32 curveCount,
+// curveCount x { u32 idOffset, u32 idLength, u32 keyOffset, u32 keyCount }
+// (offsets relative to the entry), then ids and f32 (time, value) keyframes.
+
+struct BundleTocEntry {
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t kind;      // BundleKind
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct BundleHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t mainEntry;
+    uint32_t stringsSize;
+    uint64_t tocOffset;
+    uint64_t stringsOffset;
+    uint64_t fileSize;
+    uint8_t  pad[8];
+};
+static_assert(sizeof(BundleHeader) == 56, "bundle header layout");
+static_assert(sizeof(BundleTocEntry) == 32, "bundle toc layout");
+
+struct BundleEntryView {
+    const char*    name = nullptr;
+    size_t         nameLength = 0;
+    BundleKind     kind = BundleKind::File;
+    uint8_t*       data = nullptr;   // inside the writable private mapping
+    size_t         size = 0;
+};
+
+/** Validate a bundle image; on success entries are views into data. */
+bool parseBundle(uint8_t* data, size_t size, std::vector<BundleEntryView>& entries,
+                 uint32_t* mainEntry, std::string* error = nullptr);
+
+bool isBundlePath(const std::string& path);
+
+// ---- the bundle of the loaded model (GL thread) ----
+
+/** Map a bundle (asset path on Android, filesystem path elsewhere); replaces the open one. */
+#ifdef __ANDROID__
+bool openBundle(AAssetManager* mgr, const std::string& path);
+#else
+bool openBundle(const std::string& path);
+#endif
+
+void closeBundle();
+
+bool bundleOpen();
+
+/** Size of the open bundle image; mapped reports whether it is file-backed (mmap) rather than heap. */
+size_t bundleBytes(bool* mapped = nullptr);
+
+/** Name of the model3.json entry of the open bundle. */
+std::string bundleMainEntry();
+
+/** Look up an entry of the open bundle by its model3.json-relative name. */
+const BundleEntryView* findBundleEntry(const std::string& name);
+
+// ---- writing (live2d_pack) ----
+
+struct BundleInput {
+    std::string          name;
+    BundleKind           kind = BundleKind::File;
+    std::vector<uint8_t> data;
+};
+
+/** Serialize entries (any order) into a bundle image; mainName must be one of them. */
+bool writeBundle(std::vector<BundleInput> inputs, const std::string& mainName,
+                 std::vector<uint8_t>& out, std::string* error = nullptr);
+
+/** Pre-parse a motion3.json into a BundleKind::Motion payload (live2d_renderer.cpp).
+ *  Returns false when the motion has no parameter curves; keep the JSON then. */
+bool bakeMotion3Json(const std::string& json, std::vector<uint8_t>& out);
@@ -0,0 +1,299 @@
+#include "live2d_calltrace.h"
+#include "live2d_renderer.h"
+#include "live2d_log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <unordered_map>
+
+bool g_callRecording = false;
+
+// ===================== Recording =====================
+
+static FILE*  g_traceFile = nullptr;
+static std::vector<uint8_t> g_traceBuf;
+static std::unordered_map<std::string, uint32_t> g_traceStrings;
+static double g_traceStart = 0.0;
+static double g_traceLast = 0.0;      // time of the previous record
+static double g_traceFlushed = 0.0;   // time of the last flush
+
+static double traceNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void putVarint(uint64_t v) {
+    while (v >= 0x80) { g_traceBuf.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+    g_traceBuf.push_back((uint8_t)v);
+}
+
+static void putZigzag(int v) { putVarint(((uint32_t)v << 1) ^ (uint32_t)(v >> 31)); }
+
+static void putFloat(float f) {
+    uint8_t b[4];
+    memcpy(b, &f, 4);
+    g_traceBuf.insert(g_traceBuf.end(), b, b + 4);
+}
+
+static void flushTrace() {
+    if (!g_traceFile || g_traceBuf.empty()) return;
+    if (fwrite(g_traceBuf.data(), 1, g_traceBuf.size(), g_traceFile) != g_traceBuf.size())
+        LOGE("Call trace write failed");
+    fflush(g_traceFile);
+    g_traceBuf.clear();
+}
+
+static void beginRecord(CallOp op) {
+    double now = traceNow();
+    uint64_t deltaUs = (uint64_t)((now - g_traceLast) * 1e6 + 0.5);
+    g_traceLast = now;
+    g_traceBuf.push_back((uint8_t)op);
+    putVarint(deltaUs);
+}
+
+// 首次出现的字符串先写一条 String 记录 (必须在引用它的记录之前), 之后只写编号
+static uint32_t internString(const std::string& s) {
+    auto it = g_traceStrings.find(s);
+    if (it != g_traceStrings.end()) return it->second;
+    uint32_t id = (uint32_t)g_traceStrings.size();
+    g_traceStrings.emplace(s, id);
+    beginRecord(CallOp::String);
+    putVarint(s.size());
+    g_traceBuf.insert(g_traceBuf.end(), s.begin(), s.end());
+    return id;
+}
+
+bool startCallRecording(const std::string& path) {
+    stopCallRecording();
+    g_traceFile = fopen(path.c_str(), "wb");
+    if (!g_traceFile) { LOGE("Cannot open call trace: %s", path.c_str()); return false; }
+    g_traceBuf.clear();
+    g_traceStrings.clear();
+    g_traceStart = g_traceLast = g_traceFlushed = traceNow();
+
+    const char magic[8] = {'L', '2', 'D', 'C', 'A', 'L', 'L', 'S'};
+    g_traceBuf.insert(g_traceBuf.end(), magic, magic + 8);
+    uint8_t v[4];
+    memcpy(v, &kCallTraceVersion, 4);
+    g_traceBuf.insert(g_traceBuf.end(), v, v + 4);
+    g_callRecording = true;
+    recordRendererState();
+    LOGI("Call recording started: %s", path.c_str());
+    return true;
+}
+
+void stopCallRecording() {
+    if (!g_traceFile) return;
+    flushTrace();
+    fclose(g_traceFile);
+    g_traceFile = nullptr;
+    g_callRecording = false;
+    g_traceStrings.clear();
+    LOGI("Call recording stopped (%.1fs)", traceNow() - g_traceStart);
+}
+
+bool callRecordingActive() { return g_callRecording; }
+
+void recordInit() { beginRecord(CallOp::Init); }
+
+void recordLoadModel(const std::string& path) {
+    uint32_t id = internString(path);
+    beginRecord(CallOp::LoadModel);
+    putVarint(id);
+    flushTrace();
+}
+
+void recordViewport(int width, int height) {
+    beginRecord(CallOp::Viewport);
+    putVarint((uint32_t)width);
+    putVarint((uint32_t)height);
+}
+
+void recordFrame(float dt) {
+    beginRecord(CallOp::Frame);
+    putFloat(dt);
+    // 每秒或缓冲区较大时落盘, 进程被杀时最多丢失一秒
+    if (g_traceBuf.size() >= 16384 || g_traceLast - g_traceFlushed >= 1.0) {
+        flushTrace();
+        g_traceFlushed = g_traceLast;
+    }
+}
+
+void recordStartMotion(const std::string& group, int index, int priority) {
+    uint32_t id = internString(group);
+    beginRecord(CallOp::StartMotion);
+    putVarint(id);
+    putZigzag(index);
+    putZigzag(priority);
+}
+
+void recordSetExpression(const std::string& id) {
+    uint32_t sid = internString(id);
+    beginRecord(CallOp::SetExpression);
+    putVarint(sid);
+}
+
+void recordSetParameter(const char* id, float value, float weight) {
+    uint32_t sid = internString(id);
+    beginRecord(CallOp::SetParameter);
+    putVarint(sid);
+    putFloat(value);
+    putFloat(weight);
+}
+
+void recordSetTransform(float scale, float offsetX, float offsetY) {
+    beginRecord(CallOp::SetTransform);
+    putFloat(scale);
+    putFloat(offsetX);
+    putFloat(offsetY);
+}
+
+void recordSetDynamicResolution(bool enabled, float budgetMs) {
+    beginRecord(CallOp::SetDynamicResolution);
+    putVarint(enabled ? 1 : 0);
+    putFloat(budgetMs);
+}
+
+void recordSetIdleFlipbook(bool enabled, int frames, float scale) {
+    beginRecord(CallOp::SetIdleFlipbook);
+    putVarint(enabled ? 1 : 0);
+    putVarint((uint64_t)frames);
+    putFloat(scale);
+}
+
+void recordTrimMemory(int level) {
+    beginRecord(CallOp::TrimMemory);
+    putVarint((uint64_t)level);
+}
+
+void recordSetClipMode(int mode) {
+    beginRecord(CallOp::SetClipMode);
+    putVarint((uint64_t)mode);
+}
+
+void recordRequestSnapshot(int width, int height, uint32_t background) {
+    beginRecord(CallOp::RequestSnapshot);
+    putVarint((uint64_t)std::max(width, 0));
+    putVarint((uint64_t)std::max(height, 0));
+    putVarint(background);
+}
+
+// ===================== Reading / Replay =====================
+
+namespace {
+
+struct Reader {
+    const std::vector<uint8_t>& d;
+    size_t p;
+    bool ok = true;
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p >= d.size()) { ok = false; return 0; }
+            uint8_t b = d[p++];
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+    int zigzag() { uint32_t v = (uint32_t)varint(); return (int)(v >> 1) ^ -(int)(v & 1); }
+    float f32() {
+        if (p + 4 > d.size()) { ok = false; return 0.f; }
+        float f;
+        memcpy(&f, &d[p], 4);
+        p += 4;
+        return f;
+    }
+};
+
+}
+
+bool parseCallTrace(const std::vector<uint8_t>& data, std::vector<CallRecord>& out, std::string* error) {
+    auto fail = [&](const char* msg) { if (error) *error = msg; return false; };
+    out.clear();
+    if (data.size() < 12 || memcmp(data.data(), "L2DCALLS", 8) != 0) return fail("not a call trace");
+    uint32_t version;
+    memcpy(&version, &data[8], 4);
+    if (version != kCallTraceVersion) return fail("unsupported call trace version");
+
+    std::vector<std::string> strings;
+    Reader r{data, 12};
+    double t = 0.0;
+    auto str = [&](std::string& s) {
+        uint64_t id = r.varint();
+        if (id >= strings.size()) { r.ok = false; return; }
+        s = strings[id];
+    };
+    while (r.ok && r.p < data.size()) {
+        uint8_t op = data[r.p++];
+        if (op >= (uint8_t)CallOp::Count) return fail("unknown op");
+        t += r.varint() / 1e6;
+        CallRecord rec;
+        rec.op = (CallOp)op;
+        rec.timeSec = t;
+        switch (rec.op) {
+            case CallOp::String: {
+                uint64_t n = r.varint();
+                if (!r.ok || n > data.size() - r.p) { r.ok = false; break; }
+                strings.emplace_back((const char*)&data[r.p], (size_t)n);
+                r.p += n;
+                continue;
+            }
+            case CallOp::Init: break;
+            case CallOp::LoadModel:
+            case CallOp::SetExpression: str(rec.str); break;
+            case CallOp::Viewport: rec.i0 = (int)r.varint(); rec.i1 = (int)r.varint(); break;
+            case CallOp::Frame: rec.f0 = r.f32(); break;
+            case CallOp::StartMotion: str(rec.str); rec.i0 = r.zigzag(); rec.i1 = r.zigzag(); break;
+            case CallOp::SetParameter: str(rec.str); rec.f0 = r.f32(); rec.f1 = r.f32(); break;
+            case CallOp::SetTransform: rec.f0 = r.f32(); rec.f1 = r.f32(); rec.f2 = r.f32(); break;
+            case CallOp::SetDynamicResolution: rec.i0 = (int)r.varint(); rec.f0 = r.f32(); break;
+            case CallOp::SetIdleFlipbook: rec.i0 = (int)r.varint(); rec.i1 = (int)r.varint(); rec.f0 = r.f32(); break;
+            case CallOp::TrimMemory: rec.i0 = (int)r.varint(); break;
+            case CallOp::SetClipMode: rec.i0 = (int)r.varint(); break;
+            case CallOp::RequestSnapshot: rec.i0 = (int)r.varint(); rec.i1 = (int)r.varint(); rec.i2 = (int)r.varint(); break;
+            case CallOp::Count: break;
+        }
+        if (!r.ok) break;
+        out.push_back(std::move(rec));
+    }
+    // 进程被杀时最后一条记录可能不完整, 保留之前的部分
+    if (!r.ok && out.empty()) return fail("truncated call trace");
+    return true;
+}
+
+bool loadCallTrace(const std::string& path, std::vector<CallRecord>& out, std::string* error) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) { if (error) *error = "cannot open " + path; return false; }
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return parseCallTrace(data, out, error);
+}
+
+void replayCall(const CallRecord& rec) {
+    switch (rec.op) {
+        case CallOp::Init:          initRenderer(); break;
+        case CallOp::LoadModel:     loadModel(rec.str); break;
+        case CallOp::Viewport:      setViewportSize(rec.i0, rec.i1); break;
+        case CallOp::Frame:         drawFrame(rec.f0); break;
+        case CallOp::StartMotion:   startMotion(rec.str, rec.i0, rec.i1); break;
+        case CallOp::SetExpression: setExpression(rec.str); break;
+        case CallOp::SetParameter:  setParameterOverride(rec.str.c_str(), rec.f0, rec.f1); break;
+        case CallOp::SetTransform:  setModelTransform(rec.f0, rec.f1, rec.f2); break;
+        case CallOp::SetDynamicResolution: setDynamicResolution(rec.i0 != 0, rec.f0); break;
+        case CallOp::SetIdleFlipbook: setIdleFlipbook(rec.i0 != 0, rec.i1, rec.f0); break;
+        case CallOp::TrimMemory: trimMemory((TrimLevel)rec.i0); break;
+        case CallOp::SetClipMode: setClipMode((ClipMode)rec.i0); break;
+        case CallOp::RequestSnapshot: requestSnapshot(rec.i0, rec.i1, (uint32_t)rec.i2); break;
+        case CallOp::String:
+        case CallOp::Count:         break;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// Record / replay of the renderer's public API (what the JNI bridge calls).
+//
+// While recording, every state-changing call in live2d_renderer.h is appended
+// to a compact binary trace with its timestamp; drawFrame() records the dt it
+// was given, so replaying the trace reproduces the session frame for frame
+// with deterministic time. Queries (getParameterValue, ...) are not recorded.
+//
+// Trace format (little endian):
+//   header  "L2DCALLS" u32 version
+//   record  u8 op, varint time delta (us since the previous record), payload
+//   strings are interned: op String defines the next id (varint length + bytes)
+//   and later records refer to it by varint id.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+static const uint32_t kCallTraceVersion = 1;
+
+enum class CallOp : uint8_t {
+    String = 0,         // define next string id
+    Init,
+    LoadModel,          // str path
+    Viewport,           // varint width, height
+    Frame,              // f32 dt
+    StartMotion,        // str group, zigzag index, zigzag priority
+    SetExpression,      // str id
+    SetParameter,       // str id, f32 value, f32 weight
+    SetTransform,       // f32 scale, offsetX, offsetY
+    SetDynamicResolution, // varint enabled, f32 budgetMs
+    SetIdleFlipbook,    // varint enabled, varint frames, f32 scale
+    TrimMemory,         // varint level
+    SetClipMode,        // varint mode
+    RequestSnapshot,    // varint width, height, background
+    Count
+};
+
+struct CallRecord {
+    CallOp   op = CallOp::Init;
+    double   timeSec = 0;   // since the start of the recording
+    std::string str;
+    int      i0 = 0, i1 = 0, i2 = 0;
+    float    f0 = 0, f1 = 0, f2 = 0;
+};
+
+/** Start writing a trace to path (replaces an active recording). Must be called on the GL thread. */
+bool startCallRecording(const std::string& path);
+
+/** Flush and close the trace. */
+void stopCallRecording();
+
+bool callRecordingActive();
+
+bool parseCallTrace(const std::vector<uint8_t>& data, std::vector<CallRecord>& out, std::string* error = nullptr);
+bool loadCallTrace(const std::string& path, std::vector<CallRecord>& out, std::string* error = nullptr);
+
+/** Re-issue one recorded call through the public API (Frame -> drawFrame(dt)). */
+void replayCall(const CallRecord& rec);
+
+// ---- hooks used by live2d_renderer.cpp ----
+
+extern bool g_callRecording;
+
+void recordInit();
+void recordLoadModel(const std::string& path);
+void recordViewport(int width, int height);
+void recordFrame(float dt);
+void recordStartMotion(const std::string& group, int index, int priority);
+void recordSetExpression(const std::string& id);
+void recordSetParameter(const char* id, float value, float weight);
+void recordSetTransform(float scale, float offsetX, float offsetY);
+void recordSetDynamicResolution(bool enabled, float budgetMs);
+void recordSetIdleFlipbook(bool enabled, int frames, float scale);
+void recordTrimMemory(int level);
+void recordSetClipMode(int mode);
+void recordRequestSnapshot(int width, int height, uint32_t background);
+
+/** Records the current viewport, transform and render options; implemented by the renderer, called by startCallRecording. */
+void recordRendererState();
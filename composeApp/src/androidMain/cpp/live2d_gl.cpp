@@ -0,0 +1,40 @@
+#include "live2d_gl.h"
+
+#include <EGL/egl.h>
+
+#include <cstdio>
+
+// 核心名找不到时再试扩展后缀 (OES_get_program_binary 等与 GLES3 核心函数签名相同)
+static void* resolveGL(const char* name) {
+    static const char* const kSuffixes[] = { "", "OES", "EXT" };
+    char buf[96];
+    for (const char* suffix : kSuffixes) {
+        snprintf(buf, sizeof(buf), "gl%s%s", name, suffix);
+        if (void* p = (void*)eglGetProcAddress(buf)) return p;
+    }
+    return nullptr;
+}
+
+#define L2D_GL_EXT_TRAMPOLINE(ret, name, params, args) \
+    static ret ext##name params { \
+        static ret (*fn) params = (ret (*) params)resolveGL(#name); \
+        if (!fn) return (ret)0; \
+        return fn args; \
+    }
+L2D_GL_EXT_FUNCTIONS(L2D_GL_EXT_TRAMPOLINE)
+#undef L2D_GL_EXT_TRAMPOLINE
+
+static const GLDispatch kNativeGL = {
+#define L2D_GL_NATIVE(ret, name, params, args) gl##name,
+#define L2D_GL_NATIVE_EXT(ret, name, params, args) ext##name,
+    L2D_GL_FUNCTIONS(L2D_GL_NATIVE)
+    L2D_GL_EXT_FUNCTIONS(L2D_GL_NATIVE_EXT)
+#undef L2D_GL_NATIVE_EXT
+#undef L2D_GL_NATIVE
+};
+
+const GLDispatch* g_gl = &kNativeGL;
+
+const GLDispatch* nativeGLDispatch() { return &kNativeGL; }
+
+void setGLDispatch(const GLDispatch* dispatch) { g_gl = dispatch ? dispatch : &kNativeGL; }
@@ -0,0 +1,120 @@
+#pragma once
+
+// Thin GL dispatch layer. The renderer issues every GL call through g_gl so the
+// command stream can be swapped for a recording backend (bench/gl_recorder.h)
+// in tests and benchmarks. The default table points straight at GLES2.
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <GLES3/gl3.h>
+
+// X(return type, name without "gl" prefix, parameter list, argument list)
+#define L2D_GL_FUNCTIONS(X) \
+    X(void,   ActiveTexture,            (GLenum texture), (texture)) \
+    X(void,   AttachShader,             (GLuint program, GLuint shader), (program, shader)) \
+    X(void,   BindBuffer,               (GLenum target, GLuint buffer), (target, buffer)) \
+    X(void,   BindFramebuffer,          (GLenum target, GLuint framebuffer), (target, framebuffer)) \
+    X(void,   BindRenderbuffer,         (GLenum target, GLuint renderbuffer), (target, renderbuffer)) \
+    X(void,   BindTexture,              (GLenum target, GLuint texture), (target, texture)) \
+    X(void,   BlendFuncSeparate,        (GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha), (srcRGB, dstRGB, srcAlpha, dstAlpha)) \
+    X(void,   BufferData,               (GLenum target, GLsizeiptr size, const void* data, GLenum usage), (target, size, data, usage)) \
+    X(void,   BufferSubData,            (GLenum target, GLintptr offset, GLsizeiptr size, const void* data), (target, offset, size, data)) \
+    X(GLenum, CheckFramebufferStatus,   (GLenum target), (target)) \
+    X(void,   Clear,                    (GLbitfield mask), (mask)) \
+    X(void,   ClearColor,               (GLfloat r, GLfloat g, GLfloat b, GLfloat a), (r, g, b, a)) \
+    X(void,   ColorMask,                (GLboolean r, GLboolean g, GLboolean b, GLboolean a), (r, g, b, a)) \
+    X(void,   CompileShader,            (GLuint shader), (shader)) \
+    X(GLuint, CreateProgram,            (), ()) \
+    X(GLuint, CreateShader,             (GLenum type), (type)) \
+    X(void,   CullFace,                 (GLenum mode), (mode)) \
+    X(void,   DeleteBuffers,            (GLsizei n, const GLuint* buffers), (n, buffers)) \
+    X(void,   DeleteFramebuffers,       (GLsizei n, const GLuint* framebuffers), (n, framebuffers)) \
+    X(void,   DeleteProgram,            (GLuint program), (program)) \
+    X(void,   DeleteRenderbuffers,      (GLsizei n, const GLuint* renderbuffers), (n, renderbuffers)) \
+    X(void,   DeleteShader,             (GLuint shader), (shader)) \
+    X(void,   DeleteTextures,           (GLsizei n, const GLuint* textures), (n, textures)) \
+    X(void,   Disable,                  (GLenum cap), (cap)) \
+    X(void,   DisableVertexAttribArray, (GLuint index), (index)) \
+    X(void,   DrawElements,             (GLenum mode, GLsizei count, GLenum type, const void* indices), (mode, count, type, indices)) \
+    X(void,   Enable,                   (GLenum cap), (cap)) \
+    X(void,   EnableVertexAttribArray,  (GLuint index), (index)) \
+    X(void,   Finish,                   (), ()) \
+    X(void,   FramebufferRenderbuffer,  (GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer), (target, attachment, renderbuffertarget, renderbuffer)) \
+    X(void,   FramebufferTexture2D,     (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level)) \
+    X(void,   FrontFace,                (GLenum mode), (mode)) \
+    X(void,   GenBuffers,               (GLsizei n, GLuint* buffers), (n, buffers)) \
+    X(void,   GenFramebuffers,          (GLsizei n, GLuint* framebuffers), (n, framebuffers)) \
+    X(void,   GenRenderbuffers,         (GLsizei n, GLuint* renderbuffers), (n, renderbuffers)) \
+    X(void,   GenTextures,              (GLsizei n, GLuint* textures), (n, textures)) \
+    X(void,   GenerateMipmap,           (GLenum target), (target)) \
+    X(GLint,  GetAttribLocation,        (GLuint program, const GLchar* name), (program, name)) \
+    X(GLenum, GetError,                 (), ()) \
+    X(void,   GetIntegerv,              (GLenum pname, GLint* data), (pname, data)) \
+    X(void,   GetProgramInfoLog,        (GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog), (program, bufSize, length, infoLog)) \
+    X(void,   GetProgramiv,             (GLuint program, GLenum pname, GLint* params), (program, pname, params)) \
+    X(void,   GetShaderInfoLog,         (GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog), (shader, bufSize, length, infoLog)) \
+    X(void,   GetShaderiv,              (GLuint shader, GLenum pname, GLint* params), (shader, pname, params)) \
+    X(const GLubyte*, GetString,        (GLenum name), (name)) \
+    X(GLint,  GetUniformLocation,       (GLuint program, const GLchar* name), (program, name)) \
+    X(void,   LinkProgram,              (GLuint program), (program)) \
+    X(void,   ReadPixels,               (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels), (x, y, width, height, format, type, pixels)) \
+    X(void,   RenderbufferStorage,      (GLenum target, GLenum internalformat, GLsizei width, GLsizei height), (target, internalformat, width, height)) \
+    X(void,   Scissor,                  (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height)) \
+    X(void,   ShaderSource,             (GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length), (shader, count, string, length)) \
+    X(void,   StencilFunc,              (GLenum func, GLint ref, GLuint mask), (func, ref, mask)) \
+    X(void,   StencilOp,                (GLenum fail, GLenum zfail, GLenum zpass), (fail, zfail, zpass)) \
+    X(void,   TexImage2D,               (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels), (target, level, internalformat, width, height, border, format, type, pixels)) \
+    X(void,   TexParameteri,            (GLenum target, GLenum pname, GLint param), (target, pname, param)) \
+    X(void,   Uniform1f,                (GLint location, GLfloat v0), (location, v0)) \
+    X(void,   Uniform1i,                (GLint location, GLint v0), (location, v0)) \
+    X(void,   Uniform2f,                (GLint location, GLfloat v0, GLfloat v1), (location, v0, v1)) \
+    X(void,   Uniform4f,                (GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (location, v0, v1, v2, v3)) \
+    X(void,   UniformMatrix4fv,         (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value), (location, count, transpose, value)) \
+    X(void,   UseProgram,               (GLuint program), (program)) \
+    X(void,   VertexAttribPointer,      (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer), (index, size, type, normalized, stride, pointer)) \
+    X(void,   Viewport,                 (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height))
+
+// Entry points libGLESv2 does not necessarily export (GLES3 core / extensions).
+// The native table resolves them with eglGetProcAddress on first call, trying
+// the core name and then the OES / EXT suffixed one; when none exists the call
+// does nothing (and returns 0), so callers check the extension first.
+#define L2D_GL_EXT_FUNCTIONS(X) \
+    X(void,   GetProgramBinary,         (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary), (program, bufSize, length, binaryFormat, binary)) \
+    X(void,   ProgramBinary,            (GLuint program, GLenum binaryFormat, const void* binary, GLint length), (program, binaryFormat, binary, length)) \
+    X(void,   BindVertexArray,          (GLuint array), (array)) \
+    X(void,   DeleteVertexArrays,       (GLsizei n, const GLuint* arrays), (n, arrays)) \
+    X(void,   GenVertexArrays,          (GLsizei n, GLuint* arrays), (n, arrays)) \
+    X(void*,  MapBufferRange,           (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access), (target, offset, length, access)) \
+    X(GLboolean, UnmapBuffer,           (GLenum target), (target)) \
+    X(void,   BindBufferRange,          (GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size), (target, index, buffer, offset, size)) \
+    X(GLuint, GetUniformBlockIndex,     (GLuint program, const GLchar* name), (program, name)) \
+    X(void,   UniformBlockBinding,      (GLuint program, GLuint blockIndex, GLuint blockBinding), (program, blockIndex, blockBinding)) \
+    X(void,   InvalidateFramebuffer,    (GLenum target, GLsizei numAttachments, const GLenum* attachments), (target, numAttachments, attachments)) \
+    X(GLsync, FenceSync,                (GLenum condition, GLbitfield flags), (condition, flags)) \
+    X(GLenum, ClientWaitSync,           (GLsync sync, GLbitfield flags, GLuint64 timeout), (sync, flags, timeout)) \
+    X(void,   DeleteSync,               (GLsync sync), (sync))
+
+#define L2D_GL_ALL_FUNCTIONS(X) L2D_GL_FUNCTIONS(X) L2D_GL_EXT_FUNCTIONS(X)
+
+struct GLDispatch {
+#define L2D_GL_MEMBER(ret, name, params, args) ret (*name) params;
+    L2D_GL_ALL_FUNCTIONS(L2D_GL_MEMBER)
+#undef L2D_GL_MEMBER
+};
+
+/** Stable ids for each dispatch entry, used by the recorder's log format. */
+enum class GLOp : unsigned char {
+#define L2D_GL_OP(ret, name, params, args) name,
+    L2D_GL_ALL_FUNCTIONS(L2D_GL_OP)
+#undef L2D_GL_OP
+    Count
+};
+
+/** Table currently used by the renderer. Never null. */
+extern const GLDispatch* g_gl;
+
+/** The GLES2 table (direct calls into the driver, GLES3 / extension entries resolved lazily). */
+const GLDispatch* nativeGLDispatch();
+
+/** Route the renderer through another table; nullptr restores the native one. */
+void setGLDispatch(const GLDispatch* dispatch);
@@ -0,0 +1,399 @@
+#include "live2d_inflate.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// ===================== Tables =====================
+
+namespace {
+
+const size_t kWindow = 32768;           // deflate history
+const size_t kChunk  = 256 * 1024;      // new output per next()
+const size_t kSlack  = 512;             // a match past the limit + 8-byte copy overrun
+const size_t kInSize = 64 * 1024;
+
+const unsigned kLitlenBits = 10;
+const unsigned kDistBits   = 8;
+const unsigned kCodeLenBits = 7;
+// 一级表 + 每个长码最多一张二级表 (不完整的码集合也接受, 按最坏情况分配)
+const unsigned kLitlenSize = 1024 + 286 * 32;
+const unsigned kDistSize   = 256 + 30 * 128;
+
+// table entry: [31:16] value | [14:11] subtable bits | [10:8] kind | [7:4] extra bits | [3:0] bits to consume
+enum Kind : uint32_t { kLiteral = 0, kLength = 1, kEndOfBlock = 2, kSubtable = 3, kInvalid = 4 };
+
+inline uint32_t entryLen(uint32_t e)   { return e & 15; }
+inline uint32_t entryExtra(uint32_t e) { return (e >> 4) & 15; }
+inline uint32_t entryKind(uint32_t e)  { return (e >> 8) & 7; }
+inline uint32_t entrySub(uint32_t e)   { return (e >> 11) & 15; }
+inline uint32_t entryValue(uint32_t e) { return e >> 16; }
+inline uint32_t makeEntry(uint32_t value, uint32_t kind, uint32_t extra = 0) { return value << 16 | kind << 8 | extra << 4; }
+
+const uint16_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const uint8_t kDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+const uint8_t kCodeLenOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+uint32_t litlenInfo(unsigned sym) {
+    if (sym < 256) return makeEntry(sym, kLiteral);
+    if (sym == 256) return makeEntry(0, kEndOfBlock);
+    if (sym < 286) return makeEntry(kLengthBase[sym - 257], kLength, kLengthExtra[sym - 257]);
+    return makeEntry(0, kInvalid);
+}
+
+uint32_t distInfo(unsigned sym) {
+    return sym < 30 ? makeEntry(kDistBase[sym], kLength, kDistExtra[sym]) : makeEntry(0, kInvalid);
+}
+
+uint32_t codeLenInfo(unsigned sym) { return makeEntry(sym, kLiteral); }
+
+uint32_t reverseBits(uint32_t code, unsigned len) {
+    uint32_t r = 0;
+    for (unsigned i = 0; i < len; i++) { r = r << 1 | (code & 1); code >>= 1; }
+    return r;
+}
+
+// 规范 Huffman 码 -> 一级表 (低 tableBits 位索引, 码按 LSB 先读所以位反转) + 二级表。
+// 不完整的码集合允许 (未覆盖的位置为 kInvalid), 超额订阅则失败。
+bool buildTable(const uint8_t* lens, unsigned n, uint32_t (*info)(unsigned),
+                unsigned tableBits, uint32_t* table, unsigned capacity) {
+    unsigned count[16] = {0};
+    for (unsigned s = 0; s < n; s++) count[lens[s]]++;
+    count[0] = 0;
+    int left = 1;
+    for (unsigned len = 1; len < 16; len++) {
+        left = (left << 1) - (int)count[len];
+        if (left < 0) return false;
+    }
+    uint32_t nextCode[16];
+    uint32_t code = 0;
+    for (unsigned len = 1; len < 16; len++) {
+        code = (code + count[len - 1]) << 1;
+        nextCode[len] = code;
+    }
+
+    const unsigned mainSize = 1u << tableBits;
+    const uint32_t invalid = makeEntry(0, kInvalid) | 1;
+    for (unsigned i = 0; i < mainSize; i++) table[i] = invalid;
+
+    // 长码按前缀 (低 tableBits 位) 分组: 先求每组最大码长, 再分配二级表
+    uint8_t maxLen[1024] = {0};
+    uint32_t longRev[288];
+    uint16_t longSym[288];
+    unsigned longCount = 0;
+    for (unsigned s = 0; s < n; s++) {
+        unsigned len = lens[s];
+        if (!len) continue;
+        uint32_t r = reverseBits(nextCode[len]++, len);
+        if (len <= tableBits) {
+            uint32_t e = info(s) | len;
+            for (uint32_t i = r; i < mainSize; i += 1u << len) table[i] = e;
+        } else {
+            uint32_t prefix = r & (mainSize - 1);
+            if (len > maxLen[prefix]) maxLen[prefix] = (uint8_t)len;
+            longRev[longCount] = r;
+            longSym[longCount++] = (uint16_t)s;
+        }
+    }
+
+    unsigned next = mainSize;
+    for (unsigned k = 0; k < longCount; k++) {
+        uint32_t r = longRev[k];
+        uint32_t prefix = r & (mainSize - 1);
+        unsigned len = lens[longSym[k]];
+        if (entryKind(table[prefix]) != kSubtable) {
+            unsigned subBits = maxLen[prefix] - tableBits;
+            if (next + (1u << subBits) > capacity) return false;
+            table[prefix] = next << 16 | subBits << 11 | kSubtable << 8 | tableBits;
+            for (unsigned i = 0; i < (1u << subBits); i++) table[next + i] = invalid;
+            next += 1u << subBits;
+        }
+        uint32_t e = table[prefix];
+        unsigned subLen = len - tableBits;
+        uint32_t leaf = info(longSym[k]) | subLen;
+        for (uint32_t i = r >> tableBits; i < (1u << entrySub(e)); i += 1u << subLen) table[entryValue(e) + i] = leaf;
+    }
+    return true;
+}
+
+} // namespace
+
+// ===================== Inflater =====================
+
+Inflater::Inflater(ReadFn read, void* user) : m_read(read), m_user(user) {
+    m_in = (uint8_t*)malloc(kInSize);
+    m_out = (uint8_t*)malloc(kWindow + kChunk + kSlack);
+    m_litlen = (uint32_t*)malloc(kLitlenSize * sizeof(uint32_t));
+    m_dist = (uint32_t*)malloc(kDistSize * sizeof(uint32_t));
+    if (!m_in || !m_out || !m_litlen || !m_dist) fail("out of memory");
+}
+
+Inflater::~Inflater() {
+    free(m_in);
+    free(m_out);
+    free(m_litlen);
+    free(m_dist);
+}
+
+bool Inflater::fail(const char* msg) {
+    if (m_state != Failed) m_error = msg;
+    m_state = Failed;
+    return false;
+}
+
+bool Inflater::fillInput() {
+    if (m_inEof) return false;
+    size_t keep = m_inEnd - m_inPos;
+    memmove(m_in, m_in + m_inPos, keep);
+    m_inPos = 0;
+    m_inEnd = keep;
+    while (m_inEnd < kInSize) {
+        size_t got = m_read(m_user, m_in + m_inEnd, kInSize - m_inEnd);
+        if (got == 0) { m_inEof = true; break; }
+        m_inEnd += got;
+    }
+    return m_inEnd > keep;
+}
+
+// 至少补到 49 位; 输入不足 8 字节时逐字节读, 输入结束后补 0 (m_overread 计数)
+void Inflater::refill() {
+    if (m_inEnd - m_inPos < 8) fillInput();
+    if (m_inEnd - m_inPos >= 8) {
+        uint64_t w;
+        memcpy(&w, m_in + m_inPos, 8);
+        m_bitbuf |= w << m_bitcnt;
+        m_inPos += (63 - m_bitcnt) >> 3;
+        m_bitcnt |= 56;
+        return;
+    }
+    while (m_bitcnt <= 48) {
+        uint64_t b = 0;
+        if (m_inPos < m_inEnd) b = m_in[m_inPos++];
+        else m_overread++;
+        m_bitbuf |= b << m_bitcnt;
+        m_bitcnt += 8;
+    }
+}
+
+uint32_t Inflater::bits(unsigned n) {
+    if (m_bitcnt < n) refill();
+    uint32_t v = (uint32_t)(m_bitbuf & ((1ull << n) - 1));
+    m_bitbuf >>= n;
+    m_bitcnt -= n;
+    return v;
+}
+
+bool Inflater::readBlockHeader() {
+    m_final = bits(1) != 0;
+    uint32_t type = bits(2);
+    if (m_overread > 8) return fail("unexpected end of data");
+    if (type == 0) {
+        bits(m_bitcnt & 7);
+        uint32_t len = bits(16), nlen = bits(16);
+        if ((len ^ 0xffff) != nlen) return fail("invalid stored block lengths");
+        m_storedLeft = len;
+        m_state = Stored;
+        return true;
+    }
+    if (type == 1) {
+        uint8_t lens[320];
+        for (unsigned i = 0; i < 144; i++) lens[i] = 8;
+        for (unsigned i = 144; i < 256; i++) lens[i] = 9;
+        for (unsigned i = 256; i < 280; i++) lens[i] = 7;
+        for (unsigned i = 280; i < 288; i++) lens[i] = 8;
+        for (unsigned i = 288; i < 320; i++) lens[i] = 5;
+        buildTable(lens, 288, litlenInfo, kLitlenBits, m_litlen, kLitlenSize);
+        buildTable(lens + 288, 32, distInfo, kDistBits, m_dist, kDistSize);
+        m_state = Huffman;
+        return true;
+    }
+    if (type == 2) {
+        if (!readDynamicTables()) return false;
+        m_state = Huffman;
+        return true;
+    }
+    return fail("invalid block type");
+}
+
+bool Inflater::readDynamicTables() {
+    unsigned nlit = bits(5) + 257, ndist = bits(5) + 1, ncode = bits(4) + 4;
+    if (nlit > 286 || ndist > 30) return fail("too many length or distance symbols");
+
+    uint8_t codeLens[19] = {0};
+    for (unsigned i = 0; i < ncode; i++) codeLens[kCodeLenOrder[i]] = (uint8_t)bits(3);
+    uint32_t clTable[1u << kCodeLenBits];
+    if (!buildTable(codeLens, 19, codeLenInfo, kCodeLenBits, clTable, 1u << kCodeLenBits))
+        return fail("invalid code lengths set");
+
+    uint8_t lens[286 + 30];
+    unsigned total = nlit + ndist;
+    for (unsigned i = 0; i < total;) {
+        if (m_bitcnt < kCodeLenBits) refill();
+        uint32_t e = clTable[m_bitbuf & ((1u << kCodeLenBits) - 1)];
+        if (entryKind(e) == kInvalid) return fail("invalid code lengths set");
+        m_bitbuf >>= entryLen(e);
+        m_bitcnt -= entryLen(e);
+        unsigned sym = entryValue(e), rep;
+        uint8_t value = 0;
+        if (sym < 16) { lens[i++] = (uint8_t)sym; continue; }
+        if (sym == 16) {
+            if (i == 0) return fail("invalid bit length repeat");
+            value = lens[i - 1];
+            rep = 3 + bits(2);
+        } else if (sym == 17) {
+            rep = 3 + bits(3);
+        } else {
+            rep = 11 + bits(7);
+        }
+        if (i + rep > total) return fail("invalid bit length repeat");
+        memset(lens + i, value, rep);
+        i += rep;
+    }
+    if (m_overread > 8) return fail("unexpected end of data");
+    if (lens[256] == 0) return fail("invalid code -- missing end-of-block");
+    if (!buildTable(lens, nlit, litlenInfo, kLitlenBits, m_litlen, kLitlenSize))
+        return fail("invalid literal/lengths set");
+    if (!buildTable(lens + nlit, ndist, distInfo, kDistBits, m_dist, kDistSize))
+        return fail("invalid distances set");
+    return true;
+}
+
+bool Inflater::copyStored(size_t limit) {
+    while (m_storedLeft > 0 && m_pos < limit) {
+        if (m_bitcnt >= 8) {           // 对齐后位缓冲中剩余的整字节
+            m_out[m_pos++] = (uint8_t)bits(8);
+            m_storedLeft--;
+            continue;
+        }
+        m_bitbuf = 0;                  // 丢弃预读的位, 之后直接从输入缓冲复制
+        m_bitcnt = 0;
+        if (m_overread || (m_inPos == m_inEnd && !fillInput())) return fail("unexpected end of data");
+        size_t n = m_inEnd - m_inPos;
+        if (n > m_storedLeft) n = m_storedLeft;
+        if (n > limit - m_pos) n = limit - m_pos;
+        memcpy(m_out + m_pos, m_in + m_inPos, n);
+        m_pos += n;
+        m_inPos += n;
+        m_storedLeft -= (uint32_t)n;
+    }
+    if (m_storedLeft == 0) m_state = m_final ? Done : BlockHeader;
+    return true;
+}
+
+// 主循环: 位缓冲与输出位置放在局部变量里 (uint8_t 写入会让编译器认为成员被改写)
+bool Inflater::decodeHuffman(size_t limit) {
+    uint8_t* const out = m_out;
+    const uint32_t* const litlen = m_litlen;
+    const uint32_t* const dist = m_dist;
+    size_t pos = m_pos;
+    uint64_t bb = m_bitbuf;
+    unsigned cnt = m_bitcnt;
+    const char* err = nullptr;
+
+    while (pos < limit) {
+        if (cnt < 48) {
+            if (m_inEnd - m_inPos >= 8) {
+                uint64_t w;
+                memcpy(&w, m_in + m_inPos, 8);
+                bb |= w << cnt;
+                m_inPos += (63 - cnt) >> 3;
+                cnt |= 56;
+            } else {
+                m_bitbuf = bb; m_bitcnt = cnt;
+                refill();
+                bb = m_bitbuf; cnt = m_bitcnt;
+                if (m_overread > 8) { err = "unexpected end of data"; break; }
+            }
+        }
+        uint32_t e = litlen[bb & ((1u << kLitlenBits) - 1)];
+        if (entryKind(e) == kSubtable) {
+            bb >>= kLitlenBits; cnt -= kLitlenBits;
+            e = litlen[entryValue(e) + (bb & ((1u << entrySub(e)) - 1))];
+        }
+        bb >>= entryLen(e); cnt -= entryLen(e);
+        uint32_t kind = entryKind(e);
+        if (kind == kLiteral) {
+            out[pos++] = (uint8_t)entryValue(e);
+            continue;
+        }
+        if (kind == kLength) {
+            uint32_t extra = entryExtra(e);
+            uint32_t length = entryValue(e) + (uint32_t)(bb & ((1u << extra) - 1));
+            bb >>= extra; cnt -= extra;
+            uint32_t d = dist[bb & ((1u << kDistBits) - 1)];
+            if (entryKind(d) == kSubtable) {
+                bb >>= kDistBits; cnt -= kDistBits;
+                d = dist[entryValue(d) + (bb & ((1u << entrySub(d)) - 1))];
+            }
+            bb >>= entryLen(d); cnt -= entryLen(d);
+            if (entryKind(d) != kLength) { err = "invalid distance code"; break; }
+            extra = entryExtra(d);
+            uint32_t distance = entryValue(d) + (uint32_t)(bb & ((1u << extra) - 1));
+            bb >>= extra; cnt -= extra;
+            if (distance > pos) { err = "invalid distance too far back"; break; }
+
+            uint8_t* dst = out + pos;
+            const uint8_t* src = dst - distance;
+            if (distance >= 8) {
+                // 8 字节一块向前复制, 块内不重叠; 末尾最多多写 7 字节 (kSlack)
+                uint8_t* end = dst + length;
+                do { memcpy(dst, src, 8); dst += 8; src += 8; } while (dst < end);
+            } else if (distance == 1) {
+                memset(dst, src[0], length);
+            } else {
+                for (uint32_t i = 0; i < length; i++) dst[i] = src[i];
+            }
+            pos += length;
+            continue;
+        }
+        if (kind == kEndOfBlock) {
+            m_state = m_final ? Done : BlockHeader;
+            break;
+        }
+        err = "invalid literal/length code";
+        break;
+    }
+
+    m_pos = pos;
+    m_bitbuf = bb;
+    m_bitcnt = cnt;
+    return err ? fail(err) : true;
+}
+
+Inflater::Status Inflater::next(const uint8_t** data, size_t* len) {
+    *data = m_out;
+    *len = 0;
+    if (m_state == Failed) return Error;
+    if (m_pos > kWindow) {
+        memmove(m_out, m_out + m_pos - kWindow, kWindow);
+        m_pos = kWindow;
+    }
+    size_t start = m_pos;
+    size_t limit = start + kChunk;
+    while (m_pos < limit && m_state != Done) {
+        bool ok = true;
+        switch (m_state) {
+        case ZlibHeader: {
+            uint32_t cmf = bits(8), flg = bits(8);
+            if (m_overread) ok = fail("unexpected end of data");
+            else if ((cmf & 15) != 8 || (cmf >> 4) > 7 || (cmf << 8 | flg) % 31 != 0) ok = fail("invalid zlib header");
+            else if (flg & 32) ok = fail("preset dictionary not allowed");
+            else m_state = BlockHeader;
+            break;
+        }
+        case BlockHeader: ok = readBlockHeader(); break;
+        case Stored:      ok = copyStored(limit); break;
+        case Huffman:     ok = decodeHuffman(limit); break;
+        default:          ok = false; break;
+        }
+        if (!ok) return Error;
+    }
+    *data = m_out + start;
+    *len = m_pos - start;
+    return m_state == Done ? End : More;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+// Streaming zlib/deflate decoder used by the PNG path (live2d_png.cpp).
+//
+// Output goes to a linear buffer that keeps the last 32 KB as history, so
+// matches are plain forward copies and each next() hands back up to 256 KB of
+// new bytes in one piece. Input is pulled through a callback into a 64 KB
+// buffer and read with a 64-bit bit buffer refilled a word at a time;
+// Huffman codes resolve through one 10-bit (literal/length) or 8-bit
+// (distance) table lookup, with a second-level table for longer codes.
+// The Adler-32 trailer is not checked (same as stb_image).
+
+#include <cstddef>
+#include <cstdint>
+
+class Inflater {
+public:
+    /** Reads up to n bytes of the zlib stream; 0 at end of input. */
+    typedef size_t (*ReadFn)(void* user, uint8_t* dst, size_t n);
+
+    enum Status { More, End, Error };
+
+    Inflater(ReadFn read, void* user);
+    ~Inflater();
+    Inflater(const Inflater&) = delete;
+    Inflater& operator=(const Inflater&) = delete;
+
+    /**
+     * Decompress the next piece. data/len stay valid until the following call.
+     * Returns More (len > 0), End (the stream is complete, len may be > 0) or Error.
+     */
+    Status next(const uint8_t** data, size_t* len);
+
+    const char* error() const { return m_error; }
+
+private:
+    enum State { ZlibHeader, BlockHeader, Stored, Huffman, Done, Failed };
+
+    bool fail(const char* msg);
+    bool fillInput();
+    void refill();
+    uint32_t bits(unsigned n);
+    bool readBlockHeader();
+    bool readDynamicTables();
+    bool decodeHuffman(size_t limit);
+    bool copyStored(size_t limit);
+
+    ReadFn   m_read;
+    void*    m_user;
+    State    m_state = ZlibHeader;
+    bool     m_final = false;
+    const char* m_error = nullptr;
+
+    // input
+    uint8_t* m_in;
+    size_t   m_inPos = 0, m_inEnd = 0;
+    bool     m_inEof = false;
+    size_t   m_overread = 0;    // zero bytes padded past the end of input
+    uint64_t m_bitbuf = 0;
+    unsigned m_bitcnt = 0;
+
+    // output: [0, m_pos) with at least the last 32 KB of history
+    uint8_t* m_out;
+    size_t   m_pos = 0;
+    size_t   m_total = 0;       // bytes produced before m_out[0]
+    uint32_t m_storedLeft = 0;
+
+    // decode tables (see live2d_inflate.cpp)
+    uint32_t* m_litlen;
+    uint32_t* m_dist;
+};
@@ -0,0 +1,316 @@
+#include "live2d_log.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#endif
+#include <pthread.h>
+
+namespace live2d_log {
+
+std::atomic<int> g_level{LIVE2D_LOG_MIN_LEVEL};
+
+// ===================== Ring =====================
+// Bounded multi-producer / single-consumer queue (Vyukov): a slot is free for
+// position pos when seq == pos and readable when seq == pos + 1.
+
+struct RecordHeader {
+    const char* fmt;
+    uint32_t    suppressed;
+    uint16_t    payloadBytes;
+    uint8_t     level;
+    uint8_t     truncated;
+    uint32_t    pos;
+};
+
+struct alignas(64) Slot {
+    std::atomic<uint32_t> seq{0};
+    RecordHeader header;
+    uint8_t payload[kLogSlotBytes - sizeof(RecordHeader)];
+};
+
+static Slot g_slots[kLogSlots];
+static std::atomic<uint32_t> g_enqueuePos{0};
+static uint32_t              g_dequeuePos = 0;      // consumer only
+static std::atomic<uint32_t> g_writtenPos{0};       // records fully written (for flush)
+static std::atomic<uint64_t> g_dropped{0};
+
+static std::once_flag           g_startOnce;
+static std::atomic<bool>        g_started{false};
+static std::atomic<bool>        g_consumerSleeping{false};
+static std::atomic<bool>        g_stopping{false};
+static std::mutex               g_wakeMutex;
+static std::condition_variable  g_wake;
+static std::thread              g_thread;
+
+static int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ===================== Formatting (background thread) =====================
+
+namespace {
+
+struct ArgReader {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    struct Arg { uint8_t tag = 0; int64_t i = 0; uint64_t u = 0; double d = 0; const char* s = ""; uint16_t len = 0; };
+
+    bool next(Arg& a) {
+        if (p >= end) return false;
+        a.tag = *p++;
+        switch (a.tag) {
+            case ArgInt:     if (end - p < 8) return false; memcpy(&a.i, p, 8); p += 8; a.u = (uint64_t)a.i; a.d = (double)a.i; return true;
+            case ArgUInt:
+            case ArgPointer: if (end - p < 8) return false; memcpy(&a.u, p, 8); p += 8; a.i = (int64_t)a.u; a.d = (double)a.u; return true;
+            case ArgDouble:  if (end - p < 8) return false; memcpy(&a.d, p, 8); p += 8; a.i = (int64_t)a.d; a.u = (uint64_t)a.i; return true;
+            case ArgString:
+                if (end - p < 2) return false;
+                memcpy(&a.len, p, 2); p += 2;
+                if (end - p < a.len) return false;
+                a.s = (const char*)p; p += a.len;
+                return true;
+            default: return false;
+        }
+    }
+};
+
+struct Out {
+    char*  buf;
+    size_t cap;
+    size_t n = 0;
+    void put(const char* s, size_t len) {
+        if (n + 1 >= cap) return;
+        size_t room = cap - 1 - n;
+        if (len > room) len = room;
+        memcpy(buf + n, s, len);
+        n += len;
+        buf[n] = '\0';
+    }
+    template <class T> void spec(const char* spec, T v) {
+        if (n + 1 >= cap) return;
+        int w = snprintf(buf + n, cap - n, spec, v);
+        if (w > 0) n += ((size_t)w < cap - n) ? (size_t)w : cap - n - 1;
+    }
+};
+
+}
+
+// printf with the captured arguments; every conversion is re-issued with the
+// type it was captured as (integers widened to long long)
+static void formatRecord(const char* fmt, const uint8_t* args, size_t argBytes, char* buf, size_t cap) {
+    Out out{buf, cap};
+    buf[0] = '\0';
+    ArgReader r{args, args + argBytes};
+    const char* f = fmt;
+    while (*f) {
+        const char* lit = f;
+        while (*f && *f != '%') f++;
+        out.put(lit, (size_t)(f - lit));
+        if (!*f) break;
+        if (f[1] == '%') { out.put("%", 1); f += 2; continue; }
+
+        // %[flags][width][.precision][length]conv
+        char spec[32];
+        size_t sn = 0;
+        spec[sn++] = *f++;
+        ArgReader::Arg a;
+        while (*f && strchr("-+ #0", *f) && sn < 20) spec[sn++] = *f++;
+        for (int part = 0; part < 2; part++) {
+            if (part == 1) { if (*f != '.') break; spec[sn++] = *f++; }
+            if (*f == '*') {
+                f++;
+                int v = r.next(a) ? (int)a.i : 0;
+                sn += (size_t)snprintf(spec + sn, sizeof(spec) - sn - 8, "%d", v);
+            } else {
+                while (*f >= '0' && *f <= '9' && sn < 26) spec[sn++] = *f++;
+            }
+        }
+        while (*f && strchr("hljztLq", *f)) f++;
+        char conv = *f ? *f++ : 'd';
+        if (!r.next(a)) { out.put("<?>", 3); continue; }
+
+        switch (conv) {
+            case 'd': case 'i':
+                spec[sn++] = 'l'; spec[sn++] = 'l'; spec[sn++] = conv; spec[sn] = '\0';
+                out.spec(spec, (long long)a.i);
+                break;
+            case 'u': case 'o': case 'x': case 'X':
+                spec[sn++] = 'l'; spec[sn++] = 'l'; spec[sn++] = conv; spec[sn] = '\0';
+                out.spec(spec, (unsigned long long)a.u);
+                break;
+            case 'c':
+                spec[sn++] = 'c'; spec[sn] = '\0';
+                out.spec(spec, (int)a.i);
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                spec[sn++] = conv; spec[sn] = '\0';
+                out.spec(spec, a.d);
+                break;
+            case 's': {
+                if (a.tag != ArgString) { out.put("<?>", 3); break; }
+                char tmp[kLogSlotBytes];
+                memcpy(tmp, a.s, a.len);
+                tmp[a.len] = '\0';
+                spec[sn++] = 's'; spec[sn] = '\0';
+                out.spec(spec, (const char*)tmp);
+                break;
+            }
+            case 'p':
+                spec[sn++] = 'p'; spec[sn] = '\0';
+                out.spec(spec, (void*)(uintptr_t)a.u);
+                break;
+            default:
+                out.put("<?>", 3);
+                break;
+        }
+    }
+}
+
+static void emit(int level, const char* msg) {
+#ifdef __ANDROID__
+    static const int prio[] = { ANDROID_LOG_VERBOSE, ANDROID_LOG_DEBUG, ANDROID_LOG_INFO, ANDROID_LOG_WARN, ANDROID_LOG_ERROR };
+    __android_log_write(prio[level < 0 ? 0 : level > 4 ? 4 : level], LOG_TAG, msg);
+#else
+    static const char* suffix[] = { " VERBOSE", " DEBUG", "", " WARN", " ERROR" };
+    fprintf(stderr, "[" LOG_TAG "%s] %s\n", suffix[level < 0 ? 0 : level > 4 ? 4 : level], msg);
+#endif
+}
+
+static void writeRecord(const RecordHeader& h, const uint8_t* payload) {
+    char msg[1024];
+    formatRecord(h.fmt, payload, h.payloadBytes, msg, sizeof(msg) - 48);
+    size_t n = strlen(msg);
+    if (h.truncated) n += (size_t)snprintf(msg + n, sizeof(msg) - n, " ...");
+    if (h.suppressed) snprintf(msg + n, sizeof(msg) - n, " (+%u suppressed)", h.suppressed);
+    emit(h.level, msg);
+}
+
+// Drains every readable slot; returns false when the ring was empty
+static bool drain() {
+    bool any = false;
+    static uint64_t reportedDrops = 0;
+    for (;;) {
+        Slot& s = g_slots[g_dequeuePos & (kLogSlots - 1)];
+        if (s.seq.load(std::memory_order_acquire) != g_dequeuePos + 1) break;
+        writeRecord(s.header, s.payload);
+        s.seq.store(g_dequeuePos + kLogSlots, std::memory_order_release);
+        g_dequeuePos++;
+        g_writtenPos.store(g_dequeuePos, std::memory_order_release);
+        any = true;
+    }
+    uint64_t dropped = g_dropped.load(std::memory_order_relaxed);
+    if (dropped != reportedDrops) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%llu log records dropped (ring full)", (unsigned long long)(dropped - reportedDrops));
+        emit(LIVE2D_LOG_LEVEL_WARN, msg);
+        reportedDrops = dropped;
+    }
+    return any;
+}
+
+static void consumerLoop() {
+    pthread_setname_np(pthread_self(), "live2d-log");
+    while (!g_stopping.load(std::memory_order_acquire)) {
+        if (drain()) continue;
+        std::unique_lock<std::mutex> lock(g_wakeMutex);
+        g_consumerSleeping.store(true, std::memory_order_seq_cst);
+        // 生产者不持锁通知, 可能错过一次唤醒; 超时兜底
+        if (g_slots[g_dequeuePos & (kLogSlots - 1)].seq.load(std::memory_order_acquire) != g_dequeuePos + 1)
+            g_wake.wait_for(lock, std::chrono::milliseconds(500));
+        g_consumerSleeping.store(false, std::memory_order_relaxed);
+    }
+    drain();
+}
+
+namespace {
+// Drains the ring on exit (host tools); Android processes are killed instead
+struct Shutdown {
+    ~Shutdown() {
+        if (!g_started.load(std::memory_order_acquire)) return;
+        g_stopping.store(true, std::memory_order_release);
+        g_wake.notify_one();
+        if (g_thread.joinable()) g_thread.join();
+    }
+} g_shutdown;
+}
+
+static void start() {
+    for (unsigned i = 0; i < kLogSlots; i++) g_slots[i].seq.store(i, std::memory_order_relaxed);
+    g_thread = std::thread(consumerLoop);
+    g_started.store(true, std::memory_order_release);
+}
+
+// ===================== Producer side =====================
+
+bool allow(Site& site, uint32_t* suppressed) {
+    int64_t now = nowMs();
+    int64_t start = site.windowStartMs.load(std::memory_order_relaxed);
+    if (now - start >= 1000 && site.windowStartMs.compare_exchange_strong(start, now, std::memory_order_relaxed))
+        site.count.store(0, std::memory_order_relaxed);
+    if (site.count.fetch_add(1, std::memory_order_relaxed) >= kLogSiteBurst) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    *suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+uint8_t* beginRecord(int level, const char* fmt, uint32_t suppressed, uint8_t** end, void** token) {
+    if (!g_started.load(std::memory_order_acquire)) std::call_once(g_startOnce, start);
+    if (g_stopping.load(std::memory_order_acquire)) return nullptr;
+
+    uint32_t pos = g_enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &g_slots[pos & (kLogSlots - 1)];
+        int32_t dif = (int32_t)(slot->seq.load(std::memory_order_acquire) - pos);
+        if (dif == 0) {
+            if (g_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (dif < 0) {
+            g_dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            pos = g_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    slot->header.fmt = fmt;
+    slot->header.suppressed = suppressed;
+    slot->header.level = (uint8_t)level;
+    slot->header.pos = pos;
+    *end = slot->payload + sizeof(slot->payload);
+    *token = slot;
+    return slot->payload;
+}
+
+void commitRecord(void* token, size_t payloadBytes, bool truncated) {
+    Slot* slot = (Slot*)token;
+    slot->header.payloadBytes = (uint16_t)payloadBytes;
+    slot->header.truncated = truncated ? 1 : 0;
+    slot->seq.store(slot->header.pos + 1, std::memory_order_release);
+    if (g_consumerSleeping.load(std::memory_order_seq_cst)) g_wake.notify_one();
+}
+
+void setLevel(int level) { g_level.store(level, std::memory_order_relaxed); }
+
+void flush() {
+    if (!g_started.load(std::memory_order_acquire)) return;
+    uint32_t target = g_enqueuePos.load(std::memory_order_acquire);
+    int64_t deadline = nowMs() + 1000;
+    while ((int32_t)(g_writtenPos.load(std::memory_order_acquire) - target) < 0 && nowMs() < deadline) {
+        g_wake.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+uint64_t droppedCount() { return g_dropped.load(std::memory_order_relaxed); }
+
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+// 日志: Android 走 logcat, 其他平台 (Linux 基准测试工具) 输出到 stderr
+//
+// The calling thread never formats or blocks: LOGx copies the format pointer
+// and its arguments (strings by value) into a slot of a fixed lock-free ring,
+// and a background thread formats and writes them. When the ring is full the
+// record is dropped and counted. Each call site is rate limited
+// (kLogSiteBurst records per second; the next record that gets through
+// reports how many were suppressed).
+//
+// Levels below LIVE2D_LOG_MIN_LEVEL are removed at compile time (release
+// builds keep Info and above, debug builds keep Debug); live2d_log::setLevel() raises
+// the threshold at runtime.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#define LOG_TAG "Live2D_Native"
+
+#define LIVE2D_LOG_LEVEL_VERBOSE 0
+#define LIVE2D_LOG_LEVEL_DEBUG   1
+#define LIVE2D_LOG_LEVEL_INFO    2
+#define LIVE2D_LOG_LEVEL_WARN    3
+#define LIVE2D_LOG_LEVEL_ERROR   4
+
+#ifndef LIVE2D_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LIVE2D_LOG_MIN_LEVEL LIVE2D_LOG_LEVEL_INFO
+#else
+#define LIVE2D_LOG_MIN_LEVEL LIVE2D_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+namespace live2d_log {
+
+static const int      kLogSiteBurst   = 10;     // records per call site per second
+static const size_t   kLogSlotBytes   = 512;    // header + arguments
+static const unsigned kLogSlots       = 128;    // power of two
+
+// Per call site rate limiter (one static instance per LOGx expansion)
+struct Site {
+    std::atomic<int64_t>  windowStartMs{0};
+    std::atomic<int>      count{0};
+    std::atomic<uint32_t> suppressed{0};
+};
+
+extern std::atomic<int> g_level;
+
+void setLevel(int level);
+/** Blocks until every record queued so far has been written. */
+void flush();
+/** Records dropped because the ring was full. */
+uint64_t droppedCount();
+
+// ---- argument capture ----
+
+enum ArgTag : uint8_t { ArgInt = 'i', ArgUInt = 'u', ArgDouble = 'd', ArgString = 's', ArgPointer = 'p' };
+
+struct Writer {
+    uint8_t* p;
+    uint8_t* end;
+    bool     truncated = false;
+
+    void bytes(const void* src, size_t n) {
+        if ((size_t)(end - p) < n) { truncated = true; return; }
+        for (size_t i = 0; i < n; i++) p[i] = ((const uint8_t*)src)[i];
+        p += n;
+    }
+    template <class T> void value(uint8_t tag, T v) { bytes(&tag, 1); bytes(&v, sizeof(v)); }
+    void string(const char* s) {
+        if (!s) s = "(null)";
+        size_t n = 0;
+        while (s[n]) n++;
+        size_t room = (size_t)(end - p) > 3 ? (size_t)(end - p) - 3 : 0;
+        if (n > room) { n = room; truncated = true; }
+        uint8_t tag = ArgString;
+        uint16_t len = (uint16_t)n;
+        bytes(&tag, 1);
+        bytes(&len, 2);
+        bytes(s, n);
+    }
+};
+
+template <class T>
+inline void put(Writer& w, T v) {
+    using Pointee = typename std::remove_cv<typename std::remove_pointer<T>::type>::type;
+    if constexpr (std::is_pointer<T>::value && (std::is_same<Pointee, char>::value ||
+                  std::is_same<Pointee, unsigned char>::value || std::is_same<Pointee, signed char>::value))
+        w.string((const char*)v);
+    else if constexpr (std::is_floating_point<T>::value) w.value<double>(ArgDouble, (double)v);
+    else if constexpr (std::is_pointer<T>::value) w.value<uint64_t>(ArgPointer, (uint64_t)(uintptr_t)v);
+    else if constexpr (std::is_enum<T>::value) w.value<int64_t>(ArgInt, (int64_t)v);
+    else if constexpr (std::is_signed<T>::value) w.value<int64_t>(ArgInt, (int64_t)v);
+    else w.value<uint64_t>(ArgUInt, (uint64_t)v);
+}
+
+// Slot payload writer: returns nullptr when the ring is full (record dropped)
+uint8_t* beginRecord(int level, const char* fmt, uint32_t suppressed, uint8_t** end, void** token);
+void commitRecord(void* token, size_t payloadBytes, bool truncated);
+
+bool allow(Site& site, uint32_t* suppressed);
+
+template <class... Args>
+inline void write(Site& site, int level, const char* fmt, Args... args) {
+    uint32_t suppressed;
+    if (!allow(site, &suppressed)) return;
+    uint8_t* end;
+    void* token;
+    uint8_t* p = beginRecord(level, fmt, suppressed, &end, &token);
+    if (!p) return;
+    Writer w{p, end};
+    (put(w, args), ...);
+    commitRecord(token, (size_t)(w.p - p), w.truncated);
+}
+
+// Compile-time printf checking for the captured format (never called)
+inline void checkFormat(const char*, ...) __attribute__((format(printf, 1, 2)));
+inline void checkFormat(const char*, ...) {}
+
+}
+
+#define LIVE2D_LOG(level, ...) do { \
+    if (level >= LIVE2D_LOG_MIN_LEVEL && \
+        level >= live2d_log::g_level.load(std::memory_order_relaxed)) { \
+        static live2d_log::Site l2dLogSite_; \
+        if (false) live2d_log::checkFormat(__VA_ARGS__); \
+        live2d_log::write(l2dLogSite_, level, __VA_ARGS__); \
+    } \
+} while (0)
+
+#define LOGV(...) LIVE2D_LOG(LIVE2D_LOG_LEVEL_VERBOSE, __VA_ARGS__)
+#define LOGD(...) LIVE2D_LOG(LIVE2D_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOGI(...) LIVE2D_LOG(LIVE2D_LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOGW(...) LIVE2D_LOG(LIVE2D_LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOGE(...) LIVE2D_LOG(LIVE2D_LOG_LEVEL_ERROR, __VA_ARGS__)
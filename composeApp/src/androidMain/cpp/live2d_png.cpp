@@ -0,0 +1,534 @@
+#include "live2d_png.h"
+#include "live2d_inflate.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// ===================== Stream =====================
+
+namespace {
+
+struct Source {
+    PngReadFn read;
+    void* user;
+
+    bool readExact(uint8_t* dst, size_t n) {
+        while (n > 0) {
+            size_t got = read(user, dst, n);
+            if (got == 0) return false;
+            dst += got; n -= got;
+        }
+        return true;
+    }
+
+    bool skip(size_t n) {
+        uint8_t tmp[1024];
+        while (n > 0) {
+            size_t step = n < sizeof(tmp) ? n : sizeof(tmp);
+            if (!readExact(tmp, step)) return false;
+            n -= step;
+        }
+        return true;
+    }
+};
+
+uint32_t be32(const uint8_t* p) { return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3]; }
+
+const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+// ===================== Unfilter =====================
+// 3/4 字节像素 (RGB8 / RGBA8, Cubism 导出的贴图) 的 Sub/Avg/Paeth 逐像素用 SSE2 / NEON
+// 一次处理所有通道 (思路同 libpng 的 filter_*_intrinsics), Up 按 16 字节; 其余格式走标量。
+
+uint8_t paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return (uint8_t)a;
+    return (uint8_t)(pb <= pc ? b : c);
+}
+
+template <int BPP> inline uint32_t loadPixel(const uint8_t* p) { uint32_t v = 0; memcpy(&v, p, BPP); return v; }
+template <int BPP> inline void storePixel(uint8_t* p, uint32_t v) { memcpy(p, &v, BPP); }
+
+#if defined(__SSE2__)
+
+inline __m128i loadPx(uint32_t v) { return _mm_cvtsi32_si128((int)v); }
+inline uint32_t storePx(__m128i v) { return (uint32_t)_mm_cvtsi128_si32(v); }
+inline __m128i abs16(__m128i v) { return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v)); }
+inline __m128i select(__m128i mask, __m128i t, __m128i f) { return _mm_or_si128(_mm_and_si128(mask, t), _mm_andnot_si128(mask, f)); }
+
+void unfilterUp(uint8_t* row, const uint8_t* prev, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(row + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(prev + i));
+        _mm_storeu_si128((__m128i*)(row + i), _mm_add_epi8(x, b));
+    }
+    for (; i < n; i++) row[i] += prev[i];
+}
+
+template <int BPP> void unfilterSub(uint8_t* row, size_t n) {
+    __m128i a = _mm_setzero_si128();
+    for (size_t i = 0; i < n; i += BPP) {
+        a = _mm_add_epi8(a, loadPx(loadPixel<BPP>(row + i)));
+        storePixel<BPP>(row + i, storePx(a));
+    }
+}
+
+template <int BPP> void unfilterAvg(uint8_t* row, const uint8_t* prev, size_t n) {
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i a = _mm_setzero_si128();
+    for (size_t i = 0; i < n; i += BPP) {
+        __m128i b = loadPx(loadPixel<BPP>(prev + i));
+        // _mm_avg_epu8 向上取整, 减去 (a ^ b) & 1 得到 floor((a + b) / 2)
+        __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+        a = _mm_add_epi8(loadPx(loadPixel<BPP>(row + i)), avg);
+        storePixel<BPP>(row + i, storePx(a));
+    }
+}
+
+template <int BPP> void unfilterPaeth(uint8_t* row, const uint8_t* prev, size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i a = zero, c = zero;   // 16 位通道
+    for (size_t i = 0; i < n; i += BPP) {
+        __m128i b = _mm_unpacklo_epi8(loadPx(loadPixel<BPP>(prev + i)), zero);
+        // p = a + b - c: |p - a| = |b - c|, |p - b| = |a - c|, |p - c| = |(a - c) + (b - c)|
+        __m128i pa = _mm_sub_epi16(b, c);
+        __m128i pb = _mm_sub_epi16(a, c);
+        __m128i pc = abs16(_mm_add_epi16(pa, pb));
+        pa = abs16(pa);
+        pb = abs16(pb);
+        __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+        __m128i nearest = select(_mm_cmpeq_epi16(smallest, pa), a,
+                                 select(_mm_cmpeq_epi16(smallest, pb), b, c));
+        __m128i d = _mm_add_epi8(loadPx(loadPixel<BPP>(row + i)), _mm_packus_epi16(nearest, nearest));
+        storePixel<BPP>(row + i, storePx(d));
+        a = _mm_unpacklo_epi8(d, zero);
+        c = b;
+    }
+}
+
+#define LIVE2D_PNG_SIMD 1
+
+#elif defined(__ARM_NEON)
+
+inline uint8x8_t loadPx(uint32_t v) { return vreinterpret_u8_u32(vdup_n_u32(v)); }
+inline uint32_t storePx(uint8x8_t v) { return vget_lane_u32(vreinterpret_u32_u8(v), 0); }
+
+void unfilterUp(uint8_t* row, const uint8_t* prev, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) vst1q_u8(row + i, vaddq_u8(vld1q_u8(row + i), vld1q_u8(prev + i)));
+    for (; i < n; i++) row[i] += prev[i];
+}
+
+template <int BPP> void unfilterSub(uint8_t* row, size_t n) {
+    uint8x8_t a = vdup_n_u8(0);
+    for (size_t i = 0; i < n; i += BPP) {
+        a = vadd_u8(a, loadPx(loadPixel<BPP>(row + i)));
+        storePixel<BPP>(row + i, storePx(a));
+    }
+}
+
+template <int BPP> void unfilterAvg(uint8_t* row, const uint8_t* prev, size_t n) {
+    uint8x8_t a = vdup_n_u8(0);
+    for (size_t i = 0; i < n; i += BPP) {
+        a = vadd_u8(loadPx(loadPixel<BPP>(row + i)), vhadd_u8(a, loadPx(loadPixel<BPP>(prev + i))));
+        storePixel<BPP>(row + i, storePx(a));
+    }
+}
+
+template <int BPP> void unfilterPaeth(uint8_t* row, const uint8_t* prev, size_t n) {
+    uint8x8_t a = vdup_n_u8(0), c = a;
+    for (size_t i = 0; i < n; i += BPP) {
+        uint8x8_t b = loadPx(loadPixel<BPP>(prev + i));
+        uint16x8_t pa = vabdl_u8(b, c);                                    // |p - a|
+        uint16x8_t pb = vabdl_u8(a, c);                                    // |p - b|
+        uint16x8_t pc = vabdq_u16(vaddl_u8(a, b), vaddl_u8(c, c));         // |p - c|
+        uint16x8_t useA = vandq_u16(vcleq_u16(pa, pb), vcleq_u16(pa, pc));
+        uint8x8_t bc = vbsl_u8(vmovn_u16(vcleq_u16(pb, pc)), b, c);
+        uint8x8_t nearest = vbsl_u8(vmovn_u16(useA), a, bc);
+        a = vadd_u8(loadPx(loadPixel<BPP>(row + i)), nearest);
+        storePixel<BPP>(row + i, storePx(a));
+        c = b;
+    }
+}
+
+#define LIVE2D_PNG_SIMD 1
+
+#endif
+
+// row/prev 不含滤波类型字节; bpp = 每像素字节数 (位深 < 8 时为 1)
+bool unfilterRow(int type, uint8_t* row, const uint8_t* prev, size_t n, size_t bpp) {
+    if (type == 0) return true;
+    if (type > 4) return false;
+#ifdef LIVE2D_PNG_SIMD
+    if (type == 2) { unfilterUp(row, prev, n); return true; }
+    if (bpp == 4) {
+        if (type == 1) unfilterSub<4>(row, n);
+        else if (type == 3) unfilterAvg<4>(row, prev, n);
+        else unfilterPaeth<4>(row, prev, n);
+        return true;
+    }
+    if (bpp == 3) {
+        if (type == 1) unfilterSub<3>(row, n);
+        else if (type == 3) unfilterAvg<3>(row, prev, n);
+        else unfilterPaeth<3>(row, prev, n);
+        return true;
+    }
+#endif
+    switch (type) {
+    case 1: for (size_t i = bpp; i < n; i++) row[i] += row[i - bpp]; break;
+    case 2: for (size_t i = 0; i < n; i++) row[i] += prev[i]; break;
+    case 3:
+        for (size_t i = 0; i < bpp && i < n; i++) row[i] += prev[i] >> 1;
+        for (size_t i = bpp; i < n; i++) row[i] += (uint8_t)((row[i - bpp] + prev[i]) >> 1);
+        break;
+    default:
+        for (size_t i = 0; i < bpp && i < n; i++) row[i] += prev[i];
+        for (size_t i = bpp; i < n; i++) row[i] += paeth(row[i - bpp], prev[i], prev[i - bpp]);
+        break;
+    }
+    return true;
+}
+
+// ===================== Decoder =====================
+
+struct Decoder {
+    // IHDR
+    int width = 0, height = 0, depth = 0, colorType = 0;
+    int channels = 0;
+    size_t stride = 0;      // bytes per scanline without the filter byte
+    size_t filterBpp = 1;
+
+    // PLTE / tRNS
+    uint8_t palette[256][4];
+    bool hasKey = false;
+    uint16_t key[3] = {0, 0, 0};
+
+    // output
+    bool flipY = false;
+    int scale = 1, outW = 0, outH = 0, top = 0;
+    uint8_t* pixels = nullptr;
+
+    std::vector<uint8_t> cur, prev;     // scanlines incl. the filter byte
+    std::vector<uint8_t> rgba;          // expanded source row (scale > 1)
+    std::vector<uint32_t> acc;          // box filter sums (scale > 1)
+    size_t filled = 0;
+    int row = 0;
+
+    int sample(const uint8_t* raw, size_t i) const {   // i-th sample, depth < 8
+        int perByte = 8 / depth;
+        int shift = 8 - depth * (int)(i % perByte + 1);
+        return (raw[i / perByte] >> shift) & ((1 << depth) - 1);
+    }
+
+    // 一行原始数据 -> RGBA8 (与 stb_image req_comp=4 的结果一致)
+    void expand(const uint8_t* raw, uint8_t* out) const {
+        const int n = width;
+        if (colorType == 3) {
+            for (int x = 0; x < n; x++) {
+                int idx = depth == 8 ? raw[x] : sample(raw, x);
+                memcpy(out + x * 4, palette[idx], 4);
+            }
+            return;
+        }
+        if (depth < 8) {   // 灰度 1/2/4 位
+            static const uint8_t kScale[5] = {0, 0xff, 0x55, 0, 0x11};
+            for (int x = 0; x < n; x++) {
+                int v = sample(raw, x);
+                uint8_t g = (uint8_t)(v * kScale[depth]);
+                out[x * 4 + 0] = out[x * 4 + 1] = out[x * 4 + 2] = g;
+                out[x * 4 + 3] = (hasKey && v == key[0]) ? 0 : 255;
+            }
+            return;
+        }
+        const int bytes = depth / 8;   // 16 位取高字节
+        const int step = channels * bytes;
+        for (int x = 0; x < n; x++) {
+            const uint8_t* s = raw + x * step;
+            uint8_t* d = out + x * 4;
+            switch (colorType) {
+            case 0:
+                d[0] = d[1] = d[2] = s[0];
+                d[3] = (hasKey && (bytes == 1 ? s[0] : (s[0] << 8 | s[1])) == key[0]) ? 0 : 255;
+                break;
+            case 4:
+                d[0] = d[1] = d[2] = s[0];
+                d[3] = s[bytes];
+                break;
+            case 2:
+                d[0] = s[0]; d[1] = s[bytes]; d[2] = s[2 * bytes];
+                if (!hasKey) d[3] = 255;
+                else if (bytes == 1) d[3] = (s[0] == key[0] && s[1] == key[1] && s[2] == key[2]) ? 0 : 255;
+                else d[3] = ((s[0] << 8 | s[1]) == key[0] && (s[2] << 8 | s[3]) == key[1]
+                             && (s[4] << 8 | s[5]) == key[2]) ? 0 : 255;
+                break;
+            default:   // 6
+                d[0] = s[0]; d[1] = s[bytes]; d[2] = s[2 * bytes]; d[3] = s[3 * bytes];
+                break;
+            }
+        }
+    }
+
+    uint8_t* outRow(int group) const {
+        return pixels + (size_t)(flipY ? outH - 1 - group : group) * outW * 4;
+    }
+
+    bool isRgba8() const { return colorType == 6 && depth == 8; }
+
+    // 已反滤波的一行: 丢弃不足一个方块的行, 其余累加进目标行 (RGBA8 直接用原始行)
+    void emit(const uint8_t* raw) {
+        int y = row - top;
+        if (y < 0 || y >= outH * scale) return;
+        int group = y / scale;
+        if (scale == 1) {
+            if (isRgba8()) memcpy(outRow(group), raw, (size_t)width * 4);
+            else expand(raw, outRow(group));
+            return;
+        }
+        const uint8_t* px = raw;
+        if (!isRgba8()) { expand(raw, rgba.data()); px = rgba.data(); }
+        uint32_t* a = acc.data();
+        for (int x = 0; x < outW; x++) {
+            const uint8_t* s = px + (size_t)x * scale * 4;
+            for (int k = 0; k < scale; k++, s += 4) {
+                a[x * 4 + 0] += s[0]; a[x * 4 + 1] += s[1];
+                a[x * 4 + 2] += s[2]; a[x * 4 + 3] += s[3];
+            }
+        }
+        if (y % scale != scale - 1) return;
+        const uint32_t n = (uint32_t)(scale * scale);
+        uint8_t* d = outRow(group);
+        for (int i = 0; i < outW * 4; i++) { d[i] = (uint8_t)(a[i] / n); a[i] = 0; }
+    }
+
+    bool begin(int maxDim, std::string& err) {
+        scale = pngDownsampleScale(width, height, maxDim);
+        outW = width / scale;
+        outH = height / scale;
+        if (outW == 0 || outH == 0) { err = "image too narrow to downsample"; return false; }
+        // 翻转时保留底部 (与先翻转再降采样的 stb 路径一致), 否则保留顶部
+        top = flipY ? height - outH * scale : 0;
+        pixels = (uint8_t*)malloc((size_t)outW * outH * 4);
+        if (!pixels) { err = "out of memory"; return false; }
+        cur.assign(stride + 1, 0);
+        prev.assign(stride + 1, 0);
+        if (scale > 1) {
+            if (!isRgba8()) rgba.resize((size_t)width * 4);
+            acc.assign((size_t)outW * 4, 0);
+        }
+        return true;
+    }
+
+    // 解压出的字节逐行凑齐后反滤波
+    bool feed(const uint8_t* data, size_t len, std::string& err) {
+        while (len > 0 && row < height) {
+            size_t take = cur.size() - filled;
+            if (take > len) take = len;
+            memcpy(cur.data() + filled, data, take);
+            filled += take; data += take; len -= take;
+            if (filled < cur.size()) break;
+            if (!unfilterRow(cur[0], cur.data() + 1, prev.data() + 1, stride, filterBpp)) {
+                err = "invalid filter type";
+                return false;
+            }
+            emit(cur.data() + 1);
+            cur.swap(prev);
+            filled = 0;
+            row++;
+        }
+        return true;
+    }
+};
+
+// 连续的 IDAT 块拼成一条 zlib 流; 遇到下一个非 IDAT 块时停下并保留其块头
+struct IdatReader {
+    Source* src;
+    uint32_t left = 0;      // 当前 IDAT 剩余字节
+    bool ended = false;
+    bool failed = false;
+    uint8_t nextHeader[8] = {};
+
+    bool advance() {
+        if (!src->skip(4) || !src->readExact(nextHeader, 8)) { ended = failed = true; return false; }
+        if (memcmp(nextHeader + 4, "IDAT", 4) != 0) { ended = true; return false; }
+        left = be32(nextHeader);
+        return true;
+    }
+
+    static size_t read(void* user, uint8_t* dst, size_t n) {
+        auto* r = (IdatReader*)user;
+        while (r->left == 0) if (r->ended || !r->advance()) return 0;
+        if (n > r->left) n = r->left;
+        size_t got = r->src->read(r->src->user, dst, n);
+        if (got == 0) { r->ended = r->failed = true; return 0; }
+        r->left -= (uint32_t)got;
+        return got;
+    }
+
+    // 跳过图像之后多余的 IDAT 数据
+    bool finish() {
+        while (!ended) {
+            if (!src->skip(left)) { ended = failed = true; break; }
+            left = 0;
+            advance();
+        }
+        return !failed;
+    }
+};
+
+} // namespace
+
+// ===================== API =====================
+
+int pngDownsampleScale(int width, int height, int maxDim) {
+    int scale = 1;
+    while (width / scale > maxDim || height / scale > maxDim) scale *= 2;
+    return scale;
+}
+
+void freePngImage(PngImage& img) {
+    free(img.pixels);
+    img = PngImage();
+}
+
+bool readPngSize(PngReadFn read, void* user, int& width, int& height) {
+    Source src{read, user};
+    uint8_t h[8 + 8 + 8];   // signature, IHDR chunk header, width + height
+    if (!src.readExact(h, sizeof(h)) || memcmp(h, kSignature, 8) != 0) return false;
+    if (be32(h + 8) != 13 || be32(h + 12) != be32((const uint8_t*)"IHDR")) return false;
+    uint32_t w = be32(h + 16), hh = be32(h + 20);
+    if (w == 0 || hh == 0 || w > (1u << 24) || hh > (1u << 24)) return false;
+    width = (int)w;
+    height = (int)hh;
+    return true;
+}
+
+PngStatus decodePngStream(PngReadFn read, void* user, int maxDim, bool flipY,
+                          PngImage& out, std::string* error) {
+    Source src{read, user};
+    std::string err;
+    auto fail = [&](PngStatus st, const char* msg) { if (error) *error = msg; return st; };
+
+    uint8_t sig[8];
+    if (!src.readExact(sig, 8) || memcmp(sig, kSignature, 8) != 0) return fail(PngStatus::Unsupported, "not a PNG");
+
+    Decoder dec;
+    dec.flipY = flipY;
+    for (int i = 0; i < 256; i++) { dec.palette[i][0] = dec.palette[i][1] = dec.palette[i][2] = 0; dec.palette[i][3] = 255; }
+
+    bool seenHeader = false, started = false;
+    bool pending = false;       // hdr 已由 IdatReader 读出
+    auto abort = [&](PngStatus st, const char* msg) {
+        free(dec.pixels);
+        dec.pixels = nullptr;
+        return fail(st, msg);
+    };
+
+    uint8_t hdr[8];
+    for (;;) {
+        if (pending) pending = false;
+        else if (!src.readExact(hdr, 8)) return abort(PngStatus::Error, "unexpected end of file");
+        uint32_t len = be32(hdr);
+        uint32_t type = be32(hdr + 4);
+        if (len > 0x7fffffffu) return abort(PngStatus::Error, "bad chunk length");
+        auto is = [&](const char* t) { return type == be32((const uint8_t*)t); };
+
+        if (is("CgBI")) {
+            return abort(PngStatus::Unsupported, "Apple CgBI");
+        } else if (is("IHDR")) {
+            uint8_t h[13];
+            if (seenHeader || len != 13 || !src.readExact(h, 13)) return abort(PngStatus::Error, "bad IHDR");
+            uint32_t w = be32(h), hh = be32(h + 4);
+            dec.depth = h[8];
+            dec.colorType = h[9];
+            if (w == 0 || hh == 0 || w > (1u << 24) || hh > (1u << 24)) return abort(PngStatus::Error, "bad image size");
+            if (h[10] != 0 || h[11] != 0) return abort(PngStatus::Error, "bad compression/filter method");
+            if (h[12] != 0) return abort(PngStatus::Unsupported, "interlaced");
+            switch (dec.colorType) {
+            case 0: dec.channels = 1; break;
+            case 2: dec.channels = 3; break;
+            case 3: dec.channels = 1; break;
+            case 4: dec.channels = 2; break;
+            case 6: dec.channels = 4; break;
+            default: return abort(PngStatus::Error, "bad color type");
+            }
+            int d = dec.depth;
+            bool okDepth = (d == 1 || d == 2 || d == 4 || d == 8 || d == 16)
+                && (dec.colorType == 0 || (dec.colorType == 3 ? d <= 8 : d >= 8));
+            if (!okDepth) return abort(PngStatus::Error, "bad bit depth");
+            dec.width = (int)w;
+            dec.height = (int)hh;
+            size_t bits = (size_t)dec.channels * d;
+            dec.stride = ((size_t)w * bits + 7) / 8;
+            dec.filterBpp = bits >= 8 ? bits / 8 : 1;
+            seenHeader = true;
+        } else if (!seenHeader) {
+            return abort(PngStatus::Error, "first chunk not IHDR");
+        } else if (is("PLTE")) {
+            uint8_t p[768];
+            if (len > 768 || len % 3 || !src.readExact(p, len)) return abort(PngStatus::Error, "bad PLTE");
+            for (uint32_t i = 0; i < len / 3; i++) {
+                dec.palette[i][0] = p[i * 3]; dec.palette[i][1] = p[i * 3 + 1]; dec.palette[i][2] = p[i * 3 + 2];
+            }
+        } else if (is("tRNS")) {
+            uint8_t t[256];
+            if (len > 256 || !src.readExact(t, len)) return abort(PngStatus::Error, "bad tRNS");
+            if (dec.colorType == 3) {
+                for (uint32_t i = 0; i < len; i++) dec.palette[i][3] = t[i];
+            } else if (dec.colorType == 0 && len == 2) {
+                dec.key[0] = (uint16_t)(t[0] << 8 | t[1]);
+                dec.hasKey = true;
+            } else if (dec.colorType == 2 && len == 6) {
+                for (int c = 0; c < 3; c++) dec.key[c] = (uint16_t)(t[c * 2] << 8 | t[c * 2 + 1]);
+                dec.hasKey = true;
+            } else {
+                return abort(PngStatus::Error, "bad tRNS");
+            }
+            // 8 位以下的键值只比较有效位, 8 位时只比较低字节 (与 stb 相同)
+            if (dec.depth == 8) for (uint16_t& k : dec.key) k &= 0xff;
+        } else if (is("IDAT")) {
+            if (started) return abort(PngStatus::Error, "IDAT chunks not consecutive");
+            if (!dec.begin(maxDim, err)) return abort(PngStatus::Error, err.c_str());
+            started = true;
+            IdatReader idat{&src, len};
+            {
+                Inflater inf(IdatReader::read, &idat);
+                while (dec.row < dec.height) {
+                    const uint8_t* data;
+                    size_t n;
+                    Inflater::Status st = inf.next(&data, &n);
+                    if (st == Inflater::Error) return abort(PngStatus::Error, idat.failed ? "unexpected end of file" : inf.error());
+                    if (!dec.feed(data, n, err)) return abort(PngStatus::Error, err.c_str());
+                    if (st == Inflater::End && dec.row < dec.height) return abort(PngStatus::Error, "image data too short");
+                }
+            }
+            if (!idat.finish()) return abort(PngStatus::Error, "unexpected end of file");
+            memcpy(hdr, idat.nextHeader, 8);   // IDAT 之后的块 (CRC 已跳过)
+            pending = true;
+            continue;
+        } else if (is("IEND")) {
+            if (!started) return abort(PngStatus::Error, "no image data");
+            if (dec.row < dec.height) return abort(PngStatus::Error, "image data too short");
+            break;
+        } else {
+            if (!src.skip(len)) return abort(PngStatus::Error, "unexpected end of file");
+        }
+        if (!src.skip(4)) return abort(PngStatus::Error, "unexpected end of file");   // CRC (不校验, 与 stb 相同)
+    }
+
+    out.pixels = dec.pixels;
+    out.width = dec.outW;
+    out.height = dec.outH;
+    out.srcWidth = dec.width;
+    out.srcHeight = dec.height;
+    out.scale = dec.scale;
+    return PngStatus::Ok;
+}
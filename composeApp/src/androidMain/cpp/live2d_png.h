@@ -0,0 +1,53 @@
+#pragma once
+
+// Streaming PNG decoder for texture loading.
+//
+// The compressed stream is pulled through a read callback in small pieces and
+// inflated one scanline at a time; each unfiltered row is expanded to RGBA8 and
+// box-filtered straight into the output image. Only the output buffer, two
+// scanlines and an accumulator row are alive at once, so an 8192x8192 atlas
+// downsampled to 2048 peaks at ~16 MB instead of compressed + 256 MB + 16 MB.
+//
+// Inflate is done in-tree (live2d_inflate.h) and unfiltering uses SSE2 / NEON
+// for 3- and 4-byte pixels, so no zlib is linked.
+//
+// Non-interlaced PNGs of every color type and bit depth are handled; Adam7 and
+// Apple CgBI images report Unsupported and go through stb_image instead.
+// Output matches the stb_image path bit for bit (16-bit samples keep the high
+// byte, tRNS applied, same 2^n box filter).
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/** Reads up to n bytes into dst; returns the count, 0 at end of stream or on error. */
+typedef size_t (*PngReadFn)(void* user, uint8_t* dst, size_t n);
+
+enum class PngStatus { Ok, Unsupported, Error };
+
+struct PngImage {
+    uint8_t* pixels = nullptr;   // RGBA8, width * height * 4, release with freePngImage()
+    int width = 0;               // after downsampling
+    int height = 0;
+    int srcWidth = 0;
+    int srcHeight = 0;
+    int scale = 1;               // box filter size (power of two)
+};
+
+/** Halving steps until both sides fit maxDim (the renderer's texture size cap). */
+int pngDownsampleScale(int width, int height, int maxDim);
+
+/**
+ * Image size from the IHDR chunk (reads 24 bytes). False for non-PNG and
+ * Apple CgBI files, whose first chunk is not IHDR.
+ */
+bool readPngSize(PngReadFn read, void* user, int& width, int& height);
+
+/**
+ * Decode a PNG from a stream, halving until both sides are <= maxDim.
+ * flipY stores the bottom row first (GL texture orientation).
+ */
+PngStatus decodePngStream(PngReadFn read, void* user, int maxDim, bool flipY,
+                          PngImage& out, std::string* error = nullptr);
+
+void freePngImage(PngImage& img);
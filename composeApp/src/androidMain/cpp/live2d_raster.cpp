@@ -0,0 +1,493 @@
+#include "live2d_raster.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// ===================== Vector =====================
+// 一个像素的 RGBA 占一个 4 通道向量, 颜色运算都在 [0, 1] 浮点上做 (同着色器)
+
+#if defined(__SSE2__)
+
+struct V4 {
+    __m128 v;
+    static V4 splat(float x) { return {_mm_set1_ps(x)}; }
+    static V4 set(float r, float g, float b, float a) { return {_mm_setr_ps(r, g, b, a)}; }
+    static V4 load(const float* p) { return {_mm_loadu_ps(p)}; }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+    // 4 个 8 位通道 -> 0..255
+    static V4 fromU8(uint32_t px) {
+        __m128i z = _mm_setzero_si128();
+        __m128i i = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)px), z), z);
+        return {_mm_cvtepi32_ps(i)};
+    }
+    // 0..1 -> 8 位, 就近舍入
+    uint32_t toU8() const {
+        __m128i i = _mm_cvtps_epi32(_mm_mul_ps(v, _mm_set1_ps(255.f)));
+        i = _mm_packs_epi32(i, i);
+        return (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(i, i));
+    }
+    V4 alpha() const { return {_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))}; }
+    float a() const { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))); }
+};
+
+inline V4 operator+(V4 a, V4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline V4 operator-(V4 a, V4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline V4 operator*(V4 a, V4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline V4 vmin(V4 a, V4 b) { return {_mm_min_ps(a.v, b.v)}; }
+inline V4 vmax(V4 a, V4 b) { return {_mm_max_ps(a.v, b.v)}; }
+
+#elif defined(__ARM_NEON)
+
+struct V4 {
+    float32x4_t v;
+    static V4 splat(float x) { return {vdupq_n_f32(x)}; }
+    static V4 set(float r, float g, float b, float a) { const float t[4] = {r, g, b, a}; return {vld1q_f32(t)}; }
+    static V4 load(const float* p) { return {vld1q_f32(p)}; }
+    void store(float* p) const { vst1q_f32(p, v); }
+    static V4 fromU8(uint32_t px) {
+        uint8x8_t b = vreinterpret_u8_u32(vdup_n_u32(px));
+        return {vcvtq_f32_u32(vmovl_u16(vget_low_u16(vmovl_u8(b))))};
+    }
+    // 值非负, +0.5 后截断即就近舍入
+    uint32_t toU8() const {
+        uint16x4_t h = vmovn_u32(vcvtq_u32_f32(vmlaq_n_f32(vdupq_n_f32(0.5f), v, 255.f)));
+        uint8x8_t b = vmovn_u16(vcombine_u16(h, h));
+        return vget_lane_u32(vreinterpret_u32_u8(b), 0);
+    }
+    V4 alpha() const { return {vdupq_n_f32(vgetq_lane_f32(v, 3))}; }
+    float a() const { return vgetq_lane_f32(v, 3); }
+};
+
+inline V4 operator+(V4 a, V4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline V4 operator-(V4 a, V4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline V4 operator*(V4 a, V4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline V4 vmin(V4 a, V4 b) { return {vminq_f32(a.v, b.v)}; }
+inline V4 vmax(V4 a, V4 b) { return {vmaxq_f32(a.v, b.v)}; }
+
+#else
+
+struct V4 {
+    float v[4];
+    static V4 splat(float x) { return {{x, x, x, x}}; }
+    static V4 set(float r, float g, float b, float a) { return {{r, g, b, a}}; }
+    static V4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+    void store(float* p) const { memcpy(p, v, sizeof(v)); }
+    static V4 fromU8(uint32_t px) {
+        return {{(float)(px & 0xFF), (float)(px >> 8 & 0xFF), (float)(px >> 16 & 0xFF), (float)(px >> 24)}};
+    }
+    uint32_t toU8() const {
+        uint32_t r = 0;
+        for (int c = 0; c < 4; c++) r |= (uint32_t)(v[c] * 255.f + 0.5f) << (8 * c);
+        return r;
+    }
+    V4 alpha() const { return splat(v[3]); }
+    float a() const { return v[3]; }
+};
+
+inline V4 operator+(V4 a, V4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline V4 operator-(V4 a, V4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+inline V4 operator*(V4 a, V4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline V4 vmin(V4 a, V4 b) {
+    return {{std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3])}};
+}
+inline V4 vmax(V4 a, V4 b) {
+    return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}};
+}
+
+#endif
+
+inline uint32_t load32(const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+inline void store32(uint8_t* p, uint32_t v) { memcpy(p, &v, 4); }
+
+bool isPowerOfTwo(int v) { return v > 0 && (v & (v - 1)) == 0; }
+
+// ===================== Sampling =====================
+
+// GL_LINEAR + CLAMP_TO_EDGE
+V4 sampleLevel(const RasterTexture::Level& l, float u, float v) {
+    float tx = std::min(std::max(u * l.width - 0.5f, -1.f), (float)l.width);
+    float ty = std::min(std::max(v * l.height - 0.5f, -1.f), (float)l.height);
+    float fx0 = floorf(tx), fy0 = floorf(ty);
+    int ix = (int)fx0, iy = (int)fy0;
+    V4 fx = V4::splat(tx - fx0), fy = V4::splat(ty - fy0);
+    int x0 = std::max(ix, 0), x1 = std::min(ix + 1, l.width - 1);
+    int y0 = std::max(iy, 0), y1 = std::min(iy + 1, l.height - 1);
+    x0 = std::min(x0, l.width - 1); y0 = std::min(y0, l.height - 1);
+    x1 = std::max(x1, 0); y1 = std::max(y1, 0);
+    const uint8_t* row0 = l.pixels.data() + (size_t)y0 * l.width * 4;
+    const uint8_t* row1 = l.pixels.data() + (size_t)y1 * l.width * 4;
+    V4 a = V4::fromU8(load32(row0 + x0 * 4)), b = V4::fromU8(load32(row0 + x1 * 4));
+    V4 c = V4::fromU8(load32(row1 + x0 * 4)), d = V4::fromU8(load32(row1 + x1 * 4));
+    V4 bottom = a + (b - a) * fx, top = c + (d - c) * fx;
+    return (bottom + (top - bottom) * fy) * V4::splat(1.f / 255.f);
+}
+
+// ===================== Setup =====================
+// 顶点变换到像素坐标 (左下角原点, 同 GL 窗口坐标) 并转成 8 位亚像素定点;
+// 三角形统一成逆时针, 记下原来的朝向供单面 drawable 剔除
+
+const int kTile = 64;
+const int kSubBits = 8;
+const int64_t kSub = 1 << kSubBits;
+const float kMaxCoord = 1 << 20;   // 像素坐标上限, 保证边函数不溢出 int64
+
+struct Tri {
+    int64_t x[3], y[3];            // 定点, 逆时针
+    bool    back = false;          // 原本是顺时针
+    int     x0, y0, x1, y1;        // 覆盖的像素 (中心) 范围, 闭区间, 已裁剪到目标
+    float   u, dudx, dudy;         // 像素坐标 (0, 0) 处的 UV 与梯度
+    float   v, dvdx, dvdy;
+    int     level = 0;             // 纹理 LOD: level 与 level + 1 之间按 levelFrac 混合
+    float   levelFrac = 0;
+};
+
+struct DrawableSetup {
+    int firstTri = 0, triCount = 0;
+    int x0 = INT_MAX, y0 = INT_MAX, x1 = -1, y1 = -1;   // 三角形范围的并集
+    bool empty() const { return triCount == 0; }
+};
+
+struct PixelBox {
+    int x0, y0, x1, y1;   // 闭区间
+    bool empty() const { return x1 < x0 || y1 < y0; }
+};
+
+PixelBox intersect(const PixelBox& a, const PixelBox& b) {
+    return {std::max(a.x0, b.x0), std::max(a.y0, b.y0), std::min(a.x1, b.x1), std::min(a.y1, b.y1)};
+}
+
+// 与 GL 相同的 LOD: rho = 纹素坐标对屏幕 x / y 偏导的较大长度, lambda = log2(rho)
+void selectLod(Tri& t, const RasterTexture& tex) {
+    int levels = (int)tex.levels.size();
+    if (levels <= 1) return;
+    float w = (float)tex.levels[0].width, h = (float)tex.levels[0].height;
+    float rx = std::hypot(t.dudx * w, t.dvdx * h), ry = std::hypot(t.dudy * w, t.dvdy * h);
+    float rho = std::max(rx, ry);
+    if (!(rho > 1.f)) return;
+    float lambda = std::min(log2f(rho), (float)(levels - 1));
+    t.level = (int)lambda;
+    t.levelFrac = lambda - t.level;
+    if (t.level >= levels - 1) { t.level = levels - 1; t.levelFrac = 0; }
+}
+
+void setupDrawable(const RasterDrawable& d, const RasterTexture& tex, const float* m, int width, int height,
+                   std::vector<int64_t>& fixedXY, std::vector<Tri>& tris, DrawableSetup& s) {
+    s.firstTri = (int)tris.size();
+    fixedXY.resize((size_t)d.vertexCount * 2);
+    for (int i = 0; i < d.vertexCount; i++) {
+        float x = d.positions[i * 2], y = d.positions[i * 2 + 1];
+        float nx = m[0] * x + m[4] * y + m[12];
+        float ny = m[1] * x + m[5] * y + m[13];
+        float px = std::min(std::max((nx + 1.f) * 0.5f * width, -kMaxCoord), kMaxCoord);
+        float py = std::min(std::max((ny + 1.f) * 0.5f * height, -kMaxCoord), kMaxCoord);
+        fixedXY[i * 2]     = (int64_t)llroundf(px * kSub);
+        fixedXY[i * 2 + 1] = (int64_t)llroundf(py * kSub);
+    }
+
+    for (int k = 0; k + 2 < d.indexCount; k += 3) {
+        int vi[3] = {d.indices[k], d.indices[k + 1], d.indices[k + 2]};
+        if (vi[0] >= d.vertexCount || vi[1] >= d.vertexCount || vi[2] >= d.vertexCount) continue;
+        Tri t;
+        for (int j = 0; j < 3; j++) { t.x[j] = fixedXY[vi[j] * 2]; t.y[j] = fixedXY[vi[j] * 2 + 1]; }
+        int64_t area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.x[2] - t.x[0]) * (t.y[1] - t.y[0]);
+        if (area == 0) continue;
+        if (area < 0) {
+            t.back = true;
+            std::swap(t.x[1], t.x[2]); std::swap(t.y[1], t.y[2]); std::swap(vi[1], vi[2]);
+        }
+
+        // 像素 p 被覆盖的必要条件: 中心 (p + 0.5) 落在包围盒内
+        int64_t minX = std::min({t.x[0], t.x[1], t.x[2]}), maxX = std::max({t.x[0], t.x[1], t.x[2]});
+        int64_t minY = std::min({t.y[0], t.y[1], t.y[2]}), maxY = std::max({t.y[0], t.y[1], t.y[2]});
+        int64_t half = kSub / 2;
+        t.x0 = (int)std::max<int64_t>(0, -((half - minX) >> kSubBits));
+        t.y0 = (int)std::max<int64_t>(0, -((half - minY) >> kSubBits));
+        t.x1 = (int)std::min<int64_t>(width - 1, (maxX - half) >> kSubBits);
+        t.y1 = (int)std::min<int64_t>(height - 1, (maxY - half) >> kSubBits);
+        if (t.x1 < t.x0 || t.y1 < t.y0) continue;
+
+        // UV 平面方程 (双精度求解, 像素坐标)
+        double x0 = (double)t.x[0] / kSub, y0 = (double)t.y[0] / kSub;
+        double ex1 = (double)t.x[1] / kSub - x0, ey1 = (double)t.y[1] / kSub - y0;
+        double ex2 = (double)t.x[2] / kSub - x0, ey2 = (double)t.y[2] / kSub - y0;
+        double det = ex1 * ey2 - ex2 * ey1;
+        const float* uv = d.uvs;
+        double u0 = uv[vi[0] * 2], du1 = uv[vi[1] * 2] - u0, du2 = uv[vi[2] * 2] - u0;
+        double v0 = uv[vi[0] * 2 + 1], dv1 = uv[vi[1] * 2 + 1] - v0, dv2 = uv[vi[2] * 2 + 1] - v0;
+        double dudx = (du1 * ey2 - du2 * ey1) / det, dudy = (du2 * ex1 - du1 * ex2) / det;
+        double dvdx = (dv1 * ey2 - dv2 * ey1) / det, dvdy = (dv2 * ex1 - dv1 * ex2) / det;
+        t.dudx = (float)dudx; t.dudy = (float)dudy; t.u = (float)(u0 - dudx * x0 - dudy * y0);
+        t.dvdx = (float)dvdx; t.dvdy = (float)dvdy; t.v = (float)(v0 - dvdx * x0 - dvdy * y0);
+        selectLod(t, tex);
+
+        s.x0 = std::min(s.x0, t.x0); s.y0 = std::min(s.y0, t.y0);
+        s.x1 = std::max(s.x1, t.x1); s.y1 = std::max(s.y1, t.y1);
+        tris.push_back(t);
+    }
+    s.triCount = (int)tris.size() - s.firstTri;
+}
+
+// ===================== Tiles =====================
+
+// 对 box 内被三角形覆盖的像素调用 pixel(px, py, u, v)。
+// 边函数 E = (Xb - Xa)(Py - Ya) - (Yb - Ya)(Px - Xa) 在逆时针三角形内部为正;
+// 恰好落在边上的像素只归左边 / 上边 (top-left 规则), 相邻三角形的公共边不会画两次
+template <typename F>
+void walkTriangle(const Tri& t, const PixelBox& box, F&& pixel) {
+    PixelBox r = intersect({t.x0, t.y0, t.x1, t.y1}, box);
+    if (r.empty()) return;
+    int64_t stepX[3], stepY[3], row[3];
+    int64_t px0 = (int64_t)r.x0 * kSub + kSub / 2, py0 = (int64_t)r.y0 * kSub + kSub / 2;
+    for (int e = 0; e < 3; e++) {
+        int a = e, b = e == 2 ? 0 : e + 1;
+        int64_t dx = t.x[b] - t.x[a], dy = t.y[b] - t.y[a];
+        bool topLeft = dy < 0 || (dy == 0 && dx < 0);
+        stepX[e] = -dy * kSub;
+        stepY[e] = dx * kSub;
+        row[e] = dx * (py0 - t.y[a]) - dy * (px0 - t.x[a]) + (topLeft ? 0 : -1);
+    }
+    for (int py = r.y0; py <= r.y1; py++) {
+        int64_t e0 = row[0], e1 = row[1], e2 = row[2];
+        float fy = py + 0.5f;
+        float uRow = t.u + t.dudy * fy, vRow = t.v + t.dvdy * fy;
+        for (int px = r.x0; px <= r.x1; px++) {
+            if ((e0 | e1 | e2) >= 0) {
+                float fx = px + 0.5f;
+                pixel(px, py, uRow + t.dudx * fx, vRow + t.dvdx * fx);
+            }
+            e0 += stepX[0]; e1 += stepX[1]; e2 += stepX[2];
+        }
+        row[0] += stepY[0]; row[1] += stepY[1]; row[2] += stepY[2];
+    }
+}
+
+V4 sample(const RasterTexture& tex, const Tri& t, float u, float v) {
+    V4 c = sampleLevel(tex.levels[t.level], u, v);
+    if (t.levelFrac > 0) c = c + (sampleLevel(tex.levels[t.level + 1], u, v) - c) * V4::splat(t.levelFrac);
+    return c;
+}
+
+struct Frame {
+    const RasterDrawable* drawables;
+    int drawableCount;
+    const int* order;
+    int count;
+    const RasterTexture* textures;
+    const std::vector<Tri>* tris;
+    const std::vector<DrawableSetup>* setups;
+    const RasterTarget* target;
+    int tilesX;
+};
+
+// 一个 tile: color 为 kTile x kTile 的预乘 RGBA (左下角原点), mask 为同尺寸的遮罩值
+bool renderTile(const Frame& f, int tile, float* color, float* mask) {
+    const RasterTarget& target = *f.target;
+    int tx = tile % f.tilesX, ty = tile / f.tilesX;
+    PixelBox box = {tx * kTile, ty * kTile,
+                    std::min((tx + 1) * kTile, target.width) - 1, std::min((ty + 1) * kTile, target.height) - 1};
+    std::fill(color, color + kTile * kTile * 4, 0.f);
+    const std::vector<Tri>& tris = *f.tris;
+    const std::vector<DrawableSetup>& setups = *f.setups;
+    auto at = [&](int px, int py) { return (py - box.y0) * kTile + (px - box.x0); };
+
+    const V4 one = V4::splat(1.f), zero = V4::splat(0.f);
+    const V4 rgb = V4::set(1, 1, 1, 0), alpha = V4::set(0, 0, 0, 1);
+    bool drew = false;
+    for (int k = 0; k < f.count; k++) {
+        int di = f.order[k];
+        if (di < 0 || di >= f.drawableCount) continue;
+        const DrawableSetup& s = setups[di];
+        if (s.empty()) continue;
+        PixelBox r = intersect({s.x0, s.y0, s.x1, s.y1}, box);
+        if (r.empty()) continue;
+        const RasterDrawable& d = f.drawables[di];
+        const RasterTexture& tex = f.textures[d.texture];
+
+        // ---- 遮罩: 来源 drawable 的 alpha x 不透明度累加 (GL 的 ONE, ONE 混合, 饱和到 1) ----
+        bool masked = d.maskCount > 0 && d.masks;
+        if (masked) {
+            for (int py = r.y0; py <= r.y1; py++) std::fill(mask + at(r.x0, py), mask + at(r.x1, py) + 1, 0.f);
+            for (int mk = 0; mk < d.maskCount; mk++) {
+                int mi = d.masks[mk];
+                if (mi < 0 || mi >= f.drawableCount || setups[mi].empty()) continue;
+                const DrawableSetup& ms = setups[mi];
+                if (intersect({ms.x0, ms.y0, ms.x1, ms.y1}, r).empty()) continue;
+                const RasterDrawable& md = f.drawables[mi];
+                const RasterTexture& mtex = f.textures[md.texture];
+                for (int ti = ms.firstTri; ti < ms.firstTri + ms.triCount; ti++) {
+                    const Tri& t = tris[ti];
+                    walkTriangle(t, r, [&](int px, int py, float u, float v) {
+                        float& m = mask[at(px, py)];
+                        m = std::min(1.f, m + sample(mtex, t, u, v).a() * md.opacity);
+                    });
+                }
+            }
+        }
+
+        // ---- drawable: 同 kDrawFS 的运算顺序, 再按混合模式写入 ----
+        const V4 mul = V4::set(d.multiply[0], d.multiply[1], d.multiply[2], 1.f);
+        const V4 scr = V4::set(d.screen[0], d.screen[1], d.screen[2], 0.f);
+        const bool hasMul = d.multiply[0] != 1.f || d.multiply[1] != 1.f || d.multiply[2] != 1.f;
+        const bool hasScr = d.screen[0] != 0.f || d.screen[1] != 0.f || d.screen[2] != 0.f;
+        const V4 opacity = V4::splat(d.opacity);
+        for (int ti = s.firstTri; ti < s.firstTri + s.triCount; ti++) {
+            const Tri& t = tris[ti];
+            if (t.back && !d.doubleSided) continue;
+            walkTriangle(t, r, [&](int px, int py, float u, float v) {
+                int i = at(px, py);
+                V4 c = sample(tex, t, u, v);
+                if (masked) {
+                    float m = d.invertedMask ? 1.f - mask[i] : mask[i];
+                    c = c * V4::splat(m);
+                }
+                if (hasMul) c = c * mul;
+                if (hasScr) c = vmin(one, vmax(zero, c + scr * c.alpha() - c * scr));
+                c = c * opacity;
+                float* p = color + i * 4;
+                V4 dst = V4::load(p);
+                switch (d.blend) {
+                case RasterBlend::Normal:   dst = c + dst * (one - c.alpha()); break;
+                case RasterBlend::Additive: dst = dst + c * rgb; break;
+                case RasterBlend::Multiply: dst = (c * dst + dst * (one - c.alpha())) * rgb + dst * alpha; break;
+                }
+                vmin(one, dst).store(p);
+            });
+        }
+        drew = true;
+    }
+
+    // 输出顶行在前
+    int stride = target.stride > 0 ? target.stride : target.width * 4;
+    for (int py = box.y0; py <= box.y1; py++) {
+        uint8_t* out = target.pixels + (size_t)(target.height - 1 - py) * stride + (size_t)box.x0 * 4;
+        const float* src = color + at(box.x0, py) * 4;
+        if (!drew) { memset(out, 0, (size_t)(box.x1 - box.x0 + 1) * 4); continue; }
+        for (int px = box.x0; px <= box.x1; px++, src += 4, out += 4) store32(out, V4::load(src).toU8());
+    }
+    return drew;
+}
+
+}  // namespace
+
+// ===================== Textures =====================
+
+void buildRasterTexture(const uint8_t* rgba, int width, int height, bool premultiplied, RasterTexture& out) {
+    out.levels.clear();
+    if (!rgba || width <= 0 || height <= 0) return;
+    out.levels.emplace_back();
+    RasterTexture::Level& base = out.levels.back();
+    base.width = width;
+    base.height = height;
+    base.pixels.assign(rgba, rgba + (size_t)width * height * 4);
+    if (!premultiplied) {
+        // straight -> 预乘, round(c * a / 255), 与纹理解码线程相同
+        uint8_t* p = base.pixels.data();
+        for (size_t i = 0, n = (size_t)width * height; i < n; i++, p += 4) {
+            unsigned a = p[3];
+            if (a == 255) continue;
+            for (int c = 0; c < 3; c++) {
+                unsigned t = p[c] * a + 128;
+                p[c] = (uint8_t)((t + (t >> 8)) >> 8);
+            }
+        }
+    }
+    if (!isPowerOfTwo(width) || !isPowerOfTwo(height)) return;
+
+    // 2x2 盒式滤波 mipmap, 一边到 1 后只在另一边上减半
+    while (out.levels.back().width > 1 || out.levels.back().height > 1) {
+        const RasterTexture::Level& src = out.levels.back();
+        RasterTexture::Level dst;
+        dst.width = std::max(1, src.width / 2);
+        dst.height = std::max(1, src.height / 2);
+        dst.pixels.resize((size_t)dst.width * dst.height * 4);
+        int sx = src.width > 1 ? 1 : 0, sy = src.height > 1 ? 1 : 0;
+        for (int y = 0; y < dst.height; y++) {
+            const uint8_t* r0 = src.pixels.data() + (size_t)(y * 2) * src.width * 4;
+            const uint8_t* r1 = r0 + (size_t)sy * src.width * 4;
+            uint8_t* o = dst.pixels.data() + (size_t)y * dst.width * 4;
+            for (int x = 0; x < dst.width; x++) {
+                int a = x * 2 * 4, b = (x * 2 + sx) * 4;
+                for (int c = 0; c < 4; c++)
+                    o[x * 4 + c] = (uint8_t)((r0[a + c] + r0[b + c] + r1[a + c] + r1[b + c] + 2) >> 2);
+            }
+        }
+        out.levels.push_back(std::move(dst));
+    }
+}
+
+// ===================== Rasterize =====================
+
+void rasterizeDrawables(const RasterDrawable* drawables, int drawableCount,
+                        const int* order, int count,
+                        const RasterTexture* textures, int textureCount,
+                        const float* matrix, const RasterTarget& target,
+                        int threads, RasterStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    if (!target.pixels || target.width <= 0 || target.height <= 0) return;
+
+    // 要画的 drawable 及其遮罩来源
+    std::vector<char> needed(drawableCount, 0);
+    for (int k = 0; k < count; k++) {
+        int di = order[k];
+        if (di < 0 || di >= drawableCount) continue;
+        needed[di] = 1;
+        const RasterDrawable& d = drawables[di];
+        for (int m = 0; d.masks && m < d.maskCount; m++)
+            if (d.masks[m] >= 0 && d.masks[m] < drawableCount) needed[d.masks[m]] = 1;
+    }
+
+    std::vector<Tri> tris;
+    std::vector<DrawableSetup> setups(drawableCount);
+    std::vector<int64_t> fixedXY;
+    for (int di = 0; di < drawableCount; di++) {
+        const RasterDrawable& d = drawables[di];
+        if (!needed[di] || !d.positions || !d.uvs || !d.indices || d.vertexCount <= 0 || d.indexCount < 3) continue;
+        if (d.opacity <= 0.f || d.texture < 0 || d.texture >= textureCount || textures[d.texture].levels.empty()) continue;
+        setupDrawable(d, textures[d.texture], matrix, target.width, target.height, fixedXY, tris, setups[di]);
+    }
+
+    Frame f;
+    f.drawables = drawables;
+    f.drawableCount = drawableCount;
+    f.order = order;
+    f.count = count;
+    f.textures = textures;
+    f.tris = &tris;
+    f.setups = &setups;
+    f.target = &target;
+    f.tilesX = (target.width + kTile - 1) / kTile;
+    int tileCount = f.tilesX * ((target.height + kTile - 1) / kTile);
+
+    int workers = threads > 0 ? threads : (int)std::min(8u, std::max(1u, std::thread::hardware_concurrency()));
+    workers = std::max(1, std::min(workers, tileCount));
+    std::atomic<int> next{0}, drawn{0};
+    auto work = [&] {
+        std::vector<float> color(kTile * kTile * 4), mask(kTile * kTile);
+        for (int t; (t = next.fetch_add(1)) < tileCount;)
+            if (renderTile(f, t, color.data(), mask.data())) drawn.fetch_add(1);
+    };
+    std::vector<std::thread> pool;
+    for (int w = 1; w < workers; w++) pool.emplace_back(work);
+    work();
+    for (std::thread& t : pool) t.join();
+
+    if (stats) {
+        stats->threads = workers;
+        stats->tiles = drawn.load();
+        stats->triangles = (int)tris.size();
+        stats->ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
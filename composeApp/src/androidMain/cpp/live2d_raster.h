@@ -0,0 +1,83 @@
+#pragma once
+
+// CPU rasterizer for Live2D drawables: model thumbnails off the GL thread,
+// previews in host tools, and a reference image for GL image-diff tests.
+//
+// Input is the per-drawable data the GL path submits (csmGetDrawable* vertex
+// positions, UVs, indices, opacities, blend / culling flags, multiply and
+// screen colors, masks); output is premultiplied RGBA8 in memory. Per pixel it
+// does what the draw shaders do: bilinear texture fetch (trilinear when the
+// texture has mipmaps), clipping mask = sum of the mask drawables' alpha x
+// opacity clamped to 1, multiply / screen color, opacity, then the normal /
+// additive / multiplicative blend equations of the GL pipeline table.
+//
+// The target is cut into 64x64 tiles handed out to a small thread pool. Each
+// tile owns a float color buffer and a mask buffer, so tiles share no state;
+// a pixel's RGBA is one 4-lane vector (SSE2 / NEON, scalar elsewhere).
+// Triangles are walked in 8-bit subpixel fixed point with pixel-center sampling
+// and a top-left fill rule, so edges fall on the same pixels as on a GPU.
+
+#include <cstdint>
+#include <vector>
+
+enum class RasterBlend { Normal, Additive, Multiply };
+
+/** Premultiplied RGBA8 texture and its mip chain, bottom row first (GL texture orientation). */
+struct RasterTexture {
+    struct Level {
+        int width = 0, height = 0;
+        std::vector<uint8_t> pixels;
+    };
+    std::vector<Level> levels;   // empty = drawables using it are skipped
+};
+
+/**
+ * Build a RasterTexture from RGBA8 pixels (bottom row first). Straight alpha is
+ * premultiplied. Power-of-two sizes get a box-filtered mip chain, as the GL
+ * textures do; other sizes are sampled from level 0 only.
+ */
+void buildRasterTexture(const uint8_t* rgba, int width, int height, bool premultiplied, RasterTexture& out);
+
+struct RasterDrawable {
+    const float*    positions = nullptr;   // vertexCount x (x, y), model units
+    const float*    uvs = nullptr;         // vertexCount x (u, v), v = 0 at the texture bottom
+    const uint16_t* indices = nullptr;     // triangle list
+    int   vertexCount = 0;
+    int   indexCount = 0;
+    int   texture = -1;
+    float opacity = 1;
+    RasterBlend blend = RasterBlend::Normal;
+    bool  doubleSided = true;              // false: clockwise (back-facing) triangles are culled
+    float multiply[3] = {1, 1, 1};
+    float screen[3] = {0, 0, 0};
+    const int* masks = nullptr;            // drawables whose alpha clips this one
+    int   maskCount = 0;
+    bool  invertedMask = false;
+};
+
+struct RasterTarget {
+    uint8_t* pixels = nullptr;   // premultiplied RGBA8, top row first; fully overwritten
+    int width = 0;
+    int height = 0;
+    int stride = 0;              // bytes per row, 0 = width * 4
+};
+
+struct RasterStats {
+    int    threads = 0;
+    int    tiles = 0;       // tiles that had something to draw
+    int    triangles = 0;   // triangles set up (drawables and mask sources) after culling
+    double ms = 0;
+};
+
+/**
+ * Draw drawables[order[0]] .. drawables[order[count - 1]] in that order over a
+ * transparent background. Mask sources are drawn for the mask only, whether or
+ * not they are in order. matrix is the column-major model -> NDC matrix of the
+ * GL path. threads <= 0 uses the hardware concurrency (at most 8).
+ * Safe to call from any thread; nothing is shared between calls.
+ */
+void rasterizeDrawables(const RasterDrawable* drawables, int drawableCount,
+                        const int* order, int count,
+                        const RasterTexture* textures, int textureCount,
+                        const float* matrix, const RasterTarget& target,
+                        int threads = 0, RasterStats* stats = nullptr);
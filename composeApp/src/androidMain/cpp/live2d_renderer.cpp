@@ -0,0 +1,4750 @@
+#include "live2d_renderer.h"
+#include "live2d_calltrace.h"
+#include "live2d_log.h"
+#include "live2d_arena.h"
+#include "live2d_bundle.h"
+#include "live2d_png.h"
+#include "live2d_raster.h"
+#ifdef LIVE2D_VULKAN
+#include "live2d_vulkan.h"
+#endif
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include "live2d_gl.h"
+#ifdef __ANDROID__
+#include <android/asset_manager.h>
+#endif
+#include <cstdio>
+#include "live2d/include/Live2DCubismCore.h"
+#include "stb_image.h"
+#include <ctime>
+
+// ===================== Data Structures =====================
+
+// 每张纹理的驻留分辨率 (见 Texture LOD)
+struct TextureLod {
+    std::string path;
+    int   srcWidth = 0, srcHeight = 0;  // PNG 原始尺寸, 0 = 不参与 LOD
+    int   minScale = 1;                 // kMaxTextureSize 上限对应的缩小倍数
+    int   scale    = 1;                 // 当前 level 0 的缩小倍数 (2 的幂)
+    int   width = 0, height = 0;        // 当前 level 0 尺寸
+    bool  mipmapped = false;
+    float texelsPerUnit = 0;            // 原图每模型单位的纹素数 (加载时由网格 UV 估算)
+    int   wanted = 0;                   // 最近一次算出的目标倍数
+    float wantedTime = 0;               // wanted 保持不变的时长 (秒)
+    int   trimScale = 1;                // trimMemory 之后的倍数下限, 保持期结束后回到 1
+    float useOpacity = 0;               // 本帧使用它的可见 drawable 的最大不透明度 (见 Texture Residency)
+    float unusedTime = 0;               // 连续未被使用的时长 (秒)
+    bool  premultiplied = false;        // level 0 已在解码线程预乘 alpha (见 Draw Programs)
+};
+
+// drawable 顶点的模型空间 AABB (见 Screen Bounds)
+struct DrawableBounds { float minX = 0, minY = 0, maxX = 0, maxY = 0; };
+
+struct Live2DModel {
+    csmMoc*   moc         = nullptr;
+    csmModel* model       = nullptr;
+    void*     mocBuffer   = nullptr;
+    void*     modelBuffer = nullptr;
+    bool      mocInBundle = false;   // mocBuffer 指向 bundle 映射, 不单独释放
+    size_t    mocSize     = 0;
+    size_t    modelSize   = 0;
+
+    std::vector<GLuint> textureIds;
+    std::vector<TextureLod> textureLods;
+    std::string         modelDir;
+
+    std::map<std::string, int, std::less<>> parameterMap;  // 透明比较: const char* 查找不构造临时 string
+
+    std::vector<DrawableBounds> drawableBounds;   // 加载时按 drawable 数分配
+    bool boundsStale = true;                      // 下一帧全部重算
+
+    float canvasWidth    = 0;
+    float canvasHeight   = 0;
+    float canvasOriginX  = 0;
+    float canvasOriginY  = 0;
+    float pixelsPerUnit  = 1;
+
+    bool loaded = false;
+};
+
+struct ShaderInfo {
+    GLuint program    = 0;
+    GLint  a_position = -1;
+    GLint  a_texCoord = -1;
+    GLint  u_matrix   = -1;
+    GLint  u_texture  = -1;
+    GLint  u_opacity  = -1;
+    GLint  u_multiplyColor = -1;
+    GLint  u_screenColor   = -1;
+    GLint  u_mask          = -1;
+    GLint  u_viewportSize  = -1;
+    bool   failed = false;          // 编译失败, 不再重试
+};
+
+// ===================== Globals =====================
+
+#ifdef __ANDROID__
+static AAssetManager* g_assetManager = nullptr;
+#endif
+static Live2DModel    g_model;
+static int   g_viewWidth  = 0;
+static int   g_viewHeight = 0;
+static float g_projMatrix[16];
+static bool  g_initialized = false;
+static bool  g_gles3 = false;          // 上下文是 GLES 3.x, 走 VAO / UBO 路径 (见 GLES3 Path)
+static bool  g_gles3Enabled = true;    // setGLES3Enabled(false) 时总走 GLES2 路径
+static RenderBackend g_backend = RenderBackend::GLES;   // Vulkan 时纹理 ID 是 vulkanCreateTexture 的 ID (见 Vulkan)
+
+// User‑controlled model transform (drag & pinch)
+static float g_userScale   = 1.0f;   // pinch zoom
+static float g_userOffsetX = 0.0f;   // drag offset in NDC (−1..1)
+static float g_userOffsetY = 0.0f;
+
+
+
+// ===================== Motion / Animation =====================
+
+struct MotionKeyframe { float time; float value; };
+struct MotionCurve    { std::string paramId; std::vector<MotionKeyframe> keyframes; };
+static_assert(sizeof(MotionKeyframe) == 8, "baked motion keyframes are copied as (time, value) pairs");
+struct MotionData     { float duration = 4.f; bool loop = true; float fadeInTime = 0.5f; float fadeOutTime = 0.5f; std::vector<MotionCurve> curves; };
+
+static MotionData g_idleMotion;
+static bool       g_hasIdleMotion = false;
+static float      g_motionTime    = 0.f;
+static double     g_lastTime      = 0.0;
+
+// Active (non-idle) motion system
+static MotionData g_activeMotion;
+static bool       g_hasActiveMotion = false;
+static float      g_activeMotionTime = 0.f;
+static int        g_activeMotionPriority = 0;
+
+// Expression system
+enum class ExprBlend { Add, Multiply, Overwrite };
+struct ExprParam { std::string paramId; float value; ExprBlend blend; };
+struct ExpressionData {
+    std::string name;
+    std::string file;            // 完整路径; trimMemory 释放 params 后按需重新解析
+    bool loaded = false;
+    std::vector<ExprParam> params;
+};
+
+static std::map<std::string, ExpressionData> g_expressions; // name -> data
+static std::string g_currentExpressionId;
+static float       g_expressionFadeWeight = 0.f; // 0..1 fade progress
+static float       g_expressionFadeSpeed  = 3.f; // fade in/out speed (per second)
+static bool        g_expressionFadingIn   = false;
+
+// Motion file paths (loaded from model3.json, for on-demand loading)
+struct MotionEntry { std::string file; };
+static std::map<std::string, std::vector<MotionEntry>> g_motionGroups; // group -> entries
+
+// External parameter overrides (set by Kotlin JNI, applied after animation each frame).
+// Dense per-parameter slots sized at model load, so setting one never allocates.
+struct ParamOverride { float value = 0.f; float weight = 0.f; bool active = false; };
+static std::vector<ParamOverride> g_externalOverrides; // paramIdx -> override
+
+// ===================== Pose System =====================
+// Manages mutually exclusive parts (e.g. arm variants A/B).
+// Only one part in each group should be visible at a time,
+// with smooth crossfade between them.
+struct PosePartInfo {
+    std::string partId;
+    int partIndex = -1;     // index into csmGetPartOpacities
+    std::vector<std::string> linkIds; // linked parts (unused in simple models)
+    std::vector<int> linkIndices;
+};
+// Each group = vector of mutually exclusive parts. First one is default visible.
+static std::vector<std::vector<PosePartInfo>> g_poseGroups;
+static bool g_hasPose = false;
+static const float POSE_FADE_SPEED = 5.0f; // opacity change per second
+
+// ===================== Physics =====================
+
+struct PhysVec2 { float x = 0, y = 0; };
+
+struct PhysInput {
+    std::string sourceId;
+    int sourceIdx = -1;
+    float weight = 0;      // 0-100
+    int type = 0;           // 0=X, 1=Angle
+    bool reflect = false;
+};
+
+struct PhysOutput {
+    std::string destId;
+    int destIdx = -1;
+    int vertexIndex = 0;
+    float scale = 1;
+    float weight = 100;     // 0-100
+    bool reflect = false;
+};
+
+struct PhysParticle {
+    PhysVec2 position;
+    PhysVec2 lastPosition;
+    PhysVec2 velocity;
+    PhysVec2 force;
+    PhysVec2 lastGravity;
+    float mobility = 1;
+    float delay = 1;
+    float acceleration = 1;
+    float radius = 0;
+};
+
+struct PhysNorm {
+    float posMin = -10, posDef = 0, posMax = 10;
+    float angMin = -10, angDef = 0, angMax = 10;
+};
+
+struct PhysSubRig {
+    std::vector<PhysInput> inputs;
+    std::vector<PhysOutput> outputs;
+    std::vector<PhysParticle> particles;
+    PhysNorm norm;
+};
+
+struct PhysicsRig {
+    std::vector<PhysSubRig> settings;
+    PhysVec2 gravity = {0, -1};
+    PhysVec2 wind = {0, 0};
+    float fps = 60;
+    bool loaded = false;
+};
+
+static PhysicsRig g_physics;
+
+// ===================== Clipping Mask =====================
+
+static GLuint g_maskFBO = 0;
+static GLuint g_maskTexture = 0;
+static int g_maskW = 0, g_maskH = 0;
+
+struct MaskShaderInfo {
+    GLuint program = 0;
+    GLint a_position = -1;
+    GLint a_texCoord = -1;
+    GLint u_matrix = -1;
+    GLint u_texture = -1;
+    GLint u_opacity = -1;
+    bool  failed = false;          // 编译失败, 不再重试
+};
+static MaskShaderInfo g_maskShader;
+
+// 模板裁剪: 遮罩来源按 alpha 阈值写进当前渲染目标的模板缓冲, 被遮罩的 drawable 带模板测试
+// 直接画, 整帧不切换 FBO。tiler (Mali / Adreno / PowerVR) 上每次切到遮罩 FBO 再切回都要
+// 把 tile 写回内存再读回来, 模板路径省掉这两次往返; 代价是遮罩边缘变成硬边 (无半透明过渡)。
+static ClipMode       g_clipMode = ClipMode::Auto;
+static bool           g_tiledGPU = false;        // GL_RENDERER 属于已知的 tile-based GPU
+static GLint          g_windowStencilBits = 0;   // 窗口 (FBO 0) 的模板位数
+static bool           g_stencilClipFrame = false; // 上一帧是否走了模板裁剪
+static MaskShaderInfo g_stencilMaskShader;
+
+// ===================== Dynamic Resolution (state) =====================
+
+struct DynamicResolution {
+    bool  enabled     = false;
+    float budgetMs    = 1000.f / 60.f;
+    float scale       = 1.f;     // 每轴渲染比例
+    float avgMs       = 0.f;     // 帧间隔的指数平均
+    float sinceChange = 0.f;     // 距上次调整的时间 (秒)
+    float probeDelay  = 0.f;     // 预算内持续多久后试探升档
+    bool  probing     = false;   // 最近一次调整是升档试探
+};
+static DynamicResolution g_drs;
+
+static GLuint g_sceneFBO = 0, g_sceneTexture = 0;
+static GLuint g_sceneStencil = 0;   // 模板裁剪时附在场景 FBO 上的模板渲染缓冲
+static int    g_sceneW = 0, g_sceneH = 0;
+
+// 本帧模型的渲染目标: 窗口 (FBO 0) 或离屏纹理左下角的子区域
+static GLuint g_renderFBO = 0;
+static int    g_renderW = 0, g_renderH = 0;
+static bool   g_renderStencil = false;   // 渲染目标带模板缓冲
+
+struct CompositeShaderInfo {
+    GLuint program = 0;
+    GLint a_position = -1;
+    GLint u_texture = -1;
+    GLint u_uvOffset = -1;
+    GLint u_uvScale = -1;
+};
+static CompositeShaderInfo g_compositeShader;
+
+// ===================== Screen Bounds (state) =====================
+
+// 渲染目标像素矩形, 左下角原点 (GL 坐标), [x0, x1) x [y0, y1)
+struct PixelRect {
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    bool empty() const { return x1 <= x0 || y1 <= y0; }
+};
+
+static DrawableBounds g_frameBounds;      // 本帧绘制内容的模型空间范围
+static bool       g_frameHasBounds = false;
+static ScreenRect g_modelBounds;          // 上一帧的模型范围 (窗口像素, 左上角原点), 给宿主
+static PixelRect  g_windowRect;           // 同一范围, 窗口 GL 坐标, 离屏合成时裁剪用
+static PixelRect  g_sceneDirty;           // 离屏目标中可能非透明的区域
+static int        g_sceneDirtyW = 0, g_sceneDirtyH = 0;   // 记录 g_sceneDirty 时的渲染尺寸, 0 = 内容未知
+
+// ===================== Utilities =====================
+
+#ifdef __ANDROID__
+static std::vector<unsigned char> readAsset(const std::string& path) {
+    if (!g_assetManager) { LOGE("No asset manager: %s", path.c_str()); return {}; }
+    AAsset* asset = AAssetManager_open(g_assetManager, path.c_str(), AASSET_MODE_BUFFER);
+    if (!asset) { LOGE("Cannot open asset: %s", path.c_str()); return {}; }
+    off_t sz = AAsset_getLength(asset);
+    std::vector<unsigned char> buf(sz);
+    AAsset_read(asset, buf.data(), sz);
+    AAsset_close(asset);
+    return buf;
+}
+#else
+// 非 Android 平台 (基准测试): 直接读文件系统路径
+static std::vector<unsigned char> readAsset(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) { LOGE("Cannot open file: %s", path.c_str()); return {}; }
+    fseek(f, 0, SEEK_END);
+    long sz = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    std::vector<unsigned char> buf(sz > 0 ? sz : 0);
+    if (sz > 0 && fread(buf.data(), 1, sz, f) != (size_t)sz) buf.clear();
+    fclose(f);
+    return buf;
+}
+#endif
+
+// 模型文件: bundle 打开时直接引用映射中的条目 (不复制), 否则读入 owned
+struct AssetBytes {
+    std::vector<unsigned char> owned;
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    BundleKind kind = BundleKind::File;
+    bool empty() const { return size == 0; }
+};
+
+static AssetBytes loadAsset(const std::string& path) {
+    AssetBytes a;
+    if (bundleOpen()) {
+        const BundleEntryView* e = findBundleEntry(path);
+        if (!e) { LOGE("Not in bundle: %s", path.c_str()); return a; }
+        a.data = e->data; a.size = e->size; a.kind = e->kind;
+        return a;
+    }
+    a.owned = readAsset(path);
+    a.data = a.owned.data(); a.size = a.owned.size();
+    return a;
+}
+
+static std::string readAssetString(const std::string& path) {
+    AssetBytes d = loadAsset(path);
+    return {(const char*)d.data, d.size};
+}
+
+static void* alignedMalloc(size_t size, size_t alignment) {
+    void* p = nullptr;
+    if (posix_memalign(&p, alignment, size) != 0) return nullptr;
+    return p;
+}
+
+// ===================== Minimal JSON Helpers =====================
+
+static size_t findKey(const std::string& j, const std::string& key, size_t s = 0) {
+    std::string k = "\"" + key + "\"";
+    size_t p = j.find(k, s);
+    if (p == std::string::npos) return std::string::npos;
+    p += k.size();
+    while (p < j.size() && (j[p] == ' ' || j[p] == '\t' || j[p] == '\n' || j[p] == '\r' || j[p] == ':')) p++;
+    return p;
+}
+
+static std::string extractString(const std::string& j, size_t p) {
+    if (p >= j.size() || j[p] != '"') return "";
+    size_t e = j.find('"', p + 1);
+    return (e == std::string::npos) ? "" : j.substr(p + 1, e - p - 1);
+}
+
+static std::vector<std::string> extractStringArray(const std::string& j, size_t p) {
+    std::vector<std::string> r;
+    if (p >= j.size() || j[p] != '[') return r;
+    p++;
+    while (p < j.size()) {
+        while (p < j.size() && (j[p] == ' ' || j[p] == '\t' || j[p] == '\n' || j[p] == '\r' || j[p] == ',')) p++;
+        if (p >= j.size() || j[p] == ']') break;
+        if (j[p] == '"') {
+            size_t start = p;
+            r.push_back(extractString(j, p));
+            size_t close = j.find('"', start + 1);
+            p = (close != std::string::npos) ? close + 1 : j.size();
+        } else break;
+    }
+    return r;
+}
+
+struct ModelInfo { std::string mocPath; std::vector<std::string> texturePaths; };
+
+// Extract top-level objects from a JSON array starting at '['
+static std::vector<std::string> extractObjectArray(const std::string& j, size_t p) {
+    std::vector<std::string> r;
+    if (p >= j.size() || j[p] != '[') return r;
+    p++;
+    while (p < j.size()) {
+        while (p < j.size() && (j[p]==' '||j[p]=='\t'||j[p]=='\n'||j[p]=='\r'||j[p]==',')) p++;
+        if (p >= j.size() || j[p] == ']') break;
+        if (j[p] == '{') {
+            int d = 0; size_t s = p;
+            while (p < j.size()) {
+                if (j[p] == '{') d++;
+                else if (j[p] == '}') { d--; if (d == 0) { p++; break; } }
+                p++;
+            }
+            r.push_back(j.substr(s, p - s));
+        } else p++;
+    }
+    return r;
+}
+
+static size_t findArrayStart(const std::string& j, const std::string& key, size_t s = 0) {
+    size_t p = findKey(j, key, s);
+    if (p == std::string::npos) return std::string::npos;
+    while (p < j.size() && j[p] != '[') p++;
+    return (p < j.size()) ? p : std::string::npos;
+}
+
+// ===================== Pose3.json Parser & Runtime =====================
+
+typedef std::vector<std::vector<PosePartInfo>> PoseGroups;
+
+static PoseGroups parsePoseGroups(const std::string& json) {
+    PoseGroups groups;
+    size_t groupsArr = findArrayStart(json, "Groups");
+    if (groupsArr == std::string::npos) return groups;
+
+    // Groups is an array of arrays: [ [ {Id, Link}, ... ], [ ... ], ... ]
+    size_t p = groupsArr + 1; // skip '['
+    while (p < json.size()) {
+        while (p < json.size() && (json[p]==' '||json[p]=='\t'||json[p]=='\n'||json[p]=='\r'||json[p]==',')) p++;
+        if (p >= json.size() || json[p] == ']') break;
+
+        if (json[p] == '[') {
+            auto innerObjs = extractObjectArray(json, p);
+
+            std::vector<PosePartInfo> group;
+            for (const auto& obj : innerObjs) {
+                PosePartInfo pi;
+                size_t idPos = findKey(obj, "Id");
+                if (idPos != std::string::npos) {
+                    pi.partId = extractString(obj, idPos);
+                }
+                size_t linkArr = findArrayStart(obj, "Link");
+                if (linkArr != std::string::npos) {
+                    pi.linkIds = extractStringArray(obj, linkArr);
+                }
+                if (!pi.partId.empty()) {
+                    group.push_back(pi);
+                }
+            }
+
+            if (group.size() >= 2) {
+                groups.push_back(group);
+            }
+
+            // Skip past this inner array
+            int d = 0;
+            while (p < json.size()) {
+                if (json[p] == '[') d++;
+                else if (json[p] == ']') { d--; if (d == 0) { p++; break; } }
+                p++;
+            }
+        } else {
+            p++;
+        }
+    }
+    return groups;
+}
+
+static void parsePose3Json(const std::string& json) {
+    g_poseGroups = parsePoseGroups(json);
+    g_hasPose = !g_poseGroups.empty();
+    LOGI("Pose loaded: %d groups", (int)g_poseGroups.size());
+}
+
+// 部件 ID -> 索引; 每组第一个部件可见, 其余隐藏
+static void bindPoseParts(csmModel* model, PoseGroups& groups) {
+    int partCount = csmGetPartCount(model);
+    const char** partIds = csmGetPartIds(model);
+    std::map<std::string, int> partIdMap;
+    for (int i = 0; i < partCount; i++) partIdMap[partIds[i]] = i;
+
+    float* partOpacities = csmGetPartOpacities(model);
+
+    for (auto& group : groups) {
+        for (size_t i = 0; i < group.size(); i++) {
+            auto& pi = group[i];
+            auto it = partIdMap.find(pi.partId);
+            if (it != partIdMap.end()) {
+                pi.partIndex = it->second;
+                partOpacities[pi.partIndex] = (i == 0) ? 1.0f : 0.0f;
+            } else {
+                LOGI("Pose: part '%s' not found in model", pi.partId.c_str());
+            }
+            for (const auto& lid : pi.linkIds) {
+                auto lit = partIdMap.find(lid);
+                if (lit != partIdMap.end()) pi.linkIndices.push_back(lit->second);
+            }
+        }
+    }
+}
+
+static void initPosePartIndices() { bindPoseParts(g_model.model, g_poseGroups); }
+
+static void updatePose(float dt) {
+    if (!g_hasPose || !g_model.loaded) return;
+
+    float* partOpacities = csmGetPartOpacities(g_model.model);
+
+    for (auto& group : g_poseGroups) {
+        int dominantIdx = 0;
+        float maxOpacity = 0.f;
+        for (size_t i = 0; i < group.size(); i++) {
+            if (group[i].partIndex < 0) continue;
+            float op = partOpacities[group[i].partIndex];
+            if (op > maxOpacity) { maxOpacity = op; dominantIdx = (int)i; }
+        }
+
+        for (size_t i = 0; i < group.size(); i++) {
+            if (group[i].partIndex < 0) continue;
+            float& opacity = partOpacities[group[i].partIndex];
+
+            if ((int)i == dominantIdx) {
+                opacity += dt * POSE_FADE_SPEED;
+                if (opacity > 1.f) opacity = 1.f;
+            } else {
+                opacity -= dt * POSE_FADE_SPEED;
+                if (opacity < 0.f) opacity = 0.f;
+            }
+
+            for (int linkIdx : group[i].linkIndices) partOpacities[linkIdx] = opacity;
+        }
+    }
+}
+
+static ModelInfo parseModel3Json(const std::string& json) {
+    ModelInfo info;
+    size_t fr = findKey(json, "FileReferences");
+    if (fr == std::string::npos) return info;
+    size_t mp = findKey(json, "Moc", fr);
+    if (mp != std::string::npos) info.mocPath = extractString(json, mp);
+    size_t tp = findKey(json, "Textures", fr);
+    if (tp != std::string::npos) info.texturePaths = extractStringArray(json, tp);
+    return info;
+}
+
+// ===================== Motion3.json Parser =====================
+
+static MotionData parseMotion3Json(const std::string& json) {
+    MotionData m;
+    size_t dp = findKey(json, "Duration");
+    if (dp != std::string::npos) m.duration = (float)strtod(json.c_str() + dp, nullptr);
+    size_t lp = findKey(json, "Loop");
+    if (lp != std::string::npos) m.loop = (json.substr(lp, 5).find("true") != std::string::npos);
+    size_t fip = findKey(json, "FadeInTime");
+    if (fip != std::string::npos) m.fadeInTime = (float)strtod(json.c_str() + fip, nullptr);
+    size_t fop = findKey(json, "FadeOutTime");
+    if (fop != std::string::npos) m.fadeOutTime = (float)strtod(json.c_str() + fop, nullptr);
+
+    size_t cp = findKey(json, "Curves");
+    if (cp == std::string::npos) return m;
+    while (cp < json.size() && json[cp] != '[') cp++;
+    if (cp >= json.size()) return m;
+
+    int depth = 0;
+    size_t pos = cp;
+    while (pos < json.size()) {
+        if (json[pos] == '[') depth++;
+        else if (json[pos] == ']') { depth--; if (depth <= 0) break; }
+        if (json[pos] == '{' && depth == 1) {
+            int od = 0; size_t os = pos;
+            while (pos < json.size()) {
+                if (json[pos] == '{') od++;
+                else if (json[pos] == '}') { od--; if (od == 0) { pos++; break; } }
+                pos++;
+            }
+            std::string obj(json, os, pos - os);
+            size_t tp2 = findKey(obj, "Target");
+            if (tp2 == std::string::npos || extractString(obj, tp2) != "Parameter") continue;
+            size_t ip = findKey(obj, "Id");
+            if (ip == std::string::npos) continue;
+            std::string paramId = extractString(obj, ip);
+            size_t sp = findKey(obj, "Segments");
+            if (sp == std::string::npos) continue;
+            while (sp < obj.size() && obj[sp] != '[') sp++;
+            if (sp >= obj.size()) continue;
+            sp++;
+            std::vector<float> nums;
+            while (sp < obj.size() && obj[sp] != ']') {
+                while (sp < obj.size() && (obj[sp]==' '||obj[sp]=='\t'||obj[sp]=='\n'||obj[sp]=='\r'||obj[sp]==',')) sp++;
+                if (sp >= obj.size() || obj[sp] == ']') break;
+                char* end;
+                float v = (float)strtod(obj.c_str() + sp, &end);
+                if (end > obj.c_str() + sp) { nums.push_back(v); sp = end - obj.c_str(); }
+                else sp++;
+            }
+            MotionCurve curve;
+            curve.paramId = paramId;
+            if (nums.size() >= 2) {
+                curve.keyframes.push_back({nums[0], nums[1]});
+                size_t si = 2;
+                while (si < nums.size()) {
+                    int st = (int)nums[si];
+                    if (st == 0 && si + 2 < nums.size()) {
+                        curve.keyframes.push_back({nums[si+1], nums[si+2]}); si += 3;
+                    } else if (st == 1 && si + 6 < nums.size()) {
+                        curve.keyframes.push_back({nums[si+5], nums[si+6]}); si += 7;
+                    } else if (si + 2 < nums.size()) {
+                        curve.keyframes.push_back({nums[si+1], nums[si+2]}); si += 3;
+                    } else break;
+                }
+            }
+            if (!curve.keyframes.empty()) m.curves.push_back(curve);
+        } else {
+            pos++;
+        }
+    }
+    LOGI("Motion parsed: dur=%.1f loop=%d curves=%d", m.duration, m.loop, (int)m.curves.size());
+    return m;
+}
+
+static float evaluateMotionCurve(const MotionCurve& c, float t) {
+    if (c.keyframes.empty()) return 0.f;
+    if (t <= c.keyframes.front().time) return c.keyframes.front().value;
+    if (t >= c.keyframes.back().time)  return c.keyframes.back().value;
+    for (size_t i = 1; i < c.keyframes.size(); i++) {
+        if (t <= c.keyframes[i].time) {
+            float t0 = c.keyframes[i-1].time, t1 = c.keyframes[i].time;
+            float v0 = c.keyframes[i-1].value, v1 = c.keyframes[i].value;
+            float frac = (t1 > t0) ? (t - t0) / (t1 - t0) : 0.f;
+            return v0 + (v1 - v0) * frac;
+        }
+    }
+    return c.keyframes.back().value;
+}
+
+// ===================== Baked Motions =====================
+// live2d_pack 把 motion3.json 预解析为 BundleKind::Motion 条目 (布局见 live2d_bundle.h),
+// 加载时省去 JSON 扫描和 strtod。条目在映射中不保证 4 字节对齐, 一律 memcpy 读取。
+
+static void putU32(std::vector<uint8_t>& o, uint32_t v) { o.insert(o.end(), (uint8_t*)&v, (uint8_t*)&v + 4); }
+static void putF32(std::vector<uint8_t>& o, float v) { o.insert(o.end(), (uint8_t*)&v, (uint8_t*)&v + 4); }
+static void setU32(std::vector<uint8_t>& o, size_t at, uint32_t v) { memcpy(o.data() + at, &v, 4); }
+
+bool bakeMotion3Json(const std::string& json, std::vector<uint8_t>& out) {
+    MotionData m = parseMotion3Json(json);
+    out.clear();
+    putF32(out, m.duration);
+    putF32(out, m.fadeInTime);
+    putF32(out, m.fadeOutTime);
+    putU32(out, m.loop ? 1 : 0);
+    putU32(out, (uint32_t)m.curves.size());
+    size_t records = out.size();
+    out.resize(records + m.curves.size() * 16);
+    for (size_t i = 0; i < m.curves.size(); i++) {
+        setU32(out, records + i * 16 + 0, (uint32_t)out.size());
+        setU32(out, records + i * 16 + 4, (uint32_t)m.curves[i].paramId.size());
+        out.insert(out.end(), m.curves[i].paramId.begin(), m.curves[i].paramId.end());
+    }
+    while (out.size() % 8) out.push_back(0);
+    for (size_t i = 0; i < m.curves.size(); i++) {
+        setU32(out, records + i * 16 + 8, (uint32_t)out.size());
+        setU32(out, records + i * 16 + 12, (uint32_t)m.curves[i].keyframes.size());
+        for (const MotionKeyframe& k : m.curves[i].keyframes) { putF32(out, k.time); putF32(out, k.value); }
+    }
+    return !m.curves.empty();
+}
+
+static bool decodeBakedMotion(const uint8_t* d, size_t size, MotionData& m) {
+    auto u32 = [&](size_t at) { uint32_t v; memcpy(&v, d + at, 4); return v; };
+    if (size < 20) return false;
+    memcpy(&m.duration, d, 4);
+    memcpy(&m.fadeInTime, d + 4, 4);
+    memcpy(&m.fadeOutTime, d + 8, 4);
+    m.loop = u32(12) != 0;
+    uint32_t n = u32(16);
+    if (n > (size - 20) / 16) return false;
+    m.curves.assign(n, MotionCurve());
+    for (uint32_t i = 0; i < n; i++) {
+        size_t r = 20 + (size_t)i * 16;
+        uint32_t idOff = u32(r), idLen = u32(r + 4), keyOff = u32(r + 8), keyCount = u32(r + 12);
+        if (idOff > size || idLen > size - idOff || keyOff > size || keyCount > (size - keyOff) / 8) return false;
+        m.curves[i].paramId.assign((const char*)d + idOff, idLen);
+        m.curves[i].keyframes.resize(keyCount);
+        memcpy(m.curves[i].keyframes.data(), d + keyOff, (size_t)keyCount * 8);
+    }
+    return true;
+}
+
+// bundle 中的预解析条目优先, 否则解析 motion3.json; 文件不可读或条目损坏时返回 false
+static bool loadMotion(const std::string& path, MotionData& out) {
+    AssetBytes a = loadAsset(path);
+    if (a.empty()) return false;
+    if (a.kind == BundleKind::Motion) {
+        MotionData m;
+        if (!decodeBakedMotion(a.data, a.size, m)) { LOGE("Corrupt baked motion: %s", path.c_str()); return false; }
+        out = std::move(m);
+        return true;
+    }
+    out = parseMotion3Json(std::string((const char*)a.data, a.size));
+    return true;
+}
+
+// ===================== Expression Parser =====================
+
+static ExpressionData parseExp3Json(const std::string& json, const std::string& name) {
+    ExpressionData expr;
+    expr.name = name;
+
+    size_t paramsArr = findArrayStart(json, "Parameters");
+    if (paramsArr == std::string::npos) return expr;
+
+    auto objs = extractObjectArray(json, paramsArr);
+    for (const auto& obj : objs) {
+        ExprParam ep;
+        size_t ip = findKey(obj, "Id");
+        if (ip != std::string::npos) ep.paramId = extractString(obj, ip);
+        if (ep.paramId.empty()) continue;
+
+        size_t vp = findKey(obj, "Value");
+        if (vp != std::string::npos) ep.value = (float)strtod(obj.c_str() + vp, nullptr);
+
+        size_t bp = findKey(obj, "Blend");
+        if (bp != std::string::npos) {
+            std::string blendStr = extractString(obj, bp);
+            if (blendStr == "Multiply") ep.blend = ExprBlend::Multiply;
+            else if (blendStr == "Overwrite") ep.blend = ExprBlend::Overwrite;
+            else ep.blend = ExprBlend::Add;
+        } else {
+            ep.blend = ExprBlend::Add;
+        }
+        expr.params.push_back(ep);
+    }
+    LOGI("Expression parsed: %s (%d params)", name.c_str(), (int)expr.params.size());
+    return expr;
+}
+
+// 读取并解析 e.file; 文件不可读时返回 false
+static bool loadExpression(ExpressionData& e) {
+    std::string json = readAssetString(e.file);
+    if (json.empty()) return false;
+    e.params = parseExp3Json(json, e.name).params;
+    e.loaded = true;
+    return true;
+}
+
+// ===================== Physics3.json Parser =====================
+
+static void parsePhysics3Json(const std::string& json) {
+    g_physics = PhysicsRig();
+
+    size_t fpsPos = findKey(json, "Fps");
+    if (fpsPos != std::string::npos) g_physics.fps = (float)strtod(json.c_str() + fpsPos, nullptr);
+
+    size_t efPos = findKey(json, "EffectiveForces");
+    if (efPos != std::string::npos) {
+        size_t gp = findKey(json, "Gravity", efPos);
+        if (gp != std::string::npos) {
+            size_t p = findKey(json, "X", gp);
+            if (p != std::string::npos) g_physics.gravity.x = (float)strtod(json.c_str() + p, nullptr);
+            p = findKey(json, "Y", gp);
+            if (p != std::string::npos) g_physics.gravity.y = (float)strtod(json.c_str() + p, nullptr);
+        }
+        size_t wp = findKey(json, "Wind", efPos);
+        if (wp != std::string::npos) {
+            size_t p = findKey(json, "X", wp);
+            if (p != std::string::npos) g_physics.wind.x = (float)strtod(json.c_str() + p, nullptr);
+            p = findKey(json, "Y", wp);
+            if (p != std::string::npos) g_physics.wind.y = (float)strtod(json.c_str() + p, nullptr);
+        }
+    }
+
+    size_t psArr = findArrayStart(json, "PhysicsSettings");
+    if (psArr == std::string::npos) return;
+    auto settingObjs = extractObjectArray(json, psArr);
+
+    for (const auto& sj : settingObjs) {
+        PhysSubRig sub;
+
+        // Parse Input array
+        size_t ia = findArrayStart(sj, "Input");
+        if (ia != std::string::npos) {
+            auto objs = extractObjectArray(sj, ia);
+            for (const auto& ij : objs) {
+                PhysInput inp;
+                size_t sp = findKey(ij, "Source");
+                if (sp != std::string::npos) {
+                    size_t ip = findKey(ij, "Id", sp);
+                    if (ip != std::string::npos) inp.sourceId = extractString(ij, ip);
+                }
+                size_t p = findKey(ij, "Weight");
+                if (p != std::string::npos) inp.weight = (float)strtod(ij.c_str() + p, nullptr);
+                p = findKey(ij, "Type");
+                if (p != std::string::npos) inp.type = (extractString(ij, p) == "Angle") ? 1 : 0;
+                p = findKey(ij, "Reflect");
+                if (p != std::string::npos) inp.reflect = (ij.substr(p, 4) == "true");
+                sub.inputs.push_back(inp);
+            }
+        }
+
+        // Parse Output array
+        size_t oa = findArrayStart(sj, "Output");
+        if (oa != std::string::npos) {
+            auto objs = extractObjectArray(sj, oa);
+            for (const auto& oj : objs) {
+                PhysOutput out;
+                size_t dp = findKey(oj, "Destination");
+                if (dp != std::string::npos) {
+                    size_t ip = findKey(oj, "Id", dp);
+                    if (ip != std::string::npos) out.destId = extractString(oj, ip);
+                }
+                size_t p = findKey(oj, "VertexIndex");
+                if (p != std::string::npos) out.vertexIndex = (int)strtod(oj.c_str() + p, nullptr);
+                p = findKey(oj, "Scale");
+                if (p != std::string::npos) out.scale = (float)strtod(oj.c_str() + p, nullptr);
+                p = findKey(oj, "Weight");
+                if (p != std::string::npos) out.weight = (float)strtod(oj.c_str() + p, nullptr);
+                p = findKey(oj, "Reflect");
+                if (p != std::string::npos) out.reflect = (oj.substr(p, 4) == "true");
+                sub.outputs.push_back(out);
+            }
+        }
+
+        // Parse Vertices array
+        size_t va = findArrayStart(sj, "Vertices");
+        if (va != std::string::npos) {
+            auto objs = extractObjectArray(sj, va);
+            for (const auto& vj : objs) {
+                PhysParticle pp;
+                size_t posP = findKey(vj, "Position");
+                if (posP != std::string::npos) {
+                    size_t p = findKey(vj, "X", posP);
+                    if (p != std::string::npos) pp.position.x = (float)strtod(vj.c_str() + p, nullptr);
+                    p = findKey(vj, "Y", posP);
+                    if (p != std::string::npos) pp.position.y = (float)strtod(vj.c_str() + p, nullptr);
+                }
+                pp.lastPosition = pp.position;
+                size_t p = findKey(vj, "Mobility");
+                if (p != std::string::npos) pp.mobility = (float)strtod(vj.c_str() + p, nullptr);
+                p = findKey(vj, "Delay");
+                if (p != std::string::npos) pp.delay = (float)strtod(vj.c_str() + p, nullptr);
+                p = findKey(vj, "Acceleration");
+                if (p != std::string::npos) pp.acceleration = (float)strtod(vj.c_str() + p, nullptr);
+                p = findKey(vj, "Radius");
+                if (p != std::string::npos) pp.radius = (float)strtod(vj.c_str() + p, nullptr);
+                sub.particles.push_back(pp);
+            }
+        }
+
+        // Parse Normalization
+        size_t np = findKey(sj, "Normalization");
+        if (np != std::string::npos) {
+            size_t posN = findKey(sj, "Position", np);
+            if (posN != std::string::npos) {
+                size_t p = findKey(sj, "Minimum", posN);
+                if (p != std::string::npos) sub.norm.posMin = (float)strtod(sj.c_str() + p, nullptr);
+                p = findKey(sj, "Default", posN);
+                if (p != std::string::npos) sub.norm.posDef = (float)strtod(sj.c_str() + p, nullptr);
+                p = findKey(sj, "Maximum", posN);
+                if (p != std::string::npos) sub.norm.posMax = (float)strtod(sj.c_str() + p, nullptr);
+            }
+            size_t angN = findKey(sj, "Angle", np);
+            if (angN != std::string::npos) {
+                size_t p = findKey(sj, "Minimum", angN);
+                if (p != std::string::npos) sub.norm.angMin = (float)strtod(sj.c_str() + p, nullptr);
+                p = findKey(sj, "Default", angN);
+                if (p != std::string::npos) sub.norm.angDef = (float)strtod(sj.c_str() + p, nullptr);
+                p = findKey(sj, "Maximum", angN);
+                if (p != std::string::npos) sub.norm.angMax = (float)strtod(sj.c_str() + p, nullptr);
+            }
+        }
+
+        g_physics.settings.push_back(sub);
+    }
+    LOGI("Physics parsed: %d settings, gravity=(%.1f,%.1f), fps=%.0f",
+         (int)g_physics.settings.size(), g_physics.gravity.x, g_physics.gravity.y, g_physics.fps);
+    g_physics.loaded = true;
+}
+
+// ===================== Physics Simulation =====================
+
+static float directionToRadian(PhysVec2 from, PhysVec2 to) {
+    float q1 = atan2f(from.y, from.x);
+    float q2 = atan2f(to.y, to.x);
+    float r = q2 - q1;
+    while (r < -(float)M_PI) r += 2.f * (float)M_PI;
+    while (r >  (float)M_PI) r -= 2.f * (float)M_PI;
+    return r;
+}
+
+static float normalizePhysInput(float val, float pMin, float pMax, float pDef,
+                                float nMin, float nDef, float nMax) {
+    float diff = val - pDef;
+    if (diff > 0.0001f) {
+        float pr = pMax - pDef, nr = nMax - nDef;
+        return (pr > 0.0001f) ? nDef + diff / pr * nr : nMax;
+    } else if (diff < -0.0001f) {
+        float pr = pDef - pMin, nr = nDef - nMin;
+        return (pr > 0.0001f) ? nDef + diff / pr * nr : nMin;
+    }
+    return nDef;
+}
+
+static void initPhysics() {
+    if (!g_physics.loaded || !g_model.loaded) return;
+    for (auto& sub : g_physics.settings) {
+        for (auto& inp : sub.inputs) {
+            auto it = g_model.parameterMap.find(inp.sourceId);
+            inp.sourceIdx = (it != g_model.parameterMap.end()) ? it->second : -1;
+        }
+        for (auto& out : sub.outputs) {
+            auto it = g_model.parameterMap.find(out.destId);
+            out.destIdx = (it != g_model.parameterMap.end()) ? it->second : -1;
+        }
+        // Init particles at rest: hanging in +Y direction (physics "down")
+        if (!sub.particles.empty()) {
+            sub.particles[0].position = {0, 0};
+            sub.particles[0].lastPosition = {0, 0};
+            sub.particles[0].lastGravity = {0, 1};
+            for (size_t i = 1; i < sub.particles.size(); i++) {
+                sub.particles[i].position.x = 0;
+                sub.particles[i].position.y = sub.particles[i-1].position.y + sub.particles[i].radius;
+                sub.particles[i].lastPosition = sub.particles[i].position;
+                sub.particles[i].velocity = {0, 0};
+                sub.particles[i].force = {0, 0};
+                sub.particles[i].lastGravity = {0, 1};
+            }
+        }
+    }
+    LOGI("Physics initialized: %d settings", (int)g_physics.settings.size());
+}
+
+static void updatePhysics(float dt) {
+    if (!g_physics.loaded || !g_model.loaded) return;
+
+    float* pv = csmGetParameterValues(g_model.model);
+    const float* pd = csmGetParameterDefaultValues(g_model.model);
+    const float* pmn = csmGetParameterMinimumValues(g_model.model);
+    const float* pmx = csmGetParameterMaximumValues(g_model.model);
+    int pc = csmGetParameterCount(g_model.model);
+    const float AIR_RES = 5.0f;
+
+    for (auto& sub : g_physics.settings) {
+        // ---- 1. Calculate total input ----
+        float totalAngle = 0, totalTx = 0;
+        for (const auto& inp : sub.inputs) {
+            if (inp.sourceIdx < 0 || inp.sourceIdx >= pc) continue;
+            float w = inp.weight / 100.0f;
+            float normalized;
+            if (inp.type == 1) {
+                normalized = normalizePhysInput(pv[inp.sourceIdx], pmn[inp.sourceIdx], pmx[inp.sourceIdx],
+                                                pd[inp.sourceIdx], sub.norm.angMin, sub.norm.angDef, sub.norm.angMax);
+            } else {
+                normalized = normalizePhysInput(pv[inp.sourceIdx], pmn[inp.sourceIdx], pmx[inp.sourceIdx],
+                                                pd[inp.sourceIdx], sub.norm.posMin, sub.norm.posDef, sub.norm.posMax);
+            }
+            if (inp.reflect) normalized = -normalized;
+            if (inp.type == 1) totalAngle += normalized * w;
+            else               totalTx += normalized * w;
+        }
+
+        if (sub.particles.empty()) continue;
+
+        // ---- 2. Update particle chain (Cubism SDK algorithm) ----
+        sub.particles[0].position.x = totalTx;
+
+        float totalRad = totalAngle * (float)M_PI / 180.0f;
+        PhysVec2 curGrav = { sinf(totalRad), cosf(totalRad) };
+
+        for (size_t i = 1; i < sub.particles.size(); i++) {
+            auto& p = sub.particles[i];
+            auto& prev = sub.particles[i-1];
+
+            p.force.x = curGrav.x * p.acceleration + g_physics.wind.x;
+            p.force.y = curGrav.y * p.acceleration + g_physics.wind.y;
+            PhysVec2 saved = p.position;
+            float delay = p.delay * dt * 30.0f;
+
+            // Current arm direction
+            PhysVec2 dir = { p.position.x - prev.position.x, p.position.y - prev.position.y };
+
+            // Rotate arm by gravity change
+            float rad = directionToRadian(p.lastGravity, curGrav) / AIR_RES;
+            float cr = cosf(rad), sr = sinf(rad);
+            float rx = cr * dir.x - sr * dir.y;
+            float ry = sr * dir.x + cr * dir.y;
+            dir.x = rx; dir.y = ry;
+
+            p.position.x = prev.position.x + dir.x;
+            p.position.y = prev.position.y + dir.y;
+
+            // Apply velocity and force
+            p.position.x += p.velocity.x * delay + p.force.x * delay * delay;
+            p.position.y += p.velocity.y * delay + p.force.y * delay * delay;
+
+            // Constrain to radius
+            float dx = p.position.x - prev.position.x;
+            float dy = p.position.y - prev.position.y;
+            float dist = sqrtf(dx * dx + dy * dy);
+            if (dist > 0.0001f) {
+                p.position.x = prev.position.x + (dx / dist) * p.radius;
+                p.position.y = prev.position.y + (dy / dist) * p.radius;
+            }
+            if (fabsf(p.position.x) < 0.001f) p.position.x = 0.f;
+
+            // Update velocity
+            if (delay > 0.0001f) {
+                p.velocity.x = (p.position.x - saved.x) / delay * p.mobility;
+                p.velocity.y = (p.position.y - saved.y) / delay * p.mobility;
+            }
+            p.lastGravity = curGrav;
+        }
+
+        // ---- 3. Calculate outputs ----
+        for (const auto& out : sub.outputs) {
+            if (out.destIdx < 0 || out.destIdx >= pc) continue;
+            int vi = out.vertexIndex;
+            if (vi < 1 || vi >= (int)sub.particles.size()) continue;
+
+            PhysVec2 parentDir;
+            if (vi >= 2) {
+                parentDir.x = sub.particles[vi-1].position.x - sub.particles[vi-2].position.x;
+                parentDir.y = sub.particles[vi-1].position.y - sub.particles[vi-2].position.y;
+            } else {
+                parentDir = {0, 1}; // default gravity direction
+            }
+            PhysVec2 curDir = {
+                sub.particles[vi].position.x - sub.particles[vi-1].position.x,
+                sub.particles[vi].position.y - sub.particles[vi-1].position.y
+            };
+            float angle = directionToRadian(parentDir, curDir);
+            if (out.reflect) angle = -angle;
+
+            float outputValue = angle * out.scale;
+            float w = out.weight / 100.0f;
+            float blended = pv[out.destIdx] * (1.f - w) + outputValue * w;
+            pv[out.destIdx] = std::clamp(blended, pmn[out.destIdx], pmx[out.destIdx]);
+        }
+    }
+}
+
+static double getCurrentTime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ===================== Shaders =====================
+
+// 官方 SDK 参考: CubismRenderer_OpenGLES2.cpp - SetupShaderProgram / FragShaderSrc
+// 顶点着色器: 将模型坐标通过投影矩阵变换到 NDC
+static const char* kVS =
+    "attribute vec4 a_position;\n"
+    "attribute vec2 a_texCoord;\n"
+    "varying vec2 v_texCoord;\n"
+    "uniform mat4 u_matrix;\n"
+    "void main() {\n"
+    "    gl_Position = u_matrix * a_position;\n"
+    "    v_texCoord = a_texCoord;\n"
+    "}\n";
+
+// 片段着色器: 预乘 alpha + multiplyColor + screenColor + 遮罩, 各步骤由 #define 开关 (见 Draw Programs)
+// 官方 SDK 中纹理是预乘格式; 流式解码在解码线程预乘 (PREMULTIPLIED),
+// stb_image 回退解码为 straight alpha, 在 shader 中做 c.rgb *= c.a
+static const char* kDrawFS =
+    "precision mediump float;\n"
+    "varying vec2 v_texCoord;\n"
+    "uniform sampler2D u_texture;\n"
+    "uniform float u_opacity;\n"
+    "#ifdef HAS_MULTIPLY\n"
+    "uniform vec4 u_multiplyColor;\n"
+    "#endif\n"
+    "#ifdef HAS_SCREEN\n"
+    "uniform vec4 u_screenColor;\n"
+    "#endif\n"
+    "#ifdef MASKED\n"
+    "uniform sampler2D u_mask;\n"
+    "uniform vec2 u_viewportSize;\n"
+    "#endif\n"
+    "void main() {\n"
+    "    vec4 c = texture2D(u_texture, v_texCoord);\n"
+    "#ifndef PREMULTIPLIED\n"
+    "    c.rgb *= c.a;\n"  // straight → premultiplied
+    "#endif\n"
+    "#ifdef MASKED\n"
+    "    float maskVal = texture2D(u_mask, gl_FragCoord.xy / u_viewportSize).a;\n"
+    "#ifdef INVERTED_MASK\n"
+    "    maskVal = 1.0 - maskVal;\n"
+    "#endif\n"
+    "    c *= maskVal;\n"
+    "#endif\n"
+    "#ifdef HAS_MULTIPLY\n"
+    "    c.rgb *= u_multiplyColor.rgb;\n"
+    "#endif\n"
+    "#ifdef HAS_SCREEN\n"
+    "    c.rgb = clamp(c.rgb + u_screenColor.rgb * c.a - c.rgb * u_screenColor.rgb, 0.0, 1.0);\n"
+    "#endif\n"
+    "    gl_FragColor = c * u_opacity;\n"
+    "}\n";
+
+// GLES3 路径的同一组着色器: 固定属性位置 (VAO 按 0 / 1 绑定), 矩阵和遮罩尺寸在 FrameBlock,
+// 每个 drawable 的不透明度与颜色在 DrawableBlock (两个 std140 UBO)。
+// 两个阶段都声明 FrameBlock, 成员精度必须一致, 所以显式写 highp
+static const char* kVS3 =
+    "#version 300 es\n"
+    "layout(location = 0) in vec4 a_position;\n"
+    "layout(location = 1) in vec2 a_texCoord;\n"
+    "out vec2 v_texCoord;\n"
+    "layout(std140) uniform FrameBlock { highp mat4 u_matrix; highp vec2 u_viewportSize; };\n"
+    "void main() {\n"
+    "    gl_Position = u_matrix * a_position;\n"
+    "    v_texCoord = a_texCoord;\n"
+    "}\n";
+
+// 不含 #version 行: 变体的 #define 要插在它之后 (见 buildDrawPrograms)
+static const char* kDrawFS3 =
+    "precision mediump float;\n"
+    "in vec2 v_texCoord;\n"
+    "out vec4 fragColor;\n"
+    "uniform sampler2D u_texture;\n"
+    "layout(std140) uniform FrameBlock { highp mat4 u_matrix; highp vec2 u_viewportSize; };\n"
+    "layout(std140) uniform DrawableBlock { vec4 u_multiplyColor; vec4 u_screenColor; float u_opacity; };\n"
+    "#ifdef MASKED\n"
+    "uniform sampler2D u_mask;\n"
+    "#endif\n"
+    "void main() {\n"
+    "    vec4 c = texture(u_texture, v_texCoord);\n"
+    "#ifndef PREMULTIPLIED\n"
+    "    c.rgb *= c.a;\n"
+    "#endif\n"
+    "#ifdef MASKED\n"
+    "    float maskVal = texture(u_mask, gl_FragCoord.xy / u_viewportSize).a;\n"
+    "#ifdef INVERTED_MASK\n"
+    "    maskVal = 1.0 - maskVal;\n"
+    "#endif\n"
+    "    c *= maskVal;\n"
+    "#endif\n"
+    "#ifdef HAS_MULTIPLY\n"
+    "    c.rgb *= u_multiplyColor.rgb;\n"
+    "#endif\n"
+    "#ifdef HAS_SCREEN\n"
+    "    c.rgb = clamp(c.rgb + u_screenColor.rgb * c.a - c.rgb * u_screenColor.rgb, 0.0, 1.0);\n"
+    "#endif\n"
+    "    fragColor = c * u_opacity;\n"
+    "}\n";
+
+// 只提交编译, 状态留到 buildPrograms 统一查询 (驱动可以在后台并行编译)
+static GLuint startShader(GLenum type, const char* src) {
+    GLuint s = g_gl->CreateShader(type);
+    g_gl->ShaderSource(s, 1, &src, nullptr);
+    g_gl->CompileShader(s);
+    return s;
+}
+
+static bool shaderCompiled(GLuint s, const char* name) {
+    GLint ok; g_gl->GetShaderiv(s, GL_COMPILE_STATUS, &ok);
+    if (!ok) { char buf[512]; g_gl->GetShaderInfoLog(s, 512, nullptr, buf); LOGE("%s shader err: %s", name, buf); }
+    return ok != 0;
+}
+
+// ===================== Program Binary Cache =====================
+// 每次 GL 上下文重建 (回到前台、部分机型旋转) 都要重新编译全部着色器。驱动支持
+// OES_get_program_binary (GLES3 核心) 时, 链接好的程序二进制按驱动标识 + 源码哈希存到
+// 宿主给的目录, 之后直接 glProgramBinary; 驱动升级后二进制会被拒绝, 删除文件回退到源码编译。
+// 缓存文件在工作线程写入, 不占用 GL 线程。
+
+struct ProgramSource {
+    const char* name;
+    const char* vs;
+    const char* fs;
+};
+
+struct ProgramBinaryBlob {
+    std::string          path;
+    GLenum               format = 0;
+    std::vector<uint8_t> data;
+};
+
+// 写入线程会打日志, 宿主在日志线程停止前用 flushProgramCache() 等它写完;
+// 析构中的 join 只是兜底, 不能依赖跨文件静态对象的析构顺序
+struct ProgramCacheWriter {
+    std::thread thread;
+    void join() { if (thread.joinable()) thread.join(); }
+    ~ProgramCacheWriter() { join(); }
+};
+
+static const uint32_t kProgramCacheVersion = 1;
+static const char     kProgramCacheMagic[8] = {'L', '2', 'D', 'P', 'R', 'O', 'G', '\0'};
+
+static std::string        g_shaderCacheDir;          // 空 = 不缓存
+static std::string        g_glIdentity;              // GL_VENDOR / GL_RENDERER / GL_VERSION
+static bool               g_programBinary = false;   // 当前上下文支持程序二进制
+static ShaderCacheStats   g_shaderCacheStats;
+static ProgramCacheWriter g_programCacheWriter;
+
+static uint64_t hash64(const void* data, size_t n, uint64_t h = 1469598103934665603ull) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < n; i++) { h ^= p[i]; h *= 1099511628211ull; }
+    return h;
+}
+
+// initRenderer 时调用: 记录驱动标识, 检查是否支持程序二进制, GLES 3.x 上下文走 GLES3 路径
+static void detectGLCapabilities() {
+    auto str = [](GLenum name) {
+        const GLubyte* v = g_gl->GetString(name);
+        return v ? std::string((const char*)v) : std::string();
+    };
+    std::string version = str(GL_VERSION);
+    g_glIdentity = str(GL_VENDOR) + "\n" + str(GL_RENDERER) + "\n" + version;
+    g_gles3 = g_gles3Enabled && version.compare(0, 11, "OpenGL ES 3") == 0;
+    LOGI("GL_VERSION %s: %s render path", version.c_str(), g_gles3 ? "GLES3" : "GLES2");
+    bool supported = version.compare(0, 11, "OpenGL ES 3") == 0 || str(GL_EXTENSIONS).find("GL_OES_get_program_binary") != std::string::npos;
+    GLint formats = 0;
+    if (supported) g_gl->GetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formats);
+    g_programBinary = supported && formats > 0;
+    std::string renderer = str(GL_RENDERER);
+    g_tiledGPU = false;
+    for (const char* tiler : {"Mali", "Adreno", "PowerVR", "Immortalis"})
+        if (renderer.find(tiler) != std::string::npos) g_tiledGPU = true;
+    g_windowStencilBits = 0;
+    g_gl->GetIntegerv(GL_STENCIL_BITS, &g_windowStencilBits);
+    if (!g_shaderCacheDir.empty())
+        LOGI("Program binary cache: %s", g_programBinary ? "available" : "not supported by the driver");
+}
+
+static std::string programCachePath(const ProgramSource& src) {
+    uint64_t h = hash64(g_glIdentity.data(), g_glIdentity.size());
+    h = hash64(&kProgramCacheVersion, sizeof(kProgramCacheVersion), h);
+    h = hash64(src.vs, strlen(src.vs) + 1, h);   // 含结尾 0, 分隔两段源码
+    h = hash64(src.fs, strlen(src.fs), h);
+    char name[48];
+    snprintf(name, sizeof(name), "/l2d_program_%016llx.bin", (unsigned long long)h);
+    return g_shaderCacheDir + name;
+}
+
+// 文件: magic, u32 version, u32 binaryFormat, u32 length, u32 checksum (FNV-1a 低 32 位), binary
+static GLuint loadCachedProgram(const std::string& path, const char* name) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return 0;
+    uint8_t hdr[24];
+    uint32_t version = 0, format = 0, length = 0, checksum = 0;
+    std::vector<uint8_t> bin;
+    bool ok = fread(hdr, 1, sizeof(hdr), f) == sizeof(hdr) && memcmp(hdr, kProgramCacheMagic, 8) == 0;
+    if (ok) {
+        memcpy(&version, hdr + 8, 4);  memcpy(&format, hdr + 12, 4);
+        memcpy(&length, hdr + 16, 4);  memcpy(&checksum, hdr + 20, 4);
+        ok = version == kProgramCacheVersion && length > 0 && length <= (64u << 20);
+    }
+    if (ok) {
+        bin.resize(length);
+        ok = fread(bin.data(), 1, length, f) == length && (uint32_t)hash64(bin.data(), length) == checksum;
+    }
+    fclose(f);
+    if (!ok) { LOGE("%s program: cache file corrupt, removed", name); remove(path.c_str()); return 0; }
+
+    GLuint prog = g_gl->CreateProgram();
+    g_gl->ProgramBinary(prog, format, bin.data(), (GLint)length);
+    GLint linked = 0; g_gl->GetProgramiv(prog, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        LOGI("%s program: cached binary rejected by the driver, recompiling", name);
+        g_gl->DeleteProgram(prog);
+        remove(path.c_str());
+        return 0;
+    }
+    return prog;
+}
+
+static void readProgramBinary(GLuint prog, const std::string& path, std::vector<ProgramBinaryBlob>& out) {
+    GLint length = 0;
+    g_gl->GetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+    if (length <= 0) return;
+    ProgramBinaryBlob blob;
+    blob.path = path;
+    blob.data.resize((size_t)length);
+    GLsizei got = 0;
+    g_gl->GetProgramBinary(prog, length, &got, &blob.format, blob.data.data());
+    if (got <= 0) return;
+    blob.data.resize((size_t)got);
+    out.push_back(std::move(blob));
+}
+
+// 先写临时文件再 rename, 读不到写了一半的文件
+static void storeProgramBinaries(std::vector<ProgramBinaryBlob> blobs) {
+    if (blobs.empty()) return;
+    g_programCacheWriter.join();
+    g_programCacheWriter.thread = std::thread([blobs = std::move(blobs)] {
+        for (const ProgramBinaryBlob& b : blobs) {
+            uint8_t hdr[24];
+            uint32_t format = b.format, length = (uint32_t)b.data.size();
+            uint32_t checksum = (uint32_t)hash64(b.data.data(), b.data.size());
+            memcpy(hdr, kProgramCacheMagic, 8);
+            memcpy(hdr + 8, &kProgramCacheVersion, 4);  memcpy(hdr + 12, &format, 4);
+            memcpy(hdr + 16, &length, 4);               memcpy(hdr + 20, &checksum, 4);
+            std::string tmp = b.path + ".tmp";
+            FILE* f = fopen(tmp.c_str(), "wb");
+            bool ok = f && fwrite(hdr, 1, sizeof(hdr), f) == sizeof(hdr)
+                        && fwrite(b.data.data(), 1, b.data.size(), f) == b.data.size();
+            if (f) ok = fclose(f) == 0 && ok;
+            if (ok && rename(tmp.c_str(), b.path.c_str()) == 0) {
+                LOGI("Program cache: stored %s (%u bytes)", b.path.c_str(), length);
+            } else {
+                LOGE("Program cache: cannot write %s", b.path.c_str());
+                remove(tmp.c_str());
+            }
+        }
+    });
+}
+
+// 先查缓存; 其余程序先提交全部 compile / link 再统一查询状态; 新编译的程序写入缓存
+static void buildPrograms(const ProgramSource* src, size_t n, GLuint* out) {
+    double t0 = getCurrentTime();
+    bool cache = g_programBinary && !g_shaderCacheDir.empty();
+    std::vector<std::string> paths(n);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = 0;
+        if (!cache) continue;
+        paths[i] = programCachePath(src[i]);
+        out[i] = loadCachedProgram(paths[i], src[i].name);
+        if (out[i]) { g_shaderCacheStats.cached++; LOGI("%s program loaded from cache", src[i].name); }
+    }
+
+    struct Pending { GLuint vs = 0, fs = 0, prog = 0; };
+    std::vector<Pending> pending(n);
+    for (size_t i = 0; i < n; i++) {
+        if (out[i]) continue;
+        pending[i].vs = startShader(GL_VERTEX_SHADER, src[i].vs);
+        pending[i].fs = startShader(GL_FRAGMENT_SHADER, src[i].fs);
+    }
+    for (Pending& p : pending) {
+        if (!p.vs) continue;
+        p.prog = g_gl->CreateProgram();
+        g_gl->AttachShader(p.prog, p.vs); g_gl->AttachShader(p.prog, p.fs);
+        g_gl->LinkProgram(p.prog);
+    }
+
+    std::vector<ProgramBinaryBlob> blobs;
+    for (size_t i = 0; i < n; i++) {
+        Pending& p = pending[i];
+        if (!p.prog) continue;
+        bool ok = shaderCompiled(p.vs, src[i].name) & shaderCompiled(p.fs, src[i].name);
+        if (ok) {
+            GLint linked; g_gl->GetProgramiv(p.prog, GL_LINK_STATUS, &linked);
+            if (!linked) {
+                char buf[512]; g_gl->GetProgramInfoLog(p.prog, 512, nullptr, buf);
+                LOGE("%s link err: %s", src[i].name, buf);
+                ok = false;
+            }
+        }
+        g_gl->DeleteShader(p.vs); g_gl->DeleteShader(p.fs);
+        if (!ok) { g_gl->DeleteProgram(p.prog); continue; }
+        out[i] = p.prog;
+        g_shaderCacheStats.compiled++;
+        if (cache) readProgramBinary(p.prog, paths[i], blobs);
+    }
+    storeProgramBinaries(std::move(blobs));
+    g_shaderCacheStats.ms += (getCurrentTime() - t0) * 1000.0;
+}
+
+// ===================== Mask Shader =====================
+
+// Mask shader: renders drawable alpha to FBO for clipping.
+// ALPHA_TEST variant (stencil clipping): fragments under half coverage are discarded,
+// the rest only write the stencil buffer
+static const char* kMaskFS =
+    "precision mediump float;\n"
+    "varying vec2 v_texCoord;\n"
+    "uniform sampler2D u_texture;\n"
+    "uniform float u_opacity;\n"
+    "void main() {\n"
+    "    float a = texture2D(u_texture, v_texCoord).a * u_opacity;\n"
+    "#ifdef ALPHA_TEST\n"
+    "    if (a < 0.5) discard;\n"
+    "#endif\n"
+    "    gl_FragColor = vec4(a, a, a, a);\n"
+    "}\n";
+
+// "#version 300 es" 由调用方加在 #define 之前
+static const char* kMaskFS3 =
+    "precision mediump float;\n"
+    "in vec2 v_texCoord;\n"
+    "out vec4 fragColor;\n"
+    "uniform sampler2D u_texture;\n"
+    "layout(std140) uniform DrawableBlock { vec4 u_multiplyColor; vec4 u_screenColor; float u_opacity; };\n"
+    "void main() {\n"
+    "    float a = texture(u_texture, v_texCoord).a * u_opacity;\n"
+    "#ifdef ALPHA_TEST\n"
+    "    if (a < 0.5) discard;\n"
+    "#endif\n"
+    "    fragColor = vec4(a, a, a, a);\n"
+    "}\n";
+
+// 颜色纹理 + FBO, 线性过滤; 已有则先删除。stencil 非空时再附一个 8 位模板渲染缓冲
+static void createRenderTarget(int w, int h, GLuint& fbo, GLuint& tex, const char* name, GLuint* stencil = nullptr) {
+    if (fbo) { g_gl->DeleteFramebuffers(1, &fbo); fbo = 0; }
+    if (tex) { g_gl->DeleteTextures(1, &tex); tex = 0; }
+    if (stencil && *stencil) { g_gl->DeleteRenderbuffers(1, stencil); *stencil = 0; }
+
+    g_gl->GenTextures(1, &tex);
+    g_gl->BindTexture(GL_TEXTURE_2D, tex);
+    g_gl->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    g_gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    g_gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    g_gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    g_gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    g_gl->GenFramebuffers(1, &fbo);
+    g_gl->BindFramebuffer(GL_FRAMEBUFFER, fbo);
+    g_gl->FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex, 0);
+    if (stencil) {
+        g_gl->GenRenderbuffers(1, stencil);
+        g_gl->BindRenderbuffer(GL_RENDERBUFFER, *stencil);
+        g_gl->RenderbufferStorage(GL_RENDERBUFFER, GL_STENCIL_INDEX8, w, h);
+        g_gl->FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, *stencil);
+        g_gl->BindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+
+    GLenum status = g_gl->CheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOGE("%s FBO incomplete: 0x%x", name, status);
+        // 模板附件不被支持时退回纯颜色目标, 由调用方按 *stencil == 0 走遮罩纹理
+        if (stencil && *stencil) {
+            g_gl->FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, 0);
+            g_gl->DeleteRenderbuffers(1, stencil);
+            *stencil = 0;
+        }
+    }
+    else LOGI("%s FBO created: %dx%d tex=%d fbo=%d", name, w, h, tex, fbo);
+
+    g_gl->BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// 本帧是否用模板裁剪: 显式选择, 或 Auto 在 tiler 上
+static bool stencilClippingWanted() {
+    if (g_clipMode == ClipMode::Stencil) return true;
+    return g_clipMode == ClipMode::Auto && g_tiledGPU;
+}
+
+static void ensureMaskFBO(int w, int h) {
+    if (g_maskW == w && g_maskH == h && g_maskFBO != 0) return;
+    g_maskW = w; g_maskH = h;
+    createRenderTarget(w, h, g_maskFBO, g_maskTexture, "Mask");
+}
+
+// ===================== Draw Programs =====================
+// drawable 的片段着色器按用到的步骤拼出 #define 变体: 绝大多数 drawable 的 multiplyColor
+// 为 (1,1,1)、screenColor 为 0, 走不含这两步的短着色器。每个 drawable 按当帧的颜色、遮罩
+// 和纹理格式选择变体; 常用的在 initRenderer 构建, 模型用到的在 loadModel 末尾一批构建,
+// 其余在第一次用到时构建 (都经过 Program Binary Cache)。GLES3 路径用 kVS3 / kDrawFS3 同一组变体。
+
+enum DrawPermutation {
+    kPermPremultiplied = 1 << 0,   // 纹理已预乘 alpha
+    kPermMultiply      = 1 << 1,   // multiplyColor.rgb != 1
+    kPermScreen        = 1 << 2,   // screenColor.rgb != 0
+    kPermMasked        = 1 << 3,
+    kPermInvertedMask  = 1 << 4,   // csmIsInvertedMask: 遮罩之外可见
+    kDrawPermutations  = 1 << 5,
+};
+
+static const char* const kPermDefines[] = {"PREMULTIPLIED", "HAS_MULTIPLY", "HAS_SCREEN", "MASKED", "INVERTED_MASK"};
+
+static ShaderInfo g_drawPrograms[kDrawPermutations];
+
+// GLES3: 两个 uniform block 的绑定点 (GLSL ES 3.00 不能在着色器里写 binding)
+static const GLuint kFrameBlockBinding    = 0;
+static const GLuint kDrawableBlockBinding = 1;
+
+static void bindUniformBlocks(GLuint prog) {
+    GLuint frame    = g_gl->GetUniformBlockIndex(prog, "FrameBlock");
+    GLuint drawable = g_gl->GetUniformBlockIndex(prog, "DrawableBlock");
+    if (frame != GL_INVALID_INDEX)    g_gl->UniformBlockBinding(prog, frame, kFrameBlockBinding);
+    if (drawable != GL_INVALID_INDEX) g_gl->UniformBlockBinding(prog, drawable, kDrawableBlockBinding);
+}
+
+static int colorPermutation(const csmVector4* mc, const csmVector4* sc, int i) {
+    int perm = 0;
+    if (mc && (mc[i].X != 1.f || mc[i].Y != 1.f || mc[i].Z != 1.f)) perm |= kPermMultiply;
+    if (sc && (sc[i].X != 0.f || sc[i].Y != 0.f || sc[i].Z != 0.f)) perm |= kPermScreen;
+    return perm;
+}
+
+static void setDrawProgram(int perm, GLuint prog, const char* name) {
+    ShaderInfo& sh = g_drawPrograms[perm];
+    sh = ShaderInfo();
+    if (!prog) { sh.failed = true; return; }
+    sh.program    = prog;
+    sh.a_position = g_gl->GetAttribLocation(prog, "a_position");
+    sh.a_texCoord = g_gl->GetAttribLocation(prog, "a_texCoord");
+    sh.u_matrix   = g_gl->GetUniformLocation(prog, "u_matrix");
+    sh.u_texture  = g_gl->GetUniformLocation(prog, "u_texture");
+    sh.u_opacity  = g_gl->GetUniformLocation(prog, "u_opacity");
+    sh.u_multiplyColor = g_gl->GetUniformLocation(prog, "u_multiplyColor");
+    sh.u_screenColor   = g_gl->GetUniformLocation(prog, "u_screenColor");
+    sh.u_mask          = g_gl->GetUniformLocation(prog, "u_mask");
+    sh.u_viewportSize  = g_gl->GetUniformLocation(prog, "u_viewportSize");
+    if (g_gles3) {
+        // 采样器单元和 block 绑定属于程序状态, 构建后设置一次, 绘制时不再写 uniform
+        bindUniformBlocks(prog);
+        if (sh.u_mask >= 0) { g_gl->UseProgram(prog); g_gl->Uniform1i(sh.u_mask, 1); }
+    }
+    LOGI("%s shader OK, program=%d", name, prog);
+}
+
+static void setMaskProgram(MaskShaderInfo& ms, GLuint prog, const char* name) {
+    ms = MaskShaderInfo();
+    if (!prog) { ms.failed = true; return; }
+    ms.program    = prog;
+    ms.a_position = g_gl->GetAttribLocation(prog, "a_position");
+    ms.a_texCoord = g_gl->GetAttribLocation(prog, "a_texCoord");
+    ms.u_matrix   = g_gl->GetUniformLocation(prog, "u_matrix");
+    ms.u_texture  = g_gl->GetUniformLocation(prog, "u_texture");
+    ms.u_opacity  = g_gl->GetUniformLocation(prog, "u_opacity");
+    if (g_gles3) bindUniformBlocks(prog);
+    LOGI("%s shader OK, program=%d", name, prog);
+}
+
+// perms 中的变体一起构建; withMask 时遮罩程序也放进同一批
+static void buildDrawPrograms(const int* perms, int n, bool withMask) {
+    std::vector<std::string> names(n), sources(n);
+    std::vector<ProgramSource> list;
+    const char* vs = g_gles3 ? kVS3 : kVS;
+    std::string maskSource = g_gles3 ? std::string("#version 300 es\n") + kMaskFS3 : kMaskFS;
+    if (withMask) list.push_back({"Mask", vs, maskSource.c_str()});
+    for (int k = 0; k < n; k++) {
+        names[k] = "Draw";
+        if (g_gles3) sources[k] = "#version 300 es\n";
+        for (int b = 0; b < 5; b++) {
+            if (!(perms[k] & (1 << b))) continue;
+            names[k] += names[k].size() == 4 ? " " : "+";
+            names[k] += kPermDefines[b];
+            sources[k] += std::string("#define ") + kPermDefines[b] + "\n";
+        }
+        sources[k] += g_gles3 ? kDrawFS3 : kDrawFS;
+        list.push_back({names[k].c_str(), vs, sources[k].c_str()});
+    }
+    std::vector<GLuint> programs(list.size());
+    buildPrograms(list.data(), list.size(), programs.data());
+
+    if (withMask && programs[0]) setMaskProgram(g_maskShader, programs[0], "Mask");
+    size_t first = withMask ? 1 : 0;
+    for (int k = 0; k < n; k++) setDrawProgram(perms[k], programs[first + k], names[k].c_str());
+}
+
+// 遮罩程序 + 流式解码纹理的普通 / 被遮罩变体 (合成程序在开启动态分辨率时才构建)。
+// GLES3 着色器构建失败 (驱动 bug) 时整体退回 GLES2 路径, GLSL ES 1.00 在 GLES3 上下文同样可用
+static void initShaders() {
+    const int perms[] = {kPermPremultiplied, kPermPremultiplied | kPermMasked};
+    buildDrawPrograms(perms, 2, true);
+    if (!g_gles3 || (g_maskShader.program && g_drawPrograms[perms[0]].program && g_drawPrograms[perms[1]].program)) return;
+
+    LOGE("GLES3 programs failed to build, falling back to the GLES2 path");
+    if (g_maskShader.program) g_gl->DeleteProgram(g_maskShader.program);
+    for (ShaderInfo& sh : g_drawPrograms) {
+        if (sh.program) g_gl->DeleteProgram(sh.program);
+        sh = ShaderInfo();
+    }
+    g_maskShader = MaskShaderInfo();
+    g_gles3 = false;
+    buildDrawPrograms(perms, 2, true);
+}
+
+static const ShaderInfo* drawProgram(int perm) {
+    ShaderInfo& sh = g_drawPrograms[perm];
+    if (!sh.program && !sh.failed) buildDrawPrograms(&perm, 1, false);
+    return sh.program ? &sh : nullptr;
+}
+
+// 模板裁剪的遮罩程序 (ALPHA_TEST), 第一次用到时构建
+static const MaskShaderInfo* stencilMaskProgram() {
+    MaskShaderInfo& ms = g_stencilMaskShader;
+    if (!ms.program && !ms.failed) {
+        std::string fs = g_gles3 ? std::string("#version 300 es\n#define ALPHA_TEST\n") + kMaskFS3
+                                 : std::string("#define ALPHA_TEST\n") + kMaskFS;
+        ProgramSource src = {"Mask stencil", g_gles3 ? kVS3 : kVS, fs.c_str()};
+        GLuint prog = 0;
+        buildPrograms(&src, 1, &prog);
+        setMaskProgram(ms, prog, "Mask stencil");
+    }
+    return ms.program ? &ms : nullptr;
+}
+
+// loadModel 末尾: 默认姿态下各 drawable (含隐藏的) 要用的变体一批构建, 避免首帧逐个编译。
+// 尚未上传的纹理按流式解码 (预乘) 估计; 预计走模板裁剪时被遮罩的 drawable 用普通变体
+static void prepareDrawPrograms() {
+    bool stencilClip = stencilClippingWanted() && (g_windowStencilBits > 0 || g_drs.enabled);
+    int dc = csmGetDrawableCount(g_model.model);
+    const csmFlags* cf = csmGetDrawableConstantFlags(g_model.model);
+    const int*   ti = csmGetDrawableTextureIndices(g_model.model);
+    const int*   maskCounts = csmGetDrawableMaskCounts(g_model.model);
+    const int**  masks      = csmGetDrawableMasks(g_model.model);
+    const csmVector4* mc = csmGetDrawableMultiplyColors(g_model.model);
+    const csmVector4* sc = csmGetDrawableScreenColors(g_model.model);
+    uint32_t needed = 0;
+    for (int d = 0; d < dc; d++) {
+        int t = ti[d];
+        if (t < 0 || t >= (int)g_model.textureIds.size()) continue;
+        int perm = colorPermutation(mc, sc, d);
+        if (!g_model.textureIds[t] || g_model.textureLods[t].premultiplied) perm |= kPermPremultiplied;
+        bool masked = maskCounts && masks && masks[d] && maskCounts[d] > 0;
+        if (masked && stencilClip) stencilMaskProgram();
+        else if (masked) perm |= kPermMasked | ((cf[d] & csmIsInvertedMask) ? kPermInvertedMask : 0);
+        needed |= 1u << perm;
+    }
+    int perms[kDrawPermutations], n = 0;
+    for (int p = 0; p < kDrawPermutations; p++)
+        if ((needed >> p & 1) && !g_drawPrograms[p].program && !g_drawPrograms[p].failed) perms[n++] = p;
+    if (n) buildDrawPrograms(perms, n, false);
+}
+
+// ===================== GLES3 Path =====================
+// GLES 3.x 上下文: 每个 drawable 一个常驻 VAO。UV 和索引不随参数变化, 加载后第一帧一次性放进
+// 静态缓冲; 顶点位置按固定偏移排在一个共享缓冲里, 只在有 drawable 变形的帧用 glMapBufferRange
+// (INVALIDATE_BUFFER, 驱动换一块新存储, 不等 GPU 读完上一帧) 整块重写, 所以 VAO 不用重新设置。
+// uniform 也走同一种映射: 一个 UBO 里 slot 0 是 FrameBlock (投影矩阵, 遮罩尺寸), slot i+1 是
+// drawable i 的 DrawableBlock, 绘制前只 glBindBufferRange。遮罩纹理每帧用完即丢弃
+// (glInvalidateFramebuffer), tiler 不必把它写回内存。
+// 遮罩不做实例化: 每个遮罩来源是不同的网格, 没有可以合并的相同几何。
+
+struct Gles3Buffers {
+    GLuint positions = 0;                 // 每帧流式写入
+    GLuint uvs       = 0;                 // 静态, 与 positions 偏移相同
+    GLuint indices   = 0;                 // 静态
+    GLuint uniforms  = 0;                 // FrameBlock + 每个 drawable 的 DrawableBlock
+    std::vector<GLuint>   vaos;           // 每个 drawable 一个
+    std::vector<uint32_t> vertexOffsets;  // 字节
+    std::vector<uint32_t> indexOffsets;   // 字节
+    uint32_t positionBytes = 0;
+    uint32_t blockStride   = 0;           // 按 GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 对齐
+    bool     positionsValid = false;      // 缓冲里是当前顶点
+};
+
+static const uint32_t kFrameBlockSize    = 80;   // std140: mat4 + vec2
+static const uint32_t kDrawableBlockSize = 48;   // std140: vec4 + vec4 + float
+
+static Gles3Buffers g_gles3Buffers;
+
+// 模型释放 / 重新加载时调用 (上下文仍然有效)
+static void releaseGles3Buffers() {
+    Gles3Buffers& b = g_gles3Buffers;
+    if (!b.vaos.empty()) g_gl->DeleteVertexArrays((GLsizei)b.vaos.size(), b.vaos.data());
+    for (GLuint buf : {b.positions, b.uvs, b.indices, b.uniforms})
+        if (buf) g_gl->DeleteBuffers(1, &buf);
+    b = Gles3Buffers();
+}
+
+// 加载后第一次绘制时建立缓冲和 VAO
+static void ensureGles3Buffers(int dc, const int* vc, const csmVector2** vu, const int* ic,
+                               const unsigned short** idx) {
+    Gles3Buffers& b = g_gles3Buffers;
+    if (!b.vaos.empty() || dc <= 0) return;
+
+    b.vertexOffsets.resize(dc);
+    b.indexOffsets.resize(dc);
+    uint32_t vertexBytes = 0, indexBytes = 0;
+    for (int d = 0; d < dc; d++) {
+        b.vertexOffsets[d] = vertexBytes;
+        b.indexOffsets[d]  = indexBytes;
+        vertexBytes += (uint32_t)vc[d] * sizeof(csmVector2);
+        indexBytes  += (uint32_t)ic[d] * sizeof(unsigned short);
+    }
+    b.positionBytes = vertexBytes;
+
+    GLint align = 0;
+    g_gl->GetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
+    if (align < 16) align = 16;
+    b.blockStride = (kFrameBlockSize + align - 1) / align * align;
+
+    std::vector<uint8_t> staging(std::max(vertexBytes, indexBytes));
+    g_gl->BindVertexArray(0);
+
+    g_gl->GenBuffers(1, &b.uvs);
+    g_gl->BindBuffer(GL_ARRAY_BUFFER, b.uvs);
+    for (int d = 0; d < dc; d++)
+        if (vc[d] > 0) memcpy(staging.data() + b.vertexOffsets[d], vu[d], vc[d] * sizeof(csmVector2));
+    g_gl->BufferData(GL_ARRAY_BUFFER, vertexBytes, staging.data(), GL_STATIC_DRAW);
+
+    g_gl->GenBuffers(1, &b.positions);
+    g_gl->BindBuffer(GL_ARRAY_BUFFER, b.positions);
+    g_gl->BufferData(GL_ARRAY_BUFFER, vertexBytes, nullptr, GL_STREAM_DRAW);
+
+    g_gl->GenBuffers(1, &b.indices);
+    g_gl->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, b.indices);
+    for (int d = 0; d < dc; d++)
+        if (ic[d] > 0) memcpy(staging.data() + b.indexOffsets[d], idx[d], ic[d] * sizeof(unsigned short));
+    g_gl->BufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, staging.data(), GL_STATIC_DRAW);
+    g_gl->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    g_gl->GenBuffers(1, &b.uniforms);
+    g_gl->BindBuffer(GL_UNIFORM_BUFFER, b.uniforms);
+    g_gl->BufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)b.blockStride * (dc + 1), nullptr, GL_STREAM_DRAW);
+    g_gl->BindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    b.vaos.resize(dc);
+    g_gl->GenVertexArrays(dc, b.vaos.data());
+    for (int d = 0; d < dc; d++) {
+        const void* offset = (const void*)(uintptr_t)b.vertexOffsets[d];
+        g_gl->BindVertexArray(b.vaos[d]);
+        g_gl->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, b.indices);
+        g_gl->EnableVertexAttribArray(0);
+        g_gl->EnableVertexAttribArray(1);
+        g_gl->BindBuffer(GL_ARRAY_BUFFER, b.positions);
+        g_gl->VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, offset);
+        g_gl->BindBuffer(GL_ARRAY_BUFFER, b.uvs);
+        g_gl->VertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, offset);
+    }
+    g_gl->BindVertexArray(0);
+    g_gl->BindBuffer(GL_ARRAY_BUFFER, 0);
+    LOGI("GLES3 buffers: %d VAOs, %u vertex + %u index bytes, block stride %u",
+         dc, vertexBytes, indexBytes, b.blockStride);
+}
+
+// 每次 drawModel: 变形过的帧重写顶点, 然后写 FrameBlock 和所有 DrawableBlock 并绑定 FrameBlock。
+// 映射失败 / UnmapBuffer 报告内容丢失时下一帧重写顶点
+static void uploadGles3Frame(int dc, const csmFlags* df, const int* vc, const csmVector2** vp,
+                             const float* op, const csmVector4* mc, const csmVector4* sc) {
+    Gles3Buffers& b = g_gles3Buffers;
+    if (b.vaos.empty()) return;
+
+    bool changed = !b.positionsValid;
+    for (int d = 0; d < dc && !changed; d++) changed = (df[d] & csmVertexPositionsDidChange) != 0;
+    if (changed && b.positionBytes > 0) {
+        g_gl->BindBuffer(GL_ARRAY_BUFFER, b.positions);
+        auto* dst = (uint8_t*)g_gl->MapBufferRange(GL_ARRAY_BUFFER, 0, b.positionBytes,
+                                                   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (dst) {
+            for (int d = 0; d < dc; d++)
+                if (vc[d] > 0) memcpy(dst + b.vertexOffsets[d], vp[d], vc[d] * sizeof(csmVector2));
+            b.positionsValid = g_gl->UnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+        } else {
+            b.positionsValid = false;
+        }
+        g_gl->BindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    g_gl->BindBuffer(GL_UNIFORM_BUFFER, b.uniforms);
+    auto* blocks = (uint8_t*)g_gl->MapBufferRange(GL_UNIFORM_BUFFER, 0, (GLsizeiptr)b.blockStride * (dc + 1),
+                                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (blocks) {
+        float frame[20] = {};
+        memcpy(frame, g_projMatrix, sizeof(g_projMatrix));
+        frame[16] = (float)g_maskW;   // 遮罩纹理尺寸
+        frame[17] = (float)g_maskH;
+        memcpy(blocks, frame, kFrameBlockSize);
+        for (int d = 0; d < dc; d++) {
+            float block[12] = {1, 1, 1, 1, 0, 0, 0, 0, op[d], 0, 0, 0};
+            if (mc) memcpy(block, &mc[d], sizeof(csmVector4));
+            if (sc) memcpy(block + 4, &sc[d], sizeof(csmVector4));
+            memcpy(blocks + (size_t)b.blockStride * (d + 1), block, kDrawableBlockSize);
+        }
+        g_gl->UnmapBuffer(GL_UNIFORM_BUFFER);
+    }
+    g_gl->BindBuffer(GL_UNIFORM_BUFFER, 0);
+    g_gl->BindBufferRange(GL_UNIFORM_BUFFER, kFrameBlockBinding, b.uniforms, 0, kFrameBlockSize);
+}
+
+// 当前程序已经选好: 绑定 drawable i 的 DrawableBlock 和 VAO 后绘制
+static void drawGles3(int i, int indexCount) {
+    const Gles3Buffers& b = g_gles3Buffers;
+    g_gl->BindBufferRange(GL_UNIFORM_BUFFER, kDrawableBlockBinding, b.uniforms,
+                          (GLintptr)b.blockStride * (i + 1), kDrawableBlockSize);
+    g_gl->BindVertexArray(b.vaos[i]);
+    g_gl->DrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, (const void*)(uintptr_t)b.indexOffsets[i]);
+}
+
+// 遮罩内容只在本帧有效 (每次遮罩 pass 先清除自己的范围)
+static void invalidateMaskTarget() {
+    static const GLenum kColor = GL_COLOR_ATTACHMENT0;
+    g_gl->BindFramebuffer(GL_FRAMEBUFFER, g_maskFBO);
+    g_gl->InvalidateFramebuffer(GL_FRAMEBUFFER, 1, &kColor);
+    g_gl->BindFramebuffer(GL_FRAMEBUFFER, g_renderFBO);
+}
+
+// ===================== Screen Bounds =====================
+// 每个 drawable 的 AABB 只在 csmVertexPositionsDidChange 时重算; 每帧合并实际绘制的
+// drawable 并经 g_projMatrix 投影成像素矩形, 用于:
+// - 离屏目标 (动态分辨率) 只清除上一帧与本帧范围的并集, 合成时只写本帧范围;
+// - 遮罩 FBO 每次只清除 / 绘制被遮罩 drawable 自身的范围;
+// - modelScreenBounds() 提供给宿主 (悬浮窗可按此收缩)。
+// 窗口本身仍整体清除: GLSurfaceView 的 EGL 表面交换后内容不保留 (EGL_BUFFER_DESTROYED),
+// 并且在 tile GPU 上整屏清除是免读回的快速路径。
+
+static const int kBoundsPad = 2;   // 像素; 覆盖光栅化取整与合成时的双线性采样
+
+static void updateDrawableBounds(int dc, const csmFlags* df, const int* vc, const csmVector2** vp) {
+    std::vector<DrawableBounds>& bounds = g_model.drawableBounds;
+    bool all = g_model.boundsStale;
+    if ((int)bounds.size() != dc) { bounds.assign(dc, DrawableBounds()); all = true; }   // 加载后第一帧
+    for (int i = 0; i < dc; i++) {
+        if (!all && !(df[i] & csmVertexPositionsDidChange)) continue;
+        DrawableBounds b;
+        if (vc[i] > 0) {
+            b.minX = b.maxX = vp[i][0].X;
+            b.minY = b.maxY = vp[i][0].Y;
+            for (int v = 1; v < vc[i]; v++) {
+                b.minX = std::min(b.minX, vp[i][v].X); b.maxX = std::max(b.maxX, vp[i][v].X);
+                b.minY = std::min(b.minY, vp[i][v].Y); b.maxY = std::max(b.maxY, vp[i][v].Y);
+            }
+        }
+        bounds[i] = b;
+    }
+    g_model.boundsStale = false;
+}
+
+static void uniteBounds(DrawableBounds& a, const DrawableBounds& b, bool first) {
+    if (first) { a = b; return; }
+    a.minX = std::min(a.minX, b.minX); a.minY = std::min(a.minY, b.minY);
+    a.maxX = std::max(a.maxX, b.maxX); a.maxY = std::max(a.maxY, b.maxY);
+}
+
+static PixelRect uniteRects(const PixelRect& a, const PixelRect& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    return { std::min(a.x0, b.x0), std::min(a.y0, b.y0), std::max(a.x1, b.x1), std::max(a.y1, b.y1) };
+}
+
+// 模型空间 AABB -> w x h 目标的像素矩形 (向外取整, 外扩 pad, 裁到目标内)
+static PixelRect projectBounds(const DrawableBounds& b, int w, int h, int pad) {
+    const float* m = g_projMatrix;
+    float x0 = (b.minX * m[0] + m[12]) * 0.5f + 0.5f, x1 = (b.maxX * m[0] + m[12]) * 0.5f + 0.5f;
+    float y0 = (b.minY * m[5] + m[13]) * 0.5f + 0.5f, y1 = (b.maxY * m[5] + m[13]) * 0.5f + 0.5f;
+    if (x0 > x1) std::swap(x0, x1);
+    if (y0 > y1) std::swap(y0, y1);
+    PixelRect r;
+    r.x0 = std::max(0, (int)floorf(x0 * w) - pad);
+    r.y0 = std::max(0, (int)floorf(y0 * h) - pad);
+    r.x1 = std::min(w, (int)ceilf(x1 * w) + pad);
+    r.y1 = std::min(h, (int)ceilf(y1 * h) + pad);
+    if (r.empty()) r = PixelRect();
+    return r;
+}
+
+static bool rectsOverlap(const PixelRect& a, const PixelRect& b) {
+    return a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+}
+
+static void scissorRect(const PixelRect& r) {
+    g_gl->Scissor(r.x0, r.y0, r.x1 - r.x0, r.y1 - r.y0);
+}
+
+// 记录本帧模型范围; 离屏时清除离屏目标中上一帧与本帧范围的并集
+static void setFrameBounds(const DrawableBounds& b, bool any) {
+    g_frameBounds = b;
+    g_frameHasBounds = any;
+    g_windowRect = any ? projectBounds(b, g_viewWidth, g_viewHeight, kBoundsPad) : PixelRect();
+    const PixelRect& wr = g_windowRect;
+    g_modelBounds = wr.empty() ? ScreenRect()
+                               : ScreenRect{ wr.x0, g_viewHeight - wr.y1, wr.x1 - wr.x0, wr.y1 - wr.y0 };
+    if (g_renderFBO == 0) return;
+    if (g_renderFBO != g_sceneFBO) {
+        // 其他离屏目标 (待机动画烘焙) 每次整体清除
+        g_gl->ClearColor(0.f, 0.f, 0.f, 0.f);
+        g_gl->Clear(GL_COLOR_BUFFER_BIT);
+        return;
+    }
+
+    PixelRect cur = any ? projectBounds(b, g_renderW, g_renderH, kBoundsPad) : PixelRect();
+    g_gl->ClearColor(0.f, 0.f, 0.f, 0.f);
+    if (g_sceneDirtyW != g_renderW || g_sceneDirtyH != g_renderH) {
+        // 渲染尺寸变化 (或内容未知): 整张纹理清除, 子区域外的纹素在合成的双线性采样中也会被读到
+        g_gl->Clear(GL_COLOR_BUFFER_BIT);
+    } else if (PixelRect clear = uniteRects(g_sceneDirty, cur); !clear.empty()) {
+        g_gl->Enable(GL_SCISSOR_TEST);
+        scissorRect(clear);
+        g_gl->Clear(GL_COLOR_BUFFER_BIT);
+        g_gl->Disable(GL_SCISSOR_TEST);
+    }
+    g_sceneDirty = cur;
+    g_sceneDirtyW = g_renderW; g_sceneDirtyH = g_renderH;
+}
+
+// ===================== Dynamic Resolution =====================
+// 可选模式: 模型先画到离屏纹理, 分辨率随帧时间自动调整, 再一次放大合成到窗口。
+// 离屏纹理与遮罩 FBO 都按窗口尺寸分配一次, 缩放只改变使用的左下角子区域, 调整时不重新分配。
+// 控制输入是 drawFrame 的 dt (帧间隔, 包含 GPU 反压): 平均值超出预算则降一档;
+// 在预算内持续 probeDelay 秒则试探升一档, 试探后又超预算说明已到上限, 下次试探间隔加倍。
+// dt 来自调用方, 所以基准测试 / 回放中的调整过程是确定的。
+
+static const float kDrsMinScale      = 0.5f;
+static const float kDrsStep          = 0.85f;   // 每档的缩放比例
+static const float kDrsSettle        = 0.25f;   // 调整后等平均值跟上 (秒)
+static const float kDrsProbeDelay    = 2.f;
+static const float kDrsMaxProbeDelay = 32.f;
+
+static const char* kCompositeVS =
+    "attribute vec2 a_position;\n"
+    "uniform vec2 u_uvOffset;\n"
+    "uniform vec2 u_uvScale;\n"
+    "varying vec2 v_texCoord;\n"
+    "void main() {\n"
+    "    gl_Position = vec4(a_position, 0.0, 1.0);\n"
+    "    v_texCoord = u_uvOffset + (a_position * 0.5 + 0.5) * u_uvScale;\n"
+    "}\n";
+
+static const char* kCompositeFS =
+    "precision mediump float;\n"
+    "varying vec2 v_texCoord;\n"
+    "uniform sampler2D u_texture;\n"
+    "void main() {\n"
+    "    gl_FragColor = texture2D(u_texture, v_texCoord);\n"
+    "}\n";
+
+static void initCompositeShader() {
+    const ProgramSource source = {"Composite", kCompositeVS, kCompositeFS};
+    GLuint prog;
+    buildPrograms(&source, 1, &prog);
+    if (!prog) return;
+    g_compositeShader.program    = prog;
+    g_compositeShader.a_position = g_gl->GetAttribLocation(prog, "a_position");
+    g_compositeShader.u_texture  = g_gl->GetUniformLocation(prog, "u_texture");
+    g_compositeShader.u_uvOffset = g_gl->GetUniformLocation(prog, "u_uvOffset");
+    g_compositeShader.u_uvScale  = g_gl->GetUniformLocation(prog, "u_uvScale");
+    LOGI("Composite shader OK, program=%d", prog);
+}
+
+static void releaseSceneTarget() {
+    if (g_sceneFBO) g_gl->DeleteFramebuffers(1, &g_sceneFBO);
+    if (g_sceneTexture) g_gl->DeleteTextures(1, &g_sceneTexture);
+    if (g_sceneStencil) g_gl->DeleteRenderbuffers(1, &g_sceneStencil);
+    g_sceneFBO = g_sceneTexture = g_sceneStencil = 0;
+    g_sceneW = g_sceneH = 0;
+    g_sceneDirtyW = g_sceneDirtyH = 0;
+}
+
+static void updateDynamicResolution(float dt) {
+    DynamicResolution& d = g_drs;
+    float ms = std::min(dt * 1000.f, d.budgetMs * 2.f);   // 单次卡顿 (加载, GC) 不足以触发降档
+    d.avgMs = d.avgMs > 0.f ? d.avgMs + (ms - d.avgMs) * 0.1f : ms;
+    d.sinceChange += dt;
+    if (d.sinceChange < kDrsSettle) return;
+
+    if (d.avgMs > d.budgetMs * 1.1f) {
+        if (d.scale <= kDrsMinScale) return;
+        if (d.probing) d.probeDelay = std::min(d.probeDelay * 2.f, kDrsMaxProbeDelay);
+        d.scale = std::max(kDrsMinScale, d.scale * kDrsStep);
+        d.probing = false;
+        d.sinceChange = 0.f;
+        LOGD("Dynamic resolution: %.2f (avg %.1f ms)", d.scale, d.avgMs);
+    } else if (d.scale < 1.f && d.avgMs <= d.budgetMs * 1.05f && d.sinceChange >= d.probeDelay) {
+        if (d.probing) d.probeDelay = kDrsProbeDelay;   // 上一次试探成功
+        d.scale = std::min(1.f, d.scale / kDrsStep);
+        d.probing = true;
+        d.sinceChange = 0.f;
+        LOGD("Dynamic resolution: %.2f (probe)", d.scale);
+    }
+}
+
+// 选择本帧的渲染目标并绑定。窗口在这里清空; 离屏目标由 setFrameBounds 按范围清除
+static void beginRenderTarget(float dt) {
+    g_windowRect = PixelRect();
+    g_modelBounds = ScreenRect();
+    g_frameHasBounds = false;
+    bool offscreen = g_drs.enabled && g_viewWidth > 0 && g_viewHeight > 0;
+    if (offscreen) {
+        if (!g_compositeShader.program) initCompositeShader();
+        if (g_sceneW != g_viewWidth || g_sceneH != g_viewHeight || !g_sceneFBO) {
+            g_sceneW = g_viewWidth; g_sceneH = g_viewHeight;
+            g_sceneDirtyW = g_sceneDirtyH = 0;
+            createRenderTarget(g_sceneW, g_sceneH, g_sceneFBO, g_sceneTexture, "Scene",
+                               stencilClippingWanted() ? &g_sceneStencil : nullptr);
+        }
+        offscreen = g_compositeShader.program != 0 && g_sceneFBO != 0;
+    }
+    if (!offscreen) {
+        g_renderFBO = 0;
+        g_renderW = g_viewWidth; g_renderH = g_viewHeight;
+        g_renderStencil = g_windowStencilBits > 0;
+        g_gl->ClearColor(0.f, 0.f, 0.f, 0.f);  // 透明背景
+        g_gl->Clear(GL_COLOR_BUFFER_BIT);
+        return;
+    }
+    updateDynamicResolution(dt);
+    g_renderFBO = g_sceneFBO;
+    g_renderStencil = g_sceneStencil != 0;
+    g_renderW = std::max(1, (int)(g_viewWidth * g_drs.scale + 0.5f));
+    g_renderH = std::max(1, (int)(g_viewHeight * g_drs.scale + 0.5f));
+    g_gl->BindFramebuffer(GL_FRAMEBUFFER, g_sceneFBO);
+    g_gl->Viewport(0, 0, g_renderW, g_renderH);
+}
+
+// 纹理的 [u0, u0 + us] x [v0, v0 + vs] 区域写满当前视口 (不混合)
+static void drawCompositeQuad(GLuint texture, float u0, float v0, float us, float vs) {
+    static const GLfloat kQuad[] = { -1.f, -1.f,  1.f, -1.f,  -1.f, 1.f,  1.f, 1.f };
+    static const GLushort kQuadIndices[] = { 0, 1, 2, 2, 1, 3 };
+    g_gl->Disable(GL_BLEND);
+    g_gl->Disable(GL_CULL_FACE);
+    g_gl->UseProgram(g_compositeShader.program);
+    g_gl->ActiveTexture(GL_TEXTURE0);
+    g_gl->BindTexture(GL_TEXTURE_2D, texture);
+    g_gl->Uniform1i(g_compositeShader.u_texture, 0);
+    g_gl->Uniform2f(g_compositeShader.u_uvOffset, u0, v0);
+    g_gl->Uniform2f(g_compositeShader.u_uvScale, us, vs);
+    g_gl->EnableVertexAttribArray(g_compositeShader.a_position);
+    g_gl->VertexAttribPointer(g_compositeShader.a_position, 2, GL_FLOAT, GL_FALSE, 0, kQuad);
+    g_gl->DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, kQuadIndices);
+    g_gl->DisableVertexAttribArray(g_compositeShader.a_position);
+}
+
+// 离屏时清空窗口, 再把子区域放大写到模型范围内 (范围外保持透明)
+static void endRenderTarget() {
+    if (g_renderFBO == 0) return;
+    g_gl->BindFramebuffer(GL_FRAMEBUFFER, 0);
+    g_gl->Viewport(0, 0, g_viewWidth, g_viewHeight);
+    g_gl->ClearColor(0.f, 0.f, 0.f, 0.f);
+    g_gl->Clear(GL_COLOR_BUFFER_BIT);
+    if (g_windowRect.empty()) return;
+    g_gl->Enable(GL_SCISSOR_TEST);
+    scissorRect(g_windowRect);
+    drawCompositeQuad(g_sceneTexture, 0.f, 0.f, (float)g_renderW / g_sceneW, (float)g_renderH / g_sceneH);
+    g_gl->Disable(GL_SCISSOR_TEST);
+}
+
+// ===================== Projection =====================
+
+static void identity(float* m) { memset(m, 0, 64); m[0]=m[5]=m[10]=m[15]=1; }
+
+// 画布居中并完整放进 width x height (不含用户缩放 / 平移)
+static void fitCanvas(const Live2DModel& model, int width, int height, float* m) {
+    identity(m);
+    float mw = model.canvasWidth  / model.pixelsPerUnit;
+    float mh = model.canvasHeight / model.pixelsPerUnit;
+    float ma = mw / mh;
+    float va = (float)width / height;
+
+    float sx, sy;
+    if (va > ma) {
+        sy = 2.f / mh;
+        sx = sy * ((float)height / width);
+    } else {
+        sx = 2.f / mw;
+        sy = sx * ((float)width / height);
+    }
+
+    float centerX = (model.canvasWidth / 2.f - model.canvasOriginX) / model.pixelsPerUnit;
+    float centerY = (model.canvasOriginY - model.canvasHeight / 2.f) / model.pixelsPerUnit;
+    m[0]  = sx;
+    m[5]  = sy;
+    m[12] = -centerX * sx;
+    m[13] = -centerY * sy;
+}
+
+static void updateProjection() {
+    identity(g_projMatrix);
+    if (!g_model.loaded || g_viewWidth == 0 || g_viewHeight == 0) return;
+    fitCanvas(g_model, g_viewWidth, g_viewHeight, g_projMatrix);
+
+    // Apply user zoom & pan
+    float sx = g_projMatrix[0]  * g_userScale;
+    float sy = g_projMatrix[5]  * g_userScale;
+    float tx = g_projMatrix[12] * g_userScale + g_userOffsetX;
+    float ty = g_projMatrix[13] * g_userScale + g_userOffsetY;
+
+    g_projMatrix[0]  = sx;
+    g_projMatrix[5]  = sy;
+    g_projMatrix[12] = tx;
+    g_projMatrix[13] = ty;
+
+    LOGD("Projection: sx=%.6f sy=%.6f tx=%.4f ty=%.4f scale=%.2f off=(%.3f,%.3f)", sx, sy, tx, ty, g_userScale, g_userOffsetX, g_userOffsetY);
+}
+
+// ===================== Texture loading =====================
+// 先走流式解码 (live2d_png.h): 边读边解压边降采样, 峰值内存约为一张输出图。
+// 隔行扫描等流式路径不支持的图退回 stb_image (整文件读入 + 整图解码)。
+
+static const int kMaxTextureSize = 2048;   // 超过则按 2 的幂降采样
+
+static size_t readMemory(void* user, uint8_t* dst, size_t n) {
+    auto* src = (std::pair<const unsigned char*, size_t>*)user;
+    if (n > src->second) n = src->second;
+    memcpy(dst, src->first, n);
+    src->first += n; src->second -= n;
+    return n;
+}
+
+#ifdef __ANDROID__
+static size_t readAssetStream(void* user, uint8_t* dst, size_t n) {
+    int r = AAsset_read((AAsset*)user, dst, n);
+    return r > 0 ? (size_t)r : 0;
+}
+#else
+static size_t readFileStream(void* user, uint8_t* dst, size_t n) {
+    return fread(dst, 1, n, (FILE*)user);
+}
+#endif
+
+// 纹理文件的读取流: bundle 条目 / Android asset / 本地文件
+struct TextureStream {
+    std::pair<const unsigned char*, size_t> mem{nullptr, 0};
+    PngReadFn read = nullptr;
+    void*     user = nullptr;
+#ifdef __ANDROID__
+    AAsset* asset = nullptr;
+    ~TextureStream() { if (asset) AAsset_close(asset); }
+#else
+    FILE* file = nullptr;
+    ~TextureStream() { if (file) fclose(file); }
+#endif
+
+    bool open(const std::string& path, std::string& err) {
+        if (bundleOpen()) {
+            const BundleEntryView* e = findBundleEntry(path);
+            if (!e) { err = "not in bundle"; return false; }
+            mem = {e->data, e->size};
+            read = readMemory; user = &mem;
+            return true;
+        }
+#ifdef __ANDROID__
+        if (!g_assetManager) { err = "no asset manager"; return false; }
+        asset = AAssetManager_open(g_assetManager, path.c_str(), AASSET_MODE_STREAMING);
+        if (!asset) { err = "cannot open asset"; return false; }
+        read = readAssetStream; user = asset;
+#else
+        file = fopen(path.c_str(), "rb");
+        if (!file) { err = "cannot open file"; return false; }
+        read = readFileStream; user = file;
+#endif
+        return true;
+    }
+};
+
+static PngStatus decodeTextureStream(const std::string& path, int maxDim, PngImage& img, std::string& err) {
+    TextureStream in;
+    if (!in.open(path, err)) return PngStatus::Error;
+    return decodePngStream(in.read, in.user, maxDim, true, img, &err);
+}
+
+// 只读 PNG 头取尺寸 (延迟驻留的纹理在加载时不解码)
+static bool readTextureSize(const std::string& path, int& width, int& height) {
+    TextureStream in;
+    std::string err;
+    return in.open(path, err) && readPngSize(in.read, in.user, width, height);
+}
+
+// stb_image 路径: 整文件读入, 解码整图后再降采样。pixels 均来自 malloc (stb 默认分配器)
+static bool decodeTextureStb(const std::string& path, int maxDim, PngImage& img) {
+    AssetBytes pngData = loadAsset(path);
+    if (pngData.empty()) { LOGE("Cannot read texture: %s", path.c_str()); return false; }
+    LOGI("PNG file: %s (%zu bytes)", path.c_str(), pngData.size);
+
+    if (pngData.size < 8 || pngData.data[0] != 0x89 || pngData.data[1] != 0x50
+        || pngData.data[2] != 0x4E || pngData.data[3] != 0x47) {
+        LOGE("Invalid PNG header"); return false;
+    }
+
+    // Cubism UV: V=0 = 纹理底部 (OpenGL 坐标系). stb_image 默认 row0 = 图片顶部.
+    // 必须翻转，使图片顶部对应 GL 纹理顶部 (V=1)，这样 Cubism UV 才能正确采样。
+    stbi_set_flip_vertically_on_load(1);
+    int w, h, channels;
+    unsigned char* pixels = stbi_load_from_memory(
+        pngData.data, (int)pngData.size, &w, &h, &channels, 4);
+    if (!pixels) {
+        LOGE("stb_image decode failed: %s - %s", path.c_str(), stbi_failure_reason());
+        return false;
+    }
+    LOGI("stb_image decoded: %s %dx%d ch=%d", path.c_str(), w, h, channels);
+    pngData = AssetBytes();
+
+    int scale = pngDownsampleScale(w, h, maxDim);
+    int targetW = w / scale, targetH = h / scale;
+
+    unsigned char* finalPixels = pixels;
+    if (scale > 1) {
+        LOGI("Downsampling %dx%d -> %dx%d (scale=1/%d)", w, h, targetW, targetH, scale);
+        finalPixels = (unsigned char*)malloc(targetW * targetH * 4);
+        if (!finalPixels) { stbi_image_free(pixels); return false; }
+        int n = scale * scale;
+        for (int y = 0; y < targetH; y++) {
+            for (int x = 0; x < targetW; x++) {
+                int r = 0, g = 0, b = 0, a = 0;
+                for (int sy2 = 0; sy2 < scale; sy2++) {
+                    for (int sx2 = 0; sx2 < scale; sx2++) {
+                        int srcIdx = ((y * scale + sy2) * w + (x * scale + sx2)) * 4;
+                        r += pixels[srcIdx + 0];
+                        g += pixels[srcIdx + 1];
+                        b += pixels[srcIdx + 2];
+                        a += pixels[srcIdx + 3];
+                    }
+                }
+                int dstIdx = (y * targetW + x) * 4;
+                finalPixels[dstIdx + 0] = (unsigned char)(r / n);
+                finalPixels[dstIdx + 1] = (unsigned char)(g / n);
+                finalPixels[dstIdx + 2] = (unsigned char)(b / n);
+                finalPixels[dstIdx + 3] = (unsigned char)(a / n);
+            }
+        }
+        stbi_image_free(pixels);
+        pixels = nullptr;
+    }
+
+    img.pixels = finalPixels;
+    img.width = targetW; img.height = targetH;
+    img.srcWidth = w; img.srcHeight = h;
+    img.scale = scale;
+    return true;
+}
+
+// 一张贴图的解码结果; 流式解码可以在工作线程上做, stb 回退与上传在 GL 线程
+struct TextureJob {
+    std::string path;
+    int         maxDim = kMaxTextureSize;
+    PngImage    img;
+    PngStatus   status = PngStatus::Error;
+    std::string error;
+    bool        premultiplied = false;
+    bool        done = false;
+};
+
+// straight → 预乘 alpha, round(c * a / 255)
+static void premultiplyAlpha(PngImage& img) {
+    uint8_t* p = img.pixels;
+    size_t n = (size_t)img.width * img.height;
+    for (size_t i = 0; i < n; i++, p += 4) {
+        unsigned a = p[3];
+        if (a == 255) continue;
+        for (int c = 0; c < 3; c++) {
+            unsigned t = p[c] * a + 128;
+            p[c] = (uint8_t)((t + (t >> 8)) >> 8);
+        }
+    }
+}
+
+// 流式解码的图在解码线程顺带预乘 (mipmap 与双线性过滤都在预乘空间进行, 片段着色器少一步);
+// stb_image 回退在 GL 线程, 保持 straight alpha
+static void decodeTextureJob(TextureJob& job) {
+    job.status = decodeTextureStream(job.path, job.maxDim, job.img, job.error);
+    if (job.status == PngStatus::Ok) {
+        premultiplyAlpha(job.img);
+        job.premultiplied = true;
+    }
+}
+
+// GL 线程: 流式解码不支持的图在这里退回 stb_image
+static bool resolveTextureJob(TextureJob& job) {
+    const std::string& path = job.path;
+    PngImage& img = job.img;
+    if (job.status == PngStatus::Ok) {
+        LOGI("PNG streamed: %s %dx%d -> %dx%d", path.c_str(), img.srcWidth, img.srcHeight, img.width, img.height);
+        return true;
+    }
+    if (job.status == PngStatus::Unsupported) {
+        LOGI("PNG %s: %s, using stb_image", path.c_str(), job.error.c_str());
+        return decodeTextureStb(path, job.maxDim, img);
+    }
+    LOGE("PNG decode failed: %s - %s", path.c_str(), job.error.c_str());
+    return false;
+}
+
+static bool isPowerOfTwo(int v) { return v > 0 && (v & (v - 1)) == 0; }
+
+// GL 纹理: 上传 level 0, 2 的幂尺寸时生成 mipmap 用三线性过滤
+// (GLES2 的 NPOT 纹理不能带 mipmap, 退回 GL_LINEAR)
+static GLuint uploadTextureGL(const PngImage& img, bool mipmapped) {
+    GLuint texId;
+    g_gl->GenTextures(1, &texId);
+    g_gl->BindTexture(GL_TEXTURE_2D, texId);
+    g_gl->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, img.width, img.height, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, img.pixels);
+    if (mipmapped) g_gl->GenerateMipmap(GL_TEXTURE_2D);
+    g_gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    g_gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    g_gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    g_gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    GLenum glErr = g_gl->GetError();
+    if (glErr != GL_NO_ERROR) LOGE("glTexImage2D error: 0x%x", glErr);
+    return texId;
+}
+
+// 创建纹理 (GL 或 Vulkan, 同样的 mipmap 规则) 并记录尺寸。上传后释放像素
+static GLuint createTexture(PngImage& img, TextureLod& lod) {
+    bool mipmapped = isPowerOfTwo(img.width) && isPowerOfTwo(img.height);
+#ifdef LIVE2D_VULKAN
+    GLuint texId = g_backend == RenderBackend::Vulkan
+                 ? vulkanCreateTexture(img.pixels, img.width, img.height, lod.premultiplied)
+                 : uploadTextureGL(img, mipmapped);
+#else
+    GLuint texId = uploadTextureGL(img, mipmapped);
+#endif
+
+    lod.srcWidth  = img.srcWidth;
+    lod.srcHeight = img.srcHeight;
+    lod.scale     = img.scale;
+    lod.width     = img.width;
+    lod.height    = img.height;
+    lod.mipmapped = mipmapped;
+    freePngImage(img);
+    return texId;
+}
+
+static GLuint finishTexture(TextureJob& job, TextureLod& lod) {
+    lod.path = job.path;
+    if (!resolveTextureJob(job)) return 0;
+    lod.premultiplied = job.premultiplied;
+    lod.minScale = job.img.scale;
+    GLuint texId = createTexture(job.img, lod);
+    LOGI("Texture %s -> GL %d (%dx%d%s)", job.path.c_str(), texId, lod.width, lod.height, lod.mipmapped ? ", mipmapped" : "");
+    return texId;
+}
+
+static void deleteTexture(GLuint id) {
+#ifdef LIVE2D_VULKAN
+    if (g_backend == RenderBackend::Vulkan) { vulkanDestroyTexture(id); return; }
+#endif
+    g_gl->DeleteTextures(1, &id);
+}
+
+// 多张贴图并行解码 (PNG 只有一条 zlib 流, 单张图内无法并行), 按顺序在 GL 线程上传。
+// 已解码未上传的图最多 kMaxDecodeThreads 张, 限制峰值内存。
+// needed[i] == 0 的贴图只读 PNG 头, 留给 Texture Residency 按需上传; 读不到头的照常加载。
+static const unsigned kMaxDecodeThreads = 4;
+
+static void loadTextures(const std::vector<std::string>& paths, const std::vector<char>& needed,
+                         std::vector<GLuint>& ids, std::vector<TextureLod>& lods) {
+    ids.assign(paths.size(), 0);
+    lods.assign(paths.size(), TextureLod());
+    std::vector<size_t> order;
+    for (size_t i = 0; i < paths.size(); i++) {
+        TextureLod& lod = lods[i];
+        int w, h;
+        if (needed[i] || !readTextureSize(paths[i], w, h)) { order.push_back(i); continue; }
+        lod.path = paths[i];
+        lod.srcWidth = w; lod.srcHeight = h;
+        lod.minScale = lod.scale = pngDownsampleScale(w, h, kMaxTextureSize);
+        LOGI("Texture[%d] deferred: %dx%d", (int)i, w, h);
+    }
+
+    const size_t n = order.size();
+    std::vector<TextureJob> jobs(n);
+    for (size_t k = 0; k < n; k++) jobs[k].path = paths[order[k]];
+
+    unsigned workers = std::min<unsigned>({(unsigned)n, std::max(1u, std::thread::hardware_concurrency()), kMaxDecodeThreads});
+    if (workers <= 1) {
+        for (size_t k = 0; k < n; k++) {
+            decodeTextureJob(jobs[k]);
+            ids[order[k]] = finishTexture(jobs[k], lods[order[k]]);
+        }
+        return;
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t next = 0, uploaded = 0;
+    auto work = [&] {
+        for (;;) {
+            size_t k;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return next >= n || next < uploaded + workers; });
+                if (next >= n) return;
+                k = next++;
+            }
+            decodeTextureJob(jobs[k]);
+            { std::lock_guard<std::mutex> lock(mutex); jobs[k].done = true; }
+            cv.notify_all();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned w = 0; w < workers; w++) pool.emplace_back(work);
+    for (size_t k = 0; k < n; k++) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return jobs[k].done; });
+        }
+        ids[order[k]] = finishTexture(jobs[k], lods[order[k]]);
+        { std::lock_guard<std::mutex> lock(mutex); uploaded++; }
+        cv.notify_all();
+    }
+    for (std::thread& t : pool) t.join();
+}
+
+// ===================== Texture LOD =====================
+// 桌宠多数时候以小尺寸显示, 整张 2048² 图集常驻既占显存, 采样时缓存命中率也差。
+// 每张纹理只保留当前屏幕缩放所需的分辨率作为 level 0, 其下为 mipmap;
+// 放大 (捏合缩放) 时以更高分辨率重新流式解码并替换, 缩小后稳定一段时间再降级。
+// 所需分辨率 = 原图每模型单位纹素数 / 屏幕每模型单位像素数 (g_projMatrix, 已含 g_userScale)。
+
+static const int   kMinLodSize        = 256;    // level 0 短边不低于此值
+static const float kLodUpgradeDelay   = 0.2f;   // 目标稳定这么久再升级, 跳过捏合过程中的中间级别
+static const float kLodDowngradeDelay = 3.0f;   // 降级等待更久, 避免来回缩放时反复解码
+
+// 同一时间最多一个 LOD 解码任务; 异步时在工作线程解码, 完成后的下一帧在 GL 线程替换纹理
+struct LodDecode {
+    std::thread       thread;
+    std::atomic<bool> done{false};
+    bool              busy = false;
+    size_t            texture = 0;
+    TextureJob        job;
+
+    ~LodDecode() { if (thread.joinable()) thread.join(); }   // 进程退出时仍在解码
+};
+static LodDecode g_lodDecode;
+static bool      g_lodAsync = true;
+static float     g_trimHold = 0.f;   // trimMemory 之后的保持时间 (秒): 不升级过 trimScale, 不重新烘焙待机图集
+
+// 加载时用默认姿态的网格估算每张纹理的纹素密度: sqrt(UV 面积 × 纹素数 / 模型面积)
+static void measureTextureDensity() {
+    size_t nt = g_model.textureLods.size();
+    std::vector<double> uvArea(nt, 0.0), modelArea(nt, 0.0);
+    int dc = csmGetDrawableCount(g_model.model);
+    const int* ti = csmGetDrawableTextureIndices(g_model.model);
+    const int* ic = csmGetDrawableIndexCounts(g_model.model);
+    const csmVector2** vp = csmGetDrawableVertexPositions(g_model.model);
+    const csmVector2** vu = csmGetDrawableVertexUvs(g_model.model);
+    const unsigned short** idx = csmGetDrawableIndices(g_model.model);
+    auto area = [](const csmVector2& a, const csmVector2& b, const csmVector2& c) {
+        return 0.5 * fabs((double)(b.X - a.X) * (c.Y - a.Y) - (double)(c.X - a.X) * (b.Y - a.Y));
+    };
+    for (int d = 0; d < dc; d++) {
+        if (ti[d] < 0 || ti[d] >= (int)nt) continue;
+        for (int k = 0; k + 2 < ic[d]; k += 3) {
+            unsigned short i0 = idx[d][k], i1 = idx[d][k + 1], i2 = idx[d][k + 2];
+            modelArea[ti[d]] += area(vp[d][i0], vp[d][i1], vp[d][i2]);
+            uvArea[ti[d]]    += area(vu[d][i0], vu[d][i1], vu[d][i2]);
+        }
+    }
+    for (size_t t = 0; t < nt; t++) {
+        TextureLod& lod = g_model.textureLods[t];
+        if (modelArea[t] <= 0.0 || uvArea[t] <= 0.0) continue;
+        lod.texelsPerUnit = (float)sqrt(uvArea[t] * lod.srcWidth * lod.srcHeight / modelArea[t]);
+        LOGI("Texture[%d] density: %.1f texels/unit", (int)t, lod.texelsPerUnit);
+    }
+}
+
+static int desiredLodScale(const TextureLod& lod) {
+    float pxPerUnit = fabsf(g_projMatrix[0]) * g_renderW * 0.5f;   // 含动态分辨率缩放
+    if (lod.texelsPerUnit <= 0.f || pxPerUnit <= 0.f) return lod.minScale;
+    float ratio = lod.texelsPerUnit / pxPerUnit;   // 原图纹素 / 屏幕像素
+    int shortSide = std::min(lod.srcWidth, lod.srcHeight);
+    int s = lod.minScale;
+    while (s * 2 <= ratio && shortSide / (s * 2) >= kMinLodSize) s *= 2;
+    return std::max(s, lod.trimScale);
+}
+
+static void applyLodDecode() {
+    LodDecode& d = g_lodDecode;
+    if (d.thread.joinable()) d.thread.join();
+    d.busy = false;
+    TextureLod& lod = g_model.textureLods[d.texture];
+    if (!resolveTextureJob(d.job)) {
+        lod.srcWidth = 0;   // 之后不再尝试, 保留当前纹理
+        return;
+    }
+    int oldWidth = lod.width, oldHeight = lod.height;
+    lod.premultiplied = d.job.premultiplied;
+    GLuint texId = createTexture(d.job.img, lod);
+    GLuint& slot = g_model.textureIds[d.texture];
+    if (slot) {
+        deleteTexture(slot);
+        LOGI("Texture[%d] LOD %dx%d -> %dx%d", (int)d.texture, oldWidth, oldHeight, lod.width, lod.height);
+    } else {
+        LOGI("Texture[%d] resident: %dx%d", (int)d.texture, lod.width, lod.height);
+    }
+    slot = texId;
+}
+
+static void startLodDecode(size_t texture, int scale, bool async) {
+    LodDecode& d = g_lodDecode;
+    const TextureLod& lod = g_model.textureLods[texture];
+    d.texture = texture;
+    d.job = TextureJob();
+    d.job.path = lod.path;
+    d.job.maxDim = std::max(lod.srcWidth, lod.srcHeight) / scale;
+    d.busy = true;
+    if (!async) {
+        decodeTextureJob(d.job);
+        applyLodDecode();
+        return;
+    }
+    d.done.store(false, std::memory_order_relaxed);
+    d.thread = std::thread([] {
+        decodeTextureJob(g_lodDecode.job);
+        g_lodDecode.done.store(true, std::memory_order_release);
+    });
+}
+
+// 丢弃进行中的解码 (模型切换 / GL 上下文重建)
+static void cancelLodDecode() {
+    LodDecode& d = g_lodDecode;
+    if (!d.busy) return;
+    if (d.thread.joinable()) d.thread.join();
+    freePngImage(d.job.img);
+    d.busy = false;
+}
+
+static void updateTextureLod(float dt) {
+    if (g_lodDecode.busy) {
+        if (!g_lodDecode.done.load(std::memory_order_acquire)) return;
+        applyLodDecode();
+    }
+    for (size_t t = 0; t < g_model.textureLods.size(); t++) {
+        TextureLod& lod = g_model.textureLods[t];
+        if (lod.srcWidth == 0 || g_model.textureIds[t] == 0) continue;
+        if (g_trimHold <= 0.f) lod.trimScale = 1;
+        int want = desiredLodScale(lod);
+        if (want != lod.wanted) {
+            lod.wanted = want;
+            lod.wantedTime = 0.f;
+            continue;
+        }
+        lod.wantedTime += dt;
+        if ((want < lod.scale && lod.wantedTime >= kLodUpgradeDelay) ||
+            (want > lod.scale && lod.wantedTime >= kLodDowngradeDelay)) {
+            startLodDecode(t, want, g_lodAsync);
+            return;
+        }
+    }
+}
+
+static int64_t residentTextureBytes() {
+    int64_t bytes = 0;
+    for (size_t t = 0; t < g_model.textureLods.size(); t++) {
+        const TextureLod& lod = g_model.textureLods[t];
+        if (g_model.textureIds[t] == 0) continue;
+        int64_t level0 = (int64_t)lod.width * lod.height * 4;
+        bytes += lod.mipmapped ? level0 * 4 / 3 : level0;
+    }
+    return bytes;
+}
+
+// ===================== Texture Residency =====================
+// 换装 / 姿势变体的图集可能很少显示。加载时只解码默认姿态下用得到的图集, 其余只读
+// PNG 头 (尺寸供 LOD 使用); 每帧按可见 drawable (及其遮罩) 的实际使用决定驻留:
+// drawable 开始淡入即预取 (与 LOD 共用解码任务, 异步时在工作线程),
+// 不透明度到 kResidencyRequireOpacity 仍未就绪则当帧同步解码, 在此之前它不绘制。
+// 连续 kResidencyEvictDelay 秒没有用到的纹理被释放, 再次用到时按当前 LOD 重新解码。
+
+static const float kResidencyRequireOpacity = 0.25f;
+static const float kResidencyEvictDelay     = 30.f;
+static bool        g_lazyTextures = true;
+
+// 默认姿态 (csmUpdateModel 之后) 下会被绘制的纹理
+static std::vector<char> initialTextureUse(size_t textureCount) {
+    std::vector<char> used(textureCount, g_lazyTextures ? 0 : 1);
+    int dc = csmGetDrawableCount(g_model.model);
+    const csmFlags* df = csmGetDrawableDynamicFlags(g_model.model);
+    const int*   ti = csmGetDrawableTextureIndices(g_model.model);
+    const float* op = csmGetDrawableOpacities(g_model.model);
+    const int*   maskCounts = csmGetDrawableMaskCounts(g_model.model);
+    const int**  masks      = csmGetDrawableMasks(g_model.model);
+    auto use = [&](int d) { if (ti[d] >= 0 && ti[d] < (int)textureCount) used[ti[d]] = 1; };
+    for (int d = 0; d < dc; d++) {
+        if (!(df[d] & csmIsVisible) || op[d] <= 0.001f) continue;
+        use(d);
+        for (int m = 0; maskCounts && masks && masks[d] && m < maskCounts[d]; m++) {
+            int mi = masks[d][m];
+            if (mi >= 0 && mi < dc && op[mi] > 0.001f) use(mi);
+        }
+    }
+    return used;
+}
+
+static void evictTexture(size_t t) {
+    TextureLod& lod = g_model.textureLods[t];
+    GLuint& id = g_model.textureIds[t];
+    LOGI("Texture[%d] evicted after %.0fs unused (%dx%d)", (int)t, lod.unusedTime, lod.width, lod.height);
+    deleteTexture(id);
+    id = 0;
+    lod.width = lod.height = 0;
+    lod.mipmapped = false;
+    lod.wanted = 0;
+}
+
+// 释放 unusedTime 超过 minUnused 的纹理 (LOD 正在替换的除外)
+static int evictUnusedTextures(float minUnused) {
+    int evicted = 0;
+    for (size_t t = 0; t < g_model.textureLods.size(); t++) {
+        if (!g_model.textureIds[t] || g_model.textureLods[t].unusedTime <= minUnused) continue;
+        if (g_lodDecode.busy && g_lodDecode.texture == t) continue;
+        evictTexture(t);
+        evicted++;
+    }
+    return evicted;
+}
+
+// 让纹理 t 驻留; require 时当帧完成, 否则只在解码任务空闲时发起预取
+static void requestTexture(size_t t, bool require) {
+    LodDecode& d = g_lodDecode;
+    if (d.busy) {
+        if (!require) return;
+        applyLodDecode();   // 等进行中的解码完成 (可能正是这一张)
+        if (g_model.textureIds[t]) return;
+    }
+    TextureLod& lod = g_model.textureLods[t];
+    if (lod.srcWidth == 0) return;   // 解码失败过
+    startLodDecode(t, desiredLodScale(lod), g_lodAsync && !require);
+}
+
+// updateModel 之后、drawModel 之前调用; blocking 时所有用到的纹理当帧驻留 (烘焙待机图集)
+static void updateTextureResidency(float dt, bool blocking) {
+    const size_t nt = g_model.textureLods.size();
+    if (nt == 0) return;
+    for (TextureLod& lod : g_model.textureLods) lod.useOpacity = 0.f;
+
+    int dc = csmGetDrawableCount(g_model.model);
+    const csmFlags* df = csmGetDrawableDynamicFlags(g_model.model);
+    const int*   ti = csmGetDrawableTextureIndices(g_model.model);
+    const float* op = csmGetDrawableOpacities(g_model.model);
+    const int*   maskCounts = csmGetDrawableMaskCounts(g_model.model);
+    const int**  masks      = csmGetDrawableMasks(g_model.model);
+    auto use = [&](int d, float opacity) {
+        if (ti[d] < 0 || ti[d] >= (int)nt) return;
+        float& u = g_model.textureLods[ti[d]].useOpacity;
+        u = std::max(u, opacity);
+    };
+    for (int d = 0; d < dc; d++) {
+        if (!(df[d] & csmIsVisible) || op[d] <= 0.001f) continue;
+        use(d, op[d]);
+        // 遮罩按其不透明度写入遮罩纹理: 缺了它, 被遮罩的 drawable 大约少了 op[d] * op[mi]
+        for (int m = 0; maskCounts && masks && masks[d] && m < maskCounts[d]; m++) {
+            int mi = masks[d][m];
+            if (mi >= 0 && mi < dc && op[mi] > 0.001f) use(mi, op[d] * op[mi]);
+        }
+    }
+
+    for (size_t t = 0; t < nt; t++) {
+        TextureLod& lod = g_model.textureLods[t];
+        if (lod.useOpacity <= 0.f) { lod.unusedTime += dt; continue; }
+        lod.unusedTime = 0.f;
+        if (!g_model.textureIds[t])
+            requestTexture(t, blocking || lod.useOpacity >= kResidencyRequireOpacity);
+    }
+    if (g_lazyTextures) evictUnusedTextures(kResidencyEvictDelay);
+}
+
+static int residentTextureCount() {
+    int n = 0;
+    for (GLuint id : g_model.textureIds) n += id != 0;
+    return n;
+}
+
+// ===================== Model Metadata =====================
+// 加载时把宿主需要的模型信息序列化为一个 blob (格式见 live2d_renderer.h),
+// Kotlin 侧不必再次读取和解析 model3.json
+
+static std::vector<uint8_t> g_modelMetadata;
+
+namespace {
+struct MetaWriter {
+    std::vector<uint8_t>& out;
+    void u32(uint32_t v) { for (int i = 0; i < 4; i++) out.push_back((uint8_t)(v >> (8 * i))); }
+    void i32(int v) { u32((uint32_t)v); }
+    void f32(float f) { uint32_t u; memcpy(&u, &f, 4); u32(u); }
+    void bytes(const void* p, size_t n) {
+        size_t at = out.size();
+        out.resize(at + n);
+        memcpy(out.data() + at, p, n);
+    }
+    void str(const std::string& s) {
+        size_t n = std::min<size_t>(s.size(), 0xFFFF);
+        out.push_back((uint8_t)(n & 0xFF));
+        out.push_back((uint8_t)(n >> 8));
+        out.insert(out.end(), s.begin(), s.begin() + n);
+    }
+    void str(const char* s) { str(std::string(s ? s : "")); }
+};
+}
+
+static void buildModelMetadata(const std::string& json) {
+    g_modelMetadata.clear();
+    MetaWriter w{g_modelMetadata};
+    const char magic[8] = {'L', '2', 'D', 'M', 'I', 'N', 'F', 'O'};
+    w.bytes(magic, sizeof(magic));
+    w.u32(kModelMetadataVersion);
+    w.f32(g_model.canvasWidth);
+    w.f32(g_model.canvasHeight);
+
+    // Motion groups (按组名排序, 与 startMotion 使用的表一致)
+    w.u32((uint32_t)g_motionGroups.size());
+    for (const auto& g : g_motionGroups) {
+        w.str(g.first);
+        w.u32((uint32_t)g.second.size());
+        for (const auto& e : g.second) w.str(e.file);
+    }
+
+    // Expressions: model3.json 中的顺序, 只保留成功加载的
+    std::vector<std::string> exprNames;
+    size_t exprArr = findArrayStart(json, "Expressions");
+    if (exprArr != std::string::npos) {
+        for (const auto& ej : extractObjectArray(json, exprArr)) {
+            size_t np = findKey(ej, "Name");
+            if (np == std::string::npos) continue;
+            std::string name = extractString(ej, np);
+            if (g_expressions.count(name)) exprNames.push_back(name);
+        }
+    }
+    w.u32((uint32_t)exprNames.size());
+    for (const auto& n : exprNames) w.str(n);
+
+    // HitAreas: Id, Name
+    std::vector<std::pair<std::string, std::string>> hitAreas;
+    size_t hitArr = findArrayStart(json, "HitAreas");
+    if (hitArr != std::string::npos) {
+        for (const auto& hj : extractObjectArray(json, hitArr)) {
+            size_t ip = findKey(hj, "Id"), np = findKey(hj, "Name");
+            std::string id = ip != std::string::npos ? extractString(hj, ip) : "";
+            std::string name = np != std::string::npos ? extractString(hj, np) : "";
+            if (!id.empty() || !name.empty()) hitAreas.emplace_back(id, name);
+        }
+    }
+    w.u32((uint32_t)hitAreas.size());
+    for (const auto& h : hitAreas) { w.str(h.first); w.str(h.second); }
+
+    // Groups (LipSync / EyeBlink ...): Target, Name, Ids
+    std::vector<std::string> groupObjs;
+    size_t groupArr = findArrayStart(json, "Groups");
+    if (groupArr != std::string::npos) groupObjs = extractObjectArray(json, groupArr);
+    w.u32((uint32_t)groupObjs.size());
+    for (const auto& gj : groupObjs) {
+        size_t tp = findKey(gj, "Target"), np = findKey(gj, "Name"), ip = findKey(gj, "Ids");
+        w.str(tp != std::string::npos ? extractString(gj, tp) : "");
+        w.str(np != std::string::npos ? extractString(gj, np) : "");
+        std::vector<std::string> ids;
+        if (ip != std::string::npos) ids = extractStringArray(gj, ip);
+        w.u32((uint32_t)ids.size());
+        for (const auto& id : ids) w.str(id);
+    }
+
+    // Parameters: Id, min, max, default (from the moc)
+    int pc = csmGetParameterCount(g_model.model);
+    const char** pids = csmGetParameterIds(g_model.model);
+    const float* pmin = csmGetParameterMinimumValues(g_model.model);
+    const float* pmax = csmGetParameterMaximumValues(g_model.model);
+    const float* pdef = csmGetParameterDefaultValues(g_model.model);
+    w.u32((uint32_t)pc);
+    for (int i = 0; i < pc; i++) { w.str(pids[i]); w.f32(pmin[i]); w.f32(pmax[i]); w.f32(pdef[i]); }
+
+    // Parts: Id, parent part index (-1 = root)
+    int partCount = csmGetPartCount(g_model.model);
+    const char** partIds = csmGetPartIds(g_model.model);
+    const int* partParents = csmGetPartParentPartIndices(g_model.model);
+    w.u32((uint32_t)partCount);
+    for (int i = 0; i < partCount; i++) { w.str(partIds[i]); w.i32(partParents ? partParents[i] : -1); }
+
+    LOGI("Metadata: %zu bytes (%d motion groups, %d expressions, %d hit areas, %d groups, %d params, %d parts)",
+         g_modelMetadata.size(), (int)g_motionGroups.size(), (int)exprNames.size(), (int)hitAreas.size(),
+         (int)groupObjs.size(), pc, partCount);
+}
+
+// ===================== Model Loading =====================
+
+static bool loadModelFromAssets(const std::string& modelPath) {
+    cancelLodDecode();
+    releaseGles3Buffers();
+    if (g_model.loaded) {
+        for (auto t : g_model.textureIds) if (t) deleteTexture(t);
+        if (g_model.modelBuffer) free(g_model.modelBuffer);
+        if (g_model.mocBuffer && !g_model.mocInBundle) free(g_model.mocBuffer);
+        g_model = Live2DModel();
+        g_externalOverrides.clear();
+        g_modelMetadata.clear();
+    }
+    closeBundle();
+
+    // .l2dbundle: 所有文件名相对 model3.json, 主条目即 model3.json
+    std::string model3Path = modelPath;
+    if (isBundlePath(modelPath)) {
+#ifdef __ANDROID__
+        if (!openBundle(g_assetManager, modelPath)) return false;
+#else
+        if (!openBundle(modelPath)) return false;
+#endif
+        model3Path = bundleMainEntry();
+        g_model.modelDir = "";
+    } else {
+        size_t sl = modelPath.find_last_of('/');
+        g_model.modelDir = (sl != std::string::npos) ? modelPath.substr(0, sl + 1) : "";
+    }
+
+    std::string json = readAssetString(model3Path);
+    if (json.empty()) { LOGE("Cannot read %s", model3Path.c_str()); return false; }
+    ModelInfo info = parseModel3Json(json);
+    if (info.mocPath.empty()) { LOGE("No Moc in model3.json"); return false; }
+
+    AssetBytes mocData = loadAsset(g_model.modelDir + info.mocPath);
+    if (mocData.empty()) { LOGE("Cannot read moc3"); return false; }
+    if (mocData.owned.empty() && (uintptr_t)mocData.data % csmAlignofMoc == 0) {
+        // bundle 映射可写且条目已对齐: 原地 revive, 不复制
+        g_model.mocBuffer = (void*)mocData.data;
+        g_model.mocInBundle = true;
+    } else {
+        g_model.mocBuffer = alignedMalloc(mocData.size, csmAlignofMoc);
+        if (!g_model.mocBuffer) return false;
+        memcpy(g_model.mocBuffer, mocData.data, mocData.size);
+    }
+
+    if (!csmHasMocConsistency(g_model.mocBuffer, (unsigned int)mocData.size)) {
+        LOGE("Moc consistency fail");
+        if (!g_model.mocInBundle) free(g_model.mocBuffer);
+        g_model.mocBuffer = nullptr; g_model.mocInBundle = false;
+        return false;
+    }
+    g_model.moc = csmReviveMocInPlace(g_model.mocBuffer, (unsigned int)mocData.size);
+    g_model.mocSize = mocData.size;
+    if (!g_model.moc) { LOGE("Moc revive fail"); return false; }
+    LOGI("Moc revived OK");
+
+    unsigned int msz = csmGetSizeofModel(g_model.moc);
+    g_model.modelBuffer = alignedMalloc(msz, csmAlignofModel);
+    if (!g_model.modelBuffer) return false;
+    g_model.model = csmInitializeModelInPlace(g_model.moc, g_model.modelBuffer, msz);
+    g_model.modelSize = msz;
+    if (!g_model.model) { LOGE("Model init fail"); return false; }
+    LOGI("Model initialized");
+
+    csmVector2 cs, co; float ppu;
+    csmReadCanvasInfo(g_model.model, &cs, &co, &ppu);
+    g_model.canvasWidth = cs.X; g_model.canvasHeight = cs.Y;
+    g_model.canvasOriginX = co.X; g_model.canvasOriginY = co.Y;
+    g_model.pixelsPerUnit = ppu;
+    LOGI("Canvas %.0fx%.0f origin=(%.0f,%.0f) ppu=%.1f", cs.X, cs.Y, co.X, co.Y, ppu);
+
+    int pc = csmGetParameterCount(g_model.model);
+    const char** pids = csmGetParameterIds(g_model.model);
+    for (int i = 0; i < pc; i++) g_model.parameterMap[pids[i]] = i;
+    g_externalOverrides.assign(pc, ParamOverride());
+    LOGI("Parameters: %d", pc);
+
+    g_model.loaded = true;
+    updateProjection();
+
+    // Load idle motion
+    {
+        size_t idlePos = findKey(json, "Idle");
+        if (idlePos != std::string::npos) {
+            size_t filePos = findKey(json, "File", idlePos);
+            if (filePos != std::string::npos) {
+                std::string mf = extractString(json, filePos);
+                if (!mf.empty()) {
+                    std::string mp2 = g_model.modelDir + mf;
+                    if (loadMotion(mp2, g_idleMotion)) {
+                        g_hasIdleMotion = !g_idleMotion.curves.empty();
+                        g_motionTime = 0.f;
+                        g_lastTime = 0.0;
+                        LOGI("Idle motion: %s (%d curves, %.1fs)", mp2.c_str(),
+                             (int)g_idleMotion.curves.size(), g_idleMotion.duration);
+                    }
+                }
+            }
+        }
+        if (!g_hasIdleMotion) LOGI("No idle motion found");
+    }
+
+    // Load all expressions from model3.json
+    g_expressions.clear();
+    g_currentExpressionId.clear();
+    g_expressionFadeWeight = 0.f;
+    g_expressionFadingIn = false;
+    {
+        size_t exprArr = findArrayStart(json, "Expressions");
+        if (exprArr != std::string::npos) {
+            auto exprObjs = extractObjectArray(json, exprArr);
+            for (const auto& ej : exprObjs) {
+                size_t np = findKey(ej, "Name");
+                size_t fp = findKey(ej, "File");
+                if (np == std::string::npos || fp == std::string::npos) continue;
+                std::string ename = extractString(ej, np);
+                std::string efile = extractString(ej, fp);
+                if (ename.empty() || efile.empty()) continue;
+                ExpressionData expr;
+                expr.name = ename;
+                expr.file = g_model.modelDir + efile;
+                if (loadExpression(expr)) g_expressions[ename] = std::move(expr);
+            }
+            LOGI("Expressions loaded: %d", (int)g_expressions.size());
+        }
+    }
+
+    // Load motion group paths from model3.json (for on-demand loading)
+    g_motionGroups.clear();
+    g_hasActiveMotion = false;
+    g_activeMotionPriority = 0;
+    {
+        size_t motionsPos = findKey(json, "Motions");
+        if (motionsPos != std::string::npos) {
+            // Find the opening { of Motions object
+            size_t braceStart = motionsPos;
+            while (braceStart < json.size() && json[braceStart] != '{') braceStart++;
+            if (braceStart < json.size()) {
+                // Find matching }
+                int depth = 0;
+                size_t braceEnd = braceStart;
+                while (braceEnd < json.size()) {
+                    if (json[braceEnd] == '{') depth++;
+                    else if (json[braceEnd] == '}') { depth--; if (depth == 0) break; }
+                    braceEnd++;
+                }
+                std::string motionsObj = json.substr(braceStart, braceEnd - braceStart + 1);
+                // Parse each group: "GroupName": [ { "File": "..." }, ... ]
+                // Scan for keys (group names)
+                size_t scanPos = 1; // skip '{'
+                while (scanPos < motionsObj.size()) {
+                    // Find next key
+                    size_t qStart = motionsObj.find('"', scanPos);
+                    if (qStart == std::string::npos) break;
+                    size_t qEnd = motionsObj.find('"', qStart + 1);
+                    if (qEnd == std::string::npos) break;
+                    std::string groupName = motionsObj.substr(qStart + 1, qEnd - qStart - 1);
+                    // Map empty group name to "Default" for API consistency
+                    if (groupName.empty()) groupName = "Default";
+                    // Find the array for this group
+                    size_t arrStart = motionsObj.find('[', qEnd);
+                    if (arrStart == std::string::npos) break;
+                    auto entries = extractObjectArray(motionsObj, arrStart);
+                    std::vector<MotionEntry> group;
+                    for (const auto& entry : entries) {
+                        size_t fpos = findKey(entry, "File");
+                        if (fpos != std::string::npos) {
+                            std::string file = extractString(entry, fpos);
+                            if (!file.empty()) group.push_back({file});
+                        }
+                    }
+                    if (!group.empty()) {
+                        g_motionGroups[groupName] = group;
+                        LOGI("Motion group '%s': %d entries", groupName.c_str(), (int)group.size());
+                    }
+                    // Skip past the array
+                    size_t arrEnd = arrStart;
+                    int adepth = 0;
+                    while (arrEnd < motionsObj.size()) {
+                        if (motionsObj[arrEnd] == '[') adepth++;
+                        else if (motionsObj[arrEnd] == ']') { adepth--; if (adepth == 0) { arrEnd++; break; } }
+                        arrEnd++;
+                    }
+                    scanPos = arrEnd;
+                }
+            }
+        }
+    }
+
+    // Load physics
+    {
+        size_t physPos = findKey(json, "Physics");
+        if (physPos != std::string::npos) {
+            std::string physFile = extractString(json, physPos);
+            if (!physFile.empty()) {
+                std::string pp = g_model.modelDir + physFile;
+                std::string pj = readAssetString(pp);
+                if (!pj.empty()) {
+                    parsePhysics3Json(pj);
+                    initPhysics();
+                    LOGI("Physics loaded: %s (%d settings)", pp.c_str(), (int)g_physics.settings.size());
+                }
+            }
+        }
+        if (!g_physics.loaded) LOGI("No physics found");
+    }
+
+    // Load pose (mutually exclusive parts)
+    g_poseGroups.clear();
+    g_hasPose = false;
+    {
+        size_t posePos = findKey(json, "Pose");
+        if (posePos != std::string::npos) {
+            std::string poseFile = extractString(json, posePos);
+            if (!poseFile.empty()) {
+                std::string pp = g_model.modelDir + poseFile;
+                std::string pj = readAssetString(pp);
+                if (!pj.empty()) {
+                    parsePose3Json(pj);
+                    if (g_hasPose) {
+                        initPosePartIndices();
+                        LOGI("Pose initialized: %s", pp.c_str());
+                    }
+                }
+            }
+        }
+        if (!g_hasPose) LOGI("No pose found");
+    }
+
+    // Textures: 姿势与部件不透明度就绪后, 只解码默认姿态下用得到的图集
+    csmUpdateModel(g_model.model);
+    LOGI("Loading %d textures...", (int)info.texturePaths.size());
+    std::vector<std::string> texturePaths;
+    for (size_t ti2 = 0; ti2 < info.texturePaths.size(); ti2++) {
+        texturePaths.push_back(g_model.modelDir + info.texturePaths[ti2]);
+        LOGI("Texture[%d]: %s", (int)ti2, texturePaths.back().c_str());
+    }
+    std::vector<char> needed = initialTextureUse(texturePaths.size());
+    loadTextures(texturePaths, needed, g_model.textureIds, g_model.textureLods);
+    for (size_t ti2 = 0; ti2 < g_model.textureIds.size(); ti2++)
+        if (needed[ti2] && g_model.textureIds[ti2] == 0) LOGE("Texture[%d] FAILED!", (int)ti2);
+    LOGI("Textures loaded: %d of %d", residentTextureCount(), (int)g_model.textureIds.size());
+    measureTextureDensity();
+
+    // Log vertex range
+    {
+        int dc = csmGetDrawableCount(g_model.model);
+        const int* dvc = csmGetDrawableVertexCounts(g_model.model);
+        const csmVector2** dvp = csmGetDrawableVertexPositions(g_model.model);
+        float minX = 1e9, maxX = -1e9, minY = 1e9, maxY = -1e9;
+        int totalVerts = 0;
+        for (int d = 0; d < dc; d++) {
+            for (int v = 0; v < dvc[d]; v++) {
+                float x = dvp[d][v].X, y = dvp[d][v].Y;
+                if (x < minX) minX = x; if (x > maxX) maxX = x;
+                if (y < minY) minY = y; if (y > maxY) maxY = y;
+            }
+            totalVerts += dvc[d];
+        }
+        LOGI("Drawables=%d Verts=%d X[%.3f..%.3f] Y[%.3f..%.3f]",
+             dc, totalVerts, minX, maxX, minY, maxY);
+    }
+
+    buildModelMetadata(json);
+    prepareDrawPrograms();
+
+    LOGI("Model ready!");
+    return true;
+}
+
+// ===================== Draw Pipelines =====================
+// GLES 没有管线对象: 每个 drawable 都重设混合与剔除、重新绑定纹理, 值没变驱动也要重新校验。
+// drawable 用到的固定功能状态只有几种组合, 列成一张管线表 (混合模式 x 单/双面, 加上遮罩写入),
+// drawModel 里只在管线或纹理绑定真正变化时下发。drawModel 之外 (合成, 翻页播放, 纹理上传)
+// 也会改这些状态, 所以缓存只在一次 drawModel 内有效, 开始时作废。
+
+enum DrawBlend { kBlendNormal, kBlendAdditive, kBlendMultiply, kBlendMask, kDrawBlends };
+
+struct DrawPipeline {
+    GLenum srcRGB, dstRGB, srcAlpha, dstAlpha;
+};
+
+static const DrawPipeline kDrawBlendStates[kDrawBlends] = {
+    {GL_ONE,       GL_ONE_MINUS_SRC_ALPHA, GL_ONE,  GL_ONE_MINUS_SRC_ALPHA},
+    {GL_ONE,       GL_ONE,                 GL_ZERO, GL_ONE},
+    {GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE},
+    {GL_ONE,       GL_ONE,                 GL_ONE,  GL_ONE},   // 遮罩累加 (遮罩纹理)
+};
+
+// 管线编号 = 混合模式 * 2 + 单面剔除
+static int drawPipeline(DrawBlend blend, bool cullBack) { return blend * 2 + (cullBack ? 1 : 0); }
+
+struct DrawStateCache {
+    int    pipeline = -1;
+    int    activeUnit = -1;
+    GLuint textures[2] = {~0u, ~0u};   // 纹理单元 0 (drawable), 1 (遮罩纹理)
+};
+static DrawStateCache g_drawState;
+
+static void bindPipeline(int pipeline) {
+    DrawStateCache& ds = g_drawState;
+    if (ds.pipeline == pipeline) return;
+    bool cull = pipeline & 1;
+    if (ds.pipeline < 0 || (ds.pipeline & 1) != (pipeline & 1)) {
+        if (cull) { g_gl->Enable(GL_CULL_FACE); g_gl->CullFace(GL_BACK); }
+        else g_gl->Disable(GL_CULL_FACE);
+    }
+    if (ds.pipeline < 0 || ds.pipeline / 2 != pipeline / 2) {
+        const DrawPipeline& p = kDrawBlendStates[pipeline / 2];
+        g_gl->BlendFuncSeparate(p.srcRGB, p.dstRGB, p.srcAlpha, p.dstAlpha);
+    }
+    ds.pipeline = pipeline;
+}
+
+static void bindTextureUnit(int unit, GLuint texture) {
+    DrawStateCache& ds = g_drawState;
+    if (ds.textures[unit] == texture) return;
+    if (ds.activeUnit != unit) {
+        g_gl->ActiveTexture(GL_TEXTURE0 + unit);
+        ds.activeUnit = unit;
+    }
+    g_gl->BindTexture(GL_TEXTURE_2D, texture);
+    ds.textures[unit] = texture;
+}
+
+// ===================== Rendering =====================
+// 参照官方 SDK CubismRenderer_OpenGLES2.cpp:
+// - PreDraw: disable scissor/stencil/depth, enable blend, colorMask all
+// - g_gl->FrontFace(GL_CCW)
+// - Per-drawable: culling based on csmIsDoubleSided, blend mode (Draw Pipelines), draw
+// - Clipping mask: FBO-based alpha mask for masked drawables
+
+struct DSortInfo { int index; int order; };
+
+static FrameStats g_frameStats;
+static FrameArena g_frameArena;   // per-frame scratch, rewound in drawFrame()
+
+// 动画 / 物理 / 姿势 -> csmUpdateModel
+static void updateModel(float dt) {
+    if (!g_model.loaded || !g_initialized) return;
+
+    FrameStats& st = g_frameStats;
+    double tStart = getCurrentTime();
+
+    // ---- Animation: set parameters before csmUpdateModel ----
+    float* paramValues = csmGetParameterValues(g_model.model);
+    const float* paramDefaults = csmGetParameterDefaultValues(g_model.model);
+    const float* paramMins = csmGetParameterMinimumValues(g_model.model);
+    const float* paramMaxs = csmGetParameterMaximumValues(g_model.model);
+    int paramCount = csmGetParameterCount(g_model.model);
+
+    // Reset to defaults
+    for (int p = 0; p < paramCount; p++) paramValues[p] = paramDefaults[p];
+
+    // Apply idle motion
+    if (g_hasIdleMotion) {
+        g_motionTime += dt;
+        if (g_idleMotion.loop && g_motionTime >= g_idleMotion.duration)
+            g_motionTime = fmodf(g_motionTime, g_idleMotion.duration);
+        for (const auto& curve : g_idleMotion.curves) {
+            auto it = g_model.parameterMap.find(curve.paramId);
+            if (it != g_model.parameterMap.end()) {
+                int pidx = it->second;
+                paramValues[pidx] = std::clamp(evaluateMotionCurve(curve, g_motionTime),
+                                               paramMins[pidx], paramMaxs[pidx]);
+            }
+        }
+    }
+
+    // Apply active (non-idle) motion with fade in/out, overriding idle
+    if (g_hasActiveMotion) {
+        g_activeMotionTime += dt;
+
+        // Calculate fade weight
+        float motionWeight = 1.0f;
+        float fadeIn = g_activeMotion.fadeInTime;
+        float fadeOut = g_activeMotion.fadeOutTime;
+        float dur = g_activeMotion.duration;
+
+        if (g_activeMotionTime < fadeIn && fadeIn > 0.001f) {
+            motionWeight = g_activeMotionTime / fadeIn;
+        } else if (!g_activeMotion.loop && g_activeMotionTime > dur - fadeOut && fadeOut > 0.001f) {
+            motionWeight = (dur - g_activeMotionTime) / fadeOut;
+            if (motionWeight < 0.f) motionWeight = 0.f;
+        }
+
+        // Check if motion finished
+        if (!g_activeMotion.loop && g_activeMotionTime >= dur) {
+            g_hasActiveMotion = false;
+            g_activeMotionPriority = 0;
+            LOGI("Active motion finished");
+        } else {
+            // Apply active motion curves, blending over idle with motionWeight
+            for (const auto& curve : g_activeMotion.curves) {
+                auto it = g_model.parameterMap.find(curve.paramId);
+                if (it != g_model.parameterMap.end()) {
+                    int pidx = it->second;
+                    float motionVal = evaluateMotionCurve(curve, g_activeMotionTime);
+                    motionVal = std::clamp(motionVal, paramMins[pidx], paramMaxs[pidx]);
+                    // Blend: lerp between current (idle) value and motion value
+                    paramValues[pidx] = paramValues[pidx] * (1.f - motionWeight) + motionVal * motionWeight;
+                }
+            }
+        }
+    }
+
+    // Apply expression with smooth fade
+    if (!g_currentExpressionId.empty()) {
+        auto eit = g_expressions.find(g_currentExpressionId);
+        if (eit != g_expressions.end()) {
+            // Update fade weight
+            if (g_expressionFadingIn) {
+                g_expressionFadeWeight += dt * g_expressionFadeSpeed;
+                if (g_expressionFadeWeight >= 1.f) g_expressionFadeWeight = 1.f;
+            } else {
+                g_expressionFadeWeight -= dt * g_expressionFadeSpeed;
+                if (g_expressionFadeWeight <= 0.f) {
+                    g_expressionFadeWeight = 0.f;
+                    g_currentExpressionId.clear();
+                }
+            }
+
+            float w = g_expressionFadeWeight;
+            if (w > 0.001f) {
+                for (const auto& ep : eit->second.params) {
+                    auto pit = g_model.parameterMap.find(ep.paramId);
+                    if (pit == g_model.parameterMap.end()) continue;
+                    int pidx = pit->second;
+                    switch (ep.blend) {
+                        case ExprBlend::Add:
+                            paramValues[pidx] += ep.value * w;
+                            break;
+                        case ExprBlend::Multiply:
+                            paramValues[pidx] *= (1.0f + (ep.value - 1.0f) * w);
+                            break;
+                        case ExprBlend::Overwrite:
+                            paramValues[pidx] = paramValues[pidx] * (1.f - w) + ep.value * w;
+                            break;
+                    }
+                    paramValues[pidx] = std::clamp(paramValues[pidx], paramMins[pidx], paramMaxs[pidx]);
+                }
+            }
+        }
+    }
+
+    double tAnim = getCurrentTime();
+    st.animationMs = (tAnim - tStart) * 1000.0;
+
+    // Apply physics simulation (reads motion params as input, writes physics output params)
+    updatePhysics(dt);
+
+    // Apply external overrides (lip sync, Kotlin-side param changes)
+    int ovCount = std::min(paramCount, (int)g_externalOverrides.size());
+    for (int pidx = 0; pidx < ovCount; pidx++) {
+        const ParamOverride& ov = g_externalOverrides[pidx];
+        if (!ov.active) continue;
+        if (ov.weight >= 1.f) paramValues[pidx] = ov.value;
+        else paramValues[pidx] = paramValues[pidx] * (1.f - ov.weight) + ov.value * ov.weight;
+    }
+
+    // Apply pose — manage mutually exclusive part opacities
+    updatePose(dt);
+
+    double tPhys = getCurrentTime();
+    st.physicsMs = (tPhys - tAnim) * 1000.0;
+
+    csmUpdateModel(g_model.model);
+
+    double tCore = getCurrentTime();
+    st.coreMs = (tCore - tPhys) * 1000.0;
+}
+
+// 把 csmUpdateModel 的结果画到当前渲染目标
+static void drawModel() {
+    if (!g_model.loaded || !g_initialized) return;
+
+    FrameStats& st = g_frameStats;
+    double tCore = getCurrentTime();
+
+    // ---- Get drawable data ----
+    int dc = csmGetDrawableCount(g_model.model);
+    const int*    ro   = csmGetDrawableRenderOrders(g_model.model);
+    const csmFlags* df = csmGetDrawableDynamicFlags(g_model.model);
+    const csmFlags* cf = csmGetDrawableConstantFlags(g_model.model);
+    const int*    ti   = csmGetDrawableTextureIndices(g_model.model);
+    const float*  op   = csmGetDrawableOpacities(g_model.model);
+    const int*    vc   = csmGetDrawableVertexCounts(g_model.model);
+    const csmVector2** vp = csmGetDrawableVertexPositions(g_model.model);
+    const csmVector2** vu = csmGetDrawableVertexUvs(g_model.model);
+    const int*    ic   = csmGetDrawableIndexCounts(g_model.model);
+    const unsigned short** idx = csmGetDrawableIndices(g_model.model);
+    const csmVector4* mc = csmGetDrawableMultiplyColors(g_model.model);
+    const csmVector4* sc = csmGetDrawableScreenColors(g_model.model);
+    const int*    maskCounts = csmGetDrawableMaskCounts(g_model.model);
+    const int**   masks      = csmGetDrawableMasks(g_model.model);
+
+    // Sort by render order
+    DSortInfo* sorted = g_frameArena.alloc<DSortInfo>(dc);
+    if (!sorted) return;
+    for (int i = 0; i < dc; i++) sorted[i] = {i, ro[i]};
+    std::sort(sorted, sorted + dc,
+              [](const DSortInfo& a, const DSortInfo& b){ return a.order < b.order; });
+
+    // 模板裁剪要求渲染目标带模板缓冲, 否则 (或遮罩程序构建失败) 用遮罩纹理
+    const MaskShaderInfo* stencilMask = g_renderStencil && stencilClippingWanted() ? stencilMaskProgram() : nullptr;
+    bool stencilClip = stencilMask != nullptr;
+    g_stencilClipFrame = stencilClip;
+
+    // Ensure mask FBO exists
+    // 大于窗口的截图目标临时需要更大的遮罩纹理 (下一帧换回窗口尺寸)
+    if (!stencilClip && g_viewWidth > 0 && g_viewHeight > 0 && g_maskShader.program)
+        ensureMaskFBO(std::max(g_viewWidth, g_renderW), std::max(g_viewHeight, g_renderH));
+
+    auto drawn = [&](int i) {
+        if (!(df[i] & csmIsVisible)) return false;
+        if (op[i] <= 0.001f || vc[i] == 0 || ic[i] == 0) return false;
+        int t = ti[i];
+        return t >= 0 && t < (int)g_model.textureIds.size() && g_model.textureIds[t] != 0;
+    };
+
+    // ---- Screen bounds (离屏时顺带按范围清除) ----
+    updateDrawableBounds(dc, df, vc, vp);
+    DrawableBounds frameBounds;
+    bool anyDrawn = false;
+    for (int i = 0; i < dc; i++) {
+        if (!drawn(i)) continue;
+        uniteBounds(frameBounds, g_model.drawableBounds[i], !anyDrawn);
+        anyDrawn = true;
+    }
+    setFrameBounds(frameBounds, anyDrawn);
+
+    // ---- PreDraw (官方 SDK 参考) ----
+    g_gl->Disable(GL_SCISSOR_TEST);
+    g_gl->Disable(GL_STENCIL_TEST);
+    g_gl->Disable(GL_DEPTH_TEST);
+    g_gl->Enable(GL_BLEND);
+    g_gl->FrontFace(GL_CCW);
+    g_gl->ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    g_gl->BindBuffer(GL_ARRAY_BUFFER, 0);
+    g_gl->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    g_drawState = DrawStateCache();
+
+    if (g_gles3) {
+        ensureGles3Buffers(dc, vc, vu, ic, idx);
+        uploadGles3Frame(dc, df, vc, vp, op, mc, sc);
+    }
+
+    // ---- Draw each drawable ----
+    GLuint currentProgram = 0;
+    bool maskUsed = false;
+    // 模板: 每个被遮罩 drawable 用新的参考值写入和测试, 前面遮罩留下的值不用逐个清除;
+    // 本帧第一次用到时整体清零, 参考值用完 (255) 再清一次
+    bool stencilTest = false;
+    int  stencilRef = 256;
+    for (int si = 0; si < dc; si++) {
+        int i = sorted[si].index;
+
+        if (!drawn(i)) continue;
+        int tIdx = ti[i];
+
+        // ---- Viewport culling: 包围盒投影后完全在渲染目标外则不提交 ----
+        PixelRect rect = projectBounds(g_model.drawableBounds[i], g_renderW, g_renderH, kBoundsPad);
+        if (rect.empty()) { st.culledDraws++; continue; }
+
+        bool hasMask = (maskCounts && maskCounts[i] > 0 && masks && masks[i] != nullptr
+                        && (stencilClip || (g_maskFBO != 0 && g_maskShader.program != 0)));
+
+        // 遮罩来源只有落在被遮罩 drawable 范围内才有作用; 一个都没有时遮罩全空, drawable 不可见
+        auto maskInRect = [&](int mi) {
+            if (mi < 0 || mi >= dc || vc[mi] == 0 || ic[mi] == 0) return false;
+            int mt = ti[mi];
+            if (mt < 0 || mt >= (int)g_model.textureIds.size() || g_model.textureIds[mt] == 0) return false;
+            return rectsOverlap(projectBounds(g_model.drawableBounds[mi], g_renderW, g_renderH, kBoundsPad), rect);
+        };
+        // 反转遮罩则相反: 遮罩全空时整个 drawable 可见, 不需要遮罩
+        if (hasMask) {
+            bool anyMask = false;
+            for (int m = 0; m < maskCounts[i] && !anyMask; m++) anyMask = maskInRect(masks[i][m]);
+            if (!anyMask) {
+                if (!(cf[i] & csmIsInvertedMask)) { st.culledDraws++; continue; }
+                hasMask = false;
+            }
+        }
+
+        int perm = colorPermutation(mc, sc, i);
+        if (g_model.textureLods[tIdx].premultiplied) perm |= kPermPremultiplied;
+        if (hasMask && !stencilClip) perm |= kPermMasked | ((cf[i] & csmIsInvertedMask) ? kPermInvertedMask : 0);
+        const ShaderInfo* sh = drawProgram(perm);
+        if (!sh) continue;
+
+        // ---- Render clipping mask to FBO (or the stencil buffer) if needed ----
+        // 只有被遮罩 drawable 覆盖的像素会采样遮罩, 清除与绘制都裁剪到它的范围
+        if (hasMask && stencilClip) {
+            if (!stencilTest) { g_gl->Enable(GL_STENCIL_TEST); stencilTest = true; }
+            if (++stencilRef > 255) {
+                g_gl->Clear(GL_STENCIL_BUFFER_BIT);
+                stencilRef = 1;
+            }
+            g_gl->Enable(GL_SCISSOR_TEST);
+            scissorRect(rect);
+            g_gl->ColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            g_gl->StencilFunc(GL_ALWAYS, stencilRef, 0xFF);
+            g_gl->StencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+        } else if (hasMask) {
+            g_gl->BindFramebuffer(GL_FRAMEBUFFER, g_maskFBO);
+            g_gl->Viewport(0, 0, g_renderW, g_renderH);
+            g_gl->Enable(GL_SCISSOR_TEST);
+            scissorRect(rect);
+            g_gl->ClearColor(0, 0, 0, 0);
+            g_gl->Clear(GL_COLOR_BUFFER_BIT);
+        }
+        if (hasMask) {
+            const MaskShaderInfo& ms = stencilClip ? *stencilMask : g_maskShader;
+            st.maskPasses++;
+            bindPipeline(drawPipeline(kBlendMask, false));   // additive for mask (模板路径不写颜色)
+
+            g_gl->UseProgram(ms.program);
+            if (!g_gles3) {
+                g_gl->EnableVertexAttribArray(ms.a_position);
+                g_gl->EnableVertexAttribArray(ms.a_texCoord);
+                g_gl->UniformMatrix4fv(ms.u_matrix, 1, GL_FALSE, g_projMatrix);
+                g_gl->Uniform1i(ms.u_texture, 0);
+            }
+
+            for (int m = 0; m < maskCounts[i]; m++) {
+                int mi = masks[i][m];
+                if (!maskInRect(mi)) { st.culledDraws++; continue; }
+                int mtIdx = ti[mi];
+
+                bindTextureUnit(0, g_model.textureIds[mtIdx]);
+                if (g_gles3) {
+                    drawGles3(mi, ic[mi]);
+                } else {
+                    g_gl->Uniform1f(ms.u_opacity, op[mi]);
+                    g_gl->VertexAttribPointer(ms.a_position, 2, GL_FLOAT, GL_FALSE, 0, vp[mi]);
+                    g_gl->VertexAttribPointer(ms.a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, vu[mi]);
+                    g_gl->DrawElements(GL_TRIANGLES, ic[mi], GL_UNSIGNED_SHORT, idx[mi]);
+                }
+                st.maskDraws++;
+            }
+
+            if (!g_gles3) {
+                g_gl->DisableVertexAttribArray(ms.a_position);
+                g_gl->DisableVertexAttribArray(ms.a_texCoord);
+            }
+            g_gl->Disable(GL_SCISSOR_TEST);
+            currentProgram = 0;
+
+            if (stencilClip) {
+                // 反转遮罩: 参考值以外可见
+                g_gl->ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                g_gl->StencilFunc((cf[i] & csmIsInvertedMask) ? GL_NOTEQUAL : GL_EQUAL, stencilRef, 0xFF);
+                g_gl->StencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+            } else {
+                maskUsed = true;
+                // Restore the model's render target
+                g_gl->BindFramebuffer(GL_FRAMEBUFFER, g_renderFBO);
+                g_gl->Viewport(0, 0, g_renderW, g_renderH);
+            }
+        } else if (stencilTest) {
+            g_gl->Disable(GL_STENCIL_TEST);
+            stencilTest = false;
+        }
+
+        // ---- Draw the actual drawable ----
+        // Per-drawable culling + blend mode
+        DrawBlend blend = (cf[i] & csmBlendAdditive) ? kBlendAdditive
+                        : (cf[i] & csmBlendMultiplicative) ? kBlendMultiply : kBlendNormal;
+        bindPipeline(drawPipeline(blend, !(cf[i] & csmIsDoubleSided)));
+
+        // 连续使用同一变体时不重复切换程序和设置不变的 uniform (GLES3 的 uniform 都在 UBO 里)
+        if (sh->program != currentProgram) {
+            g_gl->UseProgram(sh->program);
+            if (!g_gles3) {
+                g_gl->UniformMatrix4fv(sh->u_matrix, 1, GL_FALSE, g_projMatrix);
+                g_gl->Uniform1i(sh->u_texture, 0);
+            }
+            if ((perm & kPermMasked) && !g_gles3) {
+                g_gl->Uniform1i(sh->u_mask, 1);
+                g_gl->Uniform2f(sh->u_viewportSize, (float)g_maskW, (float)g_maskH);  // 遮罩纹理尺寸
+            }
+            currentProgram = sh->program;
+            st.programSwitches++;
+        }
+        if (perm & kPermMasked) bindTextureUnit(1, g_maskTexture);
+        bindTextureUnit(0, g_model.textureIds[tIdx]);
+
+        if (g_gles3) {
+            drawGles3(i, ic[i]);
+            st.drawCalls++;
+            continue;
+        }
+
+        g_gl->Uniform1f(sh->u_opacity, op[i]);
+        if (perm & kPermMultiply) g_gl->Uniform4f(sh->u_multiplyColor, mc[i].X, mc[i].Y, mc[i].Z, mc[i].W);
+        if (perm & kPermScreen)   g_gl->Uniform4f(sh->u_screenColor, sc[i].X, sc[i].Y, sc[i].Z, sc[i].W);
+
+        g_gl->EnableVertexAttribArray(sh->a_position);
+        g_gl->EnableVertexAttribArray(sh->a_texCoord);
+        g_gl->VertexAttribPointer(sh->a_position, 2, GL_FLOAT, GL_FALSE, 0, vp[i]);
+        g_gl->VertexAttribPointer(sh->a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, vu[i]);
+        g_gl->DrawElements(GL_TRIANGLES, ic[i], GL_UNSIGNED_SHORT, idx[i]);
+        st.drawCalls++;
+
+        g_gl->DisableVertexAttribArray(sh->a_position);
+        g_gl->DisableVertexAttribArray(sh->a_texCoord);
+    }
+
+    // ---- Cleanup ----
+    g_gl->Disable(GL_BLEND);
+    g_gl->Disable(GL_CULL_FACE);
+    if (stencilTest) g_gl->Disable(GL_STENCIL_TEST);
+    if (g_drawState.activeUnit > 0) g_gl->ActiveTexture(GL_TEXTURE0);
+    if (g_gles3) {
+        g_gl->BindVertexArray(0);   // 合成 / 翻页播放仍用默认 VAO 上的客户端数组
+        if (maskUsed) invalidateMaskTarget();
+    }
+
+    csmResetDrawableDynamicFlags(g_model.model);
+
+    double tEnd = getCurrentTime();
+    st.drawMs  = (tEnd - tCore) * 1000.0;
+    st.totalMs = st.animationMs + st.physicsMs + st.coreMs + st.drawMs;
+}
+
+static void renderModel(float dt) {
+    updateModel(dt);
+    updateTextureResidency(dt, false);
+    drawModel();
+}
+
+// csmGetDrawable* -> RasterDrawable (CPU 光栅化与 Vulkan 的输入), out 为 drawable 数个元素
+static void fillRasterDrawables(csmModel* model, RasterDrawable* out) {
+    int dc = csmGetDrawableCount(model);
+    const csmFlags* cf = csmGetDrawableConstantFlags(model);
+    const int*    ti   = csmGetDrawableTextureIndices(model);
+    const float*  op   = csmGetDrawableOpacities(model);
+    const int*    vc   = csmGetDrawableVertexCounts(model);
+    const csmVector2** vp = csmGetDrawableVertexPositions(model);
+    const csmVector2** vu = csmGetDrawableVertexUvs(model);
+    const int*    ic   = csmGetDrawableIndexCounts(model);
+    const unsigned short** idx = csmGetDrawableIndices(model);
+    const csmVector4* mc = csmGetDrawableMultiplyColors(model);
+    const csmVector4* sc = csmGetDrawableScreenColors(model);
+    const int*    maskCounts = csmGetDrawableMaskCounts(model);
+    const int**   masks      = csmGetDrawableMasks(model);
+
+    for (int i = 0; i < dc; i++) {
+        RasterDrawable& d = out[i];
+        d = RasterDrawable();
+        d.positions   = (const float*)vp[i];
+        d.uvs         = (const float*)vu[i];
+        d.indices     = idx[i];
+        d.vertexCount = vc[i];
+        d.indexCount  = ic[i];
+        d.texture     = ti[i];
+        d.opacity     = op[i];
+        d.blend = (cf[i] & csmBlendAdditive) ? RasterBlend::Additive
+                : (cf[i] & csmBlendMultiplicative) ? RasterBlend::Multiply : RasterBlend::Normal;
+        d.doubleSided = (cf[i] & csmIsDoubleSided) != 0;
+        if (mc) { d.multiply[0] = mc[i].X; d.multiply[1] = mc[i].Y; d.multiply[2] = mc[i].Z; }
+        if (sc) { d.screen[0] = sc[i].X; d.screen[1] = sc[i].Y; d.screen[2] = sc[i].Z; }
+        if (maskCounts && masks && maskCounts[i] > 0) { d.masks = masks[i]; d.maskCount = maskCounts[i]; }
+        d.invertedMask = (cf[i] & csmIsInvertedMask) != 0;
+    }
+}
+
+// ===================== Idle Flipbook =====================
+// 省电待机: 只剩循环 idle 动作 (无其他动作 / 表情, 外部参数、变换、视口都不变) 持续
+// 一段时间后, 把 idle 的一个循环按固定帧数离屏渲染进纹理图集, 之后每帧只画一个四边形,
+// 不再跑动画 / 物理 / csmUpdateModel / 逐 drawable 绘制。任何输入变化立即丢弃图集回到实时渲染。
+// - 单元格大小 = 静止期间累计的模型屏幕范围 x scale; 静止期至少一个循环, 所以范围覆盖整个循环
+// - 烘焙在一帧内同步完成, 物理以不超过 1/60 s 的子步推进; 走完一个循环后动作回到起点相位
+// - 图集是未压缩 RGBA8: 预乘 alpha 的图集需要带 alpha 的格式, GLES2 只保证 ETC1 (无 alpha),
+//   设备上现编码的开销也与省电目的相悖
+
+static const float kFlipbookIdleDelay   = 3.f;          // 秒; 实际取 max(此值, idle 循环长度)
+static const int   kFlipbookMaxAtlas    = 2048;
+static const float kFlipbookSubstep     = 1.f / 60.f;
+static const float kFlipbookOverrideEps = 1e-3f;        // 视线缓动的尾巴不算变化
+static const float kFlipbookMargin      = 0.02f;        // 范围外扩 (相对尺寸), 吸收物理的循环间差异
+
+struct IdleFlipbook {
+    bool  enabled = false;
+    int   frames  = 32;
+    float scale   = 0.5f;
+
+    // 静止检测: 上次变化时的输入快照
+    float quietTime = 0.f;
+    int   viewW = 0, viewH = 0;
+    float projMatrix[16] = {};
+    std::vector<ParamOverride> overrides;
+    DrawableBounds loopBounds;               // 静止期间绘制范围的并集
+    bool  hasBounds = false;
+
+    // 图集
+    GLuint atlasFBO = 0, atlasTexture = 0;
+    int   atlasW = 0, atlasH = 0, cols = 1, cellW = 0, cellH = 0;
+    PixelRect windowRect;                    // 播放时写入的窗口区域
+    float startTime = 0.f;                   // 烘焙开始时的 g_motionTime; 第 k 格相位为 (k + 1) * step
+    float step = 0.f;
+};
+static IdleFlipbook g_flipbook;
+
+static void releaseFlipbook() {
+    IdleFlipbook& fb = g_flipbook;
+    if (fb.atlasFBO) g_gl->DeleteFramebuffers(1, &fb.atlasFBO);
+    if (fb.atlasTexture) g_gl->DeleteTextures(1, &fb.atlasTexture);
+    fb.atlasFBO = fb.atlasTexture = 0;
+    fb.atlasW = fb.atlasH = 0;
+    fb.quietTime = 0.f;
+    fb.hasBounds = false;
+}
+
+static bool flipbookEligible() {
+    return g_hasIdleMotion && g_idleMotion.loop && g_idleMotion.duration > 0.f
+        && !g_hasActiveMotion && g_currentExpressionId.empty();
+}
+
+// 与快照比较视口、投影 (用户缩放 / 平移) 与外部参数; 有变化则更新快照
+static bool flipbookInputsChanged() {
+    IdleFlipbook& fb = g_flipbook;
+    bool changed = fb.viewW != g_viewWidth || fb.viewH != g_viewHeight
+                || memcmp(fb.projMatrix, g_projMatrix, sizeof(g_projMatrix)) != 0
+                || fb.overrides.size() != g_externalOverrides.size();
+    for (size_t i = 0; !changed && i < g_externalOverrides.size(); i++) {
+        const ParamOverride& a = fb.overrides[i];
+        const ParamOverride& b = g_externalOverrides[i];
+        changed = a.active != b.active || fabsf(a.value - b.value) > kFlipbookOverrideEps
+               || fabsf(a.weight - b.weight) > kFlipbookOverrideEps;
+    }
+    if (changed) {
+        fb.viewW = g_viewWidth; fb.viewH = g_viewHeight;
+        memcpy(fb.projMatrix, g_projMatrix, sizeof(g_projMatrix));
+        fb.overrides = g_externalOverrides;
+    }
+    return changed;
+}
+
+static void bakeFlipbook() {
+    IdleFlipbook& fb = g_flipbook;
+    double tStart = getCurrentTime();
+    if (!g_compositeShader.program) initCompositeShader();
+    if (!g_compositeShader.program || g_viewWidth <= 0 || g_viewHeight <= 0) return;
+
+    DrawableBounds lb = fb.loopBounds;
+    float mx = (lb.maxX - lb.minX) * kFlipbookMargin, my = (lb.maxY - lb.minY) * kFlipbookMargin;
+    lb.minX -= mx; lb.maxX += mx; lb.minY -= my; lb.maxY += my;
+    PixelRect wr = projectBounds(lb, g_viewWidth, g_viewHeight, kBoundsPad);
+    if (wr.empty()) return;
+
+    // 单元格尺寸; 放不进最大图集时继续缩小
+    int ww = wr.x1 - wr.x0, wh = wr.y1 - wr.y0;
+    float scale = fb.scale;
+    int cw, ch, cols, rows;
+    for (;;) {
+        cw = std::max(1, (int)(ww * scale + 0.5f));
+        ch = std::max(1, (int)(wh * scale + 0.5f));
+        cols = std::min(fb.frames, std::max(1, kFlipbookMaxAtlas / cw));
+        rows = (fb.frames + cols - 1) / cols;
+        if (cw <= kFlipbookMaxAtlas && rows * ch <= kFlipbookMaxAtlas) break;
+        scale *= 0.85f;
+    }
+
+    createRenderTarget(cols * cw, rows * ch, fb.atlasFBO, fb.atlasTexture, "Flipbook atlas");
+    GLuint bakeFBO = 0, bakeTexture = 0, bakeStencil = 0;
+    bool bakeWithStencil = stencilClippingWanted();
+    createRenderTarget(cw, ch, bakeFBO, bakeTexture, "Flipbook bake", bakeWithStencil ? &bakeStencil : nullptr);
+
+    // 投影: 窗口中 wr 对应的 NDC 范围 -> 单元格的 [-1, 1]
+    float proj[16];
+    memcpy(proj, g_projMatrix, sizeof(proj));
+    float nx0 = 2.f * wr.x0 / g_viewWidth - 1.f,  nx1 = 2.f * wr.x1 / g_viewWidth - 1.f;
+    float ny0 = 2.f * wr.y0 / g_viewHeight - 1.f, ny1 = 2.f * wr.y1 / g_viewHeight - 1.f;
+    float sx = 2.f / (nx1 - nx0), sy = 2.f / (ny1 - ny0);
+    float cellProj[16];
+    memcpy(cellProj, proj, sizeof(cellProj));
+    cellProj[0]  = proj[0] * sx;  cellProj[12] = (proj[12] - nx0) * sx - 1.f;
+    cellProj[5]  = proj[5] * sy;  cellProj[13] = (proj[13] - ny0) * sy - 1.f;
+
+    GLuint savedFBO = g_renderFBO;
+    int savedW = g_renderW, savedH = g_renderH;
+    bool savedStencil = g_renderStencil;
+    float step = g_idleMotion.duration / fb.frames;
+    int substeps = std::max(1, (int)ceilf(step / kFlipbookSubstep - 0.001f));
+    fb.startTime = g_motionTime;
+
+    for (int k = 0; k < fb.frames; k++) {
+        for (int s = 0; s < substeps; s++) updateModel(step / substeps);
+        g_model.boundsStale = true;   // 子步之间的顶点变化标志不一定累计, 包围盒全部重算
+        updateTextureResidency(step, true);
+
+        memcpy(g_projMatrix, cellProj, sizeof(cellProj));
+        g_renderFBO = bakeFBO; g_renderW = cw; g_renderH = ch;
+        g_renderStencil = bakeStencil != 0;
+        g_gl->BindFramebuffer(GL_FRAMEBUFFER, bakeFBO);
+        g_gl->Viewport(0, 0, cw, ch);
+        drawModel();
+        memcpy(g_projMatrix, proj, sizeof(proj));
+
+        g_gl->BindFramebuffer(GL_FRAMEBUFFER, fb.atlasFBO);
+        g_gl->Viewport((k % cols) * cw, (k / cols) * ch, cw, ch);
+        drawCompositeQuad(bakeTexture, 0.f, 0.f, 1.f, 1.f);
+    }
+
+    g_gl->DeleteFramebuffers(1, &bakeFBO);
+    g_gl->DeleteTextures(1, &bakeTexture);
+    if (bakeStencil) g_gl->DeleteRenderbuffers(1, &bakeStencil);
+    g_gl->BindFramebuffer(GL_FRAMEBUFFER, 0);
+    g_gl->Viewport(0, 0, g_viewWidth, g_viewHeight);
+    g_renderFBO = savedFBO; g_renderW = savedW; g_renderH = savedH;
+    g_renderStencil = savedStencil;
+
+    fb.atlasW = cols * cw; fb.atlasH = rows * ch;
+    fb.cols = cols; fb.cellW = cw; fb.cellH = ch;
+    fb.windowRect = wr;
+    fb.step = step;
+
+    // 烘焙中的绘制统计不计入本帧
+    g_frameStats = FrameStats();
+    g_frameStats.bakeMs = (getCurrentTime() - tStart) * 1000.0;
+    LOGI("Idle flipbook: %d frames of %dx%d, atlas %dx%d (%.1f MB), baked in %.1f ms",
+         fb.frames, cw, ch, fb.atlasW, fb.atlasH, fb.atlasW * fb.atlasH * 4 / 1048576.0, g_frameStats.bakeMs);
+}
+
+// 本帧是否从图集播放; 需要时丢弃或烘焙图集
+static bool updateFlipbook(float dt) {
+    IdleFlipbook& fb = g_flipbook;
+    if (!fb.enabled || !g_initialized || !g_model.loaded) return false;
+    bool changed = flipbookInputsChanged();
+    if (changed || !flipbookEligible()) {
+        if (fb.atlasFBO) LOGD("Idle flipbook dropped");
+        if (fb.atlasFBO || fb.hasBounds) releaseFlipbook();
+        fb.quietTime = 0.f;
+        return false;
+    }
+    if (!fb.atlasFBO) {
+        fb.quietTime += dt;
+        if (!fb.hasBounds || fb.quietTime < std::max(kFlipbookIdleDelay, g_idleMotion.duration)) return false;
+        if (g_trimHold > 0.f) return false;   // 内存紧张: 暂不分配图集
+        bakeFlipbook();
+        if (!fb.atlasFBO) { fb.quietTime = 0.f; return false; }   // 失败: 再等一个静止期
+        return true;
+    }
+    g_motionTime = fmodf(g_motionTime + dt, g_idleMotion.duration);
+    return true;
+}
+
+// 静止期间累计本帧的绘制范围
+static void accumulateFlipbookBounds() {
+    IdleFlipbook& fb = g_flipbook;
+    if (!fb.enabled || !g_frameHasBounds) return;
+    uniteBounds(fb.loopBounds, g_frameBounds, !fb.hasBounds);
+    fb.hasBounds = true;
+}
+
+static void drawFlipbook() {
+    IdleFlipbook& fb = g_flipbook;
+    float offset = g_motionTime - fb.startTime;
+    if (offset < 0.f) offset += g_idleMotion.duration;
+    int k = ((int)floorf(offset / fb.step + 0.5f) - 1 + fb.frames) % fb.frames;
+
+    g_gl->BindFramebuffer(GL_FRAMEBUFFER, 0);
+    g_gl->Viewport(0, 0, g_viewWidth, g_viewHeight);
+    g_gl->ClearColor(0.f, 0.f, 0.f, 0.f);
+    g_gl->Clear(GL_COLOR_BUFFER_BIT);
+    const PixelRect& r = fb.windowRect;
+    g_gl->Viewport(r.x0, r.y0, r.x1 - r.x0, r.y1 - r.y0);
+    drawCompositeQuad(fb.atlasTexture, (float)(k % fb.cols) * fb.cellW / fb.atlasW, (float)(k / fb.cols) * fb.cellH / fb.atlasH,
+                      (float)fb.cellW / fb.atlasW, (float)fb.cellH / fb.atlasH);
+    g_gl->Viewport(0, 0, g_viewWidth, g_viewHeight);
+
+    g_windowRect = r;
+    g_modelBounds = ScreenRect{ r.x0, g_viewHeight - r.y1, r.x1 - r.x0, r.y1 - r.y0 };
+    g_frameStats.flipbook = 1;
+}
+
+// ===================== Vulkan =====================
+// initRendererVulkan() 成功后 drawFrame 走这里 (live2d_vulkan.h): 动画、纹理 LOD / 驻留、
+// 屏幕范围、视口剔除与遮罩剔除都与 drawModel 相同, 结果整理成按渲染顺序的 draw 列表
+// (矩形换成左上角原点) 交给后端录制成一个命令缓冲。
+// 动态分辨率、待机序列帧与模板裁剪只在 GLES 上实现, Vulkan 下忽略。
+
+#ifdef LIVE2D_VULKAN
+static_assert(std::is_same<GLuint, uint32_t>::value, "texture ids are shared with the Vulkan backend");
+
+static bool g_vulkanGeometryStale = true;   // 加载后第一帧上传 UV / 索引
+static bool g_vulkanGlesOnlyLogged = false;
+
+static bool buildVulkanFrame(VulkanFrame& f) {
+    FrameStats& st = g_frameStats;
+    int dc = csmGetDrawableCount(g_model.model);
+    const int*    ro   = csmGetDrawableRenderOrders(g_model.model);
+    const csmFlags* df = csmGetDrawableDynamicFlags(g_model.model);
+    const csmFlags* cf = csmGetDrawableConstantFlags(g_model.model);
+    const int*    ti   = csmGetDrawableTextureIndices(g_model.model);
+    const float*  op   = csmGetDrawableOpacities(g_model.model);
+    const int*    vc   = csmGetDrawableVertexCounts(g_model.model);
+    const csmVector2** vp = csmGetDrawableVertexPositions(g_model.model);
+    const int*    ic   = csmGetDrawableIndexCounts(g_model.model);
+    const int*    maskCounts = csmGetDrawableMaskCounts(g_model.model);
+    const int**   masks      = csmGetDrawableMasks(g_model.model);
+
+    int maskTotal = 0;
+    for (int i = 0; i < dc && maskCounts && masks; i++) maskTotal += std::max(0, maskCounts[i]);
+    RasterDrawable* drawables = g_frameArena.alloc<RasterDrawable>(dc);
+    DSortInfo* sorted = g_frameArena.alloc<DSortInfo>(dc);
+    VulkanDraw* draws = g_frameArena.alloc<VulkanDraw>(dc);
+    int* maskList = g_frameArena.alloc<int>(std::max(1, maskTotal));
+    if (!drawables || !sorted || !draws || !maskList) return false;
+    fillRasterDrawables(g_model.model, drawables);
+    for (int i = 0; i < dc; i++) sorted[i] = {i, ro[i]};
+    std::sort(sorted, sorted + dc,
+              [](const DSortInfo& a, const DSortInfo& b){ return a.order < b.order; });
+
+    auto drawn = [&](int i) {
+        if (!(df[i] & csmIsVisible)) return false;
+        if (op[i] <= 0.001f || vc[i] == 0 || ic[i] == 0) return false;
+        int t = ti[i];
+        return t >= 0 && t < (int)g_model.textureIds.size() && g_model.textureIds[t] != 0;
+    };
+
+    updateDrawableBounds(dc, df, vc, vp);
+    DrawableBounds frameBounds;
+    bool anyDrawn = false;
+    for (int i = 0; i < dc; i++) {
+        if (!drawn(i)) continue;
+        uniteBounds(frameBounds, g_model.drawableBounds[i], !anyDrawn);
+        anyDrawn = true;
+    }
+    setFrameBounds(frameBounds, anyDrawn);
+
+    int n = 0, used = 0;
+    for (int si = 0; si < dc; si++) {
+        int i = sorted[si].index;
+        if (!drawn(i)) continue;
+        PixelRect rect = projectBounds(g_model.drawableBounds[i], g_renderW, g_renderH, kBoundsPad);
+        if (rect.empty()) { st.culledDraws++; continue; }
+
+        auto maskInRect = [&](int mi) {
+            if (mi < 0 || mi >= dc || vc[mi] == 0 || ic[mi] == 0) return false;
+            int mt = ti[mi];
+            if (mt < 0 || mt >= (int)g_model.textureIds.size() || g_model.textureIds[mt] == 0) return false;
+            return rectsOverlap(projectBounds(g_model.drawableBounds[mi], g_renderW, g_renderH, kBoundsPad), rect);
+        };
+        VulkanDraw& d = draws[n];
+        d.drawable = i;
+        d.x0 = rect.x0;
+        d.x1 = rect.x1;
+        d.y0 = g_renderH - rect.y1;
+        d.y1 = g_renderH - rect.y0;
+        d.masks = maskList + used;
+        d.maskCount = 0;
+        if (maskCounts && masks && maskCounts[i] > 0 && masks[i]) {
+            bool anyMask = false;
+            for (int m = 0; m < maskCounts[i] && !anyMask; m++) anyMask = maskInRect(masks[i][m]);
+            if (!anyMask && !(cf[i] & csmIsInvertedMask)) { st.culledDraws++; continue; }
+            for (int m = 0; m < maskCounts[i] && anyMask; m++) {
+                if (maskInRect(masks[i][m])) maskList[used + d.maskCount++] = masks[i][m];
+                else st.culledDraws++;
+            }
+        }
+        used += d.maskCount;
+        n++;
+    }
+
+    f.drawables = drawables;
+    f.drawableCount = dc;
+    f.draws = draws;
+    f.drawCount = n;
+    f.textures = g_model.textureIds.data();
+    f.textureCount = (int)g_model.textureIds.size();
+    f.matrix = g_projMatrix;
+    if (g_vulkanGeometryStale) {
+        vulkanSetGeometry(drawables, dc);
+        g_vulkanGeometryStale = false;
+    }
+    return true;
+}
+
+// drawFrame 的 Vulkan 部分; 没有模型时也提交一帧 (窗口清成透明)
+static void drawModelVulkan() {
+    FrameStats& st = g_frameStats;
+    double tStart = getCurrentTime();
+    g_renderFBO = 0;
+    g_renderW = g_viewWidth;
+    g_renderH = g_viewHeight;
+    if ((g_drs.enabled || g_flipbook.enabled || g_clipMode == ClipMode::Stencil) && !g_vulkanGlesOnlyLogged) {
+        LOGW("Vulkan: dynamic resolution, idle flipbook and stencil clipping are GLES-only, ignored");
+        g_vulkanGlesOnlyLogged = true;
+    }
+
+    VulkanFrame frame;
+    frame.matrix = g_projMatrix;
+    bool model = g_initialized && g_model.loaded;
+    if (!model || !buildVulkanFrame(frame)) {
+        frame = VulkanFrame();
+        frame.matrix = g_projMatrix;
+        g_modelBounds = ScreenRect();
+    }
+    VulkanFrameStats vs;
+    vulkanDrawFrame(frame, &vs);
+    if (model) csmResetDrawableDynamicFlags(g_model.model);
+
+    st.drawCalls += vs.drawCalls;
+    st.maskDraws += vs.maskDraws;
+    st.maskPasses += vs.maskPasses;
+    st.programSwitches += vs.pipelineBinds;
+    st.drawMs = (getCurrentTime() - tStart) * 1000.0;
+    st.totalMs = st.animationMs + st.physicsMs + st.coreMs + st.drawMs;
+}
+
+// 截图: 当前投影与 g_renderW / g_renderH 画进临时目标并同步读回 (顶行在前)
+static bool renderImageVulkan(int width, int height, std::vector<uint8_t>& rgba) {
+    VulkanFrame frame;
+    if (!buildVulkanFrame(frame)) return false;
+    bool ok = vulkanRenderImage(frame, width, height, rgba);
+    csmResetDrawableDynamicFlags(g_model.model);
+    return ok;
+}
+#endif
+
+// ===================== Snapshots =====================
+// 异步截图 (分享 / 聊天界面): 请求在下一次 drawFrame 末尾把模型画进独立的离屏目标, 再异步读回。
+// - GLES3: glReadPixels 写进 GL_PIXEL_PACK_BUFFER 并插入 fence, 之后每帧开头非阻塞地查询 fence,
+//   完成后才映射缓冲, 渲染线程不等 GPU; 超过 kSnapshotMaxWaitFrames 仍未完成时直接映射 (会等待)
+// - GLES2 没有 PBO: 目标保留到下一帧开头再 glReadPixels, 此时新一帧的命令还没提交,
+//   最多等上一帧 (通常在 eglSwapBuffers 之后已经完成)
+// - Vulkan: 画进临时目标后同步读回 (等 GPU), 在同一次 drawFrame 内交付
+// - 构图与屏幕相同 (投影、缩放、平移), 按目标宽高比等比放进 width x height;
+//   背景色在读回后的行翻转中叠在模型下面, 渲染本身总是透明背景
+// 每帧最多渲染一个请求, 绘制统计不计入本帧 (只记 snapshotMs / readbackMs)。
+
+static const int kMaxSnapshots          = 4;      // 排队 + 读回中
+static const int kSnapshotMaxWaitFrames = 8;
+static const int kMaxSnapshotSize       = 4096;
+
+struct SnapshotJob {
+    int      id = 0;
+    int      width = 0, height = 0;
+    uint32_t background = 0;        // 0xAARRGGBB, straight alpha
+    double   requestTime = 0;
+    int      frames = 0;            // 请求后开始的 drawFrame 数
+    bool     rendered = false;
+    GLuint   fbo = 0, texture = 0, stencil = 0;   // GLES2: 保留到读回
+    GLuint   pbo = 0;                             // GLES3
+    GLsync   fence = nullptr;
+};
+static std::vector<SnapshotJob> g_snapshotJobs;   // 请求顺序
+static std::vector<Snapshot>    g_snapshotsDone;
+static int g_nextSnapshotId = 1;
+
+static void releaseSnapshotTarget(SnapshotJob& j) {
+    if (j.fbo) g_gl->DeleteFramebuffers(1, &j.fbo);
+    if (j.texture) g_gl->DeleteTextures(1, &j.texture);
+    if (j.stencil) g_gl->DeleteRenderbuffers(1, &j.stencil);
+    j.fbo = j.texture = j.stencil = 0;
+}
+
+// 读回结果 (GL 底行在前, Vulkan 顶行在前) -> 顶行在前, 同时把背景色 (预乘后) 叠在下面; src 为空表示失败
+static void deliverSnapshot(const SnapshotJob& j, const uint8_t* src, bool topDown = false) {
+    Snapshot out;
+    out.id = j.id;
+    out.width = j.width;
+    out.height = j.height;
+    out.frames = j.frames;
+    out.latencyMs = (getCurrentTime() - j.requestTime) * 1000.0;
+    if (src) {
+        size_t row = (size_t)j.width * 4;
+        out.rgba.resize(row * j.height);
+        uint32_t ba = j.background >> 24;
+        uint32_t bg[4] = { (((j.background >> 16) & 0xFF) * ba + 127) / 255,
+                           (((j.background >> 8) & 0xFF) * ba + 127) / 255,
+                           ((j.background & 0xFF) * ba + 127) / 255, ba };
+        for (int y = 0; y < j.height; y++) {
+            const uint8_t* s = src + row * (topDown ? y : j.height - 1 - y);
+            uint8_t* d = out.rgba.data() + row * y;
+            if (!ba) { memcpy(d, s, row); continue; }
+            for (size_t x = 0; x < row; x += 4) {
+                uint32_t inv = 255 - s[x + 3];   // src over bg, 两者都是预乘
+                for (int c = 0; c < 4; c++) d[x + c] = (uint8_t)std::min<uint32_t>(255, s[x + c] + (bg[c] * inv + 127) / 255);
+            }
+        }
+    }
+    LOGI("Snapshot %d: %dx%d %s after %d frames (%.1f ms)", j.id, j.width, j.height,
+         src ? "ready" : "failed", j.frames, out.latencyMs);
+    g_snapshotsDone.push_back(std::move(out));
+}
+
+// GL 上下文重建: 旧对象 ID 已失效, 不能删除, 所有未完成的请求按失败交付
+static void abandonSnapshots() {
+    for (const SnapshotJob& j : g_snapshotJobs) deliverSnapshot(j, nullptr);
+    g_snapshotJobs.clear();
+}
+
+// drawFrame 开头: 交付读回已完成的请求
+static void collectSnapshots() {
+    if (g_snapshotJobs.empty()) return;
+    double tStart = getCurrentTime();
+    bool worked = false;
+    for (size_t k = 0; k < g_snapshotJobs.size();) {
+        SnapshotJob& j = g_snapshotJobs[k];
+        j.frames++;
+        if (!j.rendered) { k++; continue; }
+        size_t bytes = (size_t)j.width * j.height * 4;
+        if (j.pbo) {
+            GLenum r = g_gl->ClientWaitSync(j.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            bool signaled = r == GL_ALREADY_SIGNALED || r == GL_CONDITION_SATISFIED;
+            if (!signaled && r != GL_WAIT_FAILED && j.frames < kSnapshotMaxWaitFrames) { k++; continue; }
+            if (!signaled) LOGD("Snapshot %d: fence not signaled after %d frames, mapping anyway", j.id, j.frames);
+            g_gl->DeleteSync(j.fence);
+            g_gl->BindBuffer(GL_PIXEL_PACK_BUFFER, j.pbo);
+            const auto* px = (const uint8_t*)g_gl->MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)bytes, GL_MAP_READ_BIT);
+            deliverSnapshot(j, px);
+            if (px) g_gl->UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            g_gl->BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            g_gl->DeleteBuffers(1, &j.pbo);
+        } else {
+            std::vector<uint8_t> px(bytes);
+            g_gl->BindFramebuffer(GL_FRAMEBUFFER, j.fbo);
+            g_gl->ReadPixels(0, 0, j.width, j.height, GL_RGBA, GL_UNSIGNED_BYTE, px.data());
+            g_gl->BindFramebuffer(GL_FRAMEBUFFER, 0);
+            deliverSnapshot(j, px.data());
+            releaseSnapshotTarget(j);
+        }
+        g_snapshotJobs.erase(g_snapshotJobs.begin() + k);
+        worked = true;
+    }
+    if (worked) g_frameStats.readbackMs += (getCurrentTime() - tStart) * 1000.0;
+}
+
+// drawFrame 末尾: 渲染最早的一个未渲染请求并发起读回
+static void renderSnapshot() {
+    auto it = std::find_if(g_snapshotJobs.begin(), g_snapshotJobs.end(),
+                           [](const SnapshotJob& j) { return !j.rendered; });
+    if (it == g_snapshotJobs.end()) return;
+    SnapshotJob& j = *it;
+    if (!g_initialized || !g_model.loaded || g_viewWidth <= 0 || g_viewHeight <= 0) {
+        deliverSnapshot(j, nullptr);
+        g_snapshotJobs.erase(it);
+        return;
+    }
+    double tStart = getCurrentTime();
+
+    // 屏幕构图等比放进目标: 目标更宽时左右留空, 更高时上下留空
+    float proj[16];
+    memcpy(proj, g_projMatrix, sizeof(proj));
+    float viewAspect = (float)g_viewWidth / g_viewHeight, aspect = (float)j.width / j.height;
+    float sx = aspect > viewAspect ? viewAspect / aspect : 1.f;
+    float sy = aspect > viewAspect ? 1.f : aspect / viewAspect;
+    float snapProj[16];
+    memcpy(snapProj, proj, sizeof(snapProj));
+    snapProj[0] *= sx; snapProj[12] *= sx;
+    snapProj[5] *= sy; snapProj[13] *= sy;
+
+    FrameStats savedStats = g_frameStats;
+    DrawableBounds savedBounds = g_frameBounds;
+    bool savedHasBounds = g_frameHasBounds, savedStencilClip = g_stencilClipFrame;
+    PixelRect savedWindowRect = g_windowRect;
+    ScreenRect savedModelBounds = g_modelBounds;
+    GLuint savedFBO = g_renderFBO;
+    int savedW = g_renderW, savedH = g_renderH;
+    bool savedStencil = g_renderStencil;
+
+    // 待机序列帧播放时模型没有逐帧更新, 先按当前动作相位求一次姿势
+    if (savedStats.flipbook) updateModel(0.f);
+    memcpy(g_projMatrix, snapProj, sizeof(snapProj));
+#ifdef LIVE2D_VULKAN
+    // Vulkan: 同步画进临时目标并读回, 本帧内交付
+    std::vector<uint8_t> pixels;
+    bool vulkan = g_backend == RenderBackend::Vulkan;
+    if (vulkan) {
+        g_renderW = j.width; g_renderH = j.height;
+        if (!renderImageVulkan(j.width, j.height, pixels)) pixels.clear();
+    } else
+#endif
+    {
+        createRenderTarget(j.width, j.height, j.fbo, j.texture, "Snapshot", stencilClippingWanted() ? &j.stencil : nullptr);
+        g_renderFBO = j.fbo; g_renderW = j.width; g_renderH = j.height;
+        g_renderStencil = j.stencil != 0;
+        g_gl->BindFramebuffer(GL_FRAMEBUFFER, j.fbo);
+        g_gl->Viewport(0, 0, j.width, j.height);
+        drawModel();
+
+        if (g_gles3) {
+            // 读进 PBO 后目标即可删除, 驱动会等读取完成再释放
+            g_gl->GenBuffers(1, &j.pbo);
+            g_gl->BindBuffer(GL_PIXEL_PACK_BUFFER, j.pbo);
+            g_gl->BufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)j.width * j.height * 4, nullptr, GL_STREAM_READ);
+            g_gl->ReadPixels(0, 0, j.width, j.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            g_gl->BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            j.fence = g_gl->FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            releaseSnapshotTarget(j);
+        }
+        g_gl->BindFramebuffer(GL_FRAMEBUFFER, 0);
+        g_gl->Viewport(0, 0, g_viewWidth, g_viewHeight);
+    }
+    memcpy(g_projMatrix, proj, sizeof(proj));
+    g_renderFBO = savedFBO; g_renderW = savedW; g_renderH = savedH;
+    g_renderStencil = savedStencil;
+    g_frameBounds = savedBounds;
+    g_frameHasBounds = savedHasBounds;
+    g_stencilClipFrame = savedStencilClip;
+    g_windowRect = savedWindowRect;
+    g_modelBounds = savedModelBounds;
+    j.rendered = true;
+
+    g_frameStats = savedStats;
+    g_frameStats.snapshotMs += (getCurrentTime() - tStart) * 1000.0;
+#ifdef LIVE2D_VULKAN
+    if (vulkan) {
+        deliverSnapshot(j, pixels.empty() ? nullptr : pixels.data(), true);
+        g_snapshotJobs.erase(it);
+    }
+#endif
+}
+
+static int64_t snapshotBytes() {
+    int64_t bytes = 0;
+    for (const SnapshotJob& j : g_snapshotJobs)
+        if (j.rendered) bytes += (int64_t)j.width * j.height * (j.stencil ? 5 : 4);
+    return bytes;
+}
+
+// ===================== CPU Rendering =====================
+// 不需要 GL 上下文的渲染 (live2d_raster.h): 模型选择器的缩略图、宿主工具的预览,
+// 以及 GL 路径逐像素对比的参考图。输入与 drawModel 相同 (csmGetDrawable*),
+// 纹理在 CPU 上重新解码; 每次调用独立解码, 不与 GL 路径共享也不缓存。
+
+// 按渲染顺序列出 drawModel 会画的 drawable; 遮罩来源不论可见与否都参与遮罩 (同 GL 路径)
+static void collectRasterDrawables(csmModel* model, const std::vector<RasterTexture>& textures,
+                                   std::vector<RasterDrawable>& out, std::vector<int>& order) {
+    int dc = csmGetDrawableCount(model);
+    const int*    ro   = csmGetDrawableRenderOrders(model);
+    const csmFlags* df = csmGetDrawableDynamicFlags(model);
+    const float*  op   = csmGetDrawableOpacities(model);
+
+    out.assign(dc, RasterDrawable());
+    fillRasterDrawables(model, out.data());
+    order.clear();
+    for (int i = 0; i < dc; i++) {
+        const RasterDrawable& d = out[i];
+        bool textured = d.texture >= 0 && d.texture < (int)textures.size() && !textures[d.texture].levels.empty();
+        if ((df[i] & csmIsVisible) && op[i] > 0.001f && d.vertexCount > 0 && d.indexCount > 0 && textured) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return ro[a] < ro[b]; });
+}
+
+static bool rasterizeModel(csmModel* model, const std::vector<RasterTexture>& textures, const float* matrix,
+                           int width, int height, std::vector<uint8_t>& rgba, int threads) {
+    std::vector<RasterDrawable> drawables;
+    std::vector<int> order;
+    collectRasterDrawables(model, textures, drawables, order);
+
+    rgba.assign((size_t)width * height * 4, 0);
+    RasterTarget target;
+    target.pixels = rgba.data();
+    target.width = width;
+    target.height = height;
+    RasterStats stats;
+    rasterizeDrawables(drawables.data(), (int)drawables.size(), order.data(), (int)order.size(),
+                       textures.data(), (int)textures.size(), matrix, target, threads, &stats);
+    LOGI("Rasterized %dx%d: %d drawables, %d triangles, %d tiles, %d threads, %.1f ms",
+         width, height, (int)order.size(), stats.triangles, stats.tiles, stats.threads, stats.ms);
+    return true;
+}
+
+// 解码结果 -> RasterTexture (预乘 + mipmap), 释放解码像素
+static void buildRasterTextureFrom(PngImage& img, bool premultiplied, RasterTexture& out) {
+    buildRasterTexture(img.pixels, img.width, img.height, premultiplied, out);
+    freePngImage(img);
+}
+
+// 缩略图读取模型文件: .l2dbundle 整个读入后按条目名查找, 否则读模型目录下的文件。
+// 不经过 loadAsset (那里用的是当前已加载模型的 bundle)
+struct ModelFiles {
+    std::string dir;
+    std::vector<unsigned char> bundleImage;
+    std::vector<BundleEntryView> entries;
+    std::vector<unsigned char> owned;
+
+    bool open(const std::string& modelPath, std::string& mainName) {
+        if (!isBundlePath(modelPath)) {
+            size_t sl = modelPath.find_last_of('/');
+            dir = (sl != std::string::npos) ? modelPath.substr(0, sl + 1) : "";
+            mainName = modelPath.substr(dir.size());
+            return true;
+        }
+        bundleImage = readAsset(modelPath);
+        uint32_t mainEntry = 0;
+        std::string err;
+        if (bundleImage.empty() || !parseBundle(bundleImage.data(), bundleImage.size(), entries, &mainEntry, &err)) {
+            LOGE("Thumbnail: bad bundle %s: %s", modelPath.c_str(), err.c_str());
+            return false;
+        }
+        mainName.assign(entries[mainEntry].name, entries[mainEntry].nameLength);
+        return true;
+    }
+
+    // data 在下一次 read 之前有效
+    bool read(const std::string& name, const unsigned char*& data, size_t& size) {
+        if (!entries.empty()) {
+            for (const BundleEntryView& e : entries) {
+                if (e.kind != BundleKind::File || name.compare(0, std::string::npos, e.name, e.nameLength) != 0) continue;
+                data = e.data; size = e.size;
+                return true;
+            }
+            return false;
+        }
+        owned = readAsset(dir + name);
+        data = owned.data(); size = owned.size();
+        return !owned.empty();
+    }
+};
+
+// ===================== Memory Budget =====================
+// 按归属统计 native 内存; 内存紧张 (Android onTrimMemory / iOS 内存警告) 时分级释放。
+// 每帧都会用到的遮罩 / 离屏目标不释放 (下一帧就会重建), GL 上下文销毁时它们随之释放。
+// 容器按 capacity 计, 不含分配器开销, 只作量级参考。
+
+static const float kTrimHoldTime = 60.f;
+
+static int64_t motionBytes(const MotionData& m) {
+    int64_t b = (int64_t)m.curves.capacity() * sizeof(MotionCurve);
+    for (const MotionCurve& c : m.curves)
+        b += c.paramId.capacity() + (int64_t)c.keyframes.capacity() * sizeof(MotionKeyframe);
+    return b;
+}
+
+static int64_t expressionBytes() {
+    int64_t b = 0;
+    for (const auto& kv : g_expressions) {
+        const ExpressionData& e = kv.second;
+        b += sizeof(e) + kv.first.capacity() + e.name.capacity() + e.file.capacity()
+           + (int64_t)e.params.capacity() * sizeof(ExprParam);
+        for (const ExprParam& p : e.params) b += p.paramId.capacity();
+    }
+    return b;
+}
+
+static int64_t physicsBytes() {
+    int64_t b = (int64_t)g_physics.settings.capacity() * sizeof(PhysSubRig);
+    for (const PhysSubRig& r : g_physics.settings) {
+        b += (int64_t)r.inputs.capacity() * sizeof(PhysInput) + (int64_t)r.outputs.capacity() * sizeof(PhysOutput)
+           + (int64_t)r.particles.capacity() * sizeof(PhysParticle);
+        for (const PhysInput& in : r.inputs) b += in.sourceId.capacity();
+        for (const PhysOutput& out : r.outputs) b += out.destId.capacity();
+    }
+    return b;
+}
+
+// 纹理逐张降一档 (smallest: 降到 kMinLodSize 允许的最小), 同步重新解码上传
+static void trimTextures(bool smallest) {
+    cancelLodDecode();
+    for (size_t t = 0; t < g_model.textureLods.size(); t++) {
+        TextureLod& lod = g_model.textureLods[t];
+        if (lod.srcWidth == 0 || g_model.textureIds[t] == 0) continue;
+        int shortSide = std::min(lod.srcWidth, lod.srcHeight);
+        int target = lod.scale;
+        while (shortSide / (target * 2) >= kMinLodSize && (smallest || target == lod.scale)) target *= 2;
+        lod.trimScale = target;
+        lod.wanted = 0;
+        if (target > lod.scale) startLodDecode(t, target, false);
+    }
+}
+
+
+// ===================== Public API =====================
+
+#ifdef __ANDROID__
+void setAssetManager(AAssetManager* mgr) { g_assetManager = mgr; }
+#endif
+
+void initRenderer() {
+    if (g_callRecording) recordInit();
+    shutdownRendererVulkan();
+    csmVersion v = csmGetVersion();
+    LOGI("Cubism Core %d.%d.%d", (v>>24)&0xFF, (v>>16)&0xFF, v&0xFFFF);
+
+    // GL 上下文已重建，所有旧 GL 资源 ID 均已失效，必须全部归零
+    // (不能 glDelete — 旧上下文已销毁，ID 无法引用)
+    for (ShaderInfo& sh : g_drawPrograms) sh = ShaderInfo();
+    g_maskShader   = MaskShaderInfo();
+    g_stencilMaskShader = MaskShaderInfo();
+    g_gles3Buffers = Gles3Buffers();
+    g_maskFBO      = 0;
+    g_maskTexture  = 0;
+    g_maskW        = 0;
+    g_maskH        = 0;
+    g_compositeShader = CompositeShaderInfo();
+    g_sceneFBO     = 0;
+    g_sceneTexture = 0;
+    g_sceneStencil = 0;
+    g_sceneW       = 0;
+    g_sceneH       = 0;
+    g_sceneDirtyW  = 0;
+    g_sceneDirtyH  = 0;
+    g_flipbook.atlasFBO     = 0;
+    g_flipbook.atlasTexture = 0;
+    releaseFlipbook();
+    abandonSnapshots();
+
+    g_shaderCacheStats = ShaderCacheStats();
+    detectGLCapabilities();
+    initShaders();
+
+    cancelLodDecode();
+    if (g_model.loaded) {
+        // 旧纹理 ID 属于已销毁的 GL 上下文，只清列表不调 glDeleteTextures
+        g_model.textureIds.clear();
+        g_model.textureLods.clear();
+        g_model.loaded = false;
+    }
+
+    g_initialized = true;
+    LOGI("Live2D Native initialized (GL context reset)");
+}
+
+bool loadModel(const std::string& modelPath) {
+    if (g_callRecording) recordLoadModel(modelPath);
+    LOGI("Loading model: %s", modelPath.c_str());
+    releaseFlipbook();
+    bool ok = loadModelFromAssets(modelPath);
+#ifdef LIVE2D_VULKAN
+    g_vulkanGeometryStale = true;
+#endif
+    LOGI("Model load %s", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+bool isModelLoaded() { return g_model.loaded; }
+
+void setTextureLodAsync(bool async) { g_lodAsync = async; }
+
+void setShaderCacheDir(const std::string& dir) { g_shaderCacheDir = dir; }
+
+const ShaderCacheStats& shaderCacheStats() { return g_shaderCacheStats; }
+
+void flushProgramCache() { g_programCacheWriter.join(); }
+
+void setGLES3Enabled(bool enabled) { g_gles3Enabled = enabled; }
+
+int renderPathVersion() { return g_gles3 ? 3 : 2; }
+
+bool initRendererVulkan() {
+#ifdef LIVE2D_VULKAN
+    if (!vulkanInit()) {
+        LOGW("Vulkan unavailable, falling back to GLES");
+        return false;
+    }
+    releaseFlipbook();
+    abandonSnapshots();
+    cancelLodDecode();
+    if (g_model.loaded) {
+        // 纹理属于之前的 GL 上下文, 模型需要重新加载
+        g_model.textureIds.clear();
+        g_model.textureLods.clear();
+        g_model.loaded = false;
+    }
+    if (g_viewWidth > 0 && g_viewHeight > 0) vulkanResize(g_viewWidth, g_viewHeight);
+    g_backend = RenderBackend::Vulkan;
+    g_vulkanGeometryStale = true;
+    g_vulkanGlesOnlyLogged = false;
+    g_initialized = true;
+    LOGI("Live2D Native initialized (Vulkan: %s)", vulkanDeviceName());
+    return true;
+#else
+    LOGI("Vulkan backend not built, using GLES");
+    return false;
+#endif
+}
+
+RenderBackend renderBackend() { return g_backend; }
+
+bool setVulkanWindow(ANativeWindow* window) {
+#ifdef LIVE2D_VULKAN
+    if (g_backend == RenderBackend::Vulkan) return vulkanSetWindow(window);
+#endif
+    (void)window;
+    return false;
+}
+
+bool readFrameVulkan(std::vector<uint8_t>& rgba) {
+#ifdef LIVE2D_VULKAN
+    if (g_backend == RenderBackend::Vulkan) return vulkanReadFrame(rgba);
+#endif
+    (void)rgba;
+    return false;
+}
+
+void shutdownRendererVulkan() {
+#ifdef LIVE2D_VULKAN
+    if (g_backend != RenderBackend::Vulkan) return;
+    cancelLodDecode();
+    abandonSnapshots();
+    vulkanShutdown();   // 纹理随设备一起销毁
+    if (g_model.loaded) {
+        g_model.textureIds.clear();
+        g_model.textureLods.clear();
+        g_model.loaded = false;
+    }
+    g_backend = RenderBackend::GLES;
+    g_initialized = false;
+    LOGI("Vulkan renderer shut down");
+#endif
+}
+
+void setClipMode(ClipMode mode) {
+    if (g_callRecording) recordSetClipMode((int)mode);
+    if (mode == g_clipMode) return;
+    LOGI("Clip mode: %s", mode == ClipMode::Stencil ? "stencil" : mode == ClipMode::MaskTexture ? "mask texture" : "auto");
+    g_clipMode = mode;
+    // 场景目标按新模式决定要不要模板附件, 下一帧重建; 不再用到的遮罩纹理也释放 (用到时重建)
+    releaseSceneTarget();
+    if (g_maskFBO) g_gl->DeleteFramebuffers(1, &g_maskFBO);
+    if (g_maskTexture) g_gl->DeleteTextures(1, &g_maskTexture);
+    g_maskFBO = g_maskTexture = 0;
+    g_maskW = g_maskH = 0;
+}
+
+bool stencilClippingActive() { return g_stencilClipFrame; }
+
+bool rasterizeFrame(std::vector<uint8_t>& rgba, int threads) {
+    if (!g_model.loaded || g_viewWidth <= 0 || g_viewHeight <= 0) return false;
+    // 与 GL 路径相同的纹理: 已驻留的按当前 LOD 尺寸解码, 未驻留的不画
+    std::vector<RasterTexture> textures(g_model.textureIds.size());
+    for (size_t t = 0; t < textures.size(); t++) {
+        const TextureLod& lod = g_model.textureLods[t];
+        if (g_model.textureIds[t] == 0) continue;
+        TextureJob job;
+        job.path = lod.path;
+        job.maxDim = std::max(lod.width, lod.height);
+        decodeTextureJob(job);
+        if (resolveTextureJob(job)) buildRasterTextureFrom(job.img, job.premultiplied, textures[t]);
+    }
+    return rasterizeModel(g_model.model, textures, g_projMatrix, g_viewWidth, g_viewHeight, rgba, threads);
+}
+
+bool renderModelThumbnail(const std::string& modelPath, int width, int height, std::vector<uint8_t>& rgba, int threads) {
+    if (width <= 0 || height <= 0) return false;
+    ModelFiles files;
+    std::string mainName;
+    if (!files.open(modelPath, mainName)) return false;
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    if (!files.read(mainName, data, size)) { LOGE("Thumbnail: cannot read %s", modelPath.c_str()); return false; }
+    std::string json((const char*)data, size);
+    ModelInfo info = parseModel3Json(json);
+    if (info.mocPath.empty() || !files.read(info.mocPath, data, size)) {
+        LOGE("Thumbnail: no moc in %s", modelPath.c_str());
+        return false;
+    }
+
+    Live2DModel m;
+    m.mocBuffer = alignedMalloc(size, csmAlignofMoc);
+    if (!m.mocBuffer) return false;
+    memcpy(m.mocBuffer, data, size);
+    bool ok = false;
+    if (csmHasMocConsistency(m.mocBuffer, (unsigned int)size) && (m.moc = csmReviveMocInPlace(m.mocBuffer, (unsigned int)size))) {
+        unsigned int msz = csmGetSizeofModel(m.moc);
+        m.modelBuffer = alignedMalloc(msz, csmAlignofModel);
+        if (m.modelBuffer) m.model = csmInitializeModelInPlace(m.moc, m.modelBuffer, msz);
+    }
+    if (m.model) {
+        csmVector2 cs, co;
+        csmReadCanvasInfo(m.model, &cs, &co, &m.pixelsPerUnit);
+        m.canvasWidth = cs.X; m.canvasHeight = cs.Y;
+        m.canvasOriginX = co.X; m.canvasOriginY = co.Y;
+
+        // 默认姿态: 参数取默认值, 姿势组只显示第一个部件
+        size_t posePos = findKey(json, "Pose");
+        std::string poseFile = posePos != std::string::npos ? extractString(json, posePos) : "";
+        if (!poseFile.empty() && files.read(poseFile, data, size)) {
+            PoseGroups groups = parsePoseGroups(std::string((const char*)data, size));
+            bindPoseParts(m.model, groups);
+            float* partOpacities = csmGetPartOpacities(m.model);
+            for (const auto& group : groups)
+                for (const PosePartInfo& pi : group)
+                    if (pi.partIndex >= 0) for (int li : pi.linkIndices) partOpacities[li] = partOpacities[pi.partIndex];
+        }
+        csmUpdateModel(m.model);
+
+        // 只解码默认姿态用到的纹理, 分辨率按缩略图尺寸 (再由 mipmap 缩小)
+        int dc = csmGetDrawableCount(m.model);
+        const int* ti = csmGetDrawableTextureIndices(m.model);
+        std::vector<char> used(info.texturePaths.size(), 0);
+        for (int i = 0; i < dc; i++) if (ti[i] >= 0 && ti[i] < (int)used.size()) used[ti[i]] = 1;
+        int maxDim = 64;
+        while (maxDim < 2 * std::max(width, height) && maxDim < kMaxTextureSize) maxDim *= 2;
+        std::vector<RasterTexture> textures(info.texturePaths.size());
+        for (size_t t = 0; t < textures.size(); t++) {
+            if (!used[t]) continue;
+            if (!files.read(info.texturePaths[t], data, size)) { LOGE("Thumbnail: cannot read %s", info.texturePaths[t].c_str()); continue; }
+            std::pair<const unsigned char*, size_t> mem{data, size};
+            PngImage img;
+            std::string err;
+            // stb_image 的上下翻转是全局开关, 不在 GL 线程之外用; 流式解码不支持的图不画
+            if (decodePngStream(readMemory, &mem, maxDim, true, img, &err) == PngStatus::Ok)
+                buildRasterTextureFrom(img, false, textures[t]);
+            else
+                LOGE("Thumbnail: texture %s not decoded: %s", info.texturePaths[t].c_str(), err.c_str());
+        }
+
+        float matrix[16];
+        fitCanvas(m, width, height, matrix);
+        ok = rasterizeModel(m.model, textures, matrix, width, height, rgba, threads);
+    } else {
+        LOGE("Thumbnail: cannot initialize moc of %s", modelPath.c_str());
+    }
+    free(m.modelBuffer);
+    free(m.mocBuffer);
+    return ok;
+}
+
+void setLazyTextures(bool lazy) { g_lazyTextures = lazy; }
+
+void setDynamicResolution(bool enabled, float budgetMs) {
+    if (g_callRecording) recordSetDynamicResolution(enabled, budgetMs);
+    LOGI("Dynamic resolution: %s (budget %.1f ms)", enabled ? "on" : "off", budgetMs);
+    if (!enabled) releaseSceneTarget();
+    g_drs = DynamicResolution();
+    g_drs.enabled = enabled;
+    if (budgetMs > 0.f) g_drs.budgetMs = budgetMs;
+    g_drs.probeDelay = kDrsProbeDelay;
+}
+
+void setIdleFlipbook(bool enabled, int frames, float scale) {
+    if (g_callRecording) recordSetIdleFlipbook(enabled, frames, scale);
+    LOGI("Idle flipbook: %s (%d frames, scale %.2f)", enabled ? "on" : "off", frames, scale);
+    releaseFlipbook();
+    g_flipbook.enabled = enabled;
+    g_flipbook.frames = std::clamp(frames, 2, 256);
+    g_flipbook.scale = std::clamp(scale, 0.1f, 1.f);
+}
+
+void setViewportSize(int width, int height) {
+    if (g_callRecording) recordViewport(width, height);
+    g_viewWidth = width; g_viewHeight = height;
+#ifdef LIVE2D_VULKAN
+    if (g_backend == RenderBackend::Vulkan) vulkanResize(width, height);
+    else
+#endif
+    g_gl->Viewport(0, 0, width, height);
+    updateProjection();
+    LOGI("Surface: %dx%d", width, height);
+}
+
+float frameDeltaTime() {
+    double now = getCurrentTime();
+    float dt = (g_lastTime > 0.0) ? (float)(now - g_lastTime) : (1.f / 60.f);
+    if (dt > 0.1f) dt = 0.1f;
+    g_lastTime = now;
+    return dt;
+}
+
+void drawFrame(float dt) {
+    if (g_callRecording) recordFrame(dt);
+    g_frameStats = FrameStats();
+    g_frameArena.reset();
+    collectSnapshots();
+    if (g_trimHold > 0.f) g_trimHold -= dt;
+#ifdef LIVE2D_VULKAN
+    if (g_backend == RenderBackend::Vulkan) {
+        if (g_initialized && g_model.loaded) {
+            updateTextureLod(dt);
+            updateModel(dt);
+            updateTextureResidency(dt, false);
+        }
+        drawModelVulkan();
+        renderSnapshot();
+        g_frameStats.textureBytes = (int)std::min<int64_t>(residentTextureBytes(), INT32_MAX);
+        g_frameStats.residentTextures = residentTextureCount();
+        if (g_viewWidth > 0 && g_viewHeight > 0)
+            g_frameStats.coverage = (float)g_modelBounds.w * g_modelBounds.h / ((float)g_viewWidth * g_viewHeight);
+        g_frameStats.scratchBytes = (int)g_frameArena.used();
+        return;
+    }
+#endif
+    if (updateFlipbook(dt)) {
+        drawFlipbook();
+        renderSnapshot();
+        g_frameStats.flipbookBytes = g_flipbook.atlasW * g_flipbook.atlasH * 4;
+        g_frameStats.textureBytes = (int)std::min<int64_t>(residentTextureBytes(), INT32_MAX);
+        g_frameStats.residentTextures = residentTextureCount();
+        if (g_viewWidth > 0 && g_viewHeight > 0)
+            g_frameStats.coverage = (float)g_modelBounds.w * g_modelBounds.h / ((float)g_viewWidth * g_viewHeight);
+        return;
+    }
+    beginRenderTarget(dt);
+    g_gl->Disable(GL_DEPTH_TEST);
+    if (g_initialized && g_model.loaded) {
+        updateTextureLod(dt);
+        renderModel(dt);
+        accumulateFlipbookBounds();
+        g_frameStats.textureBytes = (int)std::min<int64_t>(residentTextureBytes(), INT32_MAX);
+        g_frameStats.residentTextures = residentTextureCount();
+    }
+    endRenderTarget();
+    renderSnapshot();
+    g_frameStats.renderScale = g_renderFBO ? g_drs.scale : 1.f;
+    if (g_viewWidth > 0 && g_viewHeight > 0)
+        g_frameStats.coverage = (float)g_modelBounds.w * g_modelBounds.h / ((float)g_viewWidth * g_viewHeight);
+    g_frameStats.scratchBytes = (int)g_frameArena.used();
+}
+
+const FrameStats& lastFrameStats() { return g_frameStats; }
+
+ScreenRect modelScreenBounds() { return g_modelBounds; }
+
+int requestSnapshot(int width, int height, uint32_t background) {
+    if (g_callRecording) recordRequestSnapshot(width, height, background);
+    if (!g_model.loaded || (int)g_snapshotJobs.size() >= kMaxSnapshots) return 0;
+    SnapshotJob j;
+    j.width  = width > 0 ? width : g_viewWidth;
+    j.height = height > 0 ? height : g_viewHeight;
+    if (j.width <= 0 || j.height <= 0 || j.width > kMaxSnapshotSize || j.height > kMaxSnapshotSize) return 0;
+    j.id = g_nextSnapshotId++;
+    j.background = background;
+    j.requestTime = getCurrentTime();
+    g_snapshotJobs.push_back(j);
+    return j.id;
+}
+
+bool pollSnapshot(Snapshot& out) {
+    if (g_snapshotsDone.empty()) return false;
+    out = std::move(g_snapshotsDone.front());
+    g_snapshotsDone.erase(g_snapshotsDone.begin());
+    return true;
+}
+
+MemoryStats memoryStats() {
+    MemoryStats m;
+    if (g_model.moc) m.moc = g_model.mocSize;
+    if (g_model.model) m.model = g_model.modelSize;
+    m.bundle = bundleBytes();
+    m.textures = residentTextureBytes();
+    if (g_lodDecode.busy && g_lodDecode.done.load(std::memory_order_acquire) && g_lodDecode.job.img.pixels)
+        m.pendingPixels = (int64_t)g_lodDecode.job.img.width * g_lodDecode.job.img.height * 4;
+    if (g_maskFBO) m.renderTargets += (int64_t)g_maskW * g_maskH * 4;
+    if (g_sceneFBO) m.renderTargets += (int64_t)g_sceneW * g_sceneH * (g_sceneStencil ? 5 : 4);
+    if (g_flipbook.atlasFBO) m.renderTargets += (int64_t)g_flipbook.atlasW * g_flipbook.atlasH * 4;
+    m.renderTargets += snapshotBytes();
+#ifdef LIVE2D_VULKAN
+    if (g_backend == RenderBackend::Vulkan) m.renderTargets += vulkanTargetBytes();
+#endif
+    m.motions = motionBytes(g_idleMotion) + motionBytes(g_activeMotion);
+    m.expressions = expressionBytes();
+    m.physics = physicsBytes();
+    m.caches = (int64_t)g_frameArena.capacity() + g_modelMetadata.capacity()
+             + (int64_t)g_externalOverrides.capacity() * sizeof(ParamOverride)
+             + (int64_t)g_model.drawableBounds.capacity() * sizeof(DrawableBounds)
+             + (int64_t)g_flipbook.overrides.capacity() * sizeof(ParamOverride);
+    for (const auto& kv : g_model.parameterMap) m.caches += sizeof(kv) + kv.first.capacity();
+    return m;
+}
+
+void trimMemory(TrimLevel level) {
+    if (g_callRecording) recordTrimMemory((int)level);
+    int64_t before = memoryStats().total();
+
+    releaseFlipbook();
+    if (!g_hasActiveMotion) g_activeMotion = MotionData();
+    g_frameArena.release();
+    g_trimHold = kTrimHoldTime;
+
+    if (level >= TrimLevel::Textures) {
+        int evicted = 0;
+        for (auto& kv : g_expressions) {
+            ExpressionData& e = kv.second;
+            if (!e.loaded || kv.first == g_currentExpressionId) continue;
+            std::vector<ExprParam>().swap(e.params);
+            e.loaded = false;
+            evicted++;
+        }
+        if (evicted) LOGI("Evicted %d expressions", evicted);
+        if (g_model.loaded) {
+            evictUnusedTextures(0.f);   // 上一帧没有用到的纹理直接释放, 不再降档重解码
+            trimTextures(level == TrimLevel::Critical);
+        }
+    }
+    LOGI("Trim memory (level %d): %.2f -> %.2f MB", (int)level, before / 1048576.0, memoryStats().total() / 1048576.0);
+}
+
+const std::vector<uint8_t>& modelMetadata() { return g_modelMetadata; }
+
+// 开始记录调用时先写入当前视口与变换, 回放从相同状态开始
+void recordRendererState() {
+    if (g_viewWidth > 0 && g_viewHeight > 0) recordViewport(g_viewWidth, g_viewHeight);
+    recordSetTransform(g_userScale, g_userOffsetX, g_userOffsetY);
+    if (g_drs.enabled) recordSetDynamicResolution(true, g_drs.budgetMs);
+    if (g_flipbook.enabled) recordSetIdleFlipbook(true, g_flipbook.frames, g_flipbook.scale);
+    if (g_clipMode != ClipMode::Auto) recordSetClipMode((int)g_clipMode);
+}
+
+void startMotion(const std::string& groupStr, int index, int priority) {
+    if (g_callRecording) recordStartMotion(groupStr, index, priority);
+    LOGI("StartMotion: %s[%d] p=%d", groupStr.c_str(), index, priority);
+
+    if (!g_model.loaded) return;
+
+    // Check priority: only replace if new priority >= current
+    if (g_hasActiveMotion && priority < g_activeMotionPriority) {
+        LOGI("Motion rejected: priority %d < current %d", priority, g_activeMotionPriority);
+        return;
+    }
+
+    // Find motion file in our motion groups
+    auto git = g_motionGroups.find(groupStr);
+    if (git == g_motionGroups.end()) {
+        LOGI("Motion group '%s' not found", groupStr.c_str());
+        return;
+    }
+    if (index < 0 || index >= (int)git->second.size()) {
+        LOGI("Motion index %d out of range (group '%s' has %d entries)", index, groupStr.c_str(), (int)git->second.size());
+        return;
+    }
+
+    // Load motion file on demand
+    std::string motionFile = g_model.modelDir + git->second[index].file;
+    if (!loadMotion(motionFile, g_activeMotion)) {
+        LOGE("Cannot read motion file: %s", motionFile.c_str());
+        return;
+    }
+    if (g_activeMotion.curves.empty()) {
+        LOGI("Motion has no curves, ignoring");
+        return;
+    }
+
+    g_hasActiveMotion = true;
+    g_activeMotionTime = 0.f;
+    g_activeMotionPriority = priority;
+    LOGI("Active motion started: %s (%.1fs, fade=%.2f/%.2f)",
+         motionFile.c_str(), g_activeMotion.duration, g_activeMotion.fadeInTime, g_activeMotion.fadeOutTime);
+}
+
+void setExpression(const std::string& exprId) {
+    if (g_callRecording) recordSetExpression(exprId);
+    LOGI("SetExpression: %s", exprId.c_str());
+
+    // Empty string means clear expression
+    if (exprId.empty()) {
+        if (!g_currentExpressionId.empty()) {
+            g_expressionFadingIn = false; // start fading out
+            LOGI("Expression fading out: %s", g_currentExpressionId.c_str());
+        }
+        return;
+    }
+
+    // Check if expression exists
+    auto eit = g_expressions.find(exprId);
+    if (eit == g_expressions.end()) {
+        LOGI("Expression '%s' not found", exprId.c_str());
+        return;
+    }
+    if (!eit->second.loaded && !loadExpression(eit->second)) {
+        LOGE("Cannot read expression file: %s", eit->second.file.c_str());
+        return;
+    }
+
+    // If switching to a different expression, start fresh
+    if (exprId != g_currentExpressionId) {
+        g_currentExpressionId = exprId;
+        g_expressionFadeWeight = 0.f;
+    }
+    g_expressionFadingIn = true;
+    LOGI("Expression set: %s (%d params)", exprId.c_str(), (int)eit->second.params.size());
+}
+
+void setParameterOverride(const char* paramId, float value, float weight) {
+    if (g_callRecording) recordSetParameter(paramId, value, weight);
+    if (!g_model.loaded) return;
+    auto it = g_model.parameterMap.find(paramId);
+    if (it != g_model.parameterMap.end() && it->second < (int)g_externalOverrides.size()) {
+        ParamOverride& ov = g_externalOverrides[it->second];
+        ov.active = weight >= 0.001f;
+        ov.value  = value;
+        ov.weight = weight;
+    }
+}
+
+float getParameterValue(const char* paramId) {
+    if (!g_model.loaded) return 0.f;
+    auto it = g_model.parameterMap.find(paramId);
+    if (it == g_model.parameterMap.end()) return 0.f;
+    return csmGetParameterValues(g_model.model)[it->second];
+}
+
+float getParameterRange(const char* paramId) {
+    if (!g_model.loaded) return 1.f;
+    auto it = g_model.parameterMap.find(paramId);
+    if (it == g_model.parameterMap.end()) return 1.f;
+    int pidx = it->second;
+    return csmGetParameterMaximumValues(g_model.model)[pidx] - csmGetParameterMinimumValues(g_model.model)[pidx];
+}
+
+void setModelTransform(float scale, float offsetX, float offsetY) {
+    if (g_callRecording) recordSetTransform(scale, offsetX, offsetY);
+    g_userScale   = scale;
+    g_userOffsetX = offsetX;
+    g_userOffsetY = offsetY;
+    updateProjection();
+}
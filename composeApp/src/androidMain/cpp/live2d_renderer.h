@@ -0,0 +1,300 @@
+#pragma once
+
+// Platform-neutral Live2D core: model loading, animation, physics and GLES2 rendering
+// (or Vulkan, see initRendererVulkan()).
+// Used by the JNI layer (live2d_native.cpp) and by the host benchmark (bench/).
+// All functions must be called on the thread that owns the GL context (or that
+// initialized Vulkan), except renderModelThumbnail().
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef __ANDROID__
+struct AAssetManager;
+
+/** Set the asset manager used to resolve model-relative paths. */
+void setAssetManager(AAssetManager* mgr);
+#endif
+
+/**
+ * Per-frame timing and submission counters, filled by drawFrame().
+ * Stage times are wall-clock milliseconds on the calling thread.
+ */
+struct FrameStats {
+    double animationMs = 0;  // parameter reset, idle/active motion, expression
+    double physicsMs   = 0;  // physics, external overrides, pose
+    double coreMs      = 0;  // csmUpdateModel
+    double drawMs      = 0;  // GL command submission
+    double totalMs     = 0;
+    int    drawCalls   = 0;  // glDrawElements for visible drawables
+    int    maskDraws   = 0;  // glDrawElements into the mask FBO
+    int    maskPasses  = 0;  // mask FBO bind + clear cycles
+    int    culledDraws = 0;  // drawables and mask draws skipped as off-screen
+    int    programSwitches = 0; // glUseProgram between drawables (shader permutations)
+    int    scratchBytes = 0; // per-frame arena usage
+    int    textureBytes = 0; // resident texture memory (level 0 + mip chain)
+    int    residentTextures = 0; // model textures currently uploaded
+    float  renderScale = 1;  // dynamic resolution scale per axis (1 = native)
+    float  coverage    = 0;  // model bounds area / surface area
+    int    flipbook    = 0;  // 1 = frame replayed from the idle flipbook
+    int    flipbookBytes = 0; // idle flipbook atlas memory
+    double bakeMs      = 0;  // idle flipbook bake done in this frame
+    double snapshotMs  = 0;  // snapshot rendered in this frame (draw + readback start)
+    double readbackMs  = 0;  // finished snapshots delivered in this frame (fence poll, map or glReadPixels, copy)
+};
+
+/** Pixel rectangle on the surface, top-left origin. Empty when w or h is 0. */
+struct ScreenRect {
+    int x = 0, y = 0, w = 0, h = 0;
+};
+
+/** Reset GL-side state and compile shaders. Call after the GL context is (re)created. */
+void initRenderer();
+
+/**
+ * Directory for the shader program binary cache (OES_get_program_binary or
+ * GLES3). Empty (the default) disables it. Call before initRenderer(). Files
+ * are keyed by GL vendor / renderer / version and the shader sources; a binary
+ * the driver rejects is deleted and the program compiled from source again.
+ */
+void setShaderCacheDir(const std::string& dir);
+
+/** Programs built since the last initRenderer() and the time spent on them. */
+struct ShaderCacheStats {
+    int    cached   = 0;   // loaded from the program binary cache
+    int    compiled = 0;   // compiled from source
+    double ms       = 0;   // wall-clock time spent building programs
+};
+
+const ShaderCacheStats& shaderCacheStats();
+
+/**
+ * Wait for the program binaries still being written to the cache directory.
+ * Call before the process tears down (the writer thread logs), e.g. when the
+ * render thread exits; a later initRenderer() may start writing again.
+ */
+void flushProgramCache();
+
+/** Allow the GLES3 path on GLES 3.x contexts (default). Takes effect at the next initRenderer(). */
+void setGLES3Enabled(bool enabled);
+
+/**
+ * 3 when initRenderer() found a GLES 3.x context and draws through per-drawable
+ * VAOs, mapped vertex buffers and uniform buffers; 2 for the client-array path.
+ */
+int renderPathVersion();
+
+struct ANativeWindow;
+
+enum class RenderBackend { GLES, Vulkan };
+
+/**
+ * Vulkan instead of initRenderer(), on a thread without a GL context (builds
+ * with -DLIVE2D_VULKAN=ON, see live2d_vulkan.h). False when the build has no
+ * Vulkan backend or no usable driver was found: the caller then creates its GL
+ * context and calls initRenderer() as before. Dynamic resolution, the idle
+ * flipbook and stencil clipping are GLES-only and ignored on Vulkan.
+ */
+bool initRendererVulkan();
+
+/** Backend chosen by the last initRendererVulkan() / initRenderer(). */
+RenderBackend renderBackend();
+
+/**
+ * Vulkan: present to window from the next drawFrame (Android); nullptr draws
+ * into an offscreen image instead. Takes no reference. False on GLES.
+ */
+bool setVulkanWindow(ANativeWindow* window);
+
+/** Vulkan without a window: the last drawFrame, premultiplied RGBA8, top row first. */
+bool readFrameVulkan(std::vector<uint8_t>& rgba);
+
+/** Vulkan: wait for the GPU and destroy the device; the model must be loaded again. */
+void shutdownRendererVulkan();
+
+/**
+ * How clipping masks are applied. MaskTexture renders mask drawables into an
+ * offscreen alpha texture (soft edges); Stencil alpha-tests them into the stencil
+ * buffer of the current target and never switches framebuffers (hard edges,
+ * cheaper on tile-based GPUs). Auto picks Stencil on Mali / Adreno / PowerVR.
+ * Stencil needs a stencil buffer on the window surface (or dynamic resolution,
+ * whose offscreen target gets one); without it the mask texture is used.
+ */
+enum class ClipMode { Auto = 0, MaskTexture = 1, Stencil = 2 };
+
+void setClipMode(ClipMode mode);
+
+/** True when the last drawn frame clipped through the stencil buffer. */
+bool stencilClippingActive();
+
+/** Load a model3.json (asset path on Android, filesystem path elsewhere). */
+bool loadModel(const std::string& modelPath);
+
+bool isModelLoaded();
+
+/**
+ * Textures keep only the resolution the current on-screen scale needs (plus
+ * mipmaps) and are re-decoded when the zoom changes. Async (default) decodes on
+ * a worker thread and swaps the texture on a later frame; sync decodes inside
+ * drawFrame so the GL command stream is reproducible (benchmark / replay).
+ */
+void setTextureLodAsync(bool async);
+
+/**
+ * Lazy residency (default): at load only the textures used by drawables visible
+ * in the default pose are decoded. Others are uploaded when a drawable using
+ * them starts to fade in and released after 30 s without use. Call before
+ * loadModel; false decodes every texture at load and keeps it.
+ */
+void setLazyTextures(bool lazy);
+
+/**
+ * Dynamic resolution: the model is drawn into an offscreen target whose size
+ * follows the frame interval (the dt given to drawFrame) to stay within
+ * budgetMs, then upscaled to the surface in one pass. Off by default.
+ */
+void setDynamicResolution(bool enabled, float budgetMs);
+
+/**
+ * Low-power idle: once only the looping idle motion has been playing (no other
+ * motion or expression, unchanged parameter overrides, transform and viewport)
+ * for max(3 s, one loop), one loop is rendered into an atlas of `frames` cells
+ * at `scale` x the on-screen size and replayed as a single quad until any of
+ * those inputs changes. Off by default.
+ */
+void setIdleFlipbook(bool enabled, int frames, float scale);
+
+/**
+ * Native memory held for the loaded model, in bytes. GPU figures are estimates
+ * (RGBA8, +1/3 for a mip chain, no driver overhead).
+ */
+struct MemoryStats {
+    int64_t moc           = 0;  // revived moc3 (inside the bundle image when revived in place)
+    int64_t model         = 0;  // csmModel instance
+    int64_t bundle        = 0;  // .l2dbundle image (file-backed when mapped)
+    int64_t textures      = 0;  // GPU: model textures
+    int64_t pendingPixels = 0;  // CPU: decoded texture LOD waiting for upload
+    int64_t renderTargets = 0;  // GPU: mask, scene and idle flipbook targets
+    int64_t motions       = 0;  // parsed idle + active motion
+    int64_t expressions   = 0;
+    int64_t physics       = 0;
+    int64_t caches        = 0;  // frame arena, model metadata, parameter tables
+    int64_t total() const {
+        return moc + model + bundle + textures + pendingPixels + renderTargets
+             + motions + expressions + physics + caches;
+    }
+};
+
+MemoryStats memoryStats();
+
+/**
+ * How much trimMemory() gives back. Each level includes the ones below.
+ *   Caches:   idle flipbook atlas, finished motion, frame arena block
+ *   Textures: textures one LOD step down, textures unused in the last frame,
+ *             expressions not in use
+ *   Critical: textures at the smallest LOD
+ * Dropped data is reloaded on demand. For 60 s after a trim, textures are not
+ * upgraded past the trimmed size and the idle flipbook is not re-baked.
+ */
+enum class TrimLevel { Caches = 1, Textures = 2, Critical = 3 };
+
+/** Release memory under pressure (Android onTrimMemory, iOS memory warning). */
+void trimMemory(TrimLevel level);
+
+/** Update viewport size and projection. */
+void setViewportSize(int width, int height);
+
+/** Seconds elapsed since the previous call, clamped to 0.1s (1/60 on the first frame). */
+float frameDeltaTime();
+
+/** Clear the surface and render one frame advanced by dt seconds. */
+void drawFrame(float dt);
+
+const FrameStats& lastFrameStats();
+
+/**
+ * Surface-space bounds of everything drawn by the last drawFrame (union of
+ * visible drawables' AABBs). The host can use it to fit an overlay window to
+ * the model.
+ */
+ScreenRect modelScreenBounds();
+
+/**
+ * Asynchronous snapshot of the model. The request is rendered at the end of the
+ * next drawFrame into an offscreen target of width x height (0 = surface size),
+ * with the on-screen framing (projection, zoom, pan) fitted inside it at the
+ * same aspect. background is 0xAARRGGBB put under the model; 0 keeps it
+ * transparent. On GLES3 the pixels are copied into a pixel pack buffer behind
+ * a fence and mapped on a later drawFrame once the fence has signaled, so no
+ * frame waits for the GPU (after 8 frames it is mapped anyway). GLES2 has no
+ * pack buffers: the target is read at the start of the following drawFrame,
+ * before that frame's commands, so it waits at most for the previous frame.
+ * Returns the request id, 0 when no model is loaded or 4 snapshots are pending.
+ */
+int requestSnapshot(int width, int height, uint32_t background = 0);
+
+struct Snapshot {
+    int id = 0;
+    int width = 0, height = 0;
+    std::vector<uint8_t> rgba;   // premultiplied RGBA8, top row first; empty when it failed
+    int    frames = 0;           // drawFrame calls from the request to delivery
+    double latencyMs = 0;        // wall clock from the request to delivery
+};
+
+/**
+ * Oldest finished snapshot (in order of completion); false when none is ready.
+ * Call after drawFrame. Snapshots still pending when initRenderer() runs, and
+ * requests that find no model loaded when they are rendered, come back empty.
+ */
+bool pollSnapshot(Snapshot& out);
+
+/**
+ * The loaded model's pose from the last drawFrame, rendered on the CPU
+ * (live2d_raster.h) at the surface size with the same projection: premultiplied
+ * RGBA8, top row first, transparent background. Resident textures are decoded
+ * again at their current LOD, so this costs a load's worth of PNG decoding; it
+ * is meant as a reference image, not a per-frame path. threads 0 = all cores (max 8).
+ */
+bool rasterizeFrame(std::vector<uint8_t>& rgba, int threads = 0);
+
+/**
+ * Thumbnail of a model3.json or .l2dbundle in its default pose (default
+ * parameters, first part of each pose group, no motion or physics), the canvas
+ * fitted into width x height. Output as rasterizeFrame. Loads its own copy of
+ * the moc and decodes only the textures the default pose uses, at a size the
+ * thumbnail needs; touches no renderer state, so it can run on any thread,
+ * also while a model is being drawn. Interlaced PNGs are not drawn.
+ */
+bool renderModelThumbnail(const std::string& modelPath, int width, int height,
+                          std::vector<uint8_t>& rgba, int threads = 0);
+
+/**
+ * Model information for the host, serialized once per load (empty when no
+ * model is loaded). Little endian; str = u16 byte length + UTF-8:
+ *   "L2DMINFO" u32 version, f32 canvasWidth, f32 canvasHeight (pixels)
+ *   u32 n, n x { str group, u32 k, k x str file }        motion groups
+ *   u32 n, n x str name                                   expressions
+ *   u32 n, n x { str id, str name }                       hit areas
+ *   u32 n, n x { str target, str name, u32 k, k x str id } groups (LipSync, EyeBlink)
+ *   u32 n, n x { str id, f32 min, f32 max, f32 default }  parameters
+ *   u32 n, n x { str id, i32 parent }                     parts
+ */
+static const uint32_t kModelMetadataVersion = 1;
+const std::vector<uint8_t>& modelMetadata();
+
+void startMotion(const std::string& group, int index, int priority);
+
+/** Apply an expression by name. Empty string fades out the current one. */
+void setExpression(const std::string& expressionId);
+
+/** Override a parameter after animation. weight < 0.001 removes the override. */
+void setParameterOverride(const char* paramId, float value, float weight);
+
+float getParameterValue(const char* paramId);
+
+/** max - min of the parameter, 1 if not found. */
+float getParameterRange(const char* paramId);
+
+/** User zoom & pan; offsets are in NDC (-1..1). */
+void setModelTransform(float scale, float offsetX, float offsetY);
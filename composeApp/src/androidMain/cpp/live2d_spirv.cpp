@@ -0,0 +1,300 @@
+#include "live2d_spirv.h"
+
+#include <cstring>
+
+namespace {
+
+// ===================== Assembler =====================
+// 只用到的操作码 / 枚举值 (SPIR-V 1.0 规范, GLSL.std.450 扩展指令集)
+
+enum Op : uint32_t {
+    OpExtInstImport = 11, OpExtInst = 12, OpMemoryModel = 14, OpEntryPoint = 15,
+    OpExecutionMode = 16, OpCapability = 17,
+    OpTypeVoid = 19, OpTypeInt = 21, OpTypeFloat = 22, OpTypeVector = 23, OpTypeMatrix = 24,
+    OpTypeImage = 25, OpTypeSampledImage = 27, OpTypeStruct = 30, OpTypePointer = 32,
+    OpTypeFunction = 33,
+    OpConstant = 43, OpConstantComposite = 44,
+    OpFunction = 54, OpFunctionEnd = 56,
+    OpVariable = 59, OpLoad = 61, OpStore = 62, OpAccessChain = 65,
+    OpDecorate = 71, OpMemberDecorate = 72,
+    OpVectorShuffle = 79, OpCompositeConstruct = 80, OpCompositeExtract = 81,
+    OpImageSampleImplicitLod = 87,
+    OpFAdd = 129, OpFSub = 131, OpFMul = 133, OpVectorTimesScalar = 142, OpMatrixTimesVector = 145,
+    OpLabel = 248, OpReturn = 253,
+};
+
+enum : uint32_t {
+    kCapabilityShader = 1,
+    kAddressingLogical = 0, kMemoryModelGLSL450 = 1,
+    kExecutionModelVertex = 0, kExecutionModelFragment = 4,
+    kExecutionModeOriginUpperLeft = 7,
+    kFunctionControlNone = 0,
+    kDecorationBlock = 2, kDecorationColMajor = 5, kDecorationMatrixStride = 7,
+    kDecorationBuiltIn = 11, kDecorationLocation = 30, kDecorationBinding = 33,
+    kDecorationDescriptorSet = 34, kDecorationOffset = 35,
+    kBuiltInPosition = 0, kBuiltInFragCoord = 15,
+    kStorageUniformConstant = 0, kStorageInput = 1, kStorageOutput = 3, kStoragePushConstant = 9,
+    kDim2D = 1, kImageFormatUnknown = 0,
+    kGlslFClamp = 43, kGlslFMix = 46,
+};
+
+using Words = std::vector<uint32_t>;
+
+static void appendString(Words& words, const char* s) {
+    size_t n = strlen(s) + 1;                 // 含结尾 0, 按 4 字节补齐
+    size_t start = words.size();
+    words.resize(start + (n + 3) / 4, 0u);
+    memcpy(words.data() + start, s, n);
+}
+
+// 按模块的段 (头部 / 入口 / 注解 / 类型与全局变量 / 函数) 分别收集指令, 最后按规定顺序拼接
+class Module {
+public:
+    uint32_t id() { return m_bound++; }
+
+    void header(Op op, const Words& operands) { emit(m_header, op, operands); }
+    void entry(Op op, const Words& operands) { emit(m_entry, op, operands); }
+    void annotate(Op op, const Words& operands) { emit(m_annotations, op, operands); }
+
+    // 类型: 结果 id 在第一个操作数
+    uint32_t type(Op op, const Words& operands) {
+        uint32_t r = id();
+        Words words = { r };
+        words.insert(words.end(), operands.begin(), operands.end());
+        emit(m_types, op, words);
+        return r;
+    }
+    // 常量 / 全局变量: 结果类型, 结果 id, 操作数
+    uint32_t global(Op op, uint32_t resultType, const Words& operands) { return typed(m_types, op, resultType, operands); }
+    uint32_t constant(uint32_t floatType, float v) {
+        uint32_t bits; memcpy(&bits, &v, 4);
+        return global(OpConstant, floatType, { bits });
+    }
+
+    // 函数体
+    uint32_t op(Op op, uint32_t resultType, const Words& operands) { return typed(m_code, op, resultType, operands); }
+    void opVoid(Op op, const Words& operands) { emit(m_code, op, operands); }
+
+    Words finish() const {
+        Words out = { 0x07230203u, 0x00010000u, 0u, m_bound, 0u };
+        for (const Words* s : { &m_header, &m_entry, &m_annotations, &m_types, &m_code })
+            out.insert(out.end(), s->begin(), s->end());
+        return out;
+    }
+
+private:
+    static void emit(Words& dst, Op op, const Words& operands) {
+        dst.push_back(((uint32_t)(operands.size() + 1) << 16) | op);
+        dst.insert(dst.end(), operands.begin(), operands.end());
+    }
+    uint32_t typed(Words& dst, Op op, uint32_t resultType, const Words& operands) {
+        uint32_t r = id();
+        Words words = { resultType, r };
+        words.insert(words.end(), operands.begin(), operands.end());
+        emit(dst, op, words);
+        return r;
+    }
+
+    uint32_t m_bound = 1;
+    Words m_header, m_entry, m_annotations, m_types, m_code;
+};
+
+// ===================== Shared Declarations =====================
+
+// VulkanPushConstants 的成员下标 (两个阶段都声明整个块)
+enum PushMember : uint32_t { kPcMatrix, kPcMultiply, kPcScreen, kPcOpacity, kPcStraight, kPcInvert, kPcPad, kPcMaskScale, kPcCount };
+
+struct Decls {
+    uint32_t glsl = 0;
+    uint32_t tVoid = 0, tFloat = 0, tInt = 0, tVec2 = 0, tVec4 = 0, tMat4 = 0;
+    uint32_t pInVec2 = 0, pInVec4 = 0, pOutVec4 = 0;
+    uint32_t pPcFloat = 0, pPcVec2 = 0, pPcVec4 = 0, pPcMat4 = 0;
+    uint32_t pc = 0;
+    uint32_t index[kPcCount] = {};   // AccessChain 下标常量
+    uint32_t zero = 0, one = 0;
+    uint32_t main = 0;
+};
+
+Decls declare(Module& m) {
+    Decls d;
+    m.header(OpCapability, { kCapabilityShader });
+    d.glsl = m.id();
+    Words imp = { d.glsl };
+    appendString(imp, "GLSL.std.450");
+    m.header(OpExtInstImport, imp);
+    m.header(OpMemoryModel, { kAddressingLogical, kMemoryModelGLSL450 });
+
+    d.tVoid  = m.type(OpTypeVoid, {});
+    d.tFloat = m.type(OpTypeFloat, { 32 });
+    d.tInt   = m.type(OpTypeInt, { 32, 1 });
+    d.tVec2  = m.type(OpTypeVector, { d.tFloat, 2 });
+    d.tVec4  = m.type(OpTypeVector, { d.tFloat, 4 });
+    d.tMat4  = m.type(OpTypeMatrix, { d.tVec4, 4 });
+    d.pInVec2  = m.type(OpTypePointer, { kStorageInput, d.tVec2 });
+    d.pInVec4  = m.type(OpTypePointer, { kStorageInput, d.tVec4 });
+    d.pOutVec4 = m.type(OpTypePointer, { kStorageOutput, d.tVec4 });
+
+    // 推送常量块, 偏移与 VulkanPushConstants 一致
+    uint32_t block = m.type(OpTypeStruct, { d.tMat4, d.tVec4, d.tVec4, d.tFloat, d.tFloat, d.tFloat, d.tFloat, d.tVec2 });
+    static const uint32_t kOffsets[kPcCount] = { 0, 64, 80, 96, 100, 104, 108, 112 };
+    m.annotate(OpDecorate, { block, kDecorationBlock });
+    for (uint32_t i = 0; i < kPcCount; i++)
+        m.annotate(OpMemberDecorate, { block, i, kDecorationOffset, kOffsets[i] });
+    m.annotate(OpMemberDecorate, { block, kPcMatrix, kDecorationColMajor });
+    m.annotate(OpMemberDecorate, { block, kPcMatrix, kDecorationMatrixStride, 16 });
+    uint32_t pBlock = m.type(OpTypePointer, { kStoragePushConstant, block });
+    d.pPcFloat = m.type(OpTypePointer, { kStoragePushConstant, d.tFloat });
+    d.pPcVec2  = m.type(OpTypePointer, { kStoragePushConstant, d.tVec2 });
+    d.pPcVec4  = m.type(OpTypePointer, { kStoragePushConstant, d.tVec4 });
+    d.pPcMat4  = m.type(OpTypePointer, { kStoragePushConstant, d.tMat4 });
+    d.pc = m.global(OpVariable, pBlock, { kStoragePushConstant });
+
+    for (uint32_t i = 0; i < kPcCount; i++) d.index[i] = m.global(OpConstant, d.tInt, { i });
+    d.zero = m.constant(d.tFloat, 0.f);
+    d.one  = m.constant(d.tFloat, 1.f);
+    d.main = m.id();
+    return d;
+}
+
+uint32_t variable(Module& m, uint32_t pointerType, uint32_t storage) { return m.global(OpVariable, pointerType, { storage }); }
+
+void beginMain(Module& m, const Decls& d) {
+    uint32_t fnType = m.type(OpTypeFunction, { d.tVoid });
+    m.opVoid(OpFunction, { d.tVoid, d.main, kFunctionControlNone, fnType });
+    m.opVoid(OpLabel, { m.id() });
+}
+
+void endMain(Module& m) {
+    m.opVoid(OpReturn, {});
+    m.opVoid(OpFunctionEnd, {});
+}
+
+uint32_t loadPush(Module& m, const Decls& d, PushMember member, uint32_t type, uint32_t pointerType) {
+    uint32_t p = m.op(OpAccessChain, pointerType, { d.pc, d.index[member] });
+    return m.op(OpLoad, type, { p });
+}
+
+// ===================== Vertex =====================
+
+Words vertexShader() {
+    Module m;
+    Decls d = declare(m);
+    uint32_t inPos = variable(m, d.pInVec2, kStorageInput);
+    uint32_t inUv  = variable(m, d.pInVec2, kStorageInput);
+    uint32_t pOutVec2 = m.type(OpTypePointer, { kStorageOutput, d.tVec2 });
+    uint32_t outUv  = variable(m, pOutVec2, kStorageOutput);
+    uint32_t outPos = variable(m, d.pOutVec4, kStorageOutput);
+
+    Words ep = { kExecutionModelVertex, d.main };
+    appendString(ep, "main");
+    ep.insert(ep.end(), { inPos, inUv, outUv, outPos });
+    m.entry(OpEntryPoint, ep);
+    m.annotate(OpDecorate, { inPos, kDecorationLocation, 0 });
+    m.annotate(OpDecorate, { inUv, kDecorationLocation, 1 });
+    m.annotate(OpDecorate, { outUv, kDecorationLocation, 0 });
+    m.annotate(OpDecorate, { outPos, kDecorationBuiltIn, kBuiltInPosition });
+
+    beginMain(m, d);
+    uint32_t p  = m.op(OpLoad, d.tVec2, { inPos });
+    uint32_t px = m.op(OpCompositeExtract, d.tFloat, { p, 0 });
+    uint32_t py = m.op(OpCompositeExtract, d.tFloat, { p, 1 });
+    uint32_t p4 = m.op(OpCompositeConstruct, d.tVec4, { px, py, d.zero, d.one });
+    uint32_t mat = loadPush(m, d, kPcMatrix, d.tMat4, d.pPcMat4);
+    m.opVoid(OpStore, { outPos, m.op(OpMatrixTimesVector, d.tVec4, { mat, p4 }) });
+    m.opVoid(OpStore, { outUv, m.op(OpLoad, d.tVec2, { inUv }) });
+    endMain(m);
+    return m.finish();
+}
+
+// ===================== Fragment =====================
+
+Words fragmentShader(SpirvShader kind) {
+    Module m;
+    Decls d = declare(m);
+    const bool masked = kind == SpirvShader::DrawMasked;
+
+    uint32_t tImage   = m.type(OpTypeImage, { d.tFloat, kDim2D, 0, 0, 0, 1, kImageFormatUnknown });
+    uint32_t tSampled = m.type(OpTypeSampledImage, { tImage });
+    uint32_t pSampled = m.type(OpTypePointer, { kStorageUniformConstant, tSampled });
+    uint32_t texture  = variable(m, pSampled, kStorageUniformConstant);
+    uint32_t inUv     = variable(m, d.pInVec2, kStorageInput);
+    uint32_t outColor = variable(m, d.pOutVec4, kStorageOutput);
+    uint32_t mask = 0, fragCoord = 0;
+    if (masked) {
+        mask = variable(m, pSampled, kStorageUniformConstant);
+        fragCoord = variable(m, d.pInVec4, kStorageInput);
+    }
+
+    Words ep = { kExecutionModelFragment, d.main };
+    appendString(ep, "main");
+    ep.insert(ep.end(), { inUv, outColor });
+    if (masked) ep.push_back(fragCoord);
+    m.entry(OpEntryPoint, ep);
+    m.entry(OpExecutionMode, { d.main, kExecutionModeOriginUpperLeft });
+    m.annotate(OpDecorate, { texture, kDecorationDescriptorSet, 0 });
+    m.annotate(OpDecorate, { texture, kDecorationBinding, 0 });
+    m.annotate(OpDecorate, { inUv, kDecorationLocation, 0 });
+    m.annotate(OpDecorate, { outColor, kDecorationLocation, 0 });
+    if (masked) {
+        m.annotate(OpDecorate, { mask, kDecorationDescriptorSet, 1 });
+        m.annotate(OpDecorate, { mask, kDecorationBinding, 0 });
+        m.annotate(OpDecorate, { fragCoord, kDecorationBuiltIn, kBuiltInFragCoord });
+    }
+    uint32_t zero4 = 0, one4 = 0;
+    if (kind != SpirvShader::Mask) {
+        zero4 = m.global(OpConstantComposite, d.tVec4, { d.zero, d.zero, d.zero, d.zero });
+        one4  = m.global(OpConstantComposite, d.tVec4, { d.one, d.one, d.one, d.one });
+    }
+
+    beginMain(m, d);
+    uint32_t uv = m.op(OpLoad, d.tVec2, { inUv });
+    uint32_t c  = m.op(OpImageSampleImplicitLod, d.tVec4, { m.op(OpLoad, tSampled, { texture }), uv });
+    uint32_t a  = m.op(OpCompositeExtract, d.tFloat, { c, 3 });
+    uint32_t opacity = loadPush(m, d, kPcOpacity, d.tFloat, d.pPcFloat);
+
+    if (kind == SpirvShader::Mask) {
+        // 遮罩: a = texture.a * opacity
+        uint32_t v = m.op(OpFMul, d.tFloat, { a, opacity });
+        m.opVoid(OpStore, { outColor, m.op(OpCompositeConstruct, d.tVec4, { v, v, v, v }) });
+        endMain(m);
+        return m.finish();
+    }
+
+    // straight alpha -> 预乘: c.rgb *= mix(1, c.a, straight)
+    uint32_t straight = loadPush(m, d, kPcStraight, d.tFloat, d.pPcFloat);
+    uint32_t k  = m.op(OpExtInst, d.tFloat, { d.glsl, kGlslFMix, d.one, a, straight });
+    c = m.op(OpFMul, d.tVec4, { c, m.op(OpCompositeConstruct, d.tVec4, { k, k, k, d.one }) });
+
+    if (masked) {
+        // 遮罩与目标同尺寸, 按片段坐标采样; 反转: mix(m, 1 - m, invert)
+        uint32_t fc    = m.op(OpLoad, d.tVec4, { fragCoord });
+        uint32_t xy    = m.op(OpVectorShuffle, d.tVec2, { fc, fc, 0, 1 });
+        uint32_t scale = loadPush(m, d, kPcMaskScale, d.tVec2, d.pPcVec2);
+        uint32_t muv   = m.op(OpFMul, d.tVec2, { xy, scale });
+        uint32_t mv    = m.op(OpImageSampleImplicitLod, d.tVec4, { m.op(OpLoad, tSampled, { mask }), muv });
+        uint32_t mr    = m.op(OpCompositeExtract, d.tFloat, { mv, 0 });
+        uint32_t inv   = loadPush(m, d, kPcInvert, d.tFloat, d.pPcFloat);
+        uint32_t mi    = m.op(OpFSub, d.tFloat, { d.one, mr });
+        uint32_t mval  = m.op(OpExtInst, d.tFloat, { d.glsl, kGlslFMix, mr, mi, inv });
+        c = m.op(OpVectorTimesScalar, d.tVec4, { c, mval });
+    }
+
+    // multiply (w = 1) 与 screen (w = 0): 与 GLES 着色器只改 rgb 等价
+    uint32_t multiply = loadPush(m, d, kPcMultiply, d.tVec4, d.pPcVec4);
+    c = m.op(OpFMul, d.tVec4, { c, multiply });
+    uint32_t screen = loadPush(m, d, kPcScreen, d.tVec4, d.pPcVec4);
+    uint32_t ca  = m.op(OpCompositeExtract, d.tFloat, { c, 3 });
+    uint32_t sum = m.op(OpFAdd, d.tVec4, { c, m.op(OpVectorTimesScalar, d.tVec4, { screen, ca }) });
+    uint32_t scr = m.op(OpFSub, d.tVec4, { sum, m.op(OpFMul, d.tVec4, { c, screen }) });
+    c = m.op(OpExtInst, d.tVec4, { d.glsl, kGlslFClamp, scr, zero4, one4 });
+
+    m.opVoid(OpStore, { outColor, m.op(OpVectorTimesScalar, d.tVec4, { c, opacity }) });
+    endMain(m);
+    return m.finish();
+}
+
+} // namespace
+
+std::vector<uint32_t> buildSpirvShader(SpirvShader shader) {
+    return shader == SpirvShader::Vertex ? vertexShader() : fragmentShader(shader);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// SPIR-V for the Vulkan backend (live2d_vulkan.h), emitted as words at init so
+// the build needs no shader compiler. The shaders are the GLES draw / mask
+// shaders of live2d_renderer.cpp with the #define permutations turned into
+// push constants (straight alpha, inverted mask, multiply / screen colors that
+// default to the identity); only "masked" changes the interface, so it stays a
+// separate module.
+//
+// Interface shared by all modules:
+//   vertex input  location 0 = position (vec2, model units), location 1 = uv
+//   set 0 binding 0 = drawable texture, set 1 binding 0 = mask (R8, .r)
+//   push constants = VulkanPushConstants, one range for both stages
+
+#include <cstdint>
+#include <vector>
+
+enum class SpirvShader {
+    Vertex,       // gl_Position = matrix * vec4(position, 0, 1)
+    Mask,         // texture.a * opacity into every channel
+    Draw,         // drawable color, no mask
+    DrawMasked,   // drawable color x mask sampled at gl_FragCoord * maskScale
+};
+
+struct VulkanPushConstants {
+    float matrix[16];     // column-major model -> clip space
+    float multiply[4];    // w = 1
+    float screen[4];      // w = 0
+    float opacity;
+    float straightAlpha;  // 1: premultiply the texel in the shader
+    float invertMask;     // 1: use 1 - mask
+    float pad;
+    float maskScale[2];   // 1 / mask size in pixels
+};
+static_assert(sizeof(VulkanPushConstants) == 120, "push constant block layout");
+
+std::vector<uint32_t> buildSpirvShader(SpirvShader shader);
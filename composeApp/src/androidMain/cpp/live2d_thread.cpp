@@ -0,0 +1,768 @@
+#include "live2d_thread.h"
+#include "live2d_gl.h"
+#include "live2d_log.h"
+
+#include <EGL/eglext.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <pthread.h>
+
+#ifdef __ANDROID__
+#include <android/choreographer.h>
+#include <android/looper.h>
+#include <android/native_window.h>
+#include <dlfcn.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#ifndef EGL_OPENGL_ES3_BIT_KHR
+#define EGL_OPENGL_ES3_BIT_KHR 0x0040
+#endif
+
+// ===================== State =====================
+
+static RenderThreadConfig g_config;
+static std::thread        g_thread;
+static std::thread::id    g_threadId;
+static std::atomic<bool>  g_running{false};
+
+// 任务队列与线程启动 / 退出, 受 g_taskMutex 保护
+static std::mutex              g_taskMutex;
+static std::condition_variable g_taskCv;
+struct RenderTask {
+    std::function<void()> run;
+    std::function<void()> drop;   // 线程退出时仍未执行: 释放任务持有的资源
+};
+static std::vector<RenderTask> g_tasks;
+static std::vector<RenderTask> g_taskBatch;              // 渲染线程正在执行的一批 (复用容量)
+static bool g_quit = false;
+static int  g_startState = 0;                            // 0 启动中, 1 就绪, -1 失败
+
+static std::atomic<bool>    g_paused{false};
+static std::atomic<int>     g_frameInterval{1};
+static std::atomic<int64_t> g_hostCalls{0};
+
+// 以下只在渲染线程访问
+struct EglState {
+    EGLDisplay display  = EGL_NO_DISPLAY;
+    EGLConfig  config   = nullptr;
+    EGLContext context  = EGL_NO_CONTEXT;
+    EGLSurface fallback = EGL_NO_SURFACE;   // 1x1 pbuffer: 没有窗口时保持上下文可用
+    EGLSurface surface  = EGL_NO_SURFACE;   // 窗口 (Linux 上为同尺寸 pbuffer)
+    bool       ownDisplay = false;
+};
+static EglState            g_egl;
+static EGLNativeWindowType g_window{};
+static bool    g_hasWindow = false;
+static bool    g_surfaceOk = false;         // 有窗口且窗口表面可用
+static bool    g_vulkan = false;            // Vulkan 后端: 没有 EGL 上下文, 窗口是交换链
+static int     g_windowW = 0, g_windowH = 0;
+static std::string g_modelPath;              // 上下文丢失后重新加载
+static int64_t g_periodNs = 16666667;        // vsync 间隔 (Android 上按回调间隔估计)
+static int64_t g_lastVsyncNs = 0;            // 上一次 vsync 回调
+static int64_t g_lastFrameVsyncNs = 0;       // 上一帧对应的 vsync
+static int     g_vsyncsSinceFrame = 0;
+static int     g_tasksSinceFrame = 0;
+static std::vector<std::pair<int, std::function<void(Snapshot&)>>> g_snapshotCallbacks;
+
+// 统计与上一帧的模型范围, 任意线程读取
+static std::mutex        g_statsMutex;
+static RenderThreadStats g_stats;
+static ScreenRect        g_bounds;
+
+static int64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void countStat(int RenderThreadStats::*field) {
+    std::lock_guard<std::mutex> lock(g_statsMutex);
+    g_stats.*field += 1;
+}
+
+// ===================== Host Inputs =====================
+// 原先由 Kotlin 每帧通过 JNI 写入 (Live2DManager.onFrameUpdate), 现在宿主只在值变化时写入,
+// 渲染线程在每帧 drawFrame 前自己应用。视线平滑与 GazeController.kt 相同 (指数衰减, 帧率无关)。
+
+static const float kGazeSmoothSpeed = 15.f;
+static const float kGazeSnap = 0.005f;
+
+struct HostInputs {
+    float    lipSync = 0.f;
+    std::vector<std::string> lipSyncIds{"ParamMouthOpenY"};
+    uint32_t lipSyncVersion = 1;
+    float    gazeX = 0.f, gazeY = 0.f;     // 目标
+    bool     clearGaze = false;            // 目标改为当前视线
+    bool     resetGaze = false;
+    bool     eyeTracking = true;
+};
+static std::mutex g_inputMutex;
+static HostInputs g_inputs;
+
+// 渲染线程的副本
+static std::vector<std::string> g_lipSyncIds;
+static uint32_t g_lipSyncVersion = 0;
+static float    g_gazeX = 0.f, g_gazeY = 0.f;   // 平滑后的当前视线
+static bool     g_gazeApplied = false;
+
+static const char* const kGazeParams[] = {
+    "ParamEyeBallX", "ParamEyeBallY", "ParamAngleX", "ParamAngleY", "ParamAngleZ", "ParamBodyAngleX",
+};
+
+static float smoothGaze(float current, float target, float factor) {
+    float diff = target - current;
+    return std::fabs(diff) < kGazeSnap ? target : current + diff * factor;
+}
+
+static void applyHostInputs(float dt) {
+    float lipSync, targetX, targetY;
+    bool tracking;
+    {
+        std::lock_guard<std::mutex> lock(g_inputMutex);
+        if (g_inputs.lipSyncVersion != g_lipSyncVersion) {
+            g_lipSyncIds = g_inputs.lipSyncIds;   // 只在换模型时分配
+            g_lipSyncVersion = g_inputs.lipSyncVersion;
+        }
+        if (g_inputs.resetGaze) {
+            g_gazeX = g_gazeY = 0.f;
+            g_inputs.resetGaze = false;
+        }
+        if (g_inputs.clearGaze) {
+            g_inputs.gazeX = g_gazeX;
+            g_inputs.gazeY = g_gazeY;
+            g_inputs.clearGaze = false;
+        }
+        lipSync = g_inputs.lipSync;
+        targetX = g_inputs.gazeX;
+        targetY = g_inputs.gazeY;
+        tracking = g_inputs.eyeTracking;
+    }
+    if (!isModelLoaded()) return;
+
+    for (const std::string& id : g_lipSyncIds) setParameterOverride(id.c_str(), lipSync, 1.f);
+
+    if (!tracking) {
+        // 关闭视线跟随: 去掉覆盖, 交还给动作
+        if (g_gazeApplied)
+            for (const char* id : kGazeParams) setParameterOverride(id, 0.f, 0.f);
+        g_gazeApplied = false;
+        g_gazeX = g_gazeY = 0.f;
+        return;
+    }
+    float factor = 1.f - std::exp(-kGazeSmoothSpeed * dt);
+    g_gazeX = smoothGaze(g_gazeX, targetX, factor);
+    g_gazeY = smoothGaze(g_gazeY, targetY, factor);
+    setParameterOverride("ParamEyeBallX", g_gazeX, 1.f);
+    setParameterOverride("ParamEyeBallY", g_gazeY, 1.f);
+    setParameterOverride("ParamAngleX", g_gazeX * 30.f, 1.f);
+    setParameterOverride("ParamAngleY", g_gazeY * 30.f, 1.f);
+    setParameterOverride("ParamAngleZ", g_gazeX * g_gazeY * -30.f, 1.f);
+    setParameterOverride("ParamBodyAngleX", g_gazeX * 10.f, 1.f);
+    g_gazeApplied = true;
+}
+
+void setLipSyncParameters(const std::vector<std::string>& ids) {
+    g_hostCalls++;
+    std::lock_guard<std::mutex> lock(g_inputMutex);
+    g_inputs.lipSyncIds = ids;
+    g_inputs.lipSyncVersion++;
+}
+
+void setLipSyncValue(float value) {
+    g_hostCalls++;
+    std::lock_guard<std::mutex> lock(g_inputMutex);
+    g_inputs.lipSync = value;
+}
+
+void setGazeTarget(float x, float y) {
+    g_hostCalls++;
+    std::lock_guard<std::mutex> lock(g_inputMutex);
+    g_inputs.gazeX = std::clamp(x, -1.f, 1.f);
+    g_inputs.gazeY = std::clamp(y, -1.f, 1.f);
+    g_inputs.clearGaze = false;
+}
+
+void clearGazeTarget() {
+    g_hostCalls++;
+    std::lock_guard<std::mutex> lock(g_inputMutex);
+    g_inputs.clearGaze = true;
+}
+
+void resetGaze() {
+    g_hostCalls++;
+    std::lock_guard<std::mutex> lock(g_inputMutex);
+    g_inputs.gazeX = g_inputs.gazeY = 0.f;
+    g_inputs.clearGaze = false;
+    g_inputs.resetGaze = true;
+}
+
+void setEyeTrackingEnabled(bool enabled) {
+    g_hostCalls++;
+    std::lock_guard<std::mutex> lock(g_inputMutex);
+    g_inputs.eyeTracking = enabled;
+    if (!enabled) {
+        g_inputs.gazeX = g_inputs.gazeY = 0.f;
+        g_inputs.clearGaze = false;
+    }
+}
+
+// ===================== EGL =====================
+
+#ifdef __ANDROID__
+static const EGLint kSurfaceTypes = EGL_WINDOW_BIT | EGL_PBUFFER_BIT;
+#else
+static const EGLint kSurfaceTypes = EGL_PBUFFER_BIT;
+#endif
+
+static bool chooseConfig(int version, EGLint stencil, EGLConfig& out) {
+    const EGLint attribs[] = {
+        EGL_SURFACE_TYPE, kSurfaceTypes,
+        EGL_RENDERABLE_TYPE, version >= 3 ? EGL_OPENGL_ES3_BIT_KHR : EGL_OPENGL_ES2_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_STENCIL_SIZE, stencil,   // 模板裁剪; 没有时渲染器改用遮罩纹理
+        EGL_NONE
+    };
+    EGLint n = 0;
+    return eglChooseConfig(g_egl.display, attribs, &out, 1, &n) && n > 0;
+}
+
+static bool createContext() {
+    if (g_egl.display == EGL_NO_DISPLAY) {
+        if (g_config.display != EGL_NO_DISPLAY) {
+            g_egl.display = g_config.display;
+        } else {
+            g_egl.display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+            if (g_egl.display == EGL_NO_DISPLAY || !eglInitialize(g_egl.display, nullptr, nullptr)) {
+                LOGE("Render thread: eglInitialize failed: 0x%x", eglGetError());
+                g_egl.display = EGL_NO_DISPLAY;
+                return false;
+            }
+            g_egl.ownDisplay = true;
+        }
+    }
+    eglBindAPI(EGL_OPENGL_ES_API);
+
+    int version = 0;
+    for (int v : {g_config.glesVersion >= 3 ? 3 : 2, 2}) {
+        if (!chooseConfig(v, 8, g_egl.config) && !chooseConfig(v, 0, g_egl.config)) continue;
+        const EGLint attribs[] = { EGL_CONTEXT_CLIENT_VERSION, v, EGL_NONE };
+        g_egl.context = eglCreateContext(g_egl.display, g_egl.config, EGL_NO_CONTEXT, attribs);
+        if (g_egl.context != EGL_NO_CONTEXT) { version = v; break; }
+        LOGW("Render thread: OpenGL ES %d context unavailable: 0x%x", v, eglGetError());
+    }
+    if (!version) { LOGE("Render thread: no OpenGL ES context"); return false; }
+
+    const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+    g_egl.fallback = eglCreatePbufferSurface(g_egl.display, g_egl.config, pbufferAttribs);
+    if (g_egl.fallback == EGL_NO_SURFACE ||
+        !eglMakeCurrent(g_egl.display, g_egl.fallback, g_egl.fallback, g_egl.context)) {
+        LOGE("Render thread: cannot make the context current: 0x%x", eglGetError());
+        return false;
+    }
+    countStat(&RenderThreadStats::contexts);
+    LOGI("Render thread: OpenGL ES %d context, %s", version, (const char*)g_gl->GetString(GL_RENDERER));
+    return true;
+}
+
+static void destroyWindowSurface() {
+    if (g_vulkan) { setVulkanWindow(nullptr); return; }
+    if (g_egl.surface == EGL_NO_SURFACE) return;
+    eglMakeCurrent(g_egl.display, g_egl.fallback, g_egl.fallback, g_egl.context);
+    eglDestroySurface(g_egl.display, g_egl.surface);
+    g_egl.surface = EGL_NO_SURFACE;
+}
+
+static void destroyContext() {
+    if (g_egl.display == EGL_NO_DISPLAY) return;
+    destroyWindowSurface();
+    eglMakeCurrent(g_egl.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (g_egl.fallback != EGL_NO_SURFACE) eglDestroySurface(g_egl.display, g_egl.fallback);
+    if (g_egl.context != EGL_NO_CONTEXT) eglDestroyContext(g_egl.display, g_egl.context);
+    g_egl.fallback = EGL_NO_SURFACE;
+    g_egl.context = EGL_NO_CONTEXT;
+}
+
+static bool createWindowSurface() {
+    if (g_vulkan) {
+        // 交换链在下一帧按视口尺寸创建; Linux 上渲染到离屏图像
+#ifdef __ANDROID__
+        if (!setVulkanWindow(g_window)) return false;
+#else
+        if (!setVulkanWindow(nullptr)) return false;
+#endif
+        countStat(&RenderThreadStats::windows);
+        return true;
+    }
+    if (!g_config.egl) { countStat(&RenderThreadStats::windows); return true; }
+    destroyWindowSurface();
+#ifdef __ANDROID__
+    EGLint format = 0;
+    eglGetConfigAttrib(g_egl.display, g_egl.config, EGL_NATIVE_VISUAL_ID, &format);
+    ANativeWindow_setBuffersGeometry(g_window, 0, 0, format);
+    g_egl.surface = eglCreateWindowSurface(g_egl.display, g_egl.config, g_window, nullptr);
+#else
+    const EGLint attribs[] = { EGL_WIDTH, g_windowW, EGL_HEIGHT, g_windowH, EGL_NONE };
+    g_egl.surface = eglCreatePbufferSurface(g_egl.display, g_egl.config, attribs);
+#endif
+    if (g_egl.surface == EGL_NO_SURFACE ||
+        !eglMakeCurrent(g_egl.display, g_egl.surface, g_egl.surface, g_egl.context)) {
+        LOGE("Render thread: cannot create the window surface: 0x%x", eglGetError());
+        destroyWindowSurface();
+        return false;
+    }
+    countStat(&RenderThreadStats::windows);
+    return true;
+}
+
+// ===================== Render Thread =====================
+
+static void wakeThread();
+
+static void loadModelNow(const std::string& path) {
+    bool ok = loadModel(path);
+    g_modelPath = ok ? path : std::string();
+    countStat(&RenderThreadStats::modelLoads);
+    if (g_config.onModelLoaded) g_config.onModelLoaded(path, ok);
+}
+
+static bool canRender() {
+    return g_surfaceOk && !g_paused.load(std::memory_order_relaxed);
+}
+
+static void attachWindow(EGLNativeWindowType window, int width, int height) {
+    // 另一个视图接管: 先放开旧窗口
+    if (g_hasWindow && window != g_window) {
+        destroyWindowSurface();
+#ifdef __ANDROID__
+        ANativeWindow_release(g_window);
+#endif
+        g_hasWindow = false;
+        g_surfaceOk = false;
+    }
+    bool sizeChanged = width != g_windowW || height != g_windowH;
+    g_windowW = width;
+    g_windowH = height;
+    if (!g_hasWindow) {
+        g_window = window;
+        g_hasWindow = true;
+        g_surfaceOk = createWindowSurface();
+        g_lastVsyncNs = g_lastFrameVsyncNs = 0;
+        g_vsyncsSinceFrame = 0;
+        sizeChanged = true;
+    } else {
+#ifdef __ANDROID__
+        ANativeWindow_release(window);   // 同一窗口: 调用方又取了一次引用
+#else
+        if (sizeChanged) g_surfaceOk = createWindowSurface();
+#endif
+    }
+    if (sizeChanged && width > 0 && height > 0) setViewportSize(width, height);
+}
+
+static void detachWindow() {
+    if (!g_hasWindow) return;
+    destroyWindowSurface();
+#ifdef __ANDROID__
+    ANativeWindow_release(g_window);
+#endif
+    g_window = EGLNativeWindowType{};
+    g_hasWindow = false;
+    g_surfaceOk = false;
+}
+
+// 上下文丢失 (驱动重置等): 重建上下文, 重新初始化渲染器并加载模型
+static void recoverContext() {
+    LOGW("Render thread: EGL context lost, recreating");
+    destroyContext();
+    if (!createContext()) { g_surfaceOk = false; return; }
+    initRenderer();
+    if (g_hasWindow) {
+        g_surfaceOk = createWindowSurface();
+        setViewportSize(g_windowW, g_windowH);
+    }
+    if (!g_modelPath.empty()) loadModelNow(g_modelPath);
+}
+
+static void runTasks() {
+    {
+        std::lock_guard<std::mutex> lock(g_taskMutex);
+        if (g_tasks.empty()) return;
+        std::swap(g_tasks, g_taskBatch);
+    }
+    for (auto& task : g_taskBatch) task.run();
+    int n = (int)g_taskBatch.size();
+    g_taskBatch.clear();
+    g_tasksSinceFrame += n;
+    std::lock_guard<std::mutex> lock(g_statsMutex);
+    g_stats.tasks += n;
+}
+
+static void deliverSnapshots() {
+    if (g_snapshotCallbacks.empty()) return;
+    Snapshot snap;
+    while (pollSnapshot(snap)) {
+        auto it = std::find_if(g_snapshotCallbacks.begin(), g_snapshotCallbacks.end(),
+                               [&](const auto& c) { return c.first == snap.id; });
+        if (it == g_snapshotCallbacks.end()) continue;
+        auto done = std::move(it->second);
+        g_snapshotCallbacks.erase(it);
+        done(snap);
+    }
+}
+
+static void renderFrame(int64_t vsyncNs) {
+    RenderFrameInfo info;
+    double t0 = nowNs() / 1e6;
+    info.startLateMs = t0 - vsyncNs / 1e6;
+    info.skippedVsyncs = g_lastFrameVsyncNs ? std::max(0, g_vsyncsSinceFrame - g_frameInterval.load()) : 0;
+    info.vsyncNs = vsyncNs;
+    float dt = g_lastFrameVsyncNs ? (float)((vsyncNs - g_lastFrameVsyncNs) / 1e9) : (float)(g_periodNs / 1e9);
+    info.dt = std::clamp(dt, 0.f, 0.1f);
+    g_lastFrameVsyncNs = vsyncNs;
+    g_vsyncsSinceFrame = 0;
+    info.tasks = g_tasksSinceFrame;
+    g_tasksSinceFrame = 0;
+
+    applyHostInputs(info.dt);
+    drawFrame(info.dt);
+    deliverSnapshots();
+    double t1 = nowNs() / 1e6;
+    bool lost = false;
+    if (g_config.egl && !g_vulkan && !eglSwapBuffers(g_egl.display, g_egl.surface)) {
+        EGLint err = eglGetError();
+        if (err == EGL_CONTEXT_LOST) {
+            lost = true;
+        } else {
+            // 窗口已失效 (通常紧接着会收到 surfaceDestroyed): 停止渲染, 等宿主重新设置窗口
+            LOGW("Render thread: eglSwapBuffers failed: 0x%x", err);
+            destroyWindowSurface();
+            g_surfaceOk = false;
+        }
+    }
+    double t2 = nowNs() / 1e6;
+    info.renderMs = t1 - t0;
+    info.swapMs = t2 - t1;
+    {
+        std::lock_guard<std::mutex> lock(g_statsMutex);
+        info.index = g_stats.frames++;
+        g_stats.skippedVsyncs += info.skippedVsyncs;
+        g_bounds = modelScreenBounds();
+    }
+    if (g_config.onFrame) g_config.onFrame(info);
+    if (lost) recoverContext();
+}
+
+// 每个 vsync 调用一次; 按帧间隔决定是否渲染
+static void onVsync(int64_t vsyncNs) {
+    int vsyncs = 1;
+    if (g_lastVsyncNs) {
+        int64_t d = vsyncNs - g_lastVsyncNs;
+        if (d <= 0) return;
+        vsyncs = std::max(1, (int)std::llround((double)d / g_periodNs));
+#ifdef __ANDROID__
+        // 单个 vsync 的回调间隔平滑估计刷新周期 (90 / 120 Hz 屏幕与切换刷新率)
+        if (vsyncs == 1) g_periodNs = (g_periodNs * 7 + d) / 8;
+#endif
+    }
+    g_lastVsyncNs = vsyncNs;
+    g_vsyncsSinceFrame += vsyncs;
+    if (g_vsyncsSinceFrame >= g_frameInterval.load(std::memory_order_relaxed)) renderFrame(vsyncNs);
+}
+
+#ifdef __ANDROID__
+// ALooper 上的事件循环: eventfd 唤醒执行任务, AChoreographer 回调渲染
+static int  g_wakeFd = -1;
+static bool g_vsyncPending = false;
+static AChoreographer* g_choreographer = nullptr;
+using PostFrameCallback64 = void (*)(AChoreographer*, AChoreographer_frameCallback64, void*);
+static PostFrameCallback64 g_postFrameCallback64 = nullptr;   // API 29+
+
+static void scheduleVsync();
+
+static void onFrameCallback64(int64_t frameTimeNanos, void*) {
+    g_vsyncPending = false;
+    if (canRender()) onVsync(frameTimeNanos);
+    scheduleVsync();
+}
+
+// API 26-28: 32 位进程中 long 时间戳会截断, 改用当前时间
+static void onFrameCallback(long frameTimeNanos, void*) {
+    onFrameCallback64(sizeof(long) >= 8 ? (int64_t)frameTimeNanos : nowNs(), nullptr);
+}
+
+static void scheduleVsync() {
+    if (g_vsyncPending || !canRender()) {
+        if (!canRender()) g_lastVsyncNs = g_lastFrameVsyncNs = 0;   // 恢复后第一帧 dt 为一个周期
+        return;
+    }
+    if (g_postFrameCallback64) g_postFrameCallback64(g_choreographer, onFrameCallback64, nullptr);
+    else AChoreographer_postFrameCallback(g_choreographer, onFrameCallback, nullptr);
+    g_vsyncPending = true;
+}
+
+static int onWake(int fd, int, void*) {
+    uint64_t v;
+    if (read(fd, &v, sizeof(v)) < 0) LOGW("Render thread: wake read failed");
+    runTasks();
+    scheduleVsync();
+    return 1;
+}
+
+static void eventLoop() {
+    ALooper* looper = ALooper_prepare(0);
+    g_choreographer = AChoreographer_getInstance();
+    g_postFrameCallback64 = (PostFrameCallback64)dlsym(RTLD_DEFAULT, "AChoreographer_postFrameCallback64");
+    ALooper_addFd(looper, g_wakeFd, 1, ALOOPER_EVENT_INPUT, onWake, nullptr);
+    scheduleVsync();
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(g_taskMutex);
+            if (g_quit) break;
+        }
+        ALooper_pollOnce(-1, nullptr, nullptr, nullptr);
+    }
+    ALooper_removeFd(looper, g_wakeFd);
+    g_choreographer = nullptr;
+    g_vsyncPending = false;
+}
+
+static void wakeThread() {
+    uint64_t one = 1;
+    if (g_wakeFd >= 0 && write(g_wakeFd, &one, sizeof(one)) < 0) LOGW("Render thread: wake write failed");
+}
+#else
+// 没有 choreographer: 按 timerHz 的节拍模拟 vsync, 等待期间随时执行新任务
+static void eventLoop() {
+    const int64_t period = (int64_t)(1e9 / std::max(1.f, g_config.timerHz));
+    g_periodNs = period;
+    int64_t next = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(g_taskMutex);
+            auto ready = [] { return g_quit || !g_tasks.empty(); };
+            if (!canRender()) {
+                next = 0;
+                g_lastVsyncNs = g_lastFrameVsyncNs = 0;   // 恢复后第一帧 dt 为一个周期
+                g_taskCv.wait(lock, [&] { return ready() || canRender(); });
+            } else if (next) {
+                auto deadline = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(next));
+                g_taskCv.wait_until(lock, deadline, ready);
+            }
+            if (g_quit) break;
+        }
+        runTasks();
+        if (!canRender()) continue;
+        int64_t now = nowNs();
+        if (!next) next = now;
+        if (now < next) continue;
+        int64_t vsync = next + (now - next) / period * period;   // 最近一个已过去的节拍
+        next = vsync + period;
+        onVsync(vsync);
+    }
+}
+
+static void wakeThread() {
+    // 经过一次加锁, 通知不会落在渲染线程检查条件与开始等待之间
+    { std::lock_guard<std::mutex> lock(g_taskMutex); }
+    g_taskCv.notify_all();
+}
+#endif
+
+static void threadMain() {
+    pthread_setname_np(pthread_self(), "live2d-render");
+    if (g_config.onThreadStart) g_config.onThreadStart();
+    // Vulkan 不可用时回退到 EGL / GLES
+    g_vulkan = g_config.vulkan && initRendererVulkan();
+    bool ok = g_vulkan || !g_config.egl || createContext();
+    if (ok && !g_vulkan) {
+        if (!g_config.shaderCacheDir.empty()) setShaderCacheDir(g_config.shaderCacheDir);
+        initRenderer();
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_taskMutex);
+        g_startState = ok ? 1 : -1;
+    }
+    g_taskCv.notify_all();
+    if (ok) {
+        eventLoop();
+        runTasks();
+        // 未完成的快照按失败交付, 等待方不会一直挂起
+        for (auto& c : g_snapshotCallbacks) { Snapshot empty; empty.id = c.first; c.second(empty); }
+        g_snapshotCallbacks.clear();
+    }
+    detachWindow();
+    if (g_vulkan) shutdownRendererVulkan();
+    else if (g_config.egl) destroyContext();
+    g_vulkan = false;
+    flushProgramCache();   // 写入线程在日志关闭之前结束
+    if (g_egl.ownDisplay) eglTerminate(g_egl.display);
+    g_egl = EglState();
+    if (g_config.onThreadExit) g_config.onThreadExit();
+}
+
+// ===================== Public API =====================
+
+bool startRenderThread(const RenderThreadConfig& config) {
+    if (g_thread.joinable()) return true;
+    g_config = config;
+    g_quit = false;
+    g_startState = 0;
+    g_modelPath.clear();
+    g_snapshotCallbacks.clear();
+    g_tasksSinceFrame = 0;
+    g_lipSyncVersion = 0;
+    g_gazeX = g_gazeY = 0.f;
+    g_gazeApplied = false;
+    {
+        std::lock_guard<std::mutex> lock(g_statsMutex);
+        g_stats = RenderThreadStats();
+        g_bounds = ScreenRect();
+    }
+#ifdef __ANDROID__
+    g_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (g_wakeFd < 0) { LOGE("Render thread: eventfd failed"); return false; }
+#endif
+    g_thread = std::thread(threadMain);
+    g_threadId = g_thread.get_id();
+    std::unique_lock<std::mutex> lock(g_taskMutex);
+    g_taskCv.wait(lock, [] { return g_startState != 0; });
+    if (g_startState < 0) {
+        lock.unlock();
+        g_thread.join();
+#ifdef __ANDROID__
+        close(g_wakeFd);
+        g_wakeFd = -1;
+#endif
+        return false;
+    }
+    g_running = true;
+    LOGI("Render thread started");
+    return true;
+}
+
+void stopRenderThread() {
+    if (!g_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(g_taskMutex);
+        g_quit = true;
+    }
+    wakeThread();
+    g_thread.join();
+    g_running = false;
+#ifdef __ANDROID__
+    close(g_wakeFd);
+    g_wakeFd = -1;
+#endif
+    std::vector<RenderTask> left;
+    {
+        std::lock_guard<std::mutex> lock(g_taskMutex);
+        left.swap(g_tasks);
+    }
+    for (auto& task : left) if (task.drop) task.drop();
+    LOGI("Render thread stopped");
+}
+
+bool renderThreadRunning() { return g_running; }
+
+bool postRenderTask(std::function<void()> task, std::function<void()> onDrop) {
+    g_hostCalls++;
+    {
+        std::lock_guard<std::mutex> lock(g_taskMutex);
+        if (!g_running || g_quit) { LOGW("Render thread not running, task dropped"); return false; }
+        g_tasks.push_back({std::move(task), std::move(onDrop)});
+    }
+    wakeThread();
+    return true;
+}
+
+void runRenderTask(std::function<void()> task) {
+    if (std::this_thread::get_id() == g_threadId) { task(); return; }
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> lock(g_taskMutex);
+        if (!g_running || g_quit) return;
+        auto finish = [&] {
+            std::lock_guard<std::mutex> l(doneMutex);
+            done = true;
+            doneCv.notify_all();
+        };
+        g_tasks.push_back({[&, finish] { task(); finish(); }, finish});
+    }
+    g_hostCalls++;
+    wakeThread();
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCv.wait(lock, [&] { return done; });
+}
+
+bool setRenderWindow(EGLNativeWindowType window, int width, int height) {
+    return postRenderTask([window, width, height] { attachWindow(window, width, height); },
+                          [window] {
+#ifdef __ANDROID__
+                              ANativeWindow_release(window);
+#else
+                              (void)window;
+#endif
+                          });
+}
+
+void releaseRenderWindow(EGLNativeWindowType window) {
+    runRenderTask([window] { if (g_hasWindow && g_window == window) detachWindow(); });
+}
+
+void setRenderPaused(bool paused) {
+    g_hostCalls++;
+    g_paused = paused;
+    wakeThread();
+}
+
+void setRenderFrameInterval(int vsyncs) {
+    g_hostCalls++;
+    g_frameInterval = std::clamp(vsyncs, 1, 8);
+}
+
+void renderThreadLoadModel(const std::string& path, bool force) {
+    postRenderTask([path, force] {
+        if (!force && isModelLoaded() && path == g_modelPath) {
+            if (g_config.onModelLoaded) g_config.onModelLoaded(path, true);
+            return;
+        }
+        loadModelNow(path);
+    });
+}
+
+void renderThreadSnapshot(int width, int height, uint32_t background, std::function<void(Snapshot&)> done) {
+    // 请求被拒绝或任务未执行: 立即按失败交付, 等待方不会一直挂起
+    auto cb = std::make_shared<std::function<void(Snapshot&)>>(std::move(done));
+    auto fail = [cb] { Snapshot empty; (*cb)(empty); };
+    bool posted = postRenderTask([width, height, background, cb, fail] {
+        int id = requestSnapshot(width, height, background);
+        if (!id) { fail(); return; }
+        g_snapshotCallbacks.emplace_back(id, std::move(*cb));
+    }, fail);
+    if (!posted) fail();
+}
+
+ScreenRect renderThreadModelBounds() {
+    std::lock_guard<std::mutex> lock(g_statsMutex);
+    return g_bounds;
+}
+
+RenderThreadStats renderThreadStats() {
+    std::lock_guard<std::mutex> lock(g_statsMutex);
+    RenderThreadStats s = g_stats;
+    s.hostCalls = g_hostCalls.load();
+    return s;
+}
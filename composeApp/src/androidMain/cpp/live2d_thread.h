@@ -0,0 +1,143 @@
+#pragma once
+
+// Native render thread: owns the EGL context and its surfaces and drives the
+// renderer (live2d_renderer.h) once per display vsync, so the host never calls
+// into native code per frame. The host posts work (postRenderTask) and surface
+// lifecycle events; per-frame inputs (lip sync, gaze) are stored here and
+// applied by the thread before every drawFrame.
+//
+// Pacing: AChoreographer frame callbacks on Android (the thread runs an
+// ALooper), a timer at RenderThreadConfig::timerHz elsewhere. dt is the time
+// between the vsyncs two frames were rendered for, not the wall clock, so
+// animation stays smooth when a frame starts late.
+//
+// The EGL context lives as long as the thread: a surface that goes away only
+// drops the window surface (a 1x1 pbuffer keeps the context current), so the
+// model and its textures survive the app going to the background. A lost
+// context is recreated and the model reloaded.
+//
+// With RenderThreadConfig::vulkan the thread first tries initRendererVulkan();
+// the window then becomes a swapchain presented inside drawFrame and no EGL
+// context is created. When Vulkan is unavailable the thread falls back to EGL.
+//
+// All functions may be called from any thread unless noted.
+
+#include "live2d_renderer.h"
+
+#include <EGL/egl.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/** One rendered frame, passed to RenderThreadConfig::onFrame. */
+struct RenderFrameInfo {
+    int     index = 0;          // frames rendered since the thread started
+    int64_t vsyncNs = 0;        // CLOCK_MONOTONIC timestamp of the vsync the frame was rendered for
+    float   dt = 0;             // seconds since the previous frame's vsync (max 0.1)
+    int     skippedVsyncs = 0;  // vsyncs missed since the previous frame, beyond the frame interval
+    double  startLateMs = 0;    // from the vsync to the start of the frame
+    double  renderMs = 0;       // host inputs + drawFrame
+    double  swapMs = 0;         // eglSwapBuffers (0 on Vulkan: presented inside drawFrame)
+    int     tasks = 0;          // posted tasks run since the previous frame
+};
+
+struct RenderThreadConfig {
+    bool        egl = true;                  // false: no context (the host set a null GL dispatch)
+    bool        vulkan = false;              // try the Vulkan backend first, EGL / GLES when it fails
+    EGLDisplay  display = EGL_NO_DISPLAY;    // initialized display; EGL_NO_DISPLAY = the default display
+    int         glesVersion = 3;             // context tried first; 2 is the fallback
+    float       timerHz = 60.f;              // vsync rate without a choreographer (Linux, tests)
+    std::string shaderCacheDir;
+
+    // Called on the render thread
+    std::function<void()> onThreadStart, onThreadExit;                    // JNI attach / detach
+    std::function<void(const std::string& path, bool ok)> onModelLoaded;  // after every load
+    std::function<void(const RenderFrameInfo&)> onFrame;                  // after every swap
+};
+
+/**
+ * Start the thread; it creates the context and calls initRenderer() (or
+ * initRendererVulkan()) before running any task.
+ */
+bool startRenderThread(const RenderThreadConfig& config);
+
+/** Run the remaining tasks, release surfaces and context, and join the thread. */
+void stopRenderThread();
+
+bool renderThreadRunning();
+
+/**
+ * Surface created or resized (SurfaceHolder.Callback). Another window replaces
+ * the current one. On Android the thread takes over the caller's reference to
+ * window; elsewhere window must be 0 and a width x height pbuffer stands in for it.
+ * Returns false when the thread is not running: the caller keeps the reference.
+ */
+bool setRenderWindow(EGLNativeWindowType window, int width, int height);
+
+/** Surface destroyed: returns once the thread no longer uses window. */
+void releaseRenderWindow(EGLNativeWindowType window);
+
+/** Stop / resume rendering frames; tasks keep running. */
+void setRenderPaused(bool paused);
+
+/** Render on every Nth vsync (1 = every vsync, e.g. 2 = 30 fps on a 60 Hz display). */
+void setRenderFrameInterval(int vsyncs);
+
+/**
+ * Run task on the render thread before the next frame, in posting order.
+ * Returns false (and calls nothing) when the thread is not running. onDrop is
+ * called instead of task if the thread stops before running it.
+ */
+bool postRenderTask(std::function<void()> task, std::function<void()> onDrop = {});
+
+/** postRenderTask and wait for it (or for it to be dropped). Must not be called on the render thread. */
+void runRenderTask(std::function<void()> task);
+
+/**
+ * Load a model on the render thread and report it through onModelLoaded. The
+ * path is kept for reloading after a context loss; unless force is set, a model
+ * that is already loaded from the same path is kept as it is.
+ */
+void renderThreadLoadModel(const std::string& path, bool force = false);
+
+/**
+ * Snapshot (requestSnapshot) delivered on the render thread. A refused request
+ * or a failed snapshot comes back with empty pixels.
+ */
+void renderThreadSnapshot(int width, int height, uint32_t background, std::function<void(Snapshot&)> done);
+
+// ---- Per-frame host inputs ----
+
+/** Parameters driven by the lip sync value (the model's LipSync group). */
+void setLipSyncParameters(const std::vector<std::string>& ids);
+
+/** Mouth opening 0..1, written to the lip sync parameters every frame. */
+void setLipSyncValue(float value);
+
+/**
+ * Gaze: the eyes, head and body follow the target (-1..1) with frame-rate
+ * independent exponential smoothing (ParamEyeBallX/Y, ParamAngleX/Y/Z,
+ * ParamBodyAngleX). Disabling eye tracking removes the overrides.
+ */
+void setGazeTarget(float x, float y);
+void clearGazeTarget();                 // keep looking where the gaze is now
+void resetGaze();                       // back to (0, 0) at once
+void setEyeTrackingEnabled(bool enabled);
+
+/** modelScreenBounds() of the last rendered frame. */
+ScreenRect renderThreadModelBounds();
+
+/** Counters for the benchmark. */
+struct RenderThreadStats {
+    int64_t hostCalls = 0;       // calls into this API from other threads
+    int64_t tasks = 0;           // posted tasks run
+    int     frames = 0;
+    int     skippedVsyncs = 0;
+    int     contexts = 0;        // EGL contexts created (> 1 after a context loss)
+    int     windows = 0;         // window surfaces created
+    int     modelLoads = 0;      // loadModel calls made by the thread
+};
+
+RenderThreadStats renderThreadStats();
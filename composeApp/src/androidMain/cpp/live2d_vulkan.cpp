@@ -0,0 +1,1543 @@
+#include "live2d_vulkan.h"
+#include "live2d_spirv.h"
+#include "live2d_log.h"
+
+#include <vulkan/vulkan.h>
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+// ===================== Dispatch =====================
+// 运行时加载: 不链接 libvulkan, 没有驱动的设备上 vulkanInit 返回 false, 渲染器退回 GLES
+
+#define L2D_VK_GLOBAL_FUNCTIONS(X) \
+    X(CreateInstance) \
+    X(EnumerateInstanceExtensionProperties)
+
+#define L2D_VK_INSTANCE_FUNCTIONS(X) \
+    X(DestroyInstance) \
+    X(EnumeratePhysicalDevices) \
+    X(EnumerateDeviceExtensionProperties) \
+    X(GetPhysicalDeviceProperties) \
+    X(GetPhysicalDeviceQueueFamilyProperties) \
+    X(GetPhysicalDeviceMemoryProperties) \
+    X(GetPhysicalDeviceFormatProperties) \
+    X(CreateDevice) \
+    X(GetDeviceProcAddr)
+
+#define L2D_VK_SURFACE_FUNCTIONS(X) \
+    X(DestroySurfaceKHR) \
+    X(GetPhysicalDeviceSurfaceSupportKHR) \
+    X(GetPhysicalDeviceSurfaceCapabilitiesKHR) \
+    X(GetPhysicalDeviceSurfaceFormatsKHR)
+
+#define L2D_VK_DEVICE_FUNCTIONS(X) \
+    X(DestroyDevice) X(GetDeviceQueue) X(QueueSubmit) X(QueueWaitIdle) X(DeviceWaitIdle) \
+    X(AllocateMemory) X(FreeMemory) X(MapMemory) X(UnmapMemory) \
+    X(BindBufferMemory) X(BindImageMemory) X(GetBufferMemoryRequirements) X(GetImageMemoryRequirements) \
+    X(CreateFence) X(DestroyFence) X(ResetFences) X(WaitForFences) \
+    X(CreateSemaphore) X(DestroySemaphore) \
+    X(CreateBuffer) X(DestroyBuffer) X(CreateImage) X(DestroyImage) X(CreateImageView) X(DestroyImageView) \
+    X(CreateShaderModule) X(DestroyShaderModule) \
+    X(CreateGraphicsPipelines) X(DestroyPipeline) X(CreatePipelineLayout) X(DestroyPipelineLayout) \
+    X(CreateSampler) X(DestroySampler) \
+    X(CreateDescriptorSetLayout) X(DestroyDescriptorSetLayout) \
+    X(CreateDescriptorPool) X(DestroyDescriptorPool) X(AllocateDescriptorSets) X(FreeDescriptorSets) \
+    X(UpdateDescriptorSets) \
+    X(CreateFramebuffer) X(DestroyFramebuffer) X(CreateRenderPass) X(DestroyRenderPass) \
+    X(CreateCommandPool) X(DestroyCommandPool) X(AllocateCommandBuffers) X(FreeCommandBuffers) \
+    X(BeginCommandBuffer) X(EndCommandBuffer) X(ResetCommandBuffer) \
+    X(CmdBindPipeline) X(CmdSetViewport) X(CmdSetScissor) X(CmdBindDescriptorSets) \
+    X(CmdBindIndexBuffer) X(CmdBindVertexBuffers) X(CmdDrawIndexed) \
+    X(CmdCopyBufferToImage) X(CmdCopyImageToBuffer) X(CmdBlitImage) X(CmdClearAttachments) \
+    X(CmdPipelineBarrier) X(CmdPushConstants) X(CmdBeginRenderPass) X(CmdEndRenderPass)
+
+#define L2D_VK_SWAPCHAIN_FUNCTIONS(X) \
+    X(CreateSwapchainKHR) X(DestroySwapchainKHR) X(GetSwapchainImagesKHR) \
+    X(AcquireNextImageKHR) X(QueuePresentKHR)
+
+struct VkDispatch {
+    PFN_vkGetInstanceProcAddr GetInstanceProcAddr = nullptr;
+#define L2D_VK_MEMBER(name) PFN_vk##name name = nullptr;
+    L2D_VK_GLOBAL_FUNCTIONS(L2D_VK_MEMBER)
+    L2D_VK_INSTANCE_FUNCTIONS(L2D_VK_MEMBER)
+    L2D_VK_SURFACE_FUNCTIONS(L2D_VK_MEMBER)
+    L2D_VK_DEVICE_FUNCTIONS(L2D_VK_MEMBER)
+    L2D_VK_SWAPCHAIN_FUNCTIONS(L2D_VK_MEMBER)
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+    PFN_vkCreateAndroidSurfaceKHR CreateAndroidSurfaceKHR = nullptr;
+#endif
+#undef L2D_VK_MEMBER
+};
+
+static VkDispatch vk;
+static void* g_library = nullptr;
+
+// ===================== State =====================
+
+static const int kFramesInFlight = 2;
+static const int kMaskLayers     = 4;    // 一个遮罩批次里互不重叠的被遮罩 drawable 共用一层
+static const VkFormat kOffscreenFormat = VK_FORMAT_R8G8B8A8_UNORM;
+static const VkFormat kMaskFormat      = VK_FORMAT_R8_UNORM;
+
+enum VkBlend { kVkBlendNormal, kVkBlendAdditive, kVkBlendMultiply, kVkBlends };
+
+// 管线编号 = (混合模式 * 2 + 单面剔除) * 2 + 遮罩
+static const int kDrawPipelines = kVkBlends * 2 * 2;
+static int pipelineIndex(int blend, bool cullBack, bool masked) { return (blend * 2 + (cullBack ? 1 : 0)) * 2 + (masked ? 1 : 0); }
+
+// 同一颜色格式 / 最终布局的渲染目标共用: 清除与保留两个 render pass (兼容, 管线通用) 和全部绘制管线
+struct TargetPipelines {
+    VkFormat      format = VK_FORMAT_UNDEFINED;
+    VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkRenderPass  clearPass = VK_NULL_HANDLE;
+    VkRenderPass  loadPass = VK_NULL_HANDLE;
+    VkPipeline    draw[kDrawPipelines] = {};
+};
+
+struct Buffer {
+    VkBuffer       buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize   size = 0;
+    void*          mapped = nullptr;
+};
+
+struct Image {
+    VkImage        image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView    view = VK_NULL_HANDLE;
+    int            width = 0, height = 0;
+};
+
+struct Texture {
+    Image           image;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    bool            premultiplied = false;
+    bool            used = false;
+};
+
+// 释放要等用到它的帧都完成
+struct RetiredTexture {
+    Texture  texture;
+    uint64_t serial = 0;
+};
+
+struct FrameSlot {
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    VkFence         fence = VK_NULL_HANDLE;
+    VkSemaphore     acquired = VK_NULL_HANDLE;
+    uint64_t        serial = 0;       // 提交的帧序号, 0 = 未用过
+};
+
+struct Swapchain {
+    VkSurfaceKHR   surface = VK_NULL_HANDLE;
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    VkFormat       format = VK_FORMAT_UNDEFINED;
+    int            width = 0, height = 0;
+    std::vector<VkImage>       images;
+    std::vector<VkImageView>   views;
+    std::vector<VkFramebuffer> framebuffers;
+    std::vector<VkSemaphore>   rendered;   // 每张图一个, 呈现等待
+    TargetPipelines* pipelines = nullptr;
+    bool           stale = true;
+};
+
+struct MaskTarget {
+    VkImage        image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    int            width = 0, height = 0;
+    VkImageView     views[kMaskLayers] = {};
+    VkFramebuffer   framebuffers[kMaskLayers] = {};
+    VkDescriptorSet sets[kMaskLayers] = {};
+};
+
+struct VulkanState {
+    VkInstance       instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physical = VK_NULL_HANDLE;
+    VkDevice         device = VK_NULL_HANDLE;
+    VkQueue          queue = VK_NULL_HANDLE;
+    uint32_t         queueFamily = 0;
+    VkPhysicalDeviceMemoryProperties memory{};
+    std::string      deviceName;
+    bool             surfaceSupport = false;
+
+    VkCommandPool         commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer       oneShot = VK_NULL_HANDLE;
+    VkFence               oneShotFence = VK_NULL_HANDLE;
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool      descriptorPool = VK_NULL_HANDLE;
+    VkPipelineLayout      pipelineLayout = VK_NULL_HANDLE;
+    VkSampler             sampler = VK_NULL_HANDLE;
+    VkShaderModule        modules[4] = {};   // SpirvShader 顺序
+
+    std::vector<TargetPipelines*> targetPipelines;
+    VkRenderPass maskPass = VK_NULL_HANDLE;
+    VkPipeline   maskPipeline = VK_NULL_HANDLE;
+
+    FrameSlot slots[kFramesInFlight];
+    uint64_t  submitted = 0;
+    uint64_t  completed = 0;
+
+    int   width = 0, height = 0;
+    Image offscreen;
+    VkFramebuffer offscreenFramebuffer = VK_NULL_HANDLE;
+    bool  offscreenValid = false;           // 已经画过一帧, 可以读回
+    ANativeWindow* window = nullptr;
+    Swapchain swapchain;
+    MaskTarget mask;
+
+    // 模型几何: UV 与索引静态上传, 位置每帧写进环形缓冲当前帧的一段
+    Buffer uvs, indices, positions;
+    VkDeviceSize positionSlice = 0;
+    std::vector<int> vertexBase, indexBase;
+
+    std::vector<Texture> textures;         // id - 1
+    std::vector<int> maskLayers;           // 每个 draw 所在的遮罩层, -1 = 不遮罩; 帧间复用
+    std::vector<RetiredTexture> retired;
+};
+
+static VulkanState g_vk;
+static bool g_ready = false;
+
+static bool vkCheck(VkResult r, const char* what) {
+    if (r == VK_SUCCESS) return true;
+    LOGE("Vulkan: %s failed (%d)", what, (int)r);
+    return false;
+}
+
+// ===================== Loader =====================
+
+static bool loadLibrary() {
+#ifdef __ANDROID__
+    static const char* const kNames[] = { "libvulkan.so" };
+#else
+    static const char* const kNames[] = { "libvulkan.so.1", "libvulkan.so" };
+#endif
+    for (const char* name : kNames) {
+        g_library = dlopen(name, RTLD_NOW | RTLD_LOCAL);
+        if (g_library) break;
+    }
+    if (!g_library) { LOGI("Vulkan: no loader library"); return false; }
+    vk.GetInstanceProcAddr = (PFN_vkGetInstanceProcAddr)dlsym(g_library, "vkGetInstanceProcAddr");
+    if (!vk.GetInstanceProcAddr) { LOGE("Vulkan: vkGetInstanceProcAddr missing"); return false; }
+#define L2D_VK_LOAD_GLOBAL(name) \
+    if (!(vk.name = (PFN_vk##name)vk.GetInstanceProcAddr(VK_NULL_HANDLE, "vk" #name))) { LOGE("Vulkan: vk" #name " missing"); return false; }
+    L2D_VK_GLOBAL_FUNCTIONS(L2D_VK_LOAD_GLOBAL)
+#undef L2D_VK_LOAD_GLOBAL
+    return true;
+}
+
+static bool loadInstanceFunctions() {
+#define L2D_VK_LOAD_INSTANCE(name) \
+    if (!(vk.name = (PFN_vk##name)vk.GetInstanceProcAddr(g_vk.instance, "vk" #name))) { LOGE("Vulkan: vk" #name " missing"); return false; }
+    L2D_VK_INSTANCE_FUNCTIONS(L2D_VK_LOAD_INSTANCE)
+    if (g_vk.surfaceSupport) {
+        L2D_VK_SURFACE_FUNCTIONS(L2D_VK_LOAD_INSTANCE)
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+        L2D_VK_LOAD_INSTANCE(CreateAndroidSurfaceKHR)
+#endif
+    }
+#undef L2D_VK_LOAD_INSTANCE
+    return true;
+}
+
+static bool loadDeviceFunctions() {
+#define L2D_VK_LOAD_DEVICE(name) \
+    if (!(vk.name = (PFN_vk##name)vk.GetDeviceProcAddr(g_vk.device, "vk" #name))) { LOGE("Vulkan: vk" #name " missing"); return false; }
+    L2D_VK_DEVICE_FUNCTIONS(L2D_VK_LOAD_DEVICE)
+    if (g_vk.surfaceSupport) {
+        L2D_VK_SWAPCHAIN_FUNCTIONS(L2D_VK_LOAD_DEVICE)
+    }
+#undef L2D_VK_LOAD_DEVICE
+    return true;
+}
+
+static bool hasExtension(const std::vector<VkExtensionProperties>& list, const char* name) {
+    for (const VkExtensionProperties& e : list) if (strcmp(e.extensionName, name) == 0) return true;
+    return false;
+}
+
+// Android 上需要 surface 扩展才能画到窗口; 其他平台只画离屏目标
+static bool createInstance() {
+    uint32_t n = 0;
+    vk.EnumerateInstanceExtensionProperties(nullptr, &n, nullptr);
+    std::vector<VkExtensionProperties> available(n);
+    if (n) vk.EnumerateInstanceExtensionProperties(nullptr, &n, available.data());
+    std::vector<const char*> extensions;
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+    if (!hasExtension(available, VK_KHR_SURFACE_EXTENSION_NAME) || !hasExtension(available, VK_KHR_ANDROID_SURFACE_EXTENSION_NAME)) {
+        LOGW("Vulkan: no Android surface extension");
+        return false;
+    }
+    extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+    extensions.push_back(VK_KHR_ANDROID_SURFACE_EXTENSION_NAME);
+    g_vk.surfaceSupport = true;
+#endif
+
+    VkApplicationInfo app{};
+    app.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    app.pApplicationName = "Live2D";
+    app.pEngineName = "live2d_native";
+    app.apiVersion = VK_API_VERSION_1_0;
+    VkInstanceCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    ci.pApplicationInfo = &app;
+    ci.enabledExtensionCount = (uint32_t)extensions.size();
+    ci.ppEnabledExtensionNames = extensions.data();
+    return vkCheck(vk.CreateInstance(&ci, nullptr, &g_vk.instance), "vkCreateInstance");
+}
+
+// 第一个带图形队列的设备 (优先独显 / 集显, 其次软件实现)
+static bool createDevice() {
+    uint32_t n = 0;
+    vk.EnumeratePhysicalDevices(g_vk.instance, &n, nullptr);
+    std::vector<VkPhysicalDevice> devices(n);
+    if (n) vk.EnumeratePhysicalDevices(g_vk.instance, &n, devices.data());
+    int bestScore = -1;
+    for (VkPhysicalDevice pd : devices) {
+        uint32_t qn = 0;
+        vk.GetPhysicalDeviceQueueFamilyProperties(pd, &qn, nullptr);
+        std::vector<VkQueueFamilyProperties> families(qn);
+        vk.GetPhysicalDeviceQueueFamilyProperties(pd, &qn, families.data());
+        int family = -1;
+        for (uint32_t q = 0; q < qn && family < 0; q++)
+            if (families[q].queueFlags & VK_QUEUE_GRAPHICS_BIT) family = (int)q;
+        if (family < 0) continue;
+        if (g_vk.surfaceSupport) {
+            uint32_t en = 0;
+            vk.EnumerateDeviceExtensionProperties(pd, nullptr, &en, nullptr);
+            std::vector<VkExtensionProperties> ext(en);
+            if (en) vk.EnumerateDeviceExtensionProperties(pd, nullptr, &en, ext.data());
+            if (!hasExtension(ext, VK_KHR_SWAPCHAIN_EXTENSION_NAME)) continue;
+        }
+        VkPhysicalDeviceProperties props;
+        vk.GetPhysicalDeviceProperties(pd, &props);
+        int score = props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU ? 3
+                  : props.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU ? 2
+                  : props.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU ? 0 : 1;
+        if (props.limits.maxPushConstantsSize < sizeof(VulkanPushConstants)) continue;
+        if (score <= bestScore) continue;
+        bestScore = score;
+        g_vk.physical = pd;
+        g_vk.queueFamily = (uint32_t)family;
+        g_vk.deviceName = props.deviceName;
+    }
+    if (!g_vk.physical) { LOGW("Vulkan: no device with a graphics queue"); return false; }
+    vk.GetPhysicalDeviceMemoryProperties(g_vk.physical, &g_vk.memory);
+
+    float priority = 1.f;
+    VkDeviceQueueCreateInfo qi{};
+    qi.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    qi.queueFamilyIndex = g_vk.queueFamily;
+    qi.queueCount = 1;
+    qi.pQueuePriorities = &priority;
+    const char* swapchainExt = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+    VkDeviceCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    ci.queueCreateInfoCount = 1;
+    ci.pQueueCreateInfos = &qi;
+    ci.enabledExtensionCount = g_vk.surfaceSupport ? 1 : 0;
+    ci.ppEnabledExtensionNames = g_vk.surfaceSupport ? &swapchainExt : nullptr;
+    if (!vkCheck(vk.CreateDevice(g_vk.physical, &ci, nullptr, &g_vk.device), "vkCreateDevice")) return false;
+    if (!loadDeviceFunctions()) return false;
+    vk.GetDeviceQueue(g_vk.device, g_vk.queueFamily, 0, &g_vk.queue);
+    return true;
+}
+
+// ===================== Memory =====================
+
+static int findMemoryType(uint32_t bits, VkMemoryPropertyFlags wanted) {
+    for (uint32_t i = 0; i < g_vk.memory.memoryTypeCount; i++)
+        if ((bits & (1u << i)) && (g_vk.memory.memoryTypes[i].propertyFlags & wanted) == wanted) return (int)i;
+    return -1;
+}
+
+static bool allocate(const VkMemoryRequirements& req, VkMemoryPropertyFlags wanted, VkMemoryPropertyFlags fallback,
+                     VkDeviceMemory& memory) {
+    int type = findMemoryType(req.memoryTypeBits, wanted);
+    if (type < 0) type = findMemoryType(req.memoryTypeBits, fallback);
+    if (type < 0) { LOGE("Vulkan: no memory type for 0x%x", (unsigned)wanted); return false; }
+    VkMemoryAllocateInfo ai{};
+    ai.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    ai.allocationSize = req.size;
+    ai.memoryTypeIndex = (uint32_t)type;
+    return vkCheck(vk.AllocateMemory(g_vk.device, &ai, nullptr, &memory), "vkAllocateMemory");
+}
+
+static void destroyBuffer(Buffer& b) {
+    if (b.mapped) vk.UnmapMemory(g_vk.device, b.memory);
+    if (b.buffer) vk.DestroyBuffer(g_vk.device, b.buffer, nullptr);
+    if (b.memory) vk.FreeMemory(g_vk.device, b.memory, nullptr);
+    b = Buffer();
+}
+
+// 主机可见 + 一致的缓冲, 创建后一直映射
+static bool createMappedBuffer(VkDeviceSize size, VkBufferUsageFlags usage, Buffer& out, bool cached = false) {
+    VkBufferCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    ci.size = std::max<VkDeviceSize>(size, 4);
+    ci.usage = usage;
+    ci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (!vkCheck(vk.CreateBuffer(g_vk.device, &ci, nullptr, &out.buffer), "vkCreateBuffer")) return false;
+    VkMemoryRequirements req;
+    vk.GetBufferMemoryRequirements(g_vk.device, out.buffer, &req);
+    const VkMemoryPropertyFlags coherent = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    if (!allocate(req, cached ? coherent | VK_MEMORY_PROPERTY_HOST_CACHED_BIT : coherent, coherent, out.memory)
+        || !vkCheck(vk.BindBufferMemory(g_vk.device, out.buffer, out.memory, 0), "vkBindBufferMemory")
+        || !vkCheck(vk.MapMemory(g_vk.device, out.memory, 0, VK_WHOLE_SIZE, 0, &out.mapped), "vkMapMemory")) {
+        destroyBuffer(out);
+        return false;
+    }
+    out.size = ci.size;
+    return true;
+}
+
+static void destroyImage(Image& img) {
+    if (img.view) vk.DestroyImageView(g_vk.device, img.view, nullptr);
+    if (img.image) vk.DestroyImage(g_vk.device, img.image, nullptr);
+    if (img.memory) vk.FreeMemory(g_vk.device, img.memory, nullptr);
+    img = Image();
+}
+
+static bool createImage(int w, int h, VkFormat format, uint32_t mipLevels, uint32_t layers, VkImageUsageFlags usage,
+                        VkImage& image, VkDeviceMemory& memory) {
+    VkImageCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    ci.imageType = VK_IMAGE_TYPE_2D;
+    ci.format = format;
+    ci.extent = { (uint32_t)w, (uint32_t)h, 1 };
+    ci.mipLevels = mipLevels;
+    ci.arrayLayers = layers;
+    ci.samples = VK_SAMPLE_COUNT_1_BIT;
+    ci.tiling = VK_IMAGE_TILING_OPTIMAL;
+    ci.usage = usage;
+    ci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    ci.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (!vkCheck(vk.CreateImage(g_vk.device, &ci, nullptr, &image), "vkCreateImage")) return false;
+    VkMemoryRequirements req;
+    vk.GetImageMemoryRequirements(g_vk.device, image, &req);
+    if (!allocate(req, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, memory)
+        || !vkCheck(vk.BindImageMemory(g_vk.device, image, memory, 0), "vkBindImageMemory")) {
+        vk.DestroyImage(g_vk.device, image, nullptr);
+        if (memory) vk.FreeMemory(g_vk.device, memory, nullptr);
+        image = VK_NULL_HANDLE;
+        memory = VK_NULL_HANDLE;
+        return false;
+    }
+    return true;
+}
+
+static VkImageView createView(VkImage image, VkFormat format, uint32_t mipLevels, uint32_t layer) {
+    VkImageViewCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    ci.image = image;
+    ci.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    ci.format = format;
+    ci.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, layer, 1 };
+    VkImageView view = VK_NULL_HANDLE;
+    vkCheck(vk.CreateImageView(g_vk.device, &ci, nullptr, &view), "vkCreateImageView");
+    return view;
+}
+
+static VkFramebuffer createFramebuffer(VkRenderPass pass, VkImageView view, int w, int h) {
+    VkFramebufferCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    ci.renderPass = pass;
+    ci.attachmentCount = 1;
+    ci.pAttachments = &view;
+    ci.width = (uint32_t)w;
+    ci.height = (uint32_t)h;
+    ci.layers = 1;
+    VkFramebuffer fb = VK_NULL_HANDLE;
+    vkCheck(vk.CreateFramebuffer(g_vk.device, &ci, nullptr, &fb), "vkCreateFramebuffer");
+    return fb;
+}
+
+static VkDescriptorSet allocateSet(VkImageView view) {
+    VkDescriptorSetAllocateInfo ai{};
+    ai.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    ai.descriptorPool = g_vk.descriptorPool;
+    ai.descriptorSetCount = 1;
+    ai.pSetLayouts = &g_vk.setLayout;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (!vkCheck(vk.AllocateDescriptorSets(g_vk.device, &ai, &set), "vkAllocateDescriptorSets")) return VK_NULL_HANDLE;
+    VkDescriptorImageInfo ii{ g_vk.sampler, view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    VkWriteDescriptorSet w{};
+    w.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    w.dstSet = set;
+    w.descriptorCount = 1;
+    w.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    w.pImageInfo = &ii;
+    vk.UpdateDescriptorSets(g_vk.device, 1, &w, 0, nullptr);
+    return set;
+}
+
+// 一次性命令 (纹理上传, 读回, 截图): 录制后同步等待
+static VkCommandBuffer beginOneShot() {
+    vk.ResetCommandBuffer(g_vk.oneShot, 0);
+    VkCommandBufferBeginInfo bi{};
+    bi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vk.BeginCommandBuffer(g_vk.oneShot, &bi);
+    return g_vk.oneShot;
+}
+
+static bool submitOneShot() {
+    vk.EndCommandBuffer(g_vk.oneShot);
+    vk.ResetFences(g_vk.device, 1, &g_vk.oneShotFence);
+    VkSubmitInfo si{};
+    si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    si.commandBufferCount = 1;
+    si.pCommandBuffers = &g_vk.oneShot;
+    if (!vkCheck(vk.QueueSubmit(g_vk.queue, 1, &si, g_vk.oneShotFence), "vkQueueSubmit")) return false;
+    return vkCheck(vk.WaitForFences(g_vk.device, 1, &g_vk.oneShotFence, VK_TRUE, UINT64_MAX), "vkWaitForFences");
+}
+
+static void imageBarrier(VkCommandBuffer cmd, VkImage image, uint32_t baseMip, uint32_t mips,
+                         VkImageLayout from, VkImageLayout to, VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                         VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage) {
+    VkImageMemoryBarrier b{};
+    b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    b.srcAccessMask = srcAccess;
+    b.dstAccessMask = dstAccess;
+    b.oldLayout = from;
+    b.newLayout = to;
+    b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    b.image = image;
+    b.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, baseMip, mips, 0, 1 };
+    vk.CmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &b);
+}
+
+// ===================== Pipelines =====================
+// 初始化时全部建好: 每种目标格式 12 条绘制管线 (混合 3 x 剔除 2 x 遮罩 2) 加 1 条遮罩管线。
+// 视口 / 裁剪是动态状态, 着色器变体 (预乘, 反转遮罩, 乘色 / 屏幕色) 走推送常量
+
+struct BlendFactors { VkBlendFactor srcRGB, dstRGB, srcAlpha, dstAlpha; };
+
+// 与 GLES 路径的 kDrawBlendStates 相同
+static const BlendFactors kBlendFactors[kVkBlends] = {
+    { VK_BLEND_FACTOR_ONE,       VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, VK_BLEND_FACTOR_ONE,  VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA },
+    { VK_BLEND_FACTOR_ONE,       VK_BLEND_FACTOR_ONE,                 VK_BLEND_FACTOR_ZERO, VK_BLEND_FACTOR_ONE },
+    { VK_BLEND_FACTOR_DST_COLOR, VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, VK_BLEND_FACTOR_ZERO, VK_BLEND_FACTOR_ONE },
+};
+static const BlendFactors kMaskBlend = { VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE };
+
+static VkShaderModule createModule(SpirvShader shader) {
+    std::vector<uint32_t> code = buildSpirvShader(shader);
+    VkShaderModuleCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    ci.codeSize = code.size() * sizeof(uint32_t);
+    ci.pCode = code.data();
+    VkShaderModule m = VK_NULL_HANDLE;
+    vkCheck(vk.CreateShaderModule(g_vk.device, &ci, nullptr, &m), "vkCreateShaderModule");
+    return m;
+}
+
+// 单个颜色附件的 render pass。mask: 遮罩层 (内容按矩形清除, 结束后给片段着色器采样)
+static VkRenderPass createRenderPass(VkFormat format, VkAttachmentLoadOp load, VkImageLayout initial,
+                                     VkImageLayout final, bool mask) {
+    VkAttachmentDescription a{};
+    a.format = format;
+    a.samples = VK_SAMPLE_COUNT_1_BIT;
+    a.loadOp = load;
+    a.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    a.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    a.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    a.initialLayout = initial;
+    a.finalLayout = final;
+    VkAttachmentReference ref{ 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    VkSubpassDescription sub{};
+    sub.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    sub.colorAttachmentCount = 1;
+    sub.pColorAttachments = &ref;
+
+    // 帧间共用同一目标 / 遮罩层: 进入前等上一次的写入 (和采样), 结束后对读回 / 采样可见
+    VkSubpassDependency deps[2]{};
+    deps[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    deps[0].dstSubpass = 0;
+    deps[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+                         | (mask ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT);
+    deps[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | (mask ? 0 : VK_ACCESS_TRANSFER_READ_BIT);
+    deps[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    deps[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    deps[1].srcSubpass = 0;
+    deps[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    deps[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    deps[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    deps[1].dstStageMask = mask ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+                                : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+    deps[1].dstAccessMask = mask ? VK_ACCESS_SHADER_READ_BIT
+                                 : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+
+    VkRenderPassCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    ci.attachmentCount = 1;
+    ci.pAttachments = &a;
+    ci.subpassCount = 1;
+    ci.pSubpasses = &sub;
+    ci.dependencyCount = 2;
+    ci.pDependencies = deps;
+    VkRenderPass pass = VK_NULL_HANDLE;
+    vkCheck(vk.CreateRenderPass(g_vk.device, &ci, nullptr, &pass), "vkCreateRenderPass");
+    return pass;
+}
+
+// 一次 vkCreateGraphicsPipelines 建一批; 只有混合, 剔除和片段着色器不同
+struct PipelineDesc {
+    BlendFactors blend;
+    bool cullBack;
+    VkShaderModule fragment;
+};
+
+static bool createPipelines(VkRenderPass pass, const PipelineDesc* descs, int count, VkPipeline* out) {
+    VkVertexInputBindingDescription bindings[2] = {
+        { 0, 8, VK_VERTEX_INPUT_RATE_VERTEX },   // 位置 (环形缓冲)
+        { 1, 8, VK_VERTEX_INPUT_RATE_VERTEX },   // UV (静态)
+    };
+    VkVertexInputAttributeDescription attributes[2] = {
+        { 0, 0, VK_FORMAT_R32G32_SFLOAT, 0 },
+        { 1, 1, VK_FORMAT_R32G32_SFLOAT, 0 },
+    };
+    VkPipelineVertexInputStateCreateInfo vi{};
+    vi.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vi.vertexBindingDescriptionCount = 2;
+    vi.pVertexBindingDescriptions = bindings;
+    vi.vertexAttributeDescriptionCount = 2;
+    vi.pVertexAttributeDescriptions = attributes;
+    VkPipelineInputAssemblyStateCreateInfo ia{};
+    ia.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    ia.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPipelineViewportStateCreateInfo vp{};
+    vp.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    vp.viewportCount = 1;
+    vp.scissorCount = 1;
+    VkPipelineMultisampleStateCreateInfo ms{};
+    ms.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    ms.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    VkDynamicState dynamic[2] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo ds{};
+    ds.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    ds.dynamicStateCount = 2;
+    ds.pDynamicStates = dynamic;
+
+    std::vector<VkPipelineRasterizationStateCreateInfo> rs(count);
+    std::vector<VkPipelineColorBlendAttachmentState> att(count);
+    std::vector<VkPipelineColorBlendStateCreateInfo> cb(count);
+    std::vector<VkPipelineShaderStageCreateInfo> stages(count * 2);
+    std::vector<VkGraphicsPipelineCreateInfo> ci(count);
+    for (int i = 0; i < count; i++) {
+        const PipelineDesc& d = descs[i];
+        rs[i] = VkPipelineRasterizationStateCreateInfo{};
+        rs[i].sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rs[i].polygonMode = VK_POLYGON_MODE_FILL;
+        rs[i].cullMode = d.cullBack ? VK_CULL_MODE_BACK_BIT : VK_CULL_MODE_NONE;
+        rs[i].frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;   // y 翻转后与 GL 的 CCW 一致
+        rs[i].lineWidth = 1.f;
+        att[i] = VkPipelineColorBlendAttachmentState{};
+        att[i].blendEnable = VK_TRUE;
+        att[i].srcColorBlendFactor = d.blend.srcRGB;
+        att[i].dstColorBlendFactor = d.blend.dstRGB;
+        att[i].colorBlendOp = VK_BLEND_OP_ADD;
+        att[i].srcAlphaBlendFactor = d.blend.srcAlpha;
+        att[i].dstAlphaBlendFactor = d.blend.dstAlpha;
+        att[i].alphaBlendOp = VK_BLEND_OP_ADD;
+        att[i].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
+                              | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        cb[i] = VkPipelineColorBlendStateCreateInfo{};
+        cb[i].sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        cb[i].attachmentCount = 1;
+        cb[i].pAttachments = &att[i];
+        for (int s = 0; s < 2; s++) {
+            VkPipelineShaderStageCreateInfo& st = stages[i * 2 + s];
+            st = VkPipelineShaderStageCreateInfo{};
+            st.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            st.stage = s == 0 ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_FRAGMENT_BIT;
+            st.module = s == 0 ? g_vk.modules[(int)SpirvShader::Vertex] : d.fragment;
+            st.pName = "main";
+        }
+        ci[i] = VkGraphicsPipelineCreateInfo{};
+        ci[i].sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        ci[i].stageCount = 2;
+        ci[i].pStages = &stages[i * 2];
+        ci[i].pVertexInputState = &vi;
+        ci[i].pInputAssemblyState = &ia;
+        ci[i].pViewportState = &vp;
+        ci[i].pRasterizationState = &rs[i];
+        ci[i].pMultisampleState = &ms;
+        ci[i].pColorBlendState = &cb[i];
+        ci[i].pDynamicState = &ds;
+        ci[i].layout = g_vk.pipelineLayout;
+        ci[i].renderPass = pass;
+        ci[i].basePipelineIndex = -1;
+    }
+    return vkCheck(vk.CreateGraphicsPipelines(g_vk.device, VK_NULL_HANDLE, (uint32_t)count, ci.data(), nullptr, out),
+                   "vkCreateGraphicsPipelines");
+}
+
+static void destroyTargetPipelines(TargetPipelines* t) {
+    for (VkPipeline p : t->draw) if (p) vk.DestroyPipeline(g_vk.device, p, nullptr);
+    if (t->clearPass) vk.DestroyRenderPass(g_vk.device, t->clearPass, nullptr);
+    if (t->loadPass) vk.DestroyRenderPass(g_vk.device, t->loadPass, nullptr);
+    delete t;
+}
+
+// 目标格式 + 最终布局 (读回: TRANSFER_SRC, 呈现: PRESENT_SRC) 对应的 render pass 与管线, 第一次用到时建
+static TargetPipelines* targetPipelines(VkFormat format, VkImageLayout finalLayout) {
+    for (TargetPipelines* t : g_vk.targetPipelines)
+        if (t->format == format && t->finalLayout == finalLayout) return t;
+    TargetPipelines* t = new TargetPipelines();
+    t->format = format;
+    t->finalLayout = finalLayout;
+    t->clearPass = createRenderPass(format, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_IMAGE_LAYOUT_UNDEFINED, finalLayout, false);
+    t->loadPass = createRenderPass(format, VK_ATTACHMENT_LOAD_OP_LOAD, finalLayout, finalLayout, false);
+    PipelineDesc descs[kDrawPipelines];
+    for (int blend = 0; blend < kVkBlends; blend++)
+        for (int cull = 0; cull < 2; cull++)
+            for (int masked = 0; masked < 2; masked++)
+                descs[pipelineIndex(blend, cull != 0, masked != 0)] = {
+                    kBlendFactors[blend], cull != 0,
+                    g_vk.modules[(int)(masked ? SpirvShader::DrawMasked : SpirvShader::Draw)] };
+    if (!t->clearPass || !t->loadPass || !createPipelines(t->clearPass, descs, kDrawPipelines, t->draw)) {
+        destroyTargetPipelines(t);
+        return nullptr;
+    }
+    g_vk.targetPipelines.push_back(t);
+    LOGI("Vulkan: %d draw pipelines for format %d", kDrawPipelines, (int)format);
+    return t;
+}
+
+// ===================== Targets =====================
+
+static void destroyMaskTarget() {
+    MaskTarget& m = g_vk.mask;
+    for (int l = 0; l < kMaskLayers; l++) {
+        if (m.framebuffers[l]) vk.DestroyFramebuffer(g_vk.device, m.framebuffers[l], nullptr);
+        if (m.views[l]) vk.DestroyImageView(g_vk.device, m.views[l], nullptr);
+        if (m.sets[l]) vk.FreeDescriptorSets(g_vk.device, g_vk.descriptorPool, 1, &m.sets[l]);
+    }
+    if (m.image) vk.DestroyImage(g_vk.device, m.image, nullptr);
+    if (m.memory) vk.FreeMemory(g_vk.device, m.memory, nullptr);
+    m = MaskTarget();
+}
+
+// 遮罩层至少与目标一样大 (截图目标可能更大); 变大时等 GPU 空闲后重建
+static bool ensureMaskTarget(int w, int h) {
+    MaskTarget& m = g_vk.mask;
+    if (m.image && m.width >= w && m.height >= h) return true;
+    vk.DeviceWaitIdle(g_vk.device);
+    int mw = std::max(w, m.width), mh = std::max(h, m.height);
+    destroyMaskTarget();
+    if (!createImage(mw, mh, kMaskFormat, 1, kMaskLayers,
+                     VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, m.image, m.memory))
+        return false;
+    m.width = mw;
+    m.height = mh;
+    for (int l = 0; l < kMaskLayers; l++) {
+        m.views[l] = createView(m.image, kMaskFormat, 1, (uint32_t)l);
+        m.framebuffers[l] = m.views[l] ? createFramebuffer(g_vk.maskPass, m.views[l], mw, mh) : VK_NULL_HANDLE;
+        m.sets[l] = m.views[l] ? allocateSet(m.views[l]) : VK_NULL_HANDLE;
+        if (!m.framebuffers[l] || !m.sets[l]) { destroyMaskTarget(); return false; }
+    }
+    LOGI("Vulkan: mask target %dx%d x %d layers", mw, mh, kMaskLayers);
+    return true;
+}
+
+static void destroyOffscreen() {
+    if (g_vk.offscreenFramebuffer) vk.DestroyFramebuffer(g_vk.device, g_vk.offscreenFramebuffer, nullptr);
+    g_vk.offscreenFramebuffer = VK_NULL_HANDLE;
+    destroyImage(g_vk.offscreen);
+    g_vk.offscreenValid = false;
+}
+
+static bool createColorTarget(int w, int h, TargetPipelines* pipelines, Image& img, VkFramebuffer& fb) {
+    if (!createImage(w, h, kOffscreenFormat, 1, 1, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                     img.image, img.memory))
+        return false;
+    img.width = w;
+    img.height = h;
+    img.view = createView(img.image, kOffscreenFormat, 1, 0);
+    fb = img.view ? createFramebuffer(pipelines->clearPass, img.view, w, h) : VK_NULL_HANDLE;
+    if (!fb) { destroyImage(img); return false; }
+    return true;
+}
+
+static bool ensureOffscreen() {
+    if (g_vk.offscreen.image && g_vk.offscreen.width == g_vk.width && g_vk.offscreen.height == g_vk.height) return true;
+    vk.DeviceWaitIdle(g_vk.device);
+    destroyOffscreen();
+    TargetPipelines* p = targetPipelines(kOffscreenFormat, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    return p && createColorTarget(g_vk.width, g_vk.height, p, g_vk.offscreen, g_vk.offscreenFramebuffer);
+}
+
+static void destroySwapchainImages(Swapchain& sc) {
+    for (VkFramebuffer fb : sc.framebuffers) if (fb) vk.DestroyFramebuffer(g_vk.device, fb, nullptr);
+    for (VkImageView v : sc.views) if (v) vk.DestroyImageView(g_vk.device, v, nullptr);
+    for (VkSemaphore s : sc.rendered) if (s) vk.DestroySemaphore(g_vk.device, s, nullptr);
+    sc.framebuffers.clear();
+    sc.views.clear();
+    sc.rendered.clear();
+    sc.images.clear();
+}
+
+static void destroySwapchain() {
+    Swapchain& sc = g_vk.swapchain;
+    if (!g_vk.device) return;
+    vk.DeviceWaitIdle(g_vk.device);
+    destroySwapchainImages(sc);
+    if (sc.swapchain) vk.DestroySwapchainKHR(g_vk.device, sc.swapchain, nullptr);
+    if (sc.surface) vk.DestroySurfaceKHR(g_vk.instance, sc.surface, nullptr);
+    sc = Swapchain();
+}
+
+// 窗口尺寸变化 / OUT_OF_DATE 时重建, 旧交换链交给 oldSwapchain 后销毁
+static bool ensureSwapchain() {
+    Swapchain& sc = g_vk.swapchain;
+    if (!sc.surface) return false;
+    if (!sc.stale && sc.swapchain) return true;
+    vk.DeviceWaitIdle(g_vk.device);
+
+    VkSurfaceCapabilitiesKHR caps;
+    if (!vkCheck(vk.GetPhysicalDeviceSurfaceCapabilitiesKHR(g_vk.physical, sc.surface, &caps), "surface capabilities"))
+        return false;
+    uint32_t n = 0;
+    vk.GetPhysicalDeviceSurfaceFormatsKHR(g_vk.physical, sc.surface, &n, nullptr);
+    std::vector<VkSurfaceFormatKHR> formats(n);
+    if (n) vk.GetPhysicalDeviceSurfaceFormatsKHR(g_vk.physical, sc.surface, &n, formats.data());
+    VkSurfaceFormatKHR chosen{ VK_FORMAT_UNDEFINED, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+    for (VkFormat want : { VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_B8G8R8A8_UNORM })
+        for (const VkSurfaceFormatKHR& f : formats)
+            if (chosen.format == VK_FORMAT_UNDEFINED && f.format == want) chosen = f;
+    if (chosen.format == VK_FORMAT_UNDEFINED) { LOGE("Vulkan: no RGBA8 / BGRA8 surface format"); return false; }
+
+    VkExtent2D extent = caps.currentExtent;
+    if (extent.width == 0xFFFFFFFFu) extent = { (uint32_t)g_vk.width, (uint32_t)g_vk.height };
+    if (extent.width == 0 || extent.height == 0) return false;
+    uint32_t images = std::max<uint32_t>(caps.minImageCount, 3);
+    if (caps.maxImageCount) images = std::min(images, caps.maxImageCount);
+    // 透明窗口: 优先沿用系统的合成方式, 其次预乘 alpha (渲染结果本来就是预乘的)
+    VkCompositeAlphaFlagBitsKHR alpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    for (VkCompositeAlphaFlagBitsKHR a : { VK_COMPOSITE_ALPHA_PRE_MULTIPLIED_BIT_KHR, VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR })
+        if (caps.supportedCompositeAlpha & a) alpha = a;
+    VkSurfaceTransformFlagBitsKHR transform = (caps.supportedTransforms & VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR)
+                                            ? VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR : caps.currentTransform;
+
+    VkSwapchainCreateInfoKHR ci{};
+    ci.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+    ci.surface = sc.surface;
+    ci.minImageCount = images;
+    ci.imageFormat = chosen.format;
+    ci.imageColorSpace = chosen.colorSpace;
+    ci.imageExtent = extent;
+    ci.imageArrayLayers = 1;
+    ci.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    ci.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    ci.preTransform = transform;
+    ci.compositeAlpha = alpha;
+    ci.presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    ci.clipped = VK_TRUE;
+    ci.oldSwapchain = sc.swapchain;
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    if (!vkCheck(vk.CreateSwapchainKHR(g_vk.device, &ci, nullptr, &swapchain), "vkCreateSwapchainKHR")) return false;
+    destroySwapchainImages(sc);
+    if (sc.swapchain) vk.DestroySwapchainKHR(g_vk.device, sc.swapchain, nullptr);
+    sc.swapchain = swapchain;
+    sc.format = chosen.format;
+    sc.width = (int)extent.width;
+    sc.height = (int)extent.height;
+    sc.pipelines = targetPipelines(chosen.format, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    if (!sc.pipelines) return false;
+
+    vk.GetSwapchainImagesKHR(g_vk.device, swapchain, &n, nullptr);
+    sc.images.resize(n);
+    vk.GetSwapchainImagesKHR(g_vk.device, swapchain, &n, sc.images.data());
+    VkSemaphoreCreateInfo si{};
+    si.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    for (VkImage img : sc.images) {
+        VkImageView view = createView(img, sc.format, 1, 0);
+        sc.views.push_back(view);
+        sc.framebuffers.push_back(view ? createFramebuffer(sc.pipelines->clearPass, view, sc.width, sc.height) : VK_NULL_HANDLE);
+        VkSemaphore s = VK_NULL_HANDLE;
+        vk.CreateSemaphore(g_vk.device, &si, nullptr, &s);
+        sc.rendered.push_back(s);
+        if (!sc.framebuffers.back() || !s) return false;
+    }
+    sc.stale = false;
+    LOGI("Vulkan: swapchain %dx%d, %u images, format %d, composite alpha 0x%x",
+         sc.width, sc.height, n, (int)sc.format, (unsigned)alpha);
+    return true;
+}
+
+// ===================== Textures =====================
+
+static void destroyTexture(Texture& t) {
+    if (t.set) vk.FreeDescriptorSets(g_vk.device, g_vk.descriptorPool, 1, &t.set);
+    destroyImage(t.image);
+    t = Texture();
+}
+
+static void releaseRetired(bool all) {
+    for (size_t i = 0; i < g_vk.retired.size();) {
+        if (all || g_vk.retired[i].serial <= g_vk.completed) {
+            destroyTexture(g_vk.retired[i].texture);
+            g_vk.retired.erase(g_vk.retired.begin() + i);
+        } else {
+            i++;
+        }
+    }
+}
+
+static bool isPowerOfTwo(int v) { return v > 0 && (v & (v - 1)) == 0; }
+
+uint32_t vulkanCreateTexture(const uint8_t* rgba, int width, int height, bool premultiplied) {
+    if (!g_ready || !rgba || width <= 0 || height <= 0) return 0;
+    // 2 的幂尺寸带 mipmap (同 GLES 路径), 逐级 blit 生成
+    uint32_t mips = 1;
+    if (isPowerOfTwo(width) && isPowerOfTwo(height))
+        while ((std::max(width, height) >> mips) > 0) mips++;
+
+    Texture t;
+    t.premultiplied = premultiplied;
+    t.used = true;
+    if (!createImage(width, height, kOffscreenFormat, mips, 1,
+                     VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                     t.image.image, t.image.memory))
+        return 0;
+    t.image.width = width;
+    t.image.height = height;
+
+    Buffer staging;
+    size_t bytes = (size_t)width * height * 4;
+    if (!createMappedBuffer(bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, staging)) { destroyImage(t.image); return 0; }
+    memcpy(staging.mapped, rgba, bytes);
+
+    VkCommandBuffer cmd = beginOneShot();
+    VkImage img = t.image.image;
+    imageBarrier(cmd, img, 0, mips, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    VkBufferImageCopy copy{};
+    copy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    copy.imageExtent = { (uint32_t)width, (uint32_t)height, 1 };
+    vk.CmdCopyBufferToImage(cmd, staging.buffer, img, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+    int w = width, h = height;
+    for (uint32_t level = 1; level < mips; level++) {
+        imageBarrier(cmd, img, level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                     VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        int nw = std::max(1, w / 2), nh = std::max(1, h / 2);
+        VkImageBlit blit{};
+        blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1 };
+        blit.srcOffsets[1] = { w, h, 1 };
+        blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+        blit.dstOffsets[1] = { nw, nh, 1 };
+        vk.CmdBlitImage(cmd, img, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, img, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        1, &blit, VK_FILTER_LINEAR);
+        w = nw;
+        h = nh;
+    }
+    if (mips > 1)
+        imageBarrier(cmd, img, 0, mips - 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                     VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT,
+                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    imageBarrier(cmd, img, mips - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                 VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    bool ok = submitOneShot();
+    destroyBuffer(staging);
+
+    t.image.view = ok ? createView(img, kOffscreenFormat, mips, 0) : VK_NULL_HANDLE;
+    t.set = t.image.view ? allocateSet(t.image.view) : VK_NULL_HANDLE;
+    if (!t.set) { destroyTexture(t); return 0; }
+
+    for (size_t i = 0; i < g_vk.textures.size(); i++) {
+        if (g_vk.textures[i].used) continue;
+        g_vk.textures[i] = t;
+        return (uint32_t)i + 1;
+    }
+    g_vk.textures.push_back(t);
+    return (uint32_t)g_vk.textures.size();
+}
+
+void vulkanDestroyTexture(uint32_t id) {
+    if (!g_ready || id == 0 || id > g_vk.textures.size() || !g_vk.textures[id - 1].used) return;
+    g_vk.retired.push_back({ g_vk.textures[id - 1], g_vk.submitted });
+    g_vk.textures[id - 1] = Texture();
+}
+
+static const Texture* textureFor(const VulkanFrame& f, int index) {
+    if (index < 0 || index >= f.textureCount) return nullptr;
+    uint32_t id = f.textures[index];
+    if (id == 0 || id > g_vk.textures.size() || !g_vk.textures[id - 1].used) return nullptr;
+    return &g_vk.textures[id - 1];
+}
+
+// ===================== Geometry =====================
+
+bool vulkanSetGeometry(const RasterDrawable* drawables, int count) {
+    if (!g_ready) return false;
+    vk.DeviceWaitIdle(g_vk.device);
+    destroyBuffer(g_vk.uvs);
+    destroyBuffer(g_vk.indices);
+    g_vk.vertexBase.assign(count, 0);
+    g_vk.indexBase.assign(count, 0);
+    size_t vertices = 0, indices = 0;
+    for (int i = 0; i < count; i++) {
+        g_vk.vertexBase[i] = (int)vertices;
+        g_vk.indexBase[i] = (int)indices;
+        vertices += drawables[i].vertexCount;
+        indices += drawables[i].indexCount;
+    }
+    if (!createMappedBuffer(vertices * 8, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, g_vk.uvs)
+        || !createMappedBuffer(indices * 2, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, g_vk.indices))
+        return false;
+    for (int i = 0; i < count; i++) {
+        const RasterDrawable& d = drawables[i];
+        if (d.uvs) memcpy((uint8_t*)g_vk.uvs.mapped + (size_t)g_vk.vertexBase[i] * 8, d.uvs, (size_t)d.vertexCount * 8);
+        if (d.indices) memcpy((uint16_t*)g_vk.indices.mapped + g_vk.indexBase[i], d.indices, (size_t)d.indexCount * 2);
+    }
+
+    // 位置环形缓冲: 每个在途帧一段, 顶点总数变多时重建
+    VkDeviceSize slice = std::max<VkDeviceSize>((vertices * 8 + 255) & ~(VkDeviceSize)255, 256);
+    if (slice > g_vk.positionSlice) {
+        destroyBuffer(g_vk.positions);
+        if (!createMappedBuffer(slice * kFramesInFlight, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, g_vk.positions)) {
+            g_vk.positionSlice = 0;
+            return false;
+        }
+        g_vk.positionSlice = slice;
+    }
+    LOGI("Vulkan: geometry %zu vertices, %zu indices, ring %llu KB", vertices, indices,
+         (unsigned long long)(g_vk.positions.size / 1024));
+    return true;
+}
+
+// ===================== Recording =====================
+
+struct MaskBatch {
+    int begin = 0, end = 0;      // draws [begin, end) 用这一批遮罩
+    int layerUse[kMaskLayers] = {};
+};
+
+struct Recorder {
+    VkCommandBuffer  cmd;
+    const VulkanFrame& frame;
+    TargetPipelines* pipelines;
+    VkFramebuffer    framebuffer;
+    int              width, height;
+    VkDeviceSize     ringOffset;
+    VulkanFrameStats stats;
+    VkPipeline       boundPipeline = VK_NULL_HANDLE;
+    VkDescriptorSet  boundSets[2] = {};
+    VulkanPushConstants pc{};
+};
+
+static void bindPipeline(Recorder& r, VkPipeline p) {
+    if (p == r.boundPipeline) return;
+    vk.CmdBindPipeline(r.cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, p);
+    r.boundPipeline = p;
+    r.stats.pipelineBinds++;
+}
+
+static void bindSet(Recorder& r, uint32_t index, VkDescriptorSet set) {
+    if (r.boundSets[index] == set) return;
+    vk.CmdBindDescriptorSets(r.cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vk.pipelineLayout, index, 1, &set, 0, nullptr);
+    r.boundSets[index] = set;
+}
+
+// render pass 开始后: 视口覆盖目标 (遮罩层可能比目标大, 坐标与主目标一致), 几何缓冲
+static void beginPass(Recorder& r, VkRenderPass pass, VkFramebuffer fb, int fbW, int fbH) {
+    VkClearValue clear{};
+    VkRenderPassBeginInfo bi{};
+    bi.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    bi.renderPass = pass;
+    bi.framebuffer = fb;
+    bi.renderArea = { { 0, 0 }, { (uint32_t)fbW, (uint32_t)fbH } };
+    bi.clearValueCount = 1;
+    bi.pClearValues = &clear;
+    vk.CmdBeginRenderPass(r.cmd, &bi, VK_SUBPASS_CONTENTS_INLINE);
+    r.stats.renderPasses++;
+    VkViewport vp{ 0.f, 0.f, (float)r.width, (float)r.height, 0.f, 1.f };
+    vk.CmdSetViewport(r.cmd, 0, 1, &vp);
+    VkRect2D scissor{ { 0, 0 }, { (uint32_t)r.width, (uint32_t)r.height } };
+    vk.CmdSetScissor(r.cmd, 0, 1, &scissor);
+    if (r.frame.drawCount > 0) {
+        VkBuffer buffers[2] = { g_vk.positions.buffer, g_vk.uvs.buffer };
+        VkDeviceSize offsets[2] = { r.ringOffset, 0 };
+        vk.CmdBindVertexBuffers(r.cmd, 0, 2, buffers, offsets);
+        vk.CmdBindIndexBuffer(r.cmd, g_vk.indices.buffer, 0, VK_INDEX_TYPE_UINT16);
+    }
+    r.boundPipeline = VK_NULL_HANDLE;
+    r.boundSets[0] = r.boundSets[1] = VK_NULL_HANDLE;
+}
+
+static void drawIndexed(Recorder& r, int d) {
+    const RasterDrawable& rd = r.frame.drawables[d];
+    vk.CmdPushConstants(r.cmd, g_vk.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                        0, sizeof(VulkanPushConstants), &r.pc);
+    vk.CmdDrawIndexed(r.cmd, (uint32_t)rd.indexCount, 1, (uint32_t)g_vk.indexBase[d], g_vk.vertexBase[d], 0);
+}
+
+// 从 begin 开始尽量多地把被遮罩的 draw 放进遮罩层: 同一层里的矩形互不重叠,
+// 放不下的那个 draw 开始下一批
+static MaskBatch planMaskBatch(const VulkanFrame& f, int begin, std::vector<int>& layers) {
+    MaskBatch b;
+    b.begin = begin;
+    int i = begin;
+    for (; i < f.drawCount; i++) {
+        const VulkanDraw& d = f.draws[i];
+        layers[i] = -1;
+        if (d.maskCount == 0) continue;
+        int layer = -1;
+        for (int l = 0; l < kMaskLayers && layer < 0; l++) {
+            bool free = true;
+            for (int k = begin; k < i && free; k++) {
+                const VulkanDraw& o = f.draws[k];
+                if (layers[k] == l && d.x0 < o.x1 && o.x0 < d.x1 && d.y0 < o.y1 && o.y0 < d.y1) free = false;
+            }
+            if (free) layer = l;
+        }
+        if (layer < 0) break;
+        layers[i] = layer;
+        b.layerUse[layer]++;
+    }
+    b.end = i;
+    return b;
+}
+
+// 遮罩 render pass: 每层一个, 先按矩形清零再把遮罩来源累加进去 (裁剪到矩形)
+static void recordMasks(Recorder& r, const MaskBatch& b, const std::vector<int>& layers) {
+    const VulkanFrame& f = r.frame;
+    for (int l = 0; l < kMaskLayers; l++) {
+        if (!b.layerUse[l]) continue;
+        beginPass(r, g_vk.maskPass, g_vk.mask.framebuffers[l], g_vk.mask.width, g_vk.mask.height);
+        bindPipeline(r, g_vk.maskPipeline);
+        for (int i = b.begin; i < b.end; i++) {
+            if (layers[i] != l) continue;
+            const VulkanDraw& d = f.draws[i];
+            VkRect2D rect{ { d.x0, d.y0 }, { (uint32_t)(d.x1 - d.x0), (uint32_t)(d.y1 - d.y0) } };
+            VkClearAttachment ca{};
+            ca.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            ca.colorAttachment = 0;
+            VkClearRect cr{ rect, 0, 1 };
+            vk.CmdClearAttachments(r.cmd, 1, &ca, 1, &cr);
+            vk.CmdSetScissor(r.cmd, 0, 1, &rect);
+            for (int m = 0; m < d.maskCount; m++) {
+                int mi = d.masks[m];
+                if (mi < 0 || mi >= f.drawableCount) continue;
+                const RasterDrawable& md = f.drawables[mi];
+                const Texture* t = textureFor(f, md.texture);
+                if (!t || md.indexCount == 0) continue;
+                bindSet(r, 0, t->set);
+                r.pc.opacity = md.opacity;
+                drawIndexed(r, mi);
+                r.stats.maskDraws++;
+            }
+        }
+        vk.CmdEndRenderPass(r.cmd);
+    }
+    r.stats.maskPasses++;
+}
+
+static void recordFrame(Recorder& r) {
+    const VulkanFrame& f = r.frame;
+    // 本帧顶点位置写进环形缓冲的当前段 (这一段上次的帧已经完成)
+    int geometry = f.drawCount > 0 ? std::min<int>(f.drawableCount, (int)g_vk.vertexBase.size()) : 0;
+    uint8_t* ring = (uint8_t*)g_vk.positions.mapped + r.ringOffset;
+    for (int i = 0; i < geometry; i++) {
+        const RasterDrawable& d = f.drawables[i];
+        if (d.positions && d.vertexCount > 0)
+            memcpy(ring + (size_t)g_vk.vertexBase[i] * 8, d.positions, (size_t)d.vertexCount * 8);
+    }
+
+    // GL 的矩阵 y 取反: Vulkan 帧缓冲 y 向下, 结果顶行在前, 正面方向不变 (CCW)
+    memcpy(r.pc.matrix, f.matrix, sizeof(r.pc.matrix));
+    for (int c = 0; c < 4; c++) r.pc.matrix[c * 4 + 1] = -r.pc.matrix[c * 4 + 1];
+    r.pc.maskScale[0] = g_vk.mask.width ? 1.f / g_vk.mask.width : 0.f;
+    r.pc.maskScale[1] = g_vk.mask.height ? 1.f / g_vk.mask.height : 0.f;
+
+    std::vector<int>& layers = g_vk.maskLayers;
+    if ((int)layers.size() < f.drawCount) layers.resize(f.drawCount);
+    int next = 0;
+    bool cleared = false;
+    while (next < f.drawCount || !cleared) {
+        MaskBatch batch = planMaskBatch(f, next, layers);
+        bool anyMask = false;
+        for (int l = 0; l < kMaskLayers; l++) anyMask |= batch.layerUse[l] > 0;
+        if (anyMask) recordMasks(r, batch, layers);
+
+        beginPass(r, cleared ? r.pipelines->loadPass : r.pipelines->clearPass, r.framebuffer, r.width, r.height);
+        cleared = true;
+        for (int i = batch.begin; i < batch.end; i++) {
+            const VulkanDraw& d = f.draws[i];
+            if (d.drawable < 0 || d.drawable >= geometry) continue;
+            const RasterDrawable& rd = f.drawables[d.drawable];
+            const Texture* t = textureFor(f, rd.texture);
+            if (!t || rd.indexCount == 0) continue;
+            bool masked = layers[i] >= 0;
+            int blend = rd.blend == RasterBlend::Additive ? kVkBlendAdditive
+                      : rd.blend == RasterBlend::Multiply ? kVkBlendMultiply : kVkBlendNormal;
+            bindPipeline(r, r.pipelines->draw[pipelineIndex(blend, !rd.doubleSided, masked)]);
+            bindSet(r, 0, t->set);
+            if (masked) bindSet(r, 1, g_vk.mask.sets[layers[i]]);
+            r.pc.opacity = rd.opacity;
+            r.pc.straightAlpha = t->premultiplied ? 0.f : 1.f;
+            r.pc.invertMask = rd.invertedMask ? 1.f : 0.f;
+            for (int c = 0; c < 3; c++) { r.pc.multiply[c] = rd.multiply[c]; r.pc.screen[c] = rd.screen[c]; }
+            r.pc.multiply[3] = 1.f;
+            r.pc.screen[3] = 0.f;
+            drawIndexed(r, d.drawable);
+            r.stats.drawCalls++;
+        }
+        vk.CmdEndRenderPass(r.cmd);
+        next = batch.end;
+    }
+}
+
+static bool beginCommands(VkCommandBuffer cmd) {
+    vk.ResetCommandBuffer(cmd, 0);
+    VkCommandBufferBeginInfo bi{};
+    bi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    bi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    return vkCheck(vk.BeginCommandBuffer(cmd, &bi), "vkBeginCommandBuffer");
+}
+
+// 取得交换链图像之后录制或提交失败: acquire 信号量已 (将) 被触发却没有人等待, 再次 acquire 到它
+// 是非法用法。提交一个只等待它的空批次消耗掉信号; 连这也失败时等设备空闲后换一个新的信号量。
+// 图像没画过 (布局未定义) 不能呈现, 交换链标记为过期, 下一帧重建时一并交还
+static void abandonAcquired(FrameSlot& slot) {
+    g_vk.swapchain.stale = true;
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    VkSubmitInfo si{};
+    si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    si.waitSemaphoreCount = 1;
+    si.pWaitSemaphores = &slot.acquired;
+    si.pWaitDstStageMask = &waitStage;
+    vk.ResetFences(g_vk.device, 1, &slot.fence);
+    if (vk.QueueSubmit(g_vk.queue, 1, &si, slot.fence) == VK_SUCCESS) {
+        slot.serial = ++g_vk.submitted;
+        return;
+    }
+    slot.serial = 0;
+    vk.DeviceWaitIdle(g_vk.device);
+    vk.DestroySemaphore(g_vk.device, slot.acquired, nullptr);
+    slot.acquired = VK_NULL_HANDLE;
+    VkSemaphoreCreateInfo ci{};
+    ci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    vkCheck(vk.CreateSemaphore(g_vk.device, &ci, nullptr, &slot.acquired), "vkCreateSemaphore");   // 失败时窗口不再出帧
+}
+
+// 帧所需资源: 遮罩层 (有被遮罩的 draw 时) 与几何
+static bool prepareFrame(const VulkanFrame& f, int w, int h) {
+    if (!g_vk.positions.buffer || !g_vk.uvs.buffer || !g_vk.indices.buffer) return false;
+    for (int i = 0; i < f.drawCount; i++)
+        if (f.draws[i].maskCount > 0) return ensureMaskTarget(w, h);
+    return true;
+}
+
+bool vulkanDrawFrame(const VulkanFrame& frame, VulkanFrameStats* stats) {
+    if (!g_ready || g_vk.width <= 0 || g_vk.height <= 0) return false;
+    FrameSlot& slot = g_vk.slots[g_vk.submitted % kFramesInFlight];
+    if (slot.serial) {
+        vk.WaitForFences(g_vk.device, 1, &slot.fence, VK_TRUE, UINT64_MAX);
+        g_vk.completed = std::max(g_vk.completed, slot.serial);
+    }
+    releaseRetired(false);
+
+    const bool windowed = g_vk.swapchain.surface != VK_NULL_HANDLE;
+    TargetPipelines* pipelines = nullptr;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    int w = g_vk.width, h = g_vk.height;
+    uint32_t image = 0;
+    if (windowed) {
+        if (!slot.acquired || !ensureSwapchain()) return false;
+        Swapchain& sc = g_vk.swapchain;
+        VkResult r = vk.AcquireNextImageKHR(g_vk.device, sc.swapchain, UINT64_MAX, slot.acquired, VK_NULL_HANDLE, &image);
+        if (r == VK_ERROR_OUT_OF_DATE_KHR) { sc.stale = true; return false; }
+        if (r != VK_SUCCESS && r != VK_SUBOPTIMAL_KHR) return vkCheck(r, "vkAcquireNextImageKHR");
+        if (r == VK_SUBOPTIMAL_KHR) sc.stale = true;   // 这一帧照常呈现, 下一帧重建
+        pipelines = sc.pipelines;
+        framebuffer = sc.framebuffers[image];
+        w = sc.width;
+        h = sc.height;
+    } else {
+        if (!ensureOffscreen()) return false;
+        pipelines = targetPipelines(kOffscreenFormat, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        framebuffer = g_vk.offscreenFramebuffer;
+    }
+    // 准备失败时已取得的交换链图像仍要交还: 提交一个只清除的帧
+    const bool prepared = prepareFrame(frame, w, h);
+    if (!prepared && !windowed) return false;
+    VulkanFrame empty;
+    empty.matrix = frame.matrix;
+    Recorder r{ slot.cmd, prepared ? frame : empty, pipelines, framebuffer, w, h,
+                (VkDeviceSize)(g_vk.submitted % kFramesInFlight) * g_vk.positionSlice, VulkanFrameStats() };
+    if (!beginCommands(slot.cmd)) {
+        if (windowed) abandonAcquired(slot);
+        return false;
+    }
+    recordFrame(r);
+    vk.EndCommandBuffer(slot.cmd);
+
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    VkSubmitInfo si{};
+    si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    si.commandBufferCount = 1;
+    si.pCommandBuffers = &slot.cmd;
+    if (windowed) {
+        si.waitSemaphoreCount = 1;
+        si.pWaitSemaphores = &slot.acquired;
+        si.pWaitDstStageMask = &waitStage;
+        si.signalSemaphoreCount = 1;
+        si.pSignalSemaphores = &g_vk.swapchain.rendered[image];
+    }
+    vk.ResetFences(g_vk.device, 1, &slot.fence);
+    if (!vkCheck(vk.QueueSubmit(g_vk.queue, 1, &si, slot.fence), "vkQueueSubmit")) {
+        slot.serial = 0;
+        if (windowed) abandonAcquired(slot);
+        return false;
+    }
+    slot.serial = ++g_vk.submitted;
+
+    if (windowed) {
+        VkPresentInfoKHR pi{};
+        pi.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        pi.waitSemaphoreCount = 1;
+        pi.pWaitSemaphores = &g_vk.swapchain.rendered[image];
+        pi.swapchainCount = 1;
+        pi.pSwapchains = &g_vk.swapchain.swapchain;
+        pi.pImageIndices = &image;
+        VkResult pr = vk.QueuePresentKHR(g_vk.queue, &pi);
+        if (pr == VK_ERROR_OUT_OF_DATE_KHR || pr == VK_SUBOPTIMAL_KHR) g_vk.swapchain.stale = true;
+        else if (pr != VK_SUCCESS) vkCheck(pr, "vkQueuePresentKHR");
+    } else {
+        g_vk.offscreenValid = true;
+    }
+    if (stats) *stats = r.stats;
+    return true;
+}
+
+// 目标 (TRANSFER_SRC 布局) 复制进主机缓冲, 等待完成后逐行拷出 (已是顶行在前)
+static bool readImage(VkImage image, int w, int h, std::vector<uint8_t>& rgba) {
+    Buffer readback;
+    size_t bytes = (size_t)w * h * 4;
+    if (!createMappedBuffer(bytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT, readback, true)) return false;
+    VkCommandBuffer cmd = beginOneShot();
+    VkBufferImageCopy copy{};
+    copy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    copy.imageExtent = { (uint32_t)w, (uint32_t)h, 1 };
+    vk.CmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback.buffer, 1, &copy);
+    VkMemoryBarrier mb{};
+    mb.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    mb.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    mb.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vk.CmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &mb, 0, nullptr, 0, nullptr);
+    bool ok = submitOneShot();
+    if (ok) {
+        rgba.resize(bytes);
+        memcpy(rgba.data(), readback.mapped, bytes);
+    }
+    destroyBuffer(readback);
+    return ok;
+}
+
+bool vulkanReadFrame(std::vector<uint8_t>& rgba) {
+    if (!g_ready || !g_vk.offscreenValid) return false;
+    vk.DeviceWaitIdle(g_vk.device);
+    return readImage(g_vk.offscreen.image, g_vk.offscreen.width, g_vk.offscreen.height, rgba);
+}
+
+bool vulkanRenderImage(const VulkanFrame& frame, int width, int height, std::vector<uint8_t>& rgba) {
+    if (!g_ready || width <= 0 || height <= 0) return false;
+    vk.DeviceWaitIdle(g_vk.device);
+    for (FrameSlot& s : g_vk.slots) g_vk.completed = std::max(g_vk.completed, s.serial);
+    TargetPipelines* pipelines = targetPipelines(kOffscreenFormat, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    if (!pipelines || !prepareFrame(frame, width, height)) return false;
+    Image target;
+    VkFramebuffer fb = VK_NULL_HANDLE;
+    if (!createColorTarget(width, height, pipelines, target, fb)) return false;
+
+    // GPU 空闲, 借用下一帧的环形缓冲段
+    Recorder r{ beginOneShot(), frame, pipelines, fb, width, height,
+                (VkDeviceSize)(g_vk.submitted % kFramesInFlight) * g_vk.positionSlice, VulkanFrameStats() };
+    recordFrame(r);
+    bool ok = submitOneShot() && readImage(target.image, width, height, rgba);
+    vk.DestroyFramebuffer(g_vk.device, fb, nullptr);
+    destroyImage(target);
+    return ok;
+}
+
+// ===================== Lifecycle =====================
+
+static bool createCommon() {
+    VkCommandPoolCreateInfo pool{};
+    pool.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    pool.queueFamilyIndex = g_vk.queueFamily;
+    if (!vkCheck(vk.CreateCommandPool(g_vk.device, &pool, nullptr, &g_vk.commandPool), "vkCreateCommandPool")) return false;
+    VkCommandBuffer cmds[kFramesInFlight + 1];
+    VkCommandBufferAllocateInfo ai{};
+    ai.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    ai.commandPool = g_vk.commandPool;
+    ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    ai.commandBufferCount = kFramesInFlight + 1;
+    if (!vkCheck(vk.AllocateCommandBuffers(g_vk.device, &ai, cmds), "vkAllocateCommandBuffers")) return false;
+    VkFenceCreateInfo fi{};
+    fi.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkSemaphoreCreateInfo si{};
+    si.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    for (int i = 0; i < kFramesInFlight; i++) {
+        g_vk.slots[i].cmd = cmds[i];
+        if (!vkCheck(vk.CreateFence(g_vk.device, &fi, nullptr, &g_vk.slots[i].fence), "vkCreateFence")
+            || !vkCheck(vk.CreateSemaphore(g_vk.device, &si, nullptr, &g_vk.slots[i].acquired), "vkCreateSemaphore"))
+            return false;
+    }
+    g_vk.oneShot = cmds[kFramesInFlight];
+    if (!vkCheck(vk.CreateFence(g_vk.device, &fi, nullptr, &g_vk.oneShotFence), "vkCreateFence")) return false;
+
+    VkDescriptorSetLayoutBinding binding{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr };
+    VkDescriptorSetLayoutCreateInfo li{};
+    li.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    li.bindingCount = 1;
+    li.pBindings = &binding;
+    if (!vkCheck(vk.CreateDescriptorSetLayout(g_vk.device, &li, nullptr, &g_vk.setLayout), "vkCreateDescriptorSetLayout"))
+        return false;
+    // 纹理 + 遮罩层各一个集合; 模型贴图数量有限, 换 LOD 时旧集合先释放
+    const uint32_t kMaxSets = 256;
+    VkDescriptorPoolSize size{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, kMaxSets };
+    VkDescriptorPoolCreateInfo pi{};
+    pi.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pi.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    pi.maxSets = kMaxSets;
+    pi.poolSizeCount = 1;
+    pi.pPoolSizes = &size;
+    if (!vkCheck(vk.CreateDescriptorPool(g_vk.device, &pi, nullptr, &g_vk.descriptorPool), "vkCreateDescriptorPool"))
+        return false;
+    VkDescriptorSetLayout sets[2] = { g_vk.setLayout, g_vk.setLayout };
+    VkPushConstantRange range{ VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(VulkanPushConstants) };
+    VkPipelineLayoutCreateInfo pl{};
+    pl.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pl.setLayoutCount = 2;
+    pl.pSetLayouts = sets;
+    pl.pushConstantRangeCount = 1;
+    pl.pPushConstantRanges = &range;
+    if (!vkCheck(vk.CreatePipelineLayout(g_vk.device, &pl, nullptr, &g_vk.pipelineLayout), "vkCreatePipelineLayout"))
+        return false;
+
+    // 同 GLES 纹理: 线性 + 三线性 mipmap, 边缘截断
+    VkSamplerCreateInfo sc{};
+    sc.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sc.magFilter = VK_FILTER_LINEAR;
+    sc.minFilter = VK_FILTER_LINEAR;
+    sc.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    sc.addressModeU = sc.addressModeV = sc.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sc.maxLod = VK_LOD_CLAMP_NONE;
+    if (!vkCheck(vk.CreateSampler(g_vk.device, &sc, nullptr, &g_vk.sampler), "vkCreateSampler")) return false;
+
+    for (SpirvShader s : { SpirvShader::Vertex, SpirvShader::Mask, SpirvShader::Draw, SpirvShader::DrawMasked })
+        if (!(g_vk.modules[(int)s] = createModule(s))) return false;
+
+    g_vk.maskPass = createRenderPass(kMaskFormat, VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_IMAGE_LAYOUT_UNDEFINED,
+                                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true);
+    if (!g_vk.maskPass) return false;
+    PipelineDesc mask{ kMaskBlend, false, g_vk.modules[(int)SpirvShader::Mask] };
+    if (!createPipelines(g_vk.maskPass, &mask, 1, &g_vk.maskPipeline)) return false;
+    // 离屏 / 截图目标的管线现在就建, 交换链格式的在第一次建交换链时
+    return targetPipelines(kOffscreenFormat, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) != nullptr;
+}
+
+bool vulkanInit() {
+    if (g_ready) return true;
+    if (!loadLibrary() || !createInstance() || !loadInstanceFunctions() || !createDevice() || !createCommon()) {
+        vulkanShutdown();
+        return false;
+    }
+    g_ready = true;
+    LOGI("Vulkan: %s, %d frames in flight, %d mask layers", g_vk.deviceName.c_str(), kFramesInFlight, kMaskLayers);
+    return true;
+}
+
+void vulkanShutdown() {
+    if (g_vk.device) {
+        vk.DeviceWaitIdle(g_vk.device);
+        destroySwapchain();
+        destroyOffscreen();
+        destroyMaskTarget();
+        for (Texture& t : g_vk.textures) if (t.used) destroyTexture(t);
+        releaseRetired(true);
+        destroyBuffer(g_vk.uvs);
+        destroyBuffer(g_vk.indices);
+        destroyBuffer(g_vk.positions);
+        for (TargetPipelines* t : g_vk.targetPipelines) destroyTargetPipelines(t);
+        if (g_vk.maskPipeline) vk.DestroyPipeline(g_vk.device, g_vk.maskPipeline, nullptr);
+        if (g_vk.maskPass) vk.DestroyRenderPass(g_vk.device, g_vk.maskPass, nullptr);
+        for (VkShaderModule m : g_vk.modules) if (m) vk.DestroyShaderModule(g_vk.device, m, nullptr);
+        if (g_vk.sampler) vk.DestroySampler(g_vk.device, g_vk.sampler, nullptr);
+        if (g_vk.pipelineLayout) vk.DestroyPipelineLayout(g_vk.device, g_vk.pipelineLayout, nullptr);
+        if (g_vk.descriptorPool) vk.DestroyDescriptorPool(g_vk.device, g_vk.descriptorPool, nullptr);
+        if (g_vk.setLayout) vk.DestroyDescriptorSetLayout(g_vk.device, g_vk.setLayout, nullptr);
+        for (FrameSlot& s : g_vk.slots) {
+            if (s.fence) vk.DestroyFence(g_vk.device, s.fence, nullptr);
+            if (s.acquired) vk.DestroySemaphore(g_vk.device, s.acquired, nullptr);
+        }
+        if (g_vk.oneShotFence) vk.DestroyFence(g_vk.device, g_vk.oneShotFence, nullptr);
+        if (g_vk.commandPool) vk.DestroyCommandPool(g_vk.device, g_vk.commandPool, nullptr);
+        vk.DestroyDevice(g_vk.device, nullptr);
+    }
+    if (g_vk.instance) vk.DestroyInstance(g_vk.instance, nullptr);
+    if (g_library) dlclose(g_library);
+    g_library = nullptr;
+    g_vk = VulkanState();
+    vk = VkDispatch();
+    g_ready = false;
+}
+
+bool vulkanReady() { return g_ready; }
+
+const char* vulkanDeviceName() { return g_vk.deviceName.c_str(); }
+
+bool vulkanSetWindow(ANativeWindow* window) {
+    if (!g_ready) return false;
+    if (window == g_vk.window) return true;
+    destroySwapchain();
+    g_vk.window = nullptr;
+    if (!window) return true;
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+    VkAndroidSurfaceCreateInfoKHR ci{};
+    ci.sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR;
+    ci.window = window;
+    Swapchain& sc = g_vk.swapchain;
+    if (!vkCheck(vk.CreateAndroidSurfaceKHR(g_vk.instance, &ci, nullptr, &sc.surface), "vkCreateAndroidSurfaceKHR"))
+        return false;
+    VkBool32 supported = VK_FALSE;
+    vk.GetPhysicalDeviceSurfaceSupportKHR(g_vk.physical, g_vk.queueFamily, sc.surface, &supported);
+    if (!supported) {
+        LOGE("Vulkan: queue family %u cannot present", g_vk.queueFamily);
+        destroySwapchain();
+        return false;
+    }
+    g_vk.window = window;
+    return true;
+#else
+    LOGE("Vulkan: windows are only supported on Android");
+    return false;
+#endif
+}
+
+void vulkanResize(int width, int height) {
+    if (width == g_vk.width && height == g_vk.height) return;
+    g_vk.width = width;
+    g_vk.height = height;
+    g_vk.swapchain.stale = true;
+}
+
+int64_t vulkanTargetBytes() {
+    int64_t bytes = 0;
+    if (g_vk.offscreen.image) bytes += (int64_t)g_vk.offscreen.width * g_vk.offscreen.height * 4;
+    bytes += (int64_t)g_vk.swapchain.images.size() * g_vk.swapchain.width * g_vk.swapchain.height * 4;
+    if (g_vk.mask.image) bytes += (int64_t)g_vk.mask.width * g_vk.mask.height * kMaskLayers;
+    bytes += (int64_t)(g_vk.positions.size + g_vk.uvs.size + g_vk.indices.size);
+    return bytes;
+}
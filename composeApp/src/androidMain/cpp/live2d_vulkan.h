@@ -0,0 +1,107 @@
+#pragma once
+
+// Vulkan backend for the renderer (live2d_renderer.h selects it at init and
+// falls back to GLES when vulkanInit() fails). The renderer still does the
+// model update, culling and mask bookkeeping; this file turns one frame's
+// draw list into a single command buffer:
+//
+//   - Pipelines are built at init for every blend (normal / additive /
+//     multiply) x culling x masked combination plus the mask pipeline, so no
+//     state is compiled or looked up by the driver while recording. Shader
+//     permutations are push constants (live2d_spirv.h).
+//   - Vertex positions are copied each frame into a persistently mapped,
+//     host-coherent ring (one slice per frame in flight); UVs and indices are
+//     static and uploaded once per model.
+//   - Clipping masks are drawn in their own render pass into R8 layers before
+//     the main pass. Masked draws whose rects do not overlap share a layer;
+//     when the layers run out the main pass is ended, the next batch of masks
+//     rendered and the main pass resumed with a load pass.
+//   - Two frames in flight, each with its command buffer, fence and ring slice.
+//
+// The target is a swapchain on Android (vulkanSetWindow) and an offscreen
+// RGBA8 image elsewhere, read back with vulkanReadFrame for the image-diff
+// tests. The projection is flipped in y, so images come out top row first.
+// Textures are uploaded bottom row first as on GL, so UVs need no change.
+//
+// Everything runs on the render thread. The loader is opened at run time
+// (libvulkan.so / libvulkan.so.1); no Vulkan symbol is linked.
+
+#include "live2d_raster.h"
+
+#include <cstdint>
+#include <vector>
+
+struct ANativeWindow;
+
+/** One draw of the frame, in draw order. */
+struct VulkanDraw {
+    int drawable = -1;                 // index into VulkanFrame::drawables
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;   // pixel rect covering the drawable, top-left origin
+    const int* masks = nullptr;        // mask sources to draw (already culled); none = unmasked
+    int maskCount = 0;
+};
+
+struct VulkanFrame {
+    const RasterDrawable* drawables = nullptr;   // all drawables of the model (positions of this frame)
+    int drawableCount = 0;
+    const VulkanDraw* draws = nullptr;
+    int drawCount = 0;
+    const uint32_t* textures = nullptr;          // model texture index -> vulkanCreateTexture id, 0 = none
+    int textureCount = 0;
+    const float* matrix = nullptr;               // column-major model -> NDC, GL convention
+};
+
+struct VulkanFrameStats {
+    int drawCalls = 0;
+    int maskDraws = 0;
+    int maskPasses = 0;       // mask render passes (batches of up to kMaskLayers masked draws)
+    int pipelineBinds = 0;
+    int renderPasses = 0;     // main + mask passes
+};
+
+/** Load the driver, create the device and build every pipeline. False = use GLES. */
+bool vulkanInit();
+
+/** Wait for the GPU and destroy everything (textures included). */
+void vulkanShutdown();
+
+bool vulkanReady();
+
+/** physical device name, empty before init. */
+const char* vulkanDeviceName();
+
+/**
+ * Render to window (Android) or, with nullptr, to an offscreen image. Takes no
+ * reference: the caller keeps window alive until it sets another one.
+ */
+bool vulkanSetWindow(ANativeWindow* window);
+
+/** Target size in pixels; the swapchain or offscreen image is recreated on the next frame. */
+void vulkanResize(int width, int height);
+
+/** RGBA8, bottom row first. Power-of-two sizes get a mip chain. 0 on failure. */
+uint32_t vulkanCreateTexture(const uint8_t* rgba, int width, int height, bool premultiplied);
+
+/** Released once the frames that may use it have completed. */
+void vulkanDestroyTexture(uint32_t id);
+
+/**
+ * Static geometry of the model: UVs and indices of every drawable (positions
+ * are taken from each frame). Call after a model load, before its first frame.
+ */
+bool vulkanSetGeometry(const RasterDrawable* drawables, int count);
+
+/** Record, submit and (on a window) present one frame over a transparent clear. */
+bool vulkanDrawFrame(const VulkanFrame& frame, VulkanFrameStats* stats = nullptr);
+
+/** Last frame of the offscreen target: premultiplied RGBA8, top row first. Waits for the GPU. */
+bool vulkanReadFrame(std::vector<uint8_t>& rgba);
+
+/**
+ * Render frame into a temporary width x height target and read it back
+ * (snapshots). Synchronous; leaves the on-screen target untouched.
+ */
+bool vulkanRenderImage(const VulkanFrame& frame, int width, int height, std::vector<uint8_t>& rgba);
+
+/** Estimated GPU memory of render targets (main, masks, ring), as MemoryStats::renderTargets. */
+int64_t vulkanTargetBytes();
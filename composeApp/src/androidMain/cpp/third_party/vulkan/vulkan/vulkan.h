@@ -0,0 +1,20 @@
+#ifndef VULKAN_H_
+#define VULKAN_H_ 1
+
+/*
+** Copyright 2015-2023 The Khronos Group Inc.
+**
+** SPDX-License-Identifier: Apache-2.0
+*/
+
+// Subset of the Khronos Vulkan-Headers (see ../README.md), used on Android and
+// on the host so the build needs neither the NDK's nor a system copy.
+
+#include "vk_platform.h"
+#include "vulkan_core.h"
+
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+#include "vulkan_android.h"
+#endif
+
+#endif // VULKAN_H_
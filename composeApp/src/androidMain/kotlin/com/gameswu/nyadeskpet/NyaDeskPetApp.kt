@@ -4,8 +4,10 @@ import android.app.Application
 import com.gameswu.nyadeskpet.di.androidModule
 import com.gameswu.nyadeskpet.di.commonModule
 import com.gameswu.nyadeskpet.di.setupWiring
+import com.gameswu.nyadeskpet.live2d.Live2DManager
 import org.koin.android.ext.koin.androidContext
 import org.koin.android.ext.koin.androidLogger
+import org.koin.core.context.GlobalContext
 import org.koin.core.context.startKoin
 
 class NyaDeskPetApp : Application() {
@@ -18,4 +20,10 @@ class NyaDeskPetApp : Application() {
             setupWiring()
         }
     }
+
+    override fun onTrimMemory(level: Int) {
+        super.onTrimMemory(level)
+        // 释放 native 渲染缓存，必要时降低纹理分辨率
+        GlobalContext.getOrNull()?.getOrNull<Live2DManager>()?.onTrimMemory(level)
+    }
 }
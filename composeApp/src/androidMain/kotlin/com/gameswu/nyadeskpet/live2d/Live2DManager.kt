@@ -1,75 +1,74 @@
 package com.gameswu.nyadeskpet.live2d
 
+import android.content.ComponentCallbacks2
 import android.content.Context
-import android.opengl.GLSurfaceView
+import android.graphics.Bitmap
+import android.graphics.PixelFormat
+import android.view.Surface
+import android.view.SurfaceHolder
+import android.view.SurfaceView
+import androidx.compose.ui.graphics.ImageBitmap
+import androidx.compose.ui.graphics.asImageBitmap
 import com.gameswu.nyadeskpet.PlatformContext
 import com.gameswu.nyadeskpet.agent.*
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.first
+import kotlinx.coroutines.withContext
+import kotlinx.coroutines.withTimeoutOrNull
 
 /**
  * Android Live2D Manager implementation.
+ *
+ * 渲染由 native 渲染线程完成（见 Live2DRenderer）：这里的调用只是把命令交给它，
+ * 唇形同步与视线跟随的数值只在变化时写入，由渲染线程每帧应用。
  */
 actual class Live2DManager actual constructor(private val context: PlatformContext) {
 
-    private var glSurfaceView: GLSurfaceView? = null
     private var renderer: Live2DRenderer? = null
     @Volatile
     private var lipSyncValue = 0f
-    /** 当前模型的唇形同步参数 ID 列表（从 model3.json Groups.LipSync.Ids 解析） */
-    private var lipSyncParamIds: List<String> = Live2DJsonParser.DEFAULT_LIP_SYNC_PARAMS
-    @Volatile
-    private var pendingModelPath: String? = null
 
-    /** 记住上次成功请求加载的模型路径，用于 GL 上下文重建时自动重载 */
+    /** 记住上次请求加载的模型路径（调用记录时重新加载，提取模型信息时等待其完成） */
     @Volatile
     private var lastLoadedModelPath: String? = null
 
+    /** 渲染线程上最近一次加载完成的模型及其 native 模型信息（加载失败时 metadata 为 null） */
+    private data class LoadedModel(val path: String, val metadata: Live2DModelMetadata?)
+    private val loadedModel = MutableStateFlow<LoadedModel?>(null)
+
     // ===== 视线跟随 =====
-    private val gazeController = GazeController()
     @Volatile
     private var eyeTrackingEnabled = true
 
+    init {
+        Live2DRenderer.onModelLoaded = this::onNativeModelLoaded
+    }
+
+    /** 渲染线程已启动时执行（首次调用时启动） */
+    private inline fun withNative(block: Live2DRenderer.Companion.() -> Unit) {
+        if (Live2DRenderer.start(context)) Live2DRenderer.block()
+    }
+
     actual fun initialize(): Boolean = true
 
     actual fun loadModel(modelPath: String): Boolean {
         android.util.Log.i("Live2DManager", "loadModel called: $modelPath")
         lastLoadedModelPath = modelPath
-
-        // 解析模型的 LipSync 参数 ID（从 model3.json Groups）
-        try {
-            val json = context.assets.open(modelPath).bufferedReader().use { it.readText() }
-            val ids = Live2DJsonParser.parseLipSyncIds(json)
-            if (ids.isNotEmpty()) {
-                lipSyncParamIds = ids
-                android.util.Log.i("Live2DManager", "LipSync params: $ids")
-            } else {
-                lipSyncParamIds = Live2DJsonParser.DEFAULT_LIP_SYNC_PARAMS // fallback
-                android.util.Log.i("Live2DManager", "LipSync params: fallback to ParamMouthOpenY")
-            }
-        } catch (e: Exception) {
-            lipSyncParamIds = Live2DJsonParser.DEFAULT_LIP_SYNC_PARAMS
-            android.util.Log.w("Live2DManager", "Cannot parse LipSync IDs, using fallback", e)
-        }
-
-        val r = renderer
-        val surface = glSurfaceView
-        if (r != null && surface != null) {
-            android.util.Log.i("Live2DManager", "GL available, queuing load on GL thread")
-            surface.queueEvent { r.requestLoadModel(modelPath) }
-        } else {
-            android.util.Log.i("Live2DManager", "GL not ready, saving as pending")
-            pendingModelPath = modelPath
-        }
+        // 渲染线程有上下文即可加载，不必等 surface；LipSync 参数 ID 在加载完成后由 onNativeModelLoaded 设置
+        withNative { nativeLoadModel(modelPath, false) }
         return true
     }
 
     actual fun setParameterValue(id: String, value: Float, weight: Float) {
-        val r = renderer ?: return
-        val s = glSurfaceView ?: return
-        s.queueEvent { r.nativeSetParameterValue(id, value, weight) }
+        withNative { nativeSetParameterValue(id, value, weight) }
     }
 
     actual fun setLipSync(value: Float) {
+        if (value == lipSyncValue) return
         lipSyncValue = value
+        withNative { nativeSetLipSync(value) }
     }
 
     /**
@@ -79,105 +78,136 @@ actual class Live2DManager actual constructor(private val context: PlatformConte
      * @param offsetY 垂直偏移 (NDC, -1..1)
      */
     actual fun setModelTransform(scale: Float, offsetX: Float, offsetY: Float) {
-        val r = renderer ?: return
-        val s = glSurfaceView ?: return
-        s.queueEvent { r.nativeSetModelTransform(scale, offsetX, offsetY) }
+        withNative { nativeSetModelTransform(scale, offsetX, offsetY) }
     }
 
     actual fun playMotion(group: String, index: Int, priority: Int) {
-        val r = renderer ?: return
-        val s = glSurfaceView ?: return
-        s.queueEvent { r.nativeStartMotion(group, index, priority) }
+        withNative { nativeStartMotion(group, index, priority) }
     }
 
     actual fun setExpression(expressionId: String) {
-        val r = renderer ?: return
-        val s = glSurfaceView ?: return
-        s.queueEvent { r.nativeSetExpression(expressionId) }
-    }
-
-    fun bindSurface(surface: GLSurfaceView) {
-        glSurfaceView = surface
-        // 如果有明确的 pending，使用它；否则用上次加载的模型路径（GL 上下文重建场景）
-        val pending = pendingModelPath ?: lastLoadedModelPath
-        pendingModelPath = null
-        android.util.Log.i("Live2DManager", "bindSurface called, pending=$pending (last=$lastLoadedModelPath)")
-
-        renderer = Live2DRenderer(context).also { r ->
-            // 将待加载模型路径传给 renderer，在 onSurfaceCreated 后加载
-            if (pending != null) {
-                android.util.Log.i("Live2DManager", "Passing pending path to renderer")
-                r.pendingModelPath = pending
-            }
-            surface.setEGLContextClientVersion(2)
-            surface.setEGLConfigChooser(8, 8, 8, 8, 16, 0) // RGBA8 + depth16, no stencil
-            surface.holder.setFormat(android.graphics.PixelFormat.TRANSLUCENT)
-            surface.setZOrderOnTop(true)
-            surface.setRenderer(r)
-            surface.renderMode = GLSurfaceView.RENDERMODE_CONTINUOUSLY
-        }
-        renderer?.onFrameUpdate = this::onFrameUpdate
+        withNative { nativeSetExpression(expressionId) }
     }
 
-    private fun onFrameUpdate() {
-        applyLipSync()
-        applyGaze()
+    /**
+     * 开始记录对 native 渲染器的全部调用（参数、动作、表情、变换及每帧 dt），
+     * 写入应用私有目录下的二进制 trace，可在 Linux 上用 live2d_bench --replay 逐帧复现。
+     * 已加载的模型会重新加载一次，使 trace 从模型加载开始。
+     * @return trace 文件路径；native 不可用时返回 null
+     */
+    fun startCallRecording(): String? {
+        if (!Live2DRenderer.start(context)) return null
+        val file = java.io.File(context.filesDir, "live2d_calls_${System.currentTimeMillis()}.l2dcalls")
+        Live2DRenderer.nativeStartCallRecording(file.absolutePath)
+        lastLoadedModelPath?.let { Live2DRenderer.nativeLoadModel(it, true) }
+        return file.absolutePath
     }
 
-    private fun applyLipSync() {
-        val r = renderer ?: return
-        for (paramId in lipSyncParamIds) {
-            r.nativeSetParameterValue(paramId, lipSyncValue)
-        }
+    fun stopCallRecording() {
+        withNative { nativeStopCallRecording() }
     }
 
-    // ===== 视线跟随 =====
+    /** 把应用内画布的 SurfaceView 交给渲染线程 */
+    fun bindSurface(surface: SurfaceView) {
+        android.util.Log.i("Live2DManager", "bindSurface called, model=$lastLoadedModelPath")
+        renderer?.detach()
+        renderer = Live2DRenderer(context).also { it.attach(surface) }
+    }
 
-    /**
-     * 每帧应用视线参数到 Live2D 模型。
-     * 对齐原项目 FocusController → ParamEyeBallX/Y, ParamAngleX/Y/Z, ParamBodyAngleX
-     */
-    private fun applyGaze() {
-        val r = renderer ?: return
-        val (focusX, focusY) = gazeController.update(System.currentTimeMillis())
-
-        // ParamEyeBallX/Y: 眼球方向 ±1
-        r.nativeSetParameterValue("ParamEyeBallX", focusX)
-        r.nativeSetParameterValue("ParamEyeBallY", focusY)
-        // ParamAngleX/Y: 脸部朝向 ±30
-        r.nativeSetParameterValue("ParamAngleX", focusX * 30f)
-        r.nativeSetParameterValue("ParamAngleY", focusY * 30f)
-        // ParamAngleZ: 脸部倾斜 (交叉项)
-        r.nativeSetParameterValue("ParamAngleZ", focusX * focusY * -30f)
-        // ParamBodyAngleX: 身体偏转 ±10
-        r.nativeSetParameterValue("ParamBodyAngleX", focusX * 10f)
+    fun unbindSurface() {
+        renderer?.detach()
+        renderer = null
+    }
+
+    /** 渲染线程回调：native 加载完成，解码模型信息并设置唇形同步参数 */
+    private fun onNativeModelLoaded(path: String, blob: ByteArray?) {
+        val metadata = blob?.let { Live2DModelMetadata.decode(it) }
+        val ids = metadata?.groupIds("LipSync").orEmpty().ifEmpty { Live2DJsonParser.DEFAULT_LIP_SYNC_PARAMS }
+        Live2DRenderer.nativeSetLipSyncParameters(ids.toTypedArray())
+        android.util.Log.i("Live2DManager", "Model loaded: $path, metadata=${blob?.size ?: 0} bytes, LipSync params: $ids")
+        loadedModel.value = LoadedModel(path, metadata)
     }
 
+    /** 已加载模型的信息（路径不符或尚未加载完成时为 null） */
+    private fun metadataFor(modelPath: String): Live2DModelMetadata? =
+        loadedModel.value?.takeIf { it.path == modelPath }?.metadata
+
+    /** 等待渲染线程加载 [modelPath] 完成；超时或加载失败返回 null */
+    private suspend fun awaitMetadata(modelPath: String): Live2DModelMetadata? =
+        withTimeoutOrNull(METADATA_TIMEOUT_MS) {
+            loadedModel.first { it?.path == modelPath }?.metadata
+        }
+
+    // ===== 视线跟随 =====
+    // 平滑（对齐 GazeController）与参数映射（ParamEyeBallX/Y, ParamAngleX/Y/Z, ParamBodyAngleX）
+    // 都在渲染线程每帧完成，这里只转发目标
+
     actual fun setGazeTarget(x: Float, y: Float) {
         if (!eyeTrackingEnabled) return
-        gazeController.setTarget(x, y)
+        withNative { nativeSetGazeTarget(x, y) }
     }
 
     actual fun clearGazeTarget() {
-        gazeController.clearTarget()
+        withNative { nativeClearGazeTarget() }
     }
 
     actual fun resetGaze() {
-        gazeController.forceReset()
+        withNative { nativeResetGaze() }
     }
 
     actual fun setEyeTrackingEnabled(enabled: Boolean) {
         eyeTrackingEnabled = enabled
-        if (!enabled) {
-            gazeController.forceReset()
+        withNative { nativeSetEyeTracking(enabled) }
+    }
+
+    actual fun setDynamicResolution(enabled: Boolean) {
+        Live2DRenderer.setDynamicResolution(enabled)
+    }
+
+    actual fun setIdleFlipbook(enabled: Boolean) {
+        Live2DRenderer.setIdleFlipbook(enabled)
+    }
+
+    actual fun setClippingMode(mode: String) {
+        Live2DRenderer.setClipMode(Live2DRenderer.clipModeOf(mode))
+    }
+
+    actual suspend fun renderThumbnail(modelPath: String, size: Int): ImageBitmap? {
+        if (!Live2DRenderer.nativeAvailable || modelPath.isBlank() || size <= 0) return null
+        return withContext(Dispatchers.Default) {
+            // native 输出预乘 RGBA，与 ARGB_8888 的内存布局一致
+            val rgba = Live2DRenderer.nativeRenderThumbnail(context.assets, modelPath, size, size)
+                ?: return@withContext null
+            val bitmap = Bitmap.createBitmap(size, size, Bitmap.Config.ARGB_8888)
+            bitmap.copyPixelsFromBuffer(java.nio.ByteBuffer.wrap(rgba))
+            bitmap.asImageBitmap()
         }
     }
 
+    actual suspend fun captureSnapshot(width: Int, height: Int, background: Int): ImageBitmap? {
+        if (!Live2DRenderer.start(context)) return null
+        val snapshot = Live2DRenderer.captureSnapshot(width, height, background, SNAPSHOT_TIMEOUT_MS) ?: return null
+        return withContext(Dispatchers.Default) {
+            val bitmap = Bitmap.createBitmap(snapshot.width, snapshot.height, Bitmap.Config.ARGB_8888)
+            bitmap.copyPixelsFromBuffer(java.nio.ByteBuffer.wrap(snapshot.rgba))
+            bitmap.asImageBitmap()
+        }
+    }
+
+    /** 系统内存紧张时由 Application.onTrimMemory 转发 */
+    fun onTrimMemory(level: Int) {
+        Live2DRenderer.trimMemory(level)
+    }
+
+    /** native 内存占用明细（字节，顺序见 Live2DRenderer.memoryStats）；渲染线程未启动时为 null */
+    fun memoryStats(): LongArray? = Live2DRenderer.memoryStats()
+
     /**
-     * 从 assets 读取 model3.json 并解析 HitAreas。
      * 返回有效的 hitArea 名称列表（Name 为空时 fallback 到 Id）。
+     * 模型已由 native 加载时直接使用其模型信息，否则从 assets 读取 model3.json 解析。
      */
     actual fun getModelHitAreas(modelPath: String): List<String> {
+        metadataFor(modelPath)?.let { return it.hitAreaNames() }
         return try {
             val json = context.assets.open(modelPath).bufferedReader().use { it.readText() }
             Live2DJsonParser.parseHitAreas(json)
@@ -188,13 +218,18 @@ actual class Live2DManager actual constructor(private val context: PlatformConte
     }
 
     /**
-     * 从 model3.json 提取完整的模型信息（对齐原项目 extractModelInfo）。
+     * 提取完整的模型信息（对齐原项目 extractModelInfo）。
      *
-     * 静态解析 model3.json 中的 Expressions、Motions、HitAreas，
-     * 并尝试加载同目录下的 param-map.json 以获取语义映射。
-     * availableParameters 需要运行时 JNI 访问，此处暂留空。
+     * 正在加载的模型等待 native 加载完成，直接使用其模型信息（含参数范围与画布尺寸），
+     * 不再重复读取和解析 model3.json；其他情况回退到静态解析 model3.json。
+     * 两种情况都会尝试加载同目录下的 param-map.json 以获取语义映射。
      */
-    actual fun extractModelInfo(modelPath: String): ModelInfo? {
+    actual suspend fun extractModelInfo(modelPath: String): ModelInfo? {
+        val metadata = metadataFor(modelPath)
+            ?: if (modelPath == lastLoadedModelPath && Live2DRenderer.nativeAvailable) awaitMetadata(modelPath) else null
+        if (metadata != null) {
+            return metadata.toModelInfo(modelPath, loadParamMap(context.assets, paramMapPath(modelPath)))
+        }
         return try {
             val json = context.assets.open(modelPath).bufferedReader().use { it.readText() }
 
@@ -208,9 +243,7 @@ actual class Live2DManager actual constructor(private val context: PlatformConte
             val hitAreas = Live2DJsonParser.parseHitAreas(json)
 
             // 尝试加载 param-map.json
-            val modelDir = modelPath.substringBeforeLast('/', "")
-            val paramMapPath = if (modelDir.isNotBlank()) "$modelDir/${Live2DJsonParser.PARAM_MAP_FILENAME}" else Live2DJsonParser.PARAM_MAP_FILENAME
-            val paramMap = loadParamMap(context.assets, paramMapPath)
+            val paramMap = loadParamMap(context.assets, paramMapPath(modelPath))
 
             // 构建 ModelInfo
             val modelInfo = ModelInfo(
@@ -237,6 +270,15 @@ actual class Live2DManager actual constructor(private val context: PlatformConte
     }
 
     companion object {
+        private const val METADATA_TIMEOUT_MS = 10_000L
+        /** 快照通常两帧内完成；超过则认为渲染线程没有在出帧（没有 surface 等） */
+        private const val SNAPSHOT_TIMEOUT_MS = 2_000L
+
+        private fun paramMapPath(modelPath: String): String {
+            val modelDir = modelPath.substringBeforeLast('/', "")
+            return if (modelDir.isNotBlank()) "$modelDir/${Live2DJsonParser.PARAM_MAP_FILENAME}" else Live2DJsonParser.PARAM_MAP_FILENAME
+        }
+
         private fun loadParamMap(assets: android.content.res.AssetManager, path: String): ParamMapData? {
             return try {
                 val text = assets.open(path).bufferedReader().use { it.readText() }
@@ -250,84 +292,263 @@ actual class Live2DManager actual constructor(private val context: PlatformConte
 
 /**
  * JNI bridge for Live2D rendering.
+ *
+ * native 渲染线程（live2d_thread.cpp）在进程内只有一个：它持有 EGL 上下文，按 AChoreographer 的 vsync
+ * 出帧，唇形同步与视线平滑也在 native 每帧应用，Kotlin 不再每帧调用 JNI。
+ * 下面的 native 调用可以在任意线程进行，作为任务在下一帧之前于渲染线程执行。
+ * surface 销毁时上下文保留（只放开窗口），回到前台不必重新加载模型。
+ *
+ * 每个实例把一个 SurfaceView 的 surface 交给渲染线程。应用内画布与悬浮窗同时存在时，
+ * 最近一次 surfaceChanged 的视图显示模型，它的 surface 销毁后交还给仍然存活的视图。
  */
-class Live2DRenderer(private val context: Context) : GLSurfaceView.Renderer {
-    var onFrameUpdate: (() -> Unit)? = null
-    val assetManager: android.content.res.AssetManager = context.assets
+class Live2DRenderer(private val context: Context) : SurfaceHolder.Callback {
+    private var view: SurfaceView? = null
+
+    /** 当前交给渲染线程的 surface 与尺寸（仅主线程访问）；null = 没有可用 surface */
+    private var surface: Surface? = null
+    private var surfaceWidth = 0
+    private var surfaceHeight = 0
+
+    /** 绑定视图：透明背景、置于窗口之上，surface 生命周期转给渲染线程 */
+    fun attach(view: SurfaceView) {
+        if (!start(context)) return
+        this.view = view
+        view.holder.setFormat(PixelFormat.TRANSLUCENT)
+        view.setZOrderOnTop(true)
+        view.holder.addCallback(this)
+    }
 
-    /** 待加载的模型路径 — 在 onSurfaceCreated 之后执行 */
-    @Volatile
-    var pendingModelPath: String? = null
+    fun detach() {
+        view?.holder?.removeCallback(this)
+        view = null
+        releaseSurface()
+    }
 
-    /** GL 线程上的初始化状态 */
-    @Volatile
-    private var glInitialized = false
-
-    // JNI declarations
-    external fun nativeInit(assetManager: android.content.res.AssetManager)
-    external fun nativeLoadModel(assetManager: android.content.res.AssetManager, modelPath: String)
-    external fun nativeStartMotion(group: String, index: Int, priority: Int)
-    external fun nativeSetExpression(expressionId: String)
-    external fun nativeSetParameterValue(paramId: String, value: Float, weight: Float = 1f)
-    external fun nativeOnDrawFrame()
-    external fun nativeOnSurfaceChanged(width: Int, height: Int)
-    external fun nativeSetModelTransform(scale: Float, offsetX: Float, offsetY: Float)
+    override fun surfaceCreated(holder: SurfaceHolder) {
+        // 尺寸在 surfaceChanged 中给出（创建后必定调用一次）
+    }
+
+    override fun surfaceChanged(holder: SurfaceHolder, format: Int, width: Int, height: Int) {
+        surface = holder.surface
+        surfaceWidth = width
+        surfaceHeight = height
+        synchronized(bindings) {
+            bindings.remove(this)
+            bindings.add(this)
+        }
+        nativeSetSurface(holder.surface, width, height)
+    }
+
+    override fun surfaceDestroyed(holder: SurfaceHolder) {
+        releaseSurface()
+    }
+
+    private fun releaseSurface() {
+        val s = surface ?: return
+        surface = null
+        // 返回时渲染线程已不再使用该 surface
+        nativeReleaseSurface(s)
+        val next = synchronized(bindings) {
+            bindings.remove(this)
+            bindings.lastOrNull()
+        }
+        if (next == null) return
+        val nextSurface = next.surface ?: return
+        nativeSetSurface(nextSurface, next.surfaceWidth, next.surfaceHeight)
+    }
+
+    /** 完成的快照：预乘 RGBA，顶行在前 */
+    class SnapshotPixels(val width: Int, val height: Int, val rgba: ByteArray)
 
     companion object {
+        private const val TAG = "Live2DRenderer"
+
         var nativeAvailable: Boolean = false
             private set
 
-        init {
-            try {
-                System.loadLibrary("live2d_native")
-                nativeAvailable = true
-            } catch (e: UnsatisfiedLinkError) {
-                android.util.Log.w("Live2DRenderer", "Native library not available: ${e.message}")
-                nativeAvailable = false
+        @Volatile
+        private var started = false
+
+        /** 持有可用 surface 的实例，最后一个正在显示（仅主线程修改） */
+        private val bindings = ArrayList<Live2DRenderer>()
+
+        /** 每次 native 加载结束后在渲染线程调用：模型路径与模型信息 blob（失败时为 null） */
+        @Volatile
+        var onModelLoaded: ((String, ByteArray?) -> Unit)? = null
+
+        // 渲染设置在进程内共享，渲染线程启动后立即应用
+        @Volatile
+        private var dynamicResolution = false
+        @Volatile
+        private var idleFlipbook = false
+        @Volatile
+        private var clipMode = 0
+
+        /** 启动前设置：渲染线程优先使用 Vulkan 后端（native 需以 -Plive2d.vulkan=true 编译），不可用时回退 GLES */
+        @Volatile
+        var preferVulkan = false
+
+        private val nextSnapshotToken = java.util.concurrent.atomic.AtomicInteger(1)
+        private val pendingSnapshots = java.util.concurrent.ConcurrentHashMap<Int, CompletableDeferred<SnapshotPixels?>>()
+
+        /** 设置项 clippingMode 转为 native 的 ClipMode */
+        fun clipModeOf(setting: String): Int = when (setting) {
+            "mask" -> 1
+            "stencil" -> 2
+            else -> 0
+        }
+
+        /**
+         * 启动渲染线程（进程内一次，可重复调用）。线程创建 EGL 上下文后即可加载模型，有 surface 后开始出帧。
+         * @return native 不可用或启动失败时返回 false
+         */
+        @Synchronized
+        fun start(context: Context): Boolean {
+            if (started || !nativeAvailable) return started
+            // 着色器程序二进制缓存放在 codeCacheDir（应用或系统升级时会被清空），重建上下文时免去重新编译
+            val shaderCache = java.io.File(context.codeCacheDir, "live2d_shaders")
+            val cacheDir = if (shaderCache.isDirectory || shaderCache.mkdirs()) shaderCache.absolutePath else ""
+            started = nativeStart(context.applicationContext.assets, cacheDir, preferVulkan)
+            if (!started) {
+                android.util.Log.e(TAG, "Render thread failed to start")
+                return false
             }
+            applyDynamicResolution()
+            applyIdleFlipbook()
+            nativeSetClipMode(clipMode)
+            return true
         }
-    }
 
-    /**
-     * 线程安全的模型加载请求（在 GL 线程调用）。
-     * 如果 GL 已初始化则立即加载，否则暂存等 onSurfaceCreated 后加载。
-     */
-    fun requestLoadModel(path: String) {
-        if (glInitialized) {
-            nativeLoadModel(assetManager, path)
-        } else {
-            pendingModelPath = path
+        fun setDynamicResolution(enabled: Boolean) {
+            dynamicResolution = enabled
+            if (started) applyDynamicResolution()
         }
-    }
 
-    // 纹理解码已完全移至 C++ (stb_image)，不再需要 Java 侧 decodeBitmapFromAssets
-
-    override fun onSurfaceCreated(
-        gl: javax.microedition.khronos.opengles.GL10?,
-        config: javax.microedition.khronos.egl.EGLConfig?
-    ) {
-        if (nativeAvailable) {
-            nativeInit(assetManager)
-            glInitialized = true
-            // GL 就绪后加载待加载的模型
-            pendingModelPath?.let { path ->
-                pendingModelPath = null
-                android.util.Log.i("Live2DRenderer", "Loading pending model: $path")
-                nativeLoadModel(assetManager, path)
+        fun setIdleFlipbook(enabled: Boolean) {
+            idleFlipbook = enabled
+            if (started) applyIdleFlipbook()
+        }
+
+        /** 遮罩裁剪方式（0 自动 / 1 遮罩纹理 / 2 模板缓冲，见 clipModeOf） */
+        fun setClipMode(mode: Int) {
+            clipMode = mode
+            if (started) nativeSetClipMode(mode)
+        }
+
+        // 帧预算按 60 Hz 计，超出时降低模型渲染分辨率
+        private fun applyDynamicResolution() = nativeSetDynamicResolution(dynamicResolution, 1000f / 60f)
+
+        // 待机循环烘焙 32 帧、半分辨率
+        private fun applyIdleFlipbook() = nativeSetIdleFlipbook(idleFlipbook, 32, 0.5f)
+
+        /**
+         * 异步截取模型画面（参数见 Live2DManager.captureSnapshot）。可在任意线程调用：
+         * 请求在下一帧渲染，像素读回不阻塞渲染线程，通常两帧后完成；无法截取或超时返回 null。
+         */
+        suspend fun captureSnapshot(width: Int, height: Int, background: Int, timeoutMs: Long): SnapshotPixels? {
+            if (!started) return null
+            val token = nextSnapshotToken.getAndIncrement()
+            val result = CompletableDeferred<SnapshotPixels?>()
+            pendingSnapshots[token] = result
+            try {
+                nativeRequestSnapshot(token, width, height, background)
+                return withTimeoutOrNull(timeoutMs) { result.await() }
+            } finally {
+                // 超时、取消或 native 未交付时也不留下等待项
+                pendingSnapshots.remove(token)
             }
         }
-    }
 
-    override fun onSurfaceChanged(
-        gl: javax.microedition.khronos.opengles.GL10?,
-        width: Int,
-        height: Int
-    ) {
-        if (nativeAvailable) nativeOnSurfaceChanged(width, height)
-    }
+        /**
+         * 响应系统内存压力（ComponentCallbacks2.onTrimMemory）。可在任意线程调用，下一帧前在渲染线程执行：
+         * 1 = 释放缓存（序列帧图集、帧内存池），2 = 再降低纹理分辨率并卸载未使用的表情，3 = 纹理降到最低档。
+         */
+        fun trimMemory(level: Int) {
+            if (!started) return
+            @Suppress("DEPRECATION")
+            val nativeLevel = when {
+                level >= ComponentCallbacks2.TRIM_MEMORY_COMPLETE ||
+                    level == ComponentCallbacks2.TRIM_MEMORY_RUNNING_CRITICAL -> 3
+                level >= ComponentCallbacks2.TRIM_MEMORY_BACKGROUND ||
+                    level == ComponentCallbacks2.TRIM_MEMORY_RUNNING_LOW -> 2
+                else -> 1
+            }
+            nativeTrimMemory(nativeLevel)
+        }
+
+        /**
+         * native 内存占用（字节）：[moc, model, bundle, textures, pendingPixels, renderTargets,
+         * motions, expressions, physics, caches, total]。在渲染线程统计，调用方等待结果；渲染线程未启动时返回 null。
+         */
+        fun memoryStats(): LongArray? {
+            if (!started) return null
+            val out = LongArray(11)
+            return if (nativeGetMemoryStats(out)) out else null
+        }
 
-    override fun onDrawFrame(gl: javax.microedition.khronos.opengles.GL10?) {
-        onFrameUpdate?.invoke()
-        if (nativeAvailable) nativeOnDrawFrame()
+        /**
+         * 模型在 surface 上实际绘制的范围（像素，左上角原点），可用于按模型收缩悬浮窗。
+         * 尚未绘制模型时返回 false。可在任意线程调用。
+         */
+        fun getModelBounds(out: android.graphics.Rect): Boolean {
+            if (!started) return false
+            val bounds = IntArray(4)
+            nativeGetModelBounds(bounds)
+            out.set(bounds[0], bounds[1], bounds[0] + bounds[2], bounds[1] + bounds[3])
+            return !out.isEmpty
+        }
+
+        /** native 回调（渲染线程）：模型加载结束 */
+        @JvmStatic
+        fun onNativeModelLoaded(path: String, metadata: ByteArray?) {
+            onModelLoaded?.invoke(path, metadata)
+        }
+
+        /** native 回调（渲染线程）：快照完成，失败时 rgba 为 null */
+        @JvmStatic
+        fun onNativeSnapshot(token: Int, width: Int, height: Int, rgba: ByteArray?) {
+            pendingSnapshots.remove(token)?.complete(rgba?.let { SnapshotPixels(width, height, it) })
+        }
+
+        // JNI declarations
+        @JvmStatic external fun nativeStart(assetManager: android.content.res.AssetManager, shaderCacheDir: String, vulkan: Boolean): Boolean
+        @JvmStatic external fun nativeSetSurface(surface: Surface, width: Int, height: Int)
+        @JvmStatic external fun nativeReleaseSurface(surface: Surface)
+        @JvmStatic external fun nativeLoadModel(modelPath: String, force: Boolean)
+        @JvmStatic external fun nativeStartMotion(group: String, index: Int, priority: Int)
+        @JvmStatic external fun nativeSetExpression(expressionId: String)
+        @JvmStatic external fun nativeSetParameterValue(paramId: String, value: Float, weight: Float)
+        @JvmStatic external fun nativeSetLipSyncParameters(ids: Array<String>)
+        @JvmStatic external fun nativeSetLipSync(value: Float)
+        @JvmStatic external fun nativeSetGazeTarget(x: Float, y: Float)
+        @JvmStatic external fun nativeClearGazeTarget()
+        @JvmStatic external fun nativeResetGaze()
+        @JvmStatic external fun nativeSetEyeTracking(enabled: Boolean)
+        @JvmStatic external fun nativeSetModelTransform(scale: Float, offsetX: Float, offsetY: Float)
+        @JvmStatic external fun nativeStartCallRecording(path: String)
+        @JvmStatic external fun nativeStopCallRecording()
+        @JvmStatic external fun nativeSetDynamicResolution(enabled: Boolean, budgetMs: Float)
+        @JvmStatic external fun nativeSetIdleFlipbook(enabled: Boolean, frames: Int, scale: Float)
+        @JvmStatic external fun nativeSetClipMode(mode: Int)
+        @JvmStatic external fun nativeGetModelBounds(out: IntArray)
+        @JvmStatic external fun nativeTrimMemory(level: Int)
+        @JvmStatic external fun nativeGetMemoryStats(out: LongArray): Boolean
+        @JvmStatic external fun nativeRequestSnapshot(token: Int, width: Int, height: Int, background: Int)
+
+        /** 模型缩略图（CPU 光栅化，可在任意线程调用）：预乘 RGBA，顶行在前；失败返回 null */
+        @JvmStatic
+        external fun nativeRenderThumbnail(
+            assetManager: android.content.res.AssetManager, modelPath: String, width: Int, height: Int
+        ): ByteArray?
+
+        init {
+            try {
+                System.loadLibrary("live2d_native")
+                nativeAvailable = true
+            } catch (e: UnsatisfiedLinkError) {
+                android.util.Log.w(TAG, "Native library not available: ${e.message}")
+                nativeAvailable = false
+            }
+        }
     }
-}
\ No newline at end of file
+}
@@ -4,7 +4,6 @@ import android.app.*
 import android.content.Context
 import android.content.Intent
 import android.graphics.PixelFormat
-import android.opengl.GLSurfaceView
 import android.os.Build
 import android.os.IBinder
 import android.util.Log
@@ -13,7 +12,6 @@ import android.widget.FrameLayout
 import androidx.core.app.NotificationCompat
 import com.gameswu.nyadeskpet.MainActivity
 import com.gameswu.nyadeskpet.data.SettingsRepository
-import com.gameswu.nyadeskpet.live2d.GazeController
 import com.gameswu.nyadeskpet.live2d.Live2DManager
 import com.gameswu.nyadeskpet.live2d.Live2DRenderer
 import kotlinx.coroutines.flow.MutableStateFlow
@@ -79,11 +77,12 @@ class FloatingPetService : Service() {
 
     private var windowManager: WindowManager? = null
     private var overlayContainer: FrameLayout? = null
-    private var glSurfaceView: GLSurfaceView? = null
+    private var surfaceView: SurfaceView? = null
     private var overlayRenderer: Live2DRenderer? = null
 
-    // 悬浮窗独立的视线跟随控制器
-    private val gazeController = GazeController()
+    // 上一次发给渲染线程的视线目标（多指时选最近的触摸点）
+    private var lastGazeX = 0f
+    private var lastGazeY = 0f
 
     // 悬浮窗位置状态
     private var windowX = DEFAULT_WINDOW_X
@@ -108,6 +107,11 @@ class FloatingPetService : Service() {
         return START_STICKY
     }
 
+    override fun onTrimMemory(level: Int) {
+        super.onTrimMemory(level)
+        Live2DRenderer.trimMemory(level)
+    }
+
     override fun onDestroy() {
         Log.i(TAG, "Service destroyed")
         _isRunning.value = false
@@ -184,40 +188,26 @@ class FloatingPetService : Service() {
             y = windowY
         }
 
-        // 容器 FrameLayout — 承载 GLSurfaceView
+        // 容器 FrameLayout — 承载 SurfaceView
         val container = FrameLayout(this).apply {
             // 透明背景
             setBackgroundColor(android.graphics.Color.TRANSPARENT)
         }
 
-        // 创建 GLSurfaceView 用于 Live2D 渲染
-        val glView = GLSurfaceView(this).apply {
-            setEGLContextClientVersion(2)
-            setEGLConfigChooser(8, 8, 8, 8, 16, 0)
-            holder.setFormat(PixelFormat.TRANSLUCENT)
-            setZOrderOnTop(true)
-        }
-
-        // 绑定 Live2D 渲染器
-        val renderer = Live2DRenderer(this).also { r ->
-            val modelPath = settingsRepo.current.modelPath
-            if (modelPath.isNotBlank()) {
-                r.pendingModelPath = modelPath
-            }
-            glView.setRenderer(r)
-            glView.renderMode = GLSurfaceView.RENDERMODE_CONTINUOUSLY
-        }
-        overlayRenderer = renderer
+        // 创建 SurfaceView，surface 交给 native 渲染线程
+        val view = SurfaceView(this)
 
-        // 悬浮窗模式下的每帧回调：应用视线跟随参数
-        renderer.onFrameUpdate = {
-            if (settingsRepo.current.enableEyeTracking) {
-                applyOverlayGaze(renderer)
-            }
-        }
+        // 渲染线程与模型在进程内共享：应用内已加载同一模型时不会重新加载，
+        // 上下文也不重建；悬浮窗的 surface 可用后接替应用内画布出帧
+        val settings = settingsRepo.current
+        Live2DRenderer.setDynamicResolution(settings.enableDynamicResolution)
+        Live2DRenderer.setIdleFlipbook(settings.enableIdleFlipbook)
+        Live2DRenderer.setClipMode(Live2DRenderer.clipModeOf(settings.clippingMode))
+        if (settings.modelPath.isNotBlank()) live2dManager.loadModel(settings.modelPath)
+        overlayRenderer = Live2DRenderer(this).also { it.attach(view) }
 
         container.addView(
-            glView,
+            view,
             FrameLayout.LayoutParams(
                 FrameLayout.LayoutParams.MATCH_PARENT,
                 FrameLayout.LayoutParams.MATCH_PARENT,
@@ -229,7 +219,7 @@ class FloatingPetService : Service() {
 
         windowManager?.addView(container, params)
         overlayContainer = container
-        glSurfaceView = glView
+        surfaceView = view
 
         Log.i(TAG, "Overlay window created, size=${sizePx}px")
     }
@@ -303,7 +293,7 @@ class FloatingPetService : Service() {
 
                     // 视线跟随：所有手指抬起，保持最后方向
                     if (settingsRepo.current.enableEyeTracking) {
-                        gazeController.clearTarget()
+                        live2dManager.clearGazeTarget()
                     }
                     true
                 }
@@ -322,8 +312,8 @@ class FloatingPetService : Service() {
     }
 
     /**
-     * 从触摸事件的所有活跃触摸点中选择离当前视线最近的一个，
-     * 将其坐标转换为归一化视线目标 (-1..1)。
+     * 从触摸事件的所有活跃触摸点中选择离上一次视线目标最近的一个，
+     * 将其坐标转换为归一化视线目标 (-1..1)；平滑由渲染线程完成。
      */
     private fun updateGazeFromTouch(event: MotionEvent, view: View) {
         val w = view.width.toFloat()
@@ -342,8 +332,8 @@ class FloatingPetService : Service() {
             val nx = (px / w) * 2f - 1f
             val ny = -((py / h) * 2f - 1f)
 
-            val dx = nx - gazeController.currentX
-            val dy = ny - gazeController.currentY
+            val dx = nx - lastGazeX
+            val dy = ny - lastGazeY
             val dist = dx * dx + dy * dy
             if (dist < bestDist) {
                 bestDist = dist
@@ -352,21 +342,9 @@ class FloatingPetService : Service() {
             }
         }
 
-        gazeController.setTarget(bestNx, bestNy)
-    }
-
-    /**
-     * 在 GL 渲染线程每帧调用，用悬浮窗独立的 GazeController 更新视线参数。
-     */
-    private fun applyOverlayGaze(r: Live2DRenderer) {
-        val (focusX, focusY) = gazeController.update(System.currentTimeMillis())
-
-        r.nativeSetParameterValue("ParamEyeBallX", focusX)
-        r.nativeSetParameterValue("ParamEyeBallY", focusY)
-        r.nativeSetParameterValue("ParamAngleX", focusX * 30f)
-        r.nativeSetParameterValue("ParamAngleY", focusY * 30f)
-        r.nativeSetParameterValue("ParamAngleZ", focusX * focusY * -30f)
-        r.nativeSetParameterValue("ParamBodyAngleX", focusX * 10f)
+        lastGazeX = bestNx
+        lastGazeY = bestNy
+        live2dManager.setGazeTarget(bestNx, bestNy)
     }
 
     private fun openMainActivity() {
@@ -383,12 +361,8 @@ class FloatingPetService : Service() {
     // ==================== 清理 ====================
 
     private fun removeOverlayWindow() {
-        // 先暂停 GL 渲染，确保停止 native 调用
-        try {
-            glSurfaceView?.onPause()
-        } catch (e: Exception) {
-            Log.w(TAG, "Error pausing GL: ${e.message}")
-        }
+        // 先让渲染线程放开悬浮窗的 surface（返回时已不再使用），应用内画布仍在时交还给它
+        overlayRenderer?.detach()
 
         // 从窗口管理器中移除
         try {
@@ -397,7 +371,7 @@ class FloatingPetService : Service() {
             Log.w(TAG, "Error removing overlay: ${e.message}")
         }
         overlayContainer = null
-        glSurfaceView = null
+        surfaceView = null
         overlayRenderer = null
 
         Log.i(TAG, "Overlay window removed")
@@ -1,7 +1,7 @@
 package com.gameswu.nyadeskpet.ui
 
 import android.graphics.BitmapFactory
-import android.opengl.GLSurfaceView
+import android.view.SurfaceView
 import androidx.compose.foundation.Image
 import androidx.compose.foundation.background
 import androidx.compose.foundation.layout.Box
@@ -22,7 +22,7 @@ import org.koin.compose.koinInject
 /**
  * Android Live2D 画布组件。
  *
- * - Native 可用时：使用 GLSurfaceView + Cubism Core 进行实时渲染
+ * - Native 可用时：SurfaceView 的 surface 交给 native 渲染线程（Cubism Core）实时渲染
  * - Native 不可用时（兜底）：从 assets 加载模型纹理缩略图预览
  */
 @Composable
@@ -30,16 +30,17 @@ actual fun Live2DCanvas(modifier: Modifier) {
     val context = LocalContext.current
 
     if (Live2DRenderer.nativeAvailable) {
-        // ===== 正常路径：GLSurfaceView 渲染 =====
+        // ===== 正常路径：native 渲染线程渲染到 SurfaceView =====
         val live2dManager: Live2DManager = koinInject()
-        val glView = remember {
-            GLSurfaceView(context).apply {
+        val surfaceView = remember {
+            SurfaceView(context).apply {
                 live2dManager.bindSurface(this)
             }
         }
-        AndroidView(factory = { glView }, modifier = modifier)
+        AndroidView(factory = { surfaceView }, modifier = modifier)
         DisposableEffect(Unit) {
-            onDispose { glView.onPause() }
+            // 渲染线程放开 surface 后暂停出帧，上下文与模型保留
+            onDispose { live2dManager.unbindSurface() }
         }
     } else {
         // ===== 兜底路径：纹理预览 =====
@@ -32,6 +32,12 @@ data class AppSettings(
     // Live2D 交互
     val tapConfigs: Map<String, Map<String, TapAreaConfig>> = emptyMap(),
     val enableEyeTracking: Boolean = true,
+    /** 帧耗时超出预算时降低模型渲染分辨率（仅 Android） */
+    val enableDynamicResolution: Boolean = false,
+    /** 空闲时播放预渲染的待机序列帧以省电（仅 Android） */
+    val enableIdleFlipbook: Boolean = false,
+    /** 遮罩裁剪方式："auto" | "mask"（遮罩纹理）| "stencil"（模板缓冲）（仅 Android） */
+    val clippingMode: String = "auto",
 
     // ===== LLM Provider 实例（对齐原项目 providers.json）=====
     val llmProviderInstances: List<ProviderInstanceConfig> = emptyList(),
@@ -67,6 +67,12 @@ object I18nManager {
             "settings.language" to "语言",
             "settings.showSubtitle" to "显示字幕",
             "settings.enableEyeTracking" to "视线跟随",
+            "settings.enableDynamicResolution" to "动态分辨率",
+            "settings.enableIdleFlipbook" to "待机低功耗模式",
+            "settings.clippingMode" to "遮罩裁剪方式",
+            "settings.clippingAuto" to "自动（按 GPU 选择）",
+            "settings.clippingMask" to "遮罩纹理（边缘柔和）",
+            "settings.clippingStencil" to "模板缓冲（更省电）",
             "settings.audio" to "音频",
             "settings.volume" to "音量",
             "settings.character" to "角色",
@@ -217,6 +223,12 @@ object I18nManager {
             "settings.language" to "Language",
             "settings.showSubtitle" to "Show Subtitles",
             "settings.enableEyeTracking" to "Eye Tracking",
+            "settings.enableDynamicResolution" to "Dynamic Resolution",
+            "settings.enableIdleFlipbook" to "Low-Power Idle Mode",
+            "settings.clippingMode" to "Clipping Mask Mode",
+            "settings.clippingAuto" to "Auto (by GPU)",
+            "settings.clippingMask" to "Mask Texture (soft edges)",
+            "settings.clippingStencil" to "Stencil Buffer (lower power)",
             "settings.audio" to "Audio",
             "settings.volume" to "Volume",
             "settings.character" to "Character",
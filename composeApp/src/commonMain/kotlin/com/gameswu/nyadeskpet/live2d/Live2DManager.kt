@@ -1,5 +1,6 @@
 package com.gameswu.nyadeskpet.live2d
 
+import androidx.compose.ui.graphics.ImageBitmap
 import com.gameswu.nyadeskpet.PlatformContext
 import com.gameswu.nyadeskpet.agent.ModelInfo
 
@@ -57,11 +58,26 @@ expect class Live2DManager(context: PlatformContext) {
     fun getModelHitAreas(modelPath: String): List<String>
 
     /**
-     * 从 model3.json 提取完整的模型信息（对齐原项目 extractModelInfo）。
+     * 提取完整的模型信息（对齐原项目 extractModelInfo）。
      * 包含 expressions、motions、hitAreas，以及 param-map.json 的映射表。
+     * 刚调用 [loadModel] 时，平台可挂起等待模型加载完成后直接使用加载器解析的结果。
      * 返回 null 表示无法提取（如平台未实现）。
      */
-    fun extractModelInfo(modelPath: String): ModelInfo?
+    suspend fun extractModelInfo(modelPath: String): ModelInfo?
+
+    /**
+     * 渲染模型默认姿势的缩略图（size x size，透明背景）。
+     * 在后台线程用 CPU 光栅化，不占用 GL 线程，也不影响正在显示的模型。
+     * 返回 null 表示无法渲染（路径无效或平台未实现）。
+     */
+    suspend fun renderThumbnail(modelPath: String, size: Int): ImageBitmap?
+
+    /**
+     * 截取正在显示的模型（用于分享或聊天界面），不阻塞渲染：下一帧在离屏目标中绘制，
+     * 之后几帧内异步读回。width / height 为 0 时使用 surface 尺寸，画面按当前缩放与平移等比放入；
+     * background 为 0xAARRGGBB，0 为透明背景。返回 null 表示无法截取（未加载模型、超时或平台未实现）。
+     */
+    suspend fun captureSnapshot(width: Int = 0, height: Int = 0, background: Int = 0): ImageBitmap?
 
     // ===== 视线跟随 =====
 
@@ -87,4 +103,23 @@ expect class Live2DManager(context: PlatformContext) {
      * 禁用时立即重置到默认位置。
      */
     fun setEyeTrackingEnabled(enabled: Boolean)
+
+    /**
+     * 启用/禁用动态分辨率。
+     * 启用后帧耗时超出预算时降低模型渲染分辨率，再放大合成到屏幕。
+     */
+    fun setDynamicResolution(enabled: Boolean)
+
+    /**
+     * 启用/禁用待机低功耗模式。
+     * 启用后模型空闲一段时间会把待机循环预渲染成序列帧，之后只播放图集，有交互时恢复实时渲染。
+     */
+    fun setIdleFlipbook(enabled: Boolean)
+
+    /**
+     * 设置遮罩裁剪方式："auto" | "mask" | "stencil"。
+     * mask 用离屏遮罩纹理（边缘柔和），stencil 把遮罩写进模板缓冲、不切换帧缓冲（tile 架构 GPU 上更省带宽，边缘为硬边），
+     * auto 在 Mali / Adreno / PowerVR 上选 stencil。
+     */
+    fun setClippingMode(mode: String)
 }
@@ -0,0 +1,109 @@
+package com.gameswu.nyadeskpet.live2d
+
+import com.gameswu.nyadeskpet.agent.*
+
+/**
+ * native 加载器在模型加载完成后导出的模型信息（格式见 live2d_renderer.h 的 modelMetadata()）。
+ *
+ * 包含动作组、表情、HitAreas、参数分组（LipSync / EyeBlink）、参数范围和部件层级，
+ * 宿主无需再次读取和解析 model3.json。
+ */
+data class Live2DModelMetadata(
+    val canvasWidth: Float,
+    val canvasHeight: Float,
+    val motionGroups: Map<String, List<String>>,
+    val expressions: List<String>,
+    val hitAreas: List<HitArea>,
+    val groups: List<ParamGroup>,
+    val parameters: List<ParamRange>,
+    val parts: List<Part>,
+) {
+    data class HitArea(val id: String, val name: String)
+    data class ParamGroup(val target: String, val name: String, val ids: List<String>)
+    data class ParamRange(val id: String, val min: Float, val max: Float, val default: Float)
+    data class Part(val id: String, val parentIndex: Int)
+
+    /** model3.json Groups 中指定名称的 Ids（如 "LipSync"、"EyeBlink"） */
+    fun groupIds(name: String): List<String> = groups.firstOrNull { it.name == name }?.ids ?: emptyList()
+
+    /** HitArea 名称（Name 为空时 fallback 到 Id，与 Live2DJsonParser.parseHitAreas 一致） */
+    fun hitAreaNames(): List<String> = hitAreas.map { it.name.ifBlank { it.id } }.filter { it.isNotBlank() }
+
+    /** 转换为发送给 Agent 的 ModelInfo，可选附加 param-map.json 映射 */
+    fun toModelInfo(modelPath: String, paramMap: ParamMapData?): ModelInfo {
+        val motions = motionGroups.mapValues { (_, files) -> MotionGroup(count = files.size, files = files) }
+        val base = ModelInfo(
+            available = true,
+            modelPath = modelPath,
+            dimensions = Dimensions(canvasWidth.toInt(), canvasHeight.toInt()),
+            motions = motions,
+            expressions = expressions,
+            hitAreas = hitAreaNames(),
+            availableParameters = parameters.map { ParameterInfo(it.id, it.default, it.min, it.max, it.default) },
+            parameters = ScaleInfo(canScale = true, currentScale = 1f, userScale = 1f, baseScale = 1f),
+        )
+        if (paramMap == null) return base
+        val enriched = Live2DJsonParser.enrichModelInfoWithParamMap(base, expressions, motions, paramMap)
+        // param-map.json 不含参数范围，用模型中的实际值替换占位的 0..1
+        val ranges = parameters.associateBy { it.id }
+        return enriched.copy(
+            mappedParameters = enriched.mappedParameters?.map { p ->
+                ranges[p.id]?.let { r -> p.copy(min = r.min, max = r.max, default = r.default) } ?: p
+            }
+        )
+    }
+
+    companion object {
+        private const val MAGIC = "L2DMINFO"
+        private const val VERSION = 1
+
+        /** 解析 native blob；格式不符或数据截断时返回 null */
+        fun decode(data: ByteArray): Live2DModelMetadata? {
+            val r = Reader(data)
+            return try {
+                if (r.bytes(8).decodeToString() != MAGIC || r.u32() != VERSION) return null
+                val canvasWidth = r.f32()
+                val canvasHeight = r.f32()
+                val motionGroups = LinkedHashMap<String, List<String>>()
+                repeat(r.count()) {
+                    val name = r.str()
+                    motionGroups[name] = List(r.count()) { r.str() }
+                }
+                val expressions = List(r.count()) { r.str() }
+                val hitAreas = List(r.count()) { HitArea(r.str(), r.str()) }
+                val groups = List(r.count()) { ParamGroup(r.str(), r.str(), List(r.count()) { r.str() }) }
+                val parameters = List(r.count()) { ParamRange(r.str(), r.f32(), r.f32(), r.f32()) }
+                val parts = List(r.count()) { Part(r.str(), r.u32()) }
+                Live2DModelMetadata(canvasWidth, canvasHeight, motionGroups, expressions, hitAreas, groups, parameters, parts)
+            } catch (_: IndexOutOfBoundsException) {
+                null
+            }
+        }
+    }
+
+    /** 小端读取器，越界时抛出 IndexOutOfBoundsException */
+    private class Reader(private val d: ByteArray) {
+        private var p = 0
+
+        fun bytes(n: Int): ByteArray {
+            if (n < 0 || p + n > d.size) throw IndexOutOfBoundsException()
+            return d.copyOfRange(p, p + n).also { p += n }
+        }
+
+        fun u8(): Int {
+            if (p >= d.size) throw IndexOutOfBoundsException()
+            return d[p++].toInt() and 0xFF
+        }
+
+        fun u32(): Int = u8() or (u8() shl 8) or (u8() shl 16) or (u8() shl 24)
+        fun f32(): Float = Float.fromBits(u32())
+
+        /** 元素个数，不可能超过剩余字节数 */
+        fun count(): Int = u32().also { if (it < 0 || it > d.size - p) throw IndexOutOfBoundsException() }
+
+        fun str(): String {
+            val n = u8() or (u8() shl 8)
+            return bytes(n).decodeToString()
+        }
+    }
+}
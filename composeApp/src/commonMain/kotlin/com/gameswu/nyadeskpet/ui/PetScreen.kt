@@ -76,6 +76,18 @@ fun PetScreen(viewModel: ChatViewModel = koinViewModel()) {
         live2dManager.setEyeTrackingEnabled(settings.enableEyeTracking)
     }
 
+    LaunchedEffect(settings.enableDynamicResolution) {
+        live2dManager.setDynamicResolution(settings.enableDynamicResolution)
+    }
+
+    LaunchedEffect(settings.enableIdleFlipbook) {
+        live2dManager.setIdleFlipbook(settings.enableIdleFlipbook)
+    }
+
+    LaunchedEffect(settings.clippingMode) {
+        live2dManager.setClippingMode(settings.clippingMode)
+    }
+
     Box(modifier = Modifier.fillMaxSize()) {
         // Live2D Canvas — 综合手势：拖拽 + 缩放 + 点击 + 视线跟随
         Live2DCanvas(
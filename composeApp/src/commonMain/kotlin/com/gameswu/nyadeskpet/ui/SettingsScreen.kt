@@ -1,5 +1,6 @@
 package com.gameswu.nyadeskpet.ui
 
+import androidx.compose.foundation.Image
 import androidx.compose.foundation.layout.*
 import androidx.compose.foundation.rememberScrollState
 import androidx.compose.foundation.verticalScroll
@@ -10,6 +11,7 @@ import androidx.compose.runtime.*
 import androidx.compose.ui.Alignment
 import androidx.compose.ui.Modifier
 import androidx.compose.ui.graphics.Color
+import androidx.compose.ui.graphics.ImageBitmap
 import androidx.compose.ui.unit.dp
 import com.gameswu.nyadeskpet.data.LogManager
 import com.gameswu.nyadeskpet.data.ModelDataManager
@@ -18,6 +20,7 @@ import com.gameswu.nyadeskpet.data.UpdateChecker
 import com.gameswu.nyadeskpet.getAppVersion
 import com.gameswu.nyadeskpet.i18n.I18nManager
 import com.gameswu.nyadeskpet.live2d.Live2DManager
+import kotlinx.coroutines.delay
 import kotlinx.coroutines.launch
 import org.koin.compose.koinInject
 
@@ -162,10 +165,23 @@ private fun ModelSection(
         }
     }
 
+    // 模型预览 — 后台 CPU 渲染默认姿势，输入路径时稍作防抖
+    val live2dManager: Live2DManager = koinInject()
+    val thumbnail by produceState<ImageBitmap?>(null, settings.modelPath) {
+        value = null
+        delay(300)
+        value = live2dManager.renderThumbnail(settings.modelPath, 256)
+    }
+    thumbnail?.let {
+        Spacer(Modifier.height(8.dp))
+        Box(modifier = Modifier.fillMaxWidth(), contentAlignment = Alignment.Center) {
+            Image(bitmap = it, contentDescription = settings.modelPath, modifier = Modifier.size(128.dp))
+        }
+    }
+
     Spacer(Modifier.height(8.dp))
 
     // 触碰反应配置 — 动态基于模型 HitAreas（对齐原项目 tap config）
-    val live2dManager: Live2DManager = koinInject()
     val hitAreas = remember(settings.modelPath) {
         live2dManager.getModelHitAreas(settings.modelPath)
     }
@@ -464,6 +480,46 @@ private fun DisplaySection(
         onCheckedChange = { repo.update { s -> s.copy(enableEyeTracking = it) } }
     )
 
+    SettingsToggle(
+        label = I18nManager.t("settings.enableDynamicResolution"),
+        checked = settings.enableDynamicResolution,
+        onCheckedChange = { repo.update { s -> s.copy(enableDynamicResolution = it) } }
+    )
+
+    SettingsToggle(
+        label = I18nManager.t("settings.enableIdleFlipbook"),
+        checked = settings.enableIdleFlipbook,
+        onCheckedChange = { repo.update { s -> s.copy(enableIdleFlipbook = it) } }
+    )
+
+    SectionHeader(I18nManager.t("settings.clippingMode"))
+    val clippingOptions = listOf(
+        "auto" to I18nManager.t("settings.clippingAuto"),
+        "mask" to I18nManager.t("settings.clippingMask"),
+        "stencil" to I18nManager.t("settings.clippingStencil"),
+    )
+    var clippingExpanded by remember { mutableStateOf(false) }
+    ExposedDropdownMenuBox(expanded = clippingExpanded, onExpandedChange = { clippingExpanded = it }) {
+        OutlinedTextField(
+            value = clippingOptions.firstOrNull { it.first == settings.clippingMode }?.second ?: settings.clippingMode,
+            onValueChange = {},
+            readOnly = true,
+            trailingIcon = { ExposedDropdownMenuDefaults.TrailingIcon(clippingExpanded) },
+            modifier = Modifier.fillMaxWidth().menuAnchor(ExposedDropdownMenuAnchorType.PrimaryNotEditable),
+        )
+        ExposedDropdownMenu(expanded = clippingExpanded, onDismissRequest = { clippingExpanded = false }) {
+            clippingOptions.forEach { (value, label) ->
+                DropdownMenuItem(
+                    text = { Text(label) },
+                    onClick = {
+                        repo.update { it.copy(clippingMode = value) }
+                        clippingExpanded = false
+                    },
+                )
+            }
+        }
+    }
+
 }
 
 // ==================== 角色 ====================
@@ -2,6 +2,7 @@
 
 package com.gameswu.nyadeskpet.live2d
 
+import androidx.compose.ui.graphics.ImageBitmap
 import com.gameswu.nyadeskpet.PlatformContext
 import com.gameswu.nyadeskpet.agent.*
 import kotlin.concurrent.Volatile
@@ -179,7 +180,7 @@ actual class Live2DManager actual constructor(private val context: PlatformConte
         }
     }
 
-    actual fun extractModelInfo(modelPath: String): ModelInfo? {
+    actual suspend fun extractModelInfo(modelPath: String): ModelInfo? {
         val resolvedModelPath = resolvePath(modelPath)
         return try {
             val json = readFileAsString(resolvedModelPath) ?: return null
@@ -231,6 +232,20 @@ actual class Live2DManager actual constructor(private val context: PlatformConte
         if (!enabled) gazeController.forceReset()
     }
 
+    /** iOS 端暂无 native 渲染目标，动态分辨率不生效 */
+    actual fun setDynamicResolution(enabled: Boolean) {}
+
+    /** iOS 端暂无 native 渲染目标，待机低功耗模式不生效 */
+    actual fun setIdleFlipbook(enabled: Boolean) {}
+
+    /** iOS 端暂无 native 渲染目标，裁剪方式设置不生效 */
+    actual fun setClippingMode(mode: String) {}
+
+    // 预编译桥接库没有 CPU 光栅化接口
+    actual suspend fun renderThumbnail(modelPath: String, size: Int): ImageBitmap? = null
+
+    actual suspend fun captureSnapshot(width: Int, height: Int, background: Int): ImageBitmap? = null
+
     // ===================== File Reading =====================
 
     private fun readFileAsString(path: String): String? {
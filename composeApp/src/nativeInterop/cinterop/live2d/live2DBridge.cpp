@@ -3,7 +3,7 @@
  * Ported from live2d_native.cpp (Android JNI), replacing:
  *   - AAssetManager → POSIX fopen/fread
  *   - GLES2/gl2.h → OpenGLES/ES2/gl.h
- *   - __android_log_print → printf
+ *   - __android_log_print → stderr
  *   - JNI exports → L2DBridge_* C functions
  */
 
@@ -15,6 +15,7 @@
 #include <cmath>
 #include <algorithm>
 #include <cstdio>
+#include <cstdarg>
 #include <ctime>
 
 #include <OpenGLES/ES2/gl.h>
@@ -31,8 +32,26 @@ extern "C" {
 }
 
 #define LOG_TAG "Live2D_iOS"
-#define LOGI(...) do { printf("[" LOG_TAG "] "); printf(__VA_ARGS__); printf("\n"); } while(0)
-#define LOGE(...) do { printf("[" LOG_TAG " ERROR] "); printf(__VA_ARGS__); printf("\n"); } while(0)
+// 先格式化到栈上缓冲区再一次性写出, 不在 stdout 锁下分三次 printf;
+// Release (NDEBUG) 下 LOGI 编译为空, LOGE 保留
+static void l2dLogWrite(const char* prefix, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+static void l2dLogWrite(const char* prefix, const char* fmt, ...) {
+    char buf[512];
+    int n = snprintf(buf, sizeof(buf), "%s", prefix);
+    va_list ap;
+    va_start(ap, fmt);
+    int m = vsnprintf(buf + n, sizeof(buf) - n - 1, fmt, ap);
+    va_end(ap);
+    n += (m < 0) ? 0 : (m < (int)sizeof(buf) - n - 1 ? m : (int)sizeof(buf) - n - 2);
+    buf[n++] = '\n';
+    fwrite(buf, 1, n, stderr);
+}
+#ifdef NDEBUG
+#define LOGI(...) do {} while(0)
+#else
+#define LOGI(...) l2dLogWrite("[" LOG_TAG "] ", __VA_ARGS__)
+#endif
+#define LOGE(...) l2dLogWrite("[" LOG_TAG " ERROR] ", __VA_ARGS__)
 
 // ===================== Data Structures =====================
 